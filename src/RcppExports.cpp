@@ -11,6 +11,164 @@ Rcpp::Rostream<true>&  Rcpp::Rcout = Rcpp::Rcpp_cout_get();
 Rcpp::Rostream<false>& Rcpp::Rcerr = Rcpp::Rcpp_cerr_get();
 #endif
 
+// composite_best_pixel
+bool composite_best_pixel(const Rcpp::CharacterVector& dsn, const Rcpp::IntegerVector& bands, int num_scenes, GDALRaster* const& dst_ds, const std::string& score, double qa_mask, const Rcpp::IntegerVector& ndvi_bands, const Rcpp::NumericVector& times, double target_time, bool index_band, int tile_size, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_composite_best_pixel(SEXP dsnSEXP, SEXP bandsSEXP, SEXP num_scenesSEXP, SEXP dst_dsSEXP, SEXP scoreSEXP, SEXP qa_maskSEXP, SEXP ndvi_bandsSEXP, SEXP timesSEXP, SEXP target_timeSEXP, SEXP index_bandSEXP, SEXP tile_sizeSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::CharacterVector& >::type dsn(dsnSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::IntegerVector& >::type bands(bandsSEXP);
+    Rcpp::traits::input_parameter< int >::type num_scenes(num_scenesSEXP);
+    Rcpp::traits::input_parameter< GDALRaster* const& >::type dst_ds(dst_dsSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type score(scoreSEXP);
+    Rcpp::traits::input_parameter< double >::type qa_mask(qa_maskSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::IntegerVector& >::type ndvi_bands(ndvi_bandsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type times(timesSEXP);
+    Rcpp::traits::input_parameter< double >::type target_time(target_timeSEXP);
+    Rcpp::traits::input_parameter< bool >::type index_band(index_bandSEXP);
+    Rcpp::traits::input_parameter< int >::type tile_size(tile_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(composite_best_pixel(dsn, bands, num_scenes, dst_ds, score, qa_mask, ndvi_bands, times, target_time, index_band, tile_size, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// dem_calc_window
+Rcpp::NumericVector dem_calc_window(const GDALRaster* const& src_ds, int band, int xoff, int yoff, int xsize, int ysize, const std::string& mode, const std::string& alg, bool slope_percent, double z_factor, double scale, double azimuth, double altitude, bool zero_for_flat, bool compute_edges, int num_threads);
+RcppExport SEXP _gdalraster_dem_calc_window(SEXP src_dsSEXP, SEXP bandSEXP, SEXP xoffSEXP, SEXP yoffSEXP, SEXP xsizeSEXP, SEXP ysizeSEXP, SEXP modeSEXP, SEXP algSEXP, SEXP slope_percentSEXP, SEXP z_factorSEXP, SEXP scaleSEXP, SEXP azimuthSEXP, SEXP altitudeSEXP, SEXP zero_for_flatSEXP, SEXP compute_edgesSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type src_ds(src_dsSEXP);
+    Rcpp::traits::input_parameter< int >::type band(bandSEXP);
+    Rcpp::traits::input_parameter< int >::type xoff(xoffSEXP);
+    Rcpp::traits::input_parameter< int >::type yoff(yoffSEXP);
+    Rcpp::traits::input_parameter< int >::type xsize(xsizeSEXP);
+    Rcpp::traits::input_parameter< int >::type ysize(ysizeSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type mode(modeSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type alg(algSEXP);
+    Rcpp::traits::input_parameter< bool >::type slope_percent(slope_percentSEXP);
+    Rcpp::traits::input_parameter< double >::type z_factor(z_factorSEXP);
+    Rcpp::traits::input_parameter< double >::type scale(scaleSEXP);
+    Rcpp::traits::input_parameter< double >::type azimuth(azimuthSEXP);
+    Rcpp::traits::input_parameter< double >::type altitude(altitudeSEXP);
+    Rcpp::traits::input_parameter< bool >::type zero_for_flat(zero_for_flatSEXP);
+    Rcpp::traits::input_parameter< bool >::type compute_edges(compute_edgesSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(dem_calc_window(src_ds, band, xoff, yoff, xsize, ysize, mode, alg, slope_percent, z_factor, scale, azimuth, altitude, zero_for_flat, compute_edges, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// dem_calc_ds
+bool dem_calc_ds(const GDALRaster* const& src_ds, int band, const GDALRaster* const& dst_ds, int dst_band, const std::string& mode, const std::string& alg, bool slope_percent, double z_factor, double scale, double azimuth, double altitude, bool zero_for_flat, bool compute_edges, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_dem_calc_ds(SEXP src_dsSEXP, SEXP bandSEXP, SEXP dst_dsSEXP, SEXP dst_bandSEXP, SEXP modeSEXP, SEXP algSEXP, SEXP slope_percentSEXP, SEXP z_factorSEXP, SEXP scaleSEXP, SEXP azimuthSEXP, SEXP altitudeSEXP, SEXP zero_for_flatSEXP, SEXP compute_edgesSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type src_ds(src_dsSEXP);
+    Rcpp::traits::input_parameter< int >::type band(bandSEXP);
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type dst_ds(dst_dsSEXP);
+    Rcpp::traits::input_parameter< int >::type dst_band(dst_bandSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type mode(modeSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type alg(algSEXP);
+    Rcpp::traits::input_parameter< bool >::type slope_percent(slope_percentSEXP);
+    Rcpp::traits::input_parameter< double >::type z_factor(z_factorSEXP);
+    Rcpp::traits::input_parameter< double >::type scale(scaleSEXP);
+    Rcpp::traits::input_parameter< double >::type azimuth(azimuthSEXP);
+    Rcpp::traits::input_parameter< double >::type altitude(altitudeSEXP);
+    Rcpp::traits::input_parameter< bool >::type zero_for_flat(zero_for_flatSEXP);
+    Rcpp::traits::input_parameter< bool >::type compute_edges(compute_edgesSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(dem_calc_ds(src_ds, band, dst_ds, dst_band, mode, alg, slope_percent, z_factor, scale, azimuth, altitude, zero_for_flat, compute_edges, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// dem_fill
+bool dem_fill(const GDALRaster* const& src_ds, int band, const GDALRaster* const& dst_ds, int tile_size, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_dem_fill(SEXP src_dsSEXP, SEXP bandSEXP, SEXP dst_dsSEXP, SEXP tile_sizeSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type src_ds(src_dsSEXP);
+    Rcpp::traits::input_parameter< int >::type band(bandSEXP);
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type dst_ds(dst_dsSEXP);
+    Rcpp::traits::input_parameter< int >::type tile_size(tile_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(dem_fill(src_ds, band, dst_ds, tile_size, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// flow_dir
+bool flow_dir(const GDALRaster* const& src_ds, int band, const GDALRaster* const& dst_ds, const std::string& method, int tile_size, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_flow_dir(SEXP src_dsSEXP, SEXP bandSEXP, SEXP dst_dsSEXP, SEXP methodSEXP, SEXP tile_sizeSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type src_ds(src_dsSEXP);
+    Rcpp::traits::input_parameter< int >::type band(bandSEXP);
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type dst_ds(dst_dsSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type method(methodSEXP);
+    Rcpp::traits::input_parameter< int >::type tile_size(tile_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(flow_dir(src_ds, band, dst_ds, method, tile_size, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// flow_acc
+bool flow_acc(const GDALRaster* const& src_ds, int band, const GDALRaster* const& dst_ds, const std::string& method, int tile_size, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_flow_acc(SEXP src_dsSEXP, SEXP bandSEXP, SEXP dst_dsSEXP, SEXP methodSEXP, SEXP tile_sizeSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type src_ds(src_dsSEXP);
+    Rcpp::traits::input_parameter< int >::type band(bandSEXP);
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type dst_ds(dst_dsSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type method(methodSEXP);
+    Rcpp::traits::input_parameter< int >::type tile_size(tile_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(flow_acc(src_ds, band, dst_ds, method, tile_size, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// raster_classes
+Rcpp::NumericVector raster_classes(const GDALRaster* const& src_ds, int band, int max_classes);
+RcppExport SEXP _gdalraster_raster_classes(SEXP src_dsSEXP, SEXP bandSEXP, SEXP max_classesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type src_ds(src_dsSEXP);
+    Rcpp::traits::input_parameter< int >::type band(bandSEXP);
+    Rcpp::traits::input_parameter< int >::type max_classes(max_classesSEXP);
+    rcpp_result_gen = Rcpp::wrap(raster_classes(src_ds, band, max_classes));
+    return rcpp_result_gen;
+END_RCPP
+}
+// focal_categorical
+bool focal_categorical(const GDALRaster* const& src_ds, int band, const GDALRaster* const& dst_ds, const Rcpp::CharacterVector& stats, const Rcpp::NumericVector& classes, const Rcpp::NumericVector& band_classes, int radius, bool square, int tile_size, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_focal_categorical(SEXP src_dsSEXP, SEXP bandSEXP, SEXP dst_dsSEXP, SEXP statsSEXP, SEXP classesSEXP, SEXP band_classesSEXP, SEXP radiusSEXP, SEXP squareSEXP, SEXP tile_sizeSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type src_ds(src_dsSEXP);
+    Rcpp::traits::input_parameter< int >::type band(bandSEXP);
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type dst_ds(dst_dsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::CharacterVector& >::type stats(statsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type classes(classesSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type band_classes(band_classesSEXP);
+    Rcpp::traits::input_parameter< int >::type radius(radiusSEXP);
+    Rcpp::traits::input_parameter< bool >::type square(squareSEXP);
+    Rcpp::traits::input_parameter< int >::type tile_size(tile_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(focal_categorical(src_ds, band, dst_ds, stats, classes, band_classes, radius, square, tile_size, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
 // dt_size
 int dt_size(const std::string& dt, bool as_bytes);
 RcppExport SEXP _gdalraster_dt_size(SEXP dtSEXP, SEXP as_bytesSEXP) {
@@ -1150,26 +1308,29 @@ BEGIN_RCPP
 END_RCPP
 }
 // g_wkb2wkt
-Rcpp::String g_wkb2wkt(const Rcpp::RObject& geom, bool as_iso);
-RcppExport SEXP _gdalraster_g_wkb2wkt(SEXP geomSEXP, SEXP as_isoSEXP) {
+Rcpp::String g_wkb2wkt(const Rcpp::RObject& geom, bool as_iso, int precision);
+RcppExport SEXP _gdalraster_g_wkb2wkt(SEXP geomSEXP, SEXP as_isoSEXP, SEXP precisionSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const Rcpp::RObject& >::type geom(geomSEXP);
     Rcpp::traits::input_parameter< bool >::type as_iso(as_isoSEXP);
-    rcpp_result_gen = Rcpp::wrap(g_wkb2wkt(geom, as_iso));
+    Rcpp::traits::input_parameter< int >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(g_wkb2wkt(geom, as_iso, precision));
     return rcpp_result_gen;
 END_RCPP
 }
 // g_wkb_list2wkt
-Rcpp::CharacterVector g_wkb_list2wkt(const Rcpp::List& geom, bool as_iso);
-RcppExport SEXP _gdalraster_g_wkb_list2wkt(SEXP geomSEXP, SEXP as_isoSEXP) {
+Rcpp::CharacterVector g_wkb_list2wkt(const Rcpp::List& geom, bool as_iso, int precision, int num_threads);
+RcppExport SEXP _gdalraster_g_wkb_list2wkt(SEXP geomSEXP, SEXP as_isoSEXP, SEXP precisionSEXP, SEXP num_threadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const Rcpp::List& >::type geom(geomSEXP);
     Rcpp::traits::input_parameter< bool >::type as_iso(as_isoSEXP);
-    rcpp_result_gen = Rcpp::wrap(g_wkb_list2wkt(geom, as_iso));
+    Rcpp::traits::input_parameter< int >::type precision(precisionSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(g_wkb_list2wkt(geom, as_iso, precision, num_threads));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -1187,15 +1348,16 @@ BEGIN_RCPP
 END_RCPP
 }
 // g_wkt_vector2wkb
-Rcpp::List g_wkt_vector2wkb(const Rcpp::CharacterVector& geom, bool as_iso, const std::string& byte_order);
-RcppExport SEXP _gdalraster_g_wkt_vector2wkb(SEXP geomSEXP, SEXP as_isoSEXP, SEXP byte_orderSEXP) {
+Rcpp::List g_wkt_vector2wkb(const Rcpp::CharacterVector& geom, bool as_iso, const std::string& byte_order, int num_threads);
+RcppExport SEXP _gdalraster_g_wkt_vector2wkb(SEXP geomSEXP, SEXP as_isoSEXP, SEXP byte_orderSEXP, SEXP num_threadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const Rcpp::CharacterVector& >::type geom(geomSEXP);
     Rcpp::traits::input_parameter< bool >::type as_iso(as_isoSEXP);
     Rcpp::traits::input_parameter< const std::string& >::type byte_order(byte_orderSEXP);
-    rcpp_result_gen = Rcpp::wrap(g_wkt_vector2wkb(geom, as_iso, byte_order));
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(g_wkt_vector2wkb(geom, as_iso, byte_order, num_threads));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -1239,6 +1401,18 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// g_geom_count_vec
+Rcpp::IntegerVector g_geom_count_vec(const Rcpp::RObject& geom, bool quiet);
+RcppExport SEXP _gdalraster_g_geom_count_vec(SEXP geomSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type geom(geomSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(g_geom_count_vec(geom, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
 // g_get_geom
 SEXP g_get_geom(const Rcpp::RawVector& container, int sub_geom_idx, bool as_iso, const std::string& byte_order);
 RcppExport SEXP _gdalraster_g_get_geom(SEXP containerSEXP, SEXP sub_geom_idxSEXP, SEXP as_isoSEXP, SEXP byte_orderSEXP) {
@@ -1281,6 +1455,23 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// g_make_valid_vec
+Rcpp::List g_make_valid_vec(const Rcpp::RObject& geom, const std::string& method, bool keep_collapsed, bool as_iso, const std::string& byte_order, bool quiet, int num_threads);
+RcppExport SEXP _gdalraster_g_make_valid_vec(SEXP geomSEXP, SEXP methodSEXP, SEXP keep_collapsedSEXP, SEXP as_isoSEXP, SEXP byte_orderSEXP, SEXP quietSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type geom(geomSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type method(methodSEXP);
+    Rcpp::traits::input_parameter< bool >::type keep_collapsed(keep_collapsedSEXP);
+    Rcpp::traits::input_parameter< bool >::type as_iso(as_isoSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type byte_order(byte_orderSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(g_make_valid_vec(geom, method, keep_collapsed, as_iso, byte_order, quiet, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // g_normalize
 SEXP g_normalize(const Rcpp::RObject& geom, bool as_iso, const std::string& byte_order, bool quiet);
 RcppExport SEXP _gdalraster_g_normalize(SEXP geomSEXP, SEXP as_isoSEXP, SEXP byte_orderSEXP, SEXP quietSEXP) {
@@ -1351,6 +1542,18 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// g_is_empty_vec
+Rcpp::LogicalVector g_is_empty_vec(const Rcpp::RObject& geom, bool quiet);
+RcppExport SEXP _gdalraster_g_is_empty_vec(SEXP geomSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type geom(geomSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(g_is_empty_vec(geom, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
 // g_is_3D
 Rcpp::LogicalVector g_is_3D(const Rcpp::RObject& geom, bool quiet);
 RcppExport SEXP _gdalraster_g_is_3D(SEXP geomSEXP, SEXP quietSEXP) {
@@ -1399,6 +1602,18 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// g_name_vec
+Rcpp::CharacterVector g_name_vec(const Rcpp::RObject& geom, bool quiet);
+RcppExport SEXP _gdalraster_g_name_vec(SEXP geomSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type geom(geomSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(g_name_vec(geom, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
 // g_summary
 Rcpp::String g_summary(const Rcpp::RObject& geom, bool quiet);
 RcppExport SEXP _gdalraster_g_summary(SEXP geomSEXP, SEXP quietSEXP) {
@@ -1424,107 +1639,43 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
-// g_intersects
-Rcpp::LogicalVector g_intersects(const Rcpp::RObject& this_geom, const Rcpp::RObject& other_geom, bool quiet);
-RcppExport SEXP _gdalraster_g_intersects(SEXP this_geomSEXP, SEXP other_geomSEXP, SEXP quietSEXP) {
-BEGIN_RCPP
-    Rcpp::RObject rcpp_result_gen;
-    Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type this_geom(this_geomSEXP);
-    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type other_geom(other_geomSEXP);
-    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
-    rcpp_result_gen = Rcpp::wrap(g_intersects(this_geom, other_geom, quiet));
-    return rcpp_result_gen;
-END_RCPP
-}
-// g_equals
-Rcpp::LogicalVector g_equals(const Rcpp::RObject& this_geom, const Rcpp::RObject& other_geom, bool quiet);
-RcppExport SEXP _gdalraster_g_equals(SEXP this_geomSEXP, SEXP other_geomSEXP, SEXP quietSEXP) {
+// g_envelope_vec
+Rcpp::NumericMatrix g_envelope_vec(const Rcpp::RObject& geom, bool as_3d, bool quiet);
+RcppExport SEXP _gdalraster_g_envelope_vec(SEXP geomSEXP, SEXP as_3dSEXP, SEXP quietSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type this_geom(this_geomSEXP);
-    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type other_geom(other_geomSEXP);
-    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
-    rcpp_result_gen = Rcpp::wrap(g_equals(this_geom, other_geom, quiet));
-    return rcpp_result_gen;
-END_RCPP
-}
-// g_disjoint
-Rcpp::LogicalVector g_disjoint(const Rcpp::RObject& this_geom, const Rcpp::RObject& other_geom, bool quiet);
-RcppExport SEXP _gdalraster_g_disjoint(SEXP this_geomSEXP, SEXP other_geomSEXP, SEXP quietSEXP) {
-BEGIN_RCPP
-    Rcpp::RObject rcpp_result_gen;
-    Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type this_geom(this_geomSEXP);
-    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type other_geom(other_geomSEXP);
-    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
-    rcpp_result_gen = Rcpp::wrap(g_disjoint(this_geom, other_geom, quiet));
-    return rcpp_result_gen;
-END_RCPP
-}
-// g_touches
-Rcpp::LogicalVector g_touches(const Rcpp::RObject& this_geom, const Rcpp::RObject& other_geom, bool quiet);
-RcppExport SEXP _gdalraster_g_touches(SEXP this_geomSEXP, SEXP other_geomSEXP, SEXP quietSEXP) {
-BEGIN_RCPP
-    Rcpp::RObject rcpp_result_gen;
-    Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type this_geom(this_geomSEXP);
-    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type other_geom(other_geomSEXP);
-    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
-    rcpp_result_gen = Rcpp::wrap(g_touches(this_geom, other_geom, quiet));
-    return rcpp_result_gen;
-END_RCPP
-}
-// g_contains
-Rcpp::LogicalVector g_contains(const Rcpp::RObject& this_geom, const Rcpp::RObject& other_geom, bool quiet);
-RcppExport SEXP _gdalraster_g_contains(SEXP this_geomSEXP, SEXP other_geomSEXP, SEXP quietSEXP) {
-BEGIN_RCPP
-    Rcpp::RObject rcpp_result_gen;
-    Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type this_geom(this_geomSEXP);
-    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type other_geom(other_geomSEXP);
-    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
-    rcpp_result_gen = Rcpp::wrap(g_contains(this_geom, other_geom, quiet));
-    return rcpp_result_gen;
-END_RCPP
-}
-// g_within
-Rcpp::LogicalVector g_within(const Rcpp::RObject& this_geom, const Rcpp::RObject& other_geom, bool quiet);
-RcppExport SEXP _gdalraster_g_within(SEXP this_geomSEXP, SEXP other_geomSEXP, SEXP quietSEXP) {
-BEGIN_RCPP
-    Rcpp::RObject rcpp_result_gen;
-    Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type this_geom(this_geomSEXP);
-    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type other_geom(other_geomSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type geom(geomSEXP);
+    Rcpp::traits::input_parameter< bool >::type as_3d(as_3dSEXP);
     Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
-    rcpp_result_gen = Rcpp::wrap(g_within(this_geom, other_geom, quiet));
+    rcpp_result_gen = Rcpp::wrap(g_envelope_vec(geom, as_3d, quiet));
     return rcpp_result_gen;
 END_RCPP
 }
-// g_crosses
-Rcpp::LogicalVector g_crosses(const Rcpp::RObject& this_geom, const Rcpp::RObject& other_geom, bool quiet);
-RcppExport SEXP _gdalraster_g_crosses(SEXP this_geomSEXP, SEXP other_geomSEXP, SEXP quietSEXP) {
+// g_coords_wkb
+SEXP g_coords_wkb(const Rcpp::RObject& geom);
+RcppExport SEXP _gdalraster_g_coords_wkb(SEXP geomSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type this_geom(this_geomSEXP);
-    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type other_geom(other_geomSEXP);
-    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
-    rcpp_result_gen = Rcpp::wrap(g_crosses(this_geom, other_geom, quiet));
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type geom(geomSEXP);
+    rcpp_result_gen = Rcpp::wrap(g_coords_wkb(geom));
     return rcpp_result_gen;
 END_RCPP
 }
-// g_overlaps
-Rcpp::LogicalVector g_overlaps(const Rcpp::RObject& this_geom, const Rcpp::RObject& other_geom, bool quiet);
-RcppExport SEXP _gdalraster_g_overlaps(SEXP this_geomSEXP, SEXP other_geomSEXP, SEXP quietSEXP) {
+// g_binary_pred_vec
+Rcpp::LogicalVector g_binary_pred_vec(const Rcpp::RObject& this_geom, const Rcpp::RObject& other_geom, const std::string& predicate, bool cross, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_g_binary_pred_vec(SEXP this_geomSEXP, SEXP other_geomSEXP, SEXP predicateSEXP, SEXP crossSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const Rcpp::RObject& >::type this_geom(this_geomSEXP);
     Rcpp::traits::input_parameter< const Rcpp::RObject& >::type other_geom(other_geomSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type predicate(predicateSEXP);
+    Rcpp::traits::input_parameter< bool >::type cross(crossSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
     Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
-    rcpp_result_gen = Rcpp::wrap(g_overlaps(this_geom, other_geom, quiet));
+    rcpp_result_gen = Rcpp::wrap(g_binary_pred_vec(this_geom, other_geom, predicate, cross, num_threads, quiet));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -1558,6 +1709,23 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// g_buffer_vec
+Rcpp::List g_buffer_vec(const Rcpp::RObject& geom, double dist, int quad_segs, bool as_iso, const std::string& byte_order, bool quiet, int num_threads);
+RcppExport SEXP _gdalraster_g_buffer_vec(SEXP geomSEXP, SEXP distSEXP, SEXP quad_segsSEXP, SEXP as_isoSEXP, SEXP byte_orderSEXP, SEXP quietSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type geom(geomSEXP);
+    Rcpp::traits::input_parameter< double >::type dist(distSEXP);
+    Rcpp::traits::input_parameter< int >::type quad_segs(quad_segsSEXP);
+    Rcpp::traits::input_parameter< bool >::type as_iso(as_isoSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type byte_order(byte_orderSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(g_buffer_vec(geom, dist, quad_segs, as_iso, byte_order, quiet, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // g_convex_hull
 SEXP g_convex_hull(const Rcpp::RObject& geom, bool as_iso, const std::string& byte_order, bool quiet);
 RcppExport SEXP _gdalraster_g_convex_hull(SEXP geomSEXP, SEXP as_isoSEXP, SEXP byte_orderSEXP, SEXP quietSEXP) {
@@ -1621,6 +1789,23 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// g_simplify_vec
+Rcpp::List g_simplify_vec(const Rcpp::RObject& geom, double tolerance, bool preserve_topology, bool as_iso, const std::string& byte_order, bool quiet, int num_threads);
+RcppExport SEXP _gdalraster_g_simplify_vec(SEXP geomSEXP, SEXP toleranceSEXP, SEXP preserve_topologySEXP, SEXP as_isoSEXP, SEXP byte_orderSEXP, SEXP quietSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type geom(geomSEXP);
+    Rcpp::traits::input_parameter< double >::type tolerance(toleranceSEXP);
+    Rcpp::traits::input_parameter< bool >::type preserve_topology(preserve_topologySEXP);
+    Rcpp::traits::input_parameter< bool >::type as_iso(as_isoSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type byte_order(byte_orderSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(g_simplify_vec(geom, tolerance, preserve_topology, as_iso, byte_order, quiet, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // g_unary_union
 SEXP g_unary_union(const Rcpp::RObject& geom, bool as_iso, const std::string& byte_order, bool quiet);
 RcppExport SEXP _gdalraster_g_unary_union(SEXP geomSEXP, SEXP as_isoSEXP, SEXP byte_orderSEXP, SEXP quietSEXP) {
@@ -1773,8 +1958,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // g_transform
-SEXP g_transform(const Rcpp::RObject& geom, const std::string& srs_from, const std::string& srs_to, bool wrap_date_line, int date_line_offset, bool traditional_gis_order, bool as_iso, const std::string& byte_order, bool quiet);
-RcppExport SEXP _gdalraster_g_transform(SEXP geomSEXP, SEXP srs_fromSEXP, SEXP srs_toSEXP, SEXP wrap_date_lineSEXP, SEXP date_line_offsetSEXP, SEXP traditional_gis_orderSEXP, SEXP as_isoSEXP, SEXP byte_orderSEXP, SEXP quietSEXP) {
+SEXP g_transform(const Rcpp::RObject& geom, const std::string& srs_from, const std::string& srs_to, bool wrap_date_line, int date_line_offset, bool traditional_gis_order, bool as_iso, const std::string& byte_order, bool quiet, int num_threads);
+RcppExport SEXP _gdalraster_g_transform(SEXP geomSEXP, SEXP srs_fromSEXP, SEXP srs_toSEXP, SEXP wrap_date_lineSEXP, SEXP date_line_offsetSEXP, SEXP traditional_gis_orderSEXP, SEXP as_isoSEXP, SEXP byte_orderSEXP, SEXP quietSEXP, SEXP num_threadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -1787,7 +1972,8 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< bool >::type as_iso(as_isoSEXP);
     Rcpp::traits::input_parameter< const std::string& >::type byte_order(byte_orderSEXP);
     Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
-    rcpp_result_gen = Rcpp::wrap(g_transform(geom, srs_from, srs_to, wrap_date_line, date_line_offset, traditional_gis_order, as_iso, byte_order, quiet));
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(g_transform(geom, srs_from, srs_to, wrap_date_line, date_line_offset, traditional_gis_order, as_iso, byte_order, quiet, num_threads));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -1817,6 +2003,119 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// g_union_agg
+Rcpp::List g_union_agg(const Rcpp::RObject& geom, const Rcpp::IntegerVector& group, int num_groups, bool coverage, bool as_iso, const std::string& byte_order, bool quiet, int num_threads);
+RcppExport SEXP _gdalraster_g_union_agg(SEXP geomSEXP, SEXP groupSEXP, SEXP num_groupsSEXP, SEXP coverageSEXP, SEXP as_isoSEXP, SEXP byte_orderSEXP, SEXP quietSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type geom(geomSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::IntegerVector& >::type group(groupSEXP);
+    Rcpp::traits::input_parameter< int >::type num_groups(num_groupsSEXP);
+    Rcpp::traits::input_parameter< bool >::type coverage(coverageSEXP);
+    Rcpp::traits::input_parameter< bool >::type as_iso(as_isoSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type byte_order(byte_orderSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(g_union_agg(geom, group, num_groups, coverage, as_iso, byte_order, quiet, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ogr_union_agg
+Rcpp::List ogr_union_agg(GDALVector* const& lyr, const std::string& by, bool coverage, bool as_iso, const std::string& byte_order, bool quiet, int num_threads);
+RcppExport SEXP _gdalraster_ogr_union_agg(SEXP lyrSEXP, SEXP bySEXP, SEXP coverageSEXP, SEXP as_isoSEXP, SEXP byte_orderSEXP, SEXP quietSEXP, SEXP num_threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< GDALVector* const& >::type lyr(lyrSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type by(bySEXP);
+    Rcpp::traits::input_parameter< bool >::type coverage(coverageSEXP);
+    Rcpp::traits::input_parameter< bool >::type as_iso(as_isoSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type byte_order(byte_orderSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(ogr_union_agg(lyr, by, coverage, as_iso, byte_order, quiet, num_threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// grid_points_ds
+bool grid_points_ds(const Rcpp::RObject& xyz, const GDALRaster* const& dst_ds, int band, const std::string& method, double power, double radius, int max_points, int min_points, int tile_size, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_grid_points_ds(SEXP xyzSEXP, SEXP dst_dsSEXP, SEXP bandSEXP, SEXP methodSEXP, SEXP powerSEXP, SEXP radiusSEXP, SEXP max_pointsSEXP, SEXP min_pointsSEXP, SEXP tile_sizeSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type xyz(xyzSEXP);
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type dst_ds(dst_dsSEXP);
+    Rcpp::traits::input_parameter< int >::type band(bandSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type method(methodSEXP);
+    Rcpp::traits::input_parameter< double >::type power(powerSEXP);
+    Rcpp::traits::input_parameter< double >::type radius(radiusSEXP);
+    Rcpp::traits::input_parameter< int >::type max_points(max_pointsSEXP);
+    Rcpp::traits::input_parameter< int >::type min_points(min_pointsSEXP);
+    Rcpp::traits::input_parameter< int >::type tile_size(tile_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(grid_points_ds(xyz, dst_ds, band, method, power, radius, max_points, min_points, tile_size, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// grid_points_grid
+Rcpp::NumericVector grid_points_grid(const Rcpp::RObject& xyz, const Rcpp::NumericVector& gt, int xsize, int ysize, const std::string& method, double power, double radius, int max_points, int min_points, int tile_size, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_grid_points_grid(SEXP xyzSEXP, SEXP gtSEXP, SEXP xsizeSEXP, SEXP ysizeSEXP, SEXP methodSEXP, SEXP powerSEXP, SEXP radiusSEXP, SEXP max_pointsSEXP, SEXP min_pointsSEXP, SEXP tile_sizeSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type xyz(xyzSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type gt(gtSEXP);
+    Rcpp::traits::input_parameter< int >::type xsize(xsizeSEXP);
+    Rcpp::traits::input_parameter< int >::type ysize(ysizeSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type method(methodSEXP);
+    Rcpp::traits::input_parameter< double >::type power(powerSEXP);
+    Rcpp::traits::input_parameter< double >::type radius(radiusSEXP);
+    Rcpp::traits::input_parameter< int >::type max_points(max_pointsSEXP);
+    Rcpp::traits::input_parameter< int >::type min_points(min_pointsSEXP);
+    Rcpp::traits::input_parameter< int >::type tile_size(tile_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(grid_points_grid(xyz, gt, xsize, ysize, method, power, radius, max_points, min_points, tile_size, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// landscape_metrics
+Rcpp::List landscape_metrics(const GDALRaster* const& src_ds, int band, int connectedness, const Rcpp::Nullable<Rcpp::RObject>& dst_ds, bool return_patches, int tile_size, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_landscape_metrics(SEXP src_dsSEXP, SEXP bandSEXP, SEXP connectednessSEXP, SEXP dst_dsSEXP, SEXP return_patchesSEXP, SEXP tile_sizeSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type src_ds(src_dsSEXP);
+    Rcpp::traits::input_parameter< int >::type band(bandSEXP);
+    Rcpp::traits::input_parameter< int >::type connectedness(connectednessSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::Nullable<Rcpp::RObject>& >::type dst_ds(dst_dsSEXP);
+    Rcpp::traits::input_parameter< bool >::type return_patches(return_patchesSEXP);
+    Rcpp::traits::input_parameter< int >::type tile_size(tile_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(landscape_metrics(src_ds, band, connectedness, dst_ds, return_patches, tile_size, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// lazy_compute
+SEXP lazy_compute(const Rcpp::List& nodes, const Rcpp::List& sources, const Rcpp::Nullable<Rcpp::RObject>& dst_ds, int band, int tile_size, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_lazy_compute(SEXP nodesSEXP, SEXP sourcesSEXP, SEXP dst_dsSEXP, SEXP bandSEXP, SEXP tile_sizeSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type nodes(nodesSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type sources(sourcesSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::Nullable<Rcpp::RObject>& >::type dst_ds(dst_dsSEXP);
+    Rcpp::traits::input_parameter< int >::type band(bandSEXP);
+    Rcpp::traits::input_parameter< int >::type tile_size(tile_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(lazy_compute(nodes, sources, dst_ds, band, tile_size, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
 // ogr_ds_exists
 bool ogr_ds_exists(const std::string& dsn, bool with_update);
 RcppExport SEXP _gdalraster_ogr_ds_exists(SEXP dsnSEXP, SEXP with_updateSEXP) {
@@ -2076,6 +2375,192 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// point_density_ds
+bool point_density_ds(const Rcpp::RObject& xy, const Rcpp::NumericVector& weights, const GDALRaster* const& dst_ds, int band, const std::string& kernel, double bandwidth, bool add, int tile_size, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_point_density_ds(SEXP xySEXP, SEXP weightsSEXP, SEXP dst_dsSEXP, SEXP bandSEXP, SEXP kernelSEXP, SEXP bandwidthSEXP, SEXP addSEXP, SEXP tile_sizeSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type xy(xySEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type dst_ds(dst_dsSEXP);
+    Rcpp::traits::input_parameter< int >::type band(bandSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type kernel(kernelSEXP);
+    Rcpp::traits::input_parameter< double >::type bandwidth(bandwidthSEXP);
+    Rcpp::traits::input_parameter< bool >::type add(addSEXP);
+    Rcpp::traits::input_parameter< int >::type tile_size(tile_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(point_density_ds(xy, weights, dst_ds, band, kernel, bandwidth, add, tile_size, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// point_density_grid
+Rcpp::NumericVector point_density_grid(const Rcpp::RObject& xy, const Rcpp::NumericVector& weights, const Rcpp::NumericVector& gt, int xsize, int ysize, const std::string& kernel, double bandwidth, int tile_size, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_point_density_grid(SEXP xySEXP, SEXP weightsSEXP, SEXP gtSEXP, SEXP xsizeSEXP, SEXP ysizeSEXP, SEXP kernelSEXP, SEXP bandwidthSEXP, SEXP tile_sizeSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type xy(xySEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type gt(gtSEXP);
+    Rcpp::traits::input_parameter< int >::type xsize(xsizeSEXP);
+    Rcpp::traits::input_parameter< int >::type ysize(ysizeSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type kernel(kernelSEXP);
+    Rcpp::traits::input_parameter< double >::type bandwidth(bandwidthSEXP);
+    Rcpp::traits::input_parameter< int >::type tile_size(tile_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(point_density_grid(xy, weights, gt, xsize, ysize, kernel, bandwidth, tile_size, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// polygonize_tiled
+bool polygonize_tiled(const Rcpp::CharacterVector& src_filename, int src_band, const Rcpp::CharacterVector& out_dsn, const std::string& out_layer, const std::string& fld_name, const Rcpp::CharacterVector& mask_file, bool nomask, int connectedness, int tile_size, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_polygonize_tiled(SEXP src_filenameSEXP, SEXP src_bandSEXP, SEXP out_dsnSEXP, SEXP out_layerSEXP, SEXP fld_nameSEXP, SEXP mask_fileSEXP, SEXP nomaskSEXP, SEXP connectednessSEXP, SEXP tile_sizeSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::CharacterVector& >::type src_filename(src_filenameSEXP);
+    Rcpp::traits::input_parameter< int >::type src_band(src_bandSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::CharacterVector& >::type out_dsn(out_dsnSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type out_layer(out_layerSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type fld_name(fld_nameSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::CharacterVector& >::type mask_file(mask_fileSEXP);
+    Rcpp::traits::input_parameter< bool >::type nomask(nomaskSEXP);
+    Rcpp::traits::input_parameter< int >::type connectedness(connectednessSEXP);
+    Rcpp::traits::input_parameter< int >::type tile_size(tile_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(polygonize_tiled(src_filename, src_band, out_dsn, out_layer, fld_name, mask_file, nomask, connectedness, tile_size, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// proximity
+bool proximity(const GDALRaster* const& src_ds, int band, const GDALRaster* const& dst_ds, const Rcpp::NumericVector& target_values, const std::string& units, double max_dist, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_proximity(SEXP src_dsSEXP, SEXP bandSEXP, SEXP dst_dsSEXP, SEXP target_valuesSEXP, SEXP unitsSEXP, SEXP max_distSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type src_ds(src_dsSEXP);
+    Rcpp::traits::input_parameter< int >::type band(bandSEXP);
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type dst_ds(dst_dsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type target_values(target_valuesSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type units(unitsSEXP);
+    Rcpp::traits::input_parameter< double >::type max_dist(max_distSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(proximity(src_ds, band, dst_ds, target_values, units, max_dist, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// read_ds_lazy
+SEXP read_ds_lazy(const GDALRaster* const& ds, const Rcpp::IntegerVector& bands, int xoff, int yoff, int xsize, int ysize, bool as_integer);
+RcppExport SEXP _gdalraster_read_ds_lazy(SEXP dsSEXP, SEXP bandsSEXP, SEXP xoffSEXP, SEXP yoffSEXP, SEXP xsizeSEXP, SEXP ysizeSEXP, SEXP as_integerSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type ds(dsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::IntegerVector& >::type bands(bandsSEXP);
+    Rcpp::traits::input_parameter< int >::type xoff(xoffSEXP);
+    Rcpp::traits::input_parameter< int >::type yoff(yoffSEXP);
+    Rcpp::traits::input_parameter< int >::type xsize(xsizeSEXP);
+    Rcpp::traits::input_parameter< int >::type ysize(ysizeSEXP);
+    Rcpp::traits::input_parameter< bool >::type as_integer(as_integerSEXP);
+    rcpp_result_gen = Rcpp::wrap(read_ds_lazy(ds, bands, xoff, yoff, xsize, ysize, as_integer));
+    return rcpp_result_gen;
+END_RCPP
+}
+// raster_profile
+Rcpp::List raster_profile(const GDALRaster* const& src_ds, const Rcpp::RObject& geom, const Rcpp::IntegerVector& bands, const std::string& srs, double max_cache_mb, bool quiet);
+RcppExport SEXP _gdalraster_raster_profile(SEXP src_dsSEXP, SEXP geomSEXP, SEXP bandsSEXP, SEXP srsSEXP, SEXP max_cache_mbSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type src_ds(src_dsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type geom(geomSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::IntegerVector& >::type bands(bandsSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type srs(srsSEXP);
+    Rcpp::traits::input_parameter< double >::type max_cache_mb(max_cache_mbSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(raster_profile(src_ds, geom, bands, srs, max_cache_mb, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rasterize_geom_ds
+bool rasterize_geom_ds(const Rcpp::RObject& geom, const Rcpp::NumericVector& burn_value, const std::string& burn_attr, const GDALRaster* const& dst_ds, int band, bool all_touched, bool add, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_rasterize_geom_ds(SEXP geomSEXP, SEXP burn_valueSEXP, SEXP burn_attrSEXP, SEXP dst_dsSEXP, SEXP bandSEXP, SEXP all_touchedSEXP, SEXP addSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type geom(geomSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type burn_value(burn_valueSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type burn_attr(burn_attrSEXP);
+    Rcpp::traits::input_parameter< const GDALRaster* const& >::type dst_ds(dst_dsSEXP);
+    Rcpp::traits::input_parameter< int >::type band(bandSEXP);
+    Rcpp::traits::input_parameter< bool >::type all_touched(all_touchedSEXP);
+    Rcpp::traits::input_parameter< bool >::type add(addSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(rasterize_geom_ds(geom, burn_value, burn_attr, dst_ds, band, all_touched, add, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rasterize_geom_grid
+Rcpp::NumericVector rasterize_geom_grid(const Rcpp::RObject& geom, const Rcpp::NumericVector& burn_value, const std::string& burn_attr, const Rcpp::NumericVector& gt, int xsize, int ysize, double init, bool all_touched, bool add, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_rasterize_geom_grid(SEXP geomSEXP, SEXP burn_valueSEXP, SEXP burn_attrSEXP, SEXP gtSEXP, SEXP xsizeSEXP, SEXP ysizeSEXP, SEXP initSEXP, SEXP all_touchedSEXP, SEXP addSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type geom(geomSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type burn_value(burn_valueSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type burn_attr(burn_attrSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type gt(gtSEXP);
+    Rcpp::traits::input_parameter< int >::type xsize(xsizeSEXP);
+    Rcpp::traits::input_parameter< int >::type ysize(ysizeSEXP);
+    Rcpp::traits::input_parameter< double >::type init(initSEXP);
+    Rcpp::traits::input_parameter< bool >::type all_touched(all_touchedSEXP);
+    Rcpp::traits::input_parameter< bool >::type add(addSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(rasterize_geom_grid(geom, burn_value, burn_attr, gt, xsize, ysize, init, all_touched, add, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ogr_sjoin_fid
+Rcpp::List ogr_sjoin_fid(GDALVector* const& x_lyr, GDALVector* const& y_lyr, const std::string& predicate, bool left, int num_threads, int batch_size, bool quiet);
+RcppExport SEXP _gdalraster_ogr_sjoin_fid(SEXP x_lyrSEXP, SEXP y_lyrSEXP, SEXP predicateSEXP, SEXP leftSEXP, SEXP num_threadsSEXP, SEXP batch_sizeSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< GDALVector* const& >::type x_lyr(x_lyrSEXP);
+    Rcpp::traits::input_parameter< GDALVector* const& >::type y_lyr(y_lyrSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type predicate(predicateSEXP);
+    Rcpp::traits::input_parameter< bool >::type left(leftSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type batch_size(batch_sizeSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(ogr_sjoin_fid(x_lyr, y_lyr, predicate, left, num_threads, batch_size, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
+// g_nearest_idx
+Rcpp::List g_nearest_idx(const Rcpp::RObject& x, const Rcpp::RObject& y, int k, double max_distance, const std::string& sphere_srs, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_g_nearest_idx(SEXP xSEXP, SEXP ySEXP, SEXP kSEXP, SEXP max_distanceSEXP, SEXP sphere_srsSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::RObject& >::type y(ySEXP);
+    Rcpp::traits::input_parameter< int >::type k(kSEXP);
+    Rcpp::traits::input_parameter< double >::type max_distance(max_distanceSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type sphere_srs(sphere_srsSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(g_nearest_idx(x, y, k, max_distance, sphere_srs, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
 // epsg_to_wkt
 std::string epsg_to_wkt(int epsg, bool pretty);
 RcppExport SEXP _gdalraster_epsg_to_wkt(SEXP epsgSEXP, SEXP prettySEXP) {
@@ -2374,6 +2859,27 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// temporal_reduce
+bool temporal_reduce(const Rcpp::CharacterVector& dsn, int band, const Rcpp::IntegerVector& ndvi_bands, GDALRaster* const& dst_ds, const Rcpp::CharacterVector& band_stats, const Rcpp::NumericVector& band_probs, const Rcpp::NumericVector& times, int min_obs, int tile_size, int num_threads, bool quiet);
+RcppExport SEXP _gdalraster_temporal_reduce(SEXP dsnSEXP, SEXP bandSEXP, SEXP ndvi_bandsSEXP, SEXP dst_dsSEXP, SEXP band_statsSEXP, SEXP band_probsSEXP, SEXP timesSEXP, SEXP min_obsSEXP, SEXP tile_sizeSEXP, SEXP num_threadsSEXP, SEXP quietSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::CharacterVector& >::type dsn(dsnSEXP);
+    Rcpp::traits::input_parameter< int >::type band(bandSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::IntegerVector& >::type ndvi_bands(ndvi_bandsSEXP);
+    Rcpp::traits::input_parameter< GDALRaster* const& >::type dst_ds(dst_dsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::CharacterVector& >::type band_stats(band_statsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type band_probs(band_probsSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type times(timesSEXP);
+    Rcpp::traits::input_parameter< int >::type min_obs(min_obsSEXP);
+    Rcpp::traits::input_parameter< int >::type tile_size(tile_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type num_threads(num_threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type quiet(quietSEXP);
+    rcpp_result_gen = Rcpp::wrap(temporal_reduce(dsn, band, ndvi_bands, dst_ds, band_stats, band_probs, times, min_obs, tile_size, num_threads, quiet));
+    return rcpp_result_gen;
+END_RCPP
+}
 // getPROJVersion
 std::vector<int> getPROJVersion();
 RcppExport SEXP _gdalraster_getPROJVersion() {
@@ -2465,15 +2971,44 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// transform_cache_stats
+Rcpp::List transform_cache_stats();
+RcppExport SEXP _gdalraster_transform_cache_stats() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(transform_cache_stats());
+    return rcpp_result_gen;
+END_RCPP
+}
+// transform_cache_clear
+void transform_cache_clear();
+RcppExport SEXP _gdalraster_transform_cache_clear() {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    transform_cache_clear();
+    return R_NilValue;
+END_RCPP
+}
 
 RcppExport SEXP _rcpp_module_boot_mod_cmb_table();
 RcppExport SEXP _rcpp_module_boot_mod_GDALAlg();
 RcppExport SEXP _rcpp_module_boot_mod_GDALRaster();
 RcppExport SEXP _rcpp_module_boot_mod_GDALVector();
+RcppExport SEXP _rcpp_module_boot_mod_raster_stack();
 RcppExport SEXP _rcpp_module_boot_mod_running_stats();
+RcppExport SEXP _rcpp_module_boot_mod_spatial_index();
 RcppExport SEXP _rcpp_module_boot_mod_VSIFile();
 
 static const R_CallMethodDef CallEntries[] = {
+    {"_gdalraster_composite_best_pixel", (DL_FUNC) &_gdalraster_composite_best_pixel, 13},
+    {"_gdalraster_dem_calc_window", (DL_FUNC) &_gdalraster_dem_calc_window, 16},
+    {"_gdalraster_dem_calc_ds", (DL_FUNC) &_gdalraster_dem_calc_ds, 15},
+    {"_gdalraster_dem_fill", (DL_FUNC) &_gdalraster_dem_fill, 6},
+    {"_gdalraster_flow_dir", (DL_FUNC) &_gdalraster_flow_dir, 7},
+    {"_gdalraster_flow_acc", (DL_FUNC) &_gdalraster_flow_acc, 7},
+    {"_gdalraster_raster_classes", (DL_FUNC) &_gdalraster_raster_classes, 3},
+    {"_gdalraster_focal_categorical", (DL_FUNC) &_gdalraster_focal_categorical, 11},
     {"_gdalraster_dt_size", (DL_FUNC) &_gdalraster_dt_size, 2},
     {"_gdalraster_dt_is_complex", (DL_FUNC) &_gdalraster_dt_is_complex, 1},
     {"_gdalraster_dt_is_integer", (DL_FUNC) &_gdalraster_dt_is_integer, 1},
@@ -2565,41 +3100,42 @@ static const R_CallMethodDef CallEntries[] = {
     {"_gdalraster_gdal_global_reg_names", (DL_FUNC) &_gdalraster_gdal_global_reg_names, 0},
     {"_gdalraster_getGEOSVersion", (DL_FUNC) &_gdalraster_getGEOSVersion, 0},
     {"_gdalraster_has_geos", (DL_FUNC) &_gdalraster_has_geos, 0},
-    {"_gdalraster_g_wkb2wkt", (DL_FUNC) &_gdalraster_g_wkb2wkt, 2},
-    {"_gdalraster_g_wkb_list2wkt", (DL_FUNC) &_gdalraster_g_wkb_list2wkt, 2},
+    {"_gdalraster_g_wkb2wkt", (DL_FUNC) &_gdalraster_g_wkb2wkt, 3},
+    {"_gdalraster_g_wkb_list2wkt", (DL_FUNC) &_gdalraster_g_wkb_list2wkt, 4},
     {"_gdalraster_g_wkt2wkb", (DL_FUNC) &_gdalraster_g_wkt2wkb, 3},
-    {"_gdalraster_g_wkt_vector2wkb", (DL_FUNC) &_gdalraster_g_wkt_vector2wkb, 3},
+    {"_gdalraster_g_wkt_vector2wkb", (DL_FUNC) &_gdalraster_g_wkt_vector2wkb, 4},
     {"_gdalraster_g_create", (DL_FUNC) &_gdalraster_g_create, 4},
     {"_gdalraster_g_add_geom", (DL_FUNC) &_gdalraster_g_add_geom, 4},
     {"_gdalraster_g_geom_count", (DL_FUNC) &_gdalraster_g_geom_count, 2},
+    {"_gdalraster_g_geom_count_vec", (DL_FUNC) &_gdalraster_g_geom_count_vec, 2},
     {"_gdalraster_g_get_geom", (DL_FUNC) &_gdalraster_g_get_geom, 4},
     {"_gdalraster_g_is_valid", (DL_FUNC) &_gdalraster_g_is_valid, 2},
     {"_gdalraster_g_make_valid", (DL_FUNC) &_gdalraster_g_make_valid, 6},
+    {"_gdalraster_g_make_valid_vec", (DL_FUNC) &_gdalraster_g_make_valid_vec, 7},
     {"_gdalraster_g_normalize", (DL_FUNC) &_gdalraster_g_normalize, 4},
     {"_gdalraster_g_set_3D", (DL_FUNC) &_gdalraster_g_set_3D, 5},
     {"_gdalraster_g_set_measured", (DL_FUNC) &_gdalraster_g_set_measured, 5},
     {"_gdalraster_g_swap_xy", (DL_FUNC) &_gdalraster_g_swap_xy, 4},
     {"_gdalraster_g_is_empty", (DL_FUNC) &_gdalraster_g_is_empty, 2},
+    {"_gdalraster_g_is_empty_vec", (DL_FUNC) &_gdalraster_g_is_empty_vec, 2},
     {"_gdalraster_g_is_3D", (DL_FUNC) &_gdalraster_g_is_3D, 2},
     {"_gdalraster_g_is_measured", (DL_FUNC) &_gdalraster_g_is_measured, 2},
     {"_gdalraster_g_is_ring", (DL_FUNC) &_gdalraster_g_is_ring, 2},
     {"_gdalraster_g_name", (DL_FUNC) &_gdalraster_g_name, 2},
+    {"_gdalraster_g_name_vec", (DL_FUNC) &_gdalraster_g_name_vec, 2},
     {"_gdalraster_g_summary", (DL_FUNC) &_gdalraster_g_summary, 2},
     {"_gdalraster_g_envelope", (DL_FUNC) &_gdalraster_g_envelope, 3},
-    {"_gdalraster_g_intersects", (DL_FUNC) &_gdalraster_g_intersects, 3},
-    {"_gdalraster_g_equals", (DL_FUNC) &_gdalraster_g_equals, 3},
-    {"_gdalraster_g_disjoint", (DL_FUNC) &_gdalraster_g_disjoint, 3},
-    {"_gdalraster_g_touches", (DL_FUNC) &_gdalraster_g_touches, 3},
-    {"_gdalraster_g_contains", (DL_FUNC) &_gdalraster_g_contains, 3},
-    {"_gdalraster_g_within", (DL_FUNC) &_gdalraster_g_within, 3},
-    {"_gdalraster_g_crosses", (DL_FUNC) &_gdalraster_g_crosses, 3},
-    {"_gdalraster_g_overlaps", (DL_FUNC) &_gdalraster_g_overlaps, 3},
+    {"_gdalraster_g_envelope_vec", (DL_FUNC) &_gdalraster_g_envelope_vec, 3},
+    {"_gdalraster_g_coords_wkb", (DL_FUNC) &_gdalraster_g_coords_wkb, 1},
+    {"_gdalraster_g_binary_pred_vec", (DL_FUNC) &_gdalraster_g_binary_pred_vec, 6},
     {"_gdalraster_g_boundary", (DL_FUNC) &_gdalraster_g_boundary, 4},
     {"_gdalraster_g_buffer", (DL_FUNC) &_gdalraster_g_buffer, 6},
+    {"_gdalraster_g_buffer_vec", (DL_FUNC) &_gdalraster_g_buffer_vec, 7},
     {"_gdalraster_g_convex_hull", (DL_FUNC) &_gdalraster_g_convex_hull, 4},
     {"_gdalraster_g_concave_hull", (DL_FUNC) &_gdalraster_g_concave_hull, 6},
     {"_gdalraster_g_delaunay_triangulation", (DL_FUNC) &_gdalraster_g_delaunay_triangulation, 7},
     {"_gdalraster_g_simplify", (DL_FUNC) &_gdalraster_g_simplify, 6},
+    {"_gdalraster_g_simplify_vec", (DL_FUNC) &_gdalraster_g_simplify_vec, 7},
     {"_gdalraster_g_unary_union", (DL_FUNC) &_gdalraster_g_unary_union, 4},
     {"_gdalraster_g_intersection", (DL_FUNC) &_gdalraster_g_intersection, 5},
     {"_gdalraster_g_union", (DL_FUNC) &_gdalraster_g_union, 5},
@@ -2611,9 +3147,15 @@ static const R_CallMethodDef CallEntries[] = {
     {"_gdalraster_g_geodesic_area", (DL_FUNC) &_gdalraster_g_geodesic_area, 4},
     {"_gdalraster_g_geodesic_length", (DL_FUNC) &_gdalraster_g_geodesic_length, 4},
     {"_gdalraster_g_centroid", (DL_FUNC) &_gdalraster_g_centroid, 2},
-    {"_gdalraster_g_transform", (DL_FUNC) &_gdalraster_g_transform, 9},
+    {"_gdalraster_g_transform", (DL_FUNC) &_gdalraster_g_transform, 10},
     {"_gdalraster_bbox_from_wkt", (DL_FUNC) &_gdalraster_bbox_from_wkt, 3},
     {"_gdalraster_bbox_to_wkt", (DL_FUNC) &_gdalraster_bbox_to_wkt, 3},
+    {"_gdalraster_g_union_agg", (DL_FUNC) &_gdalraster_g_union_agg, 8},
+    {"_gdalraster_ogr_union_agg", (DL_FUNC) &_gdalraster_ogr_union_agg, 7},
+    {"_gdalraster_grid_points_ds", (DL_FUNC) &_gdalraster_grid_points_ds, 11},
+    {"_gdalraster_grid_points_grid", (DL_FUNC) &_gdalraster_grid_points_grid, 12},
+    {"_gdalraster_landscape_metrics", (DL_FUNC) &_gdalraster_landscape_metrics, 8},
+    {"_gdalraster_lazy_compute", (DL_FUNC) &_gdalraster_lazy_compute, 7},
     {"_gdalraster_ogr_ds_exists", (DL_FUNC) &_gdalraster_ogr_ds_exists, 2},
     {"_gdalraster_ogr_ds_format", (DL_FUNC) &_gdalraster_ogr_ds_format, 1},
     {"_gdalraster_ogr_ds_test_cap", (DL_FUNC) &_gdalraster_ogr_ds_test_cap, 2},
@@ -2634,6 +3176,16 @@ static const R_CallMethodDef CallEntries[] = {
     {"_gdalraster_ogr_field_set_domain_name", (DL_FUNC) &_gdalraster_ogr_field_set_domain_name, 4},
     {"_gdalraster_ogr_field_delete", (DL_FUNC) &_gdalraster_ogr_field_delete, 3},
     {"_gdalraster_ogr_execute_sql", (DL_FUNC) &_gdalraster_ogr_execute_sql, 4},
+    {"_gdalraster_point_density_ds", (DL_FUNC) &_gdalraster_point_density_ds, 10},
+    {"_gdalraster_point_density_grid", (DL_FUNC) &_gdalraster_point_density_grid, 10},
+    {"_gdalraster_polygonize_tiled", (DL_FUNC) &_gdalraster_polygonize_tiled, 11},
+    {"_gdalraster_proximity", (DL_FUNC) &_gdalraster_proximity, 8},
+    {"_gdalraster_read_ds_lazy", (DL_FUNC) &_gdalraster_read_ds_lazy, 7},
+    {"_gdalraster_raster_profile", (DL_FUNC) &_gdalraster_raster_profile, 6},
+    {"_gdalraster_rasterize_geom_ds", (DL_FUNC) &_gdalraster_rasterize_geom_ds, 9},
+    {"_gdalraster_rasterize_geom_grid", (DL_FUNC) &_gdalraster_rasterize_geom_grid, 11},
+    {"_gdalraster_ogr_sjoin_fid", (DL_FUNC) &_gdalraster_ogr_sjoin_fid, 7},
+    {"_gdalraster_g_nearest_idx", (DL_FUNC) &_gdalraster_g_nearest_idx, 7},
     {"_gdalraster_epsg_to_wkt", (DL_FUNC) &_gdalraster_epsg_to_wkt, 2},
     {"_gdalraster_srs_to_wkt", (DL_FUNC) &_gdalraster_srs_to_wkt, 3},
     {"_gdalraster_srs_to_projjson", (DL_FUNC) &_gdalraster_srs_to_projjson, 4},
@@ -2660,6 +3212,7 @@ static const R_CallMethodDef CallEntries[] = {
     {"_gdalraster_srs_epsg_treats_as_northing_easting", (DL_FUNC) &_gdalraster_srs_epsg_treats_as_northing_easting, 1},
     {"_gdalraster_srs_get_celestial_body_name", (DL_FUNC) &_gdalraster_srs_get_celestial_body_name, 1},
     {"_gdalraster_srs_info_from_db", (DL_FUNC) &_gdalraster_srs_info_from_db, 1},
+    {"_gdalraster_temporal_reduce", (DL_FUNC) &_gdalraster_temporal_reduce, 11},
     {"_gdalraster_getPROJVersion", (DL_FUNC) &_gdalraster_getPROJVersion, 0},
     {"_gdalraster_getPROJSearchPaths", (DL_FUNC) &_gdalraster_getPROJSearchPaths, 0},
     {"_gdalraster_setPROJSearchPaths", (DL_FUNC) &_gdalraster_setPROJSearchPaths, 1},
@@ -2668,11 +3221,15 @@ static const R_CallMethodDef CallEntries[] = {
     {"_gdalraster_inv_project", (DL_FUNC) &_gdalraster_inv_project, 3},
     {"_gdalraster_transform_xy", (DL_FUNC) &_gdalraster_transform_xy, 3},
     {"_gdalraster_transform_bounds", (DL_FUNC) &_gdalraster_transform_bounds, 5},
+    {"_gdalraster_transform_cache_stats", (DL_FUNC) &_gdalraster_transform_cache_stats, 0},
+    {"_gdalraster_transform_cache_clear", (DL_FUNC) &_gdalraster_transform_cache_clear, 0},
     {"_rcpp_module_boot_mod_cmb_table", (DL_FUNC) &_rcpp_module_boot_mod_cmb_table, 0},
     {"_rcpp_module_boot_mod_GDALAlg", (DL_FUNC) &_rcpp_module_boot_mod_GDALAlg, 0},
     {"_rcpp_module_boot_mod_GDALRaster", (DL_FUNC) &_rcpp_module_boot_mod_GDALRaster, 0},
     {"_rcpp_module_boot_mod_GDALVector", (DL_FUNC) &_rcpp_module_boot_mod_GDALVector, 0},
+    {"_rcpp_module_boot_mod_raster_stack", (DL_FUNC) &_rcpp_module_boot_mod_raster_stack, 0},
     {"_rcpp_module_boot_mod_running_stats", (DL_FUNC) &_rcpp_module_boot_mod_running_stats, 0},
+    {"_rcpp_module_boot_mod_spatial_index", (DL_FUNC) &_rcpp_module_boot_mod_spatial_index, 0},
     {"_rcpp_module_boot_mod_VSIFile", (DL_FUNC) &_rcpp_module_boot_mod_VSIFile, 0},
     {NULL, NULL, 0}
 };
@@ -0,0 +1,328 @@
+/* Best-pixel compositing of aligned scenes by a per-pixel quality score
+
+   All the layers (the value bands of every scene followed by the QA band of
+   every scene) are one RasterStack, so a tile of all the scenes is read in
+   one call with one I/O thread per file. The tiles are processed in
+   batches, and the next batch is read on a background thread while the
+   workers composite the current batch and the main thread writes it, so
+   that I/O overlaps with computation.
+
+   For each tile, the scenes are scanned in order with simple loops over the
+   pixels: the score of the scene is computed for every pixel, set to NaN
+   where the observation is masked by the QA bits or any value band is
+   nodata, and the scene replaces the current best where its score is
+   higher (so ties go to the earlier scene). The value bands of the best
+   scene are then gathered into the output bands.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_port.h>
+#include <gdal.h>
+
+#include <Rcpp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "composite.h"
+#include "gdalraster.h"
+#include "raster_stack.h"
+#include "tile_util.h"
+
+namespace {
+
+constexpr double CP_NAN = std::numeric_limits<double>::quiet_NaN();
+
+enum CpScore { CP_MAX_QA, CP_MIN_QA, CP_MAX_NDVI, CP_TARGET_TIME };
+
+struct CpParams {
+    CpScore score {CP_MAX_QA};
+    std::size_t num_scenes {0};
+    std::size_t num_bands {0};
+    std::int64_t qa_mask {0};
+    std::size_t red {0};
+    std::size_t nir {0};
+    std::vector<double> times;
+    double target_time {0};
+    bool index_band {false};
+};
+
+// joins a background thread when leaving scope, also on error
+struct CpJoin {
+    std::thread &t;
+    ~CpJoin() {
+        if (t.joinable())
+            t.join();
+    }
+};
+
+// composite one tile: in holds num_scenes * num_bands value layers (scene
+// by scene) then num_scenes QA layers, of npix values each (NaN for
+// nodata), out receives num_bands layers plus the scene index if requested
+// does not call the R API
+void compositeTile_(const CpParams &p, std::size_t npix, const double *in,
+                    double *out) {
+
+    std::vector<double> best(npix, CP_NAN);
+    std::vector<double> best_scene(npix, -1.0);
+    std::vector<double> sc(npix);
+
+    for (std::size_t s = 0; s < p.num_scenes; ++s) {
+        const double *vals = in + s * p.num_bands * npix;
+        const double *qa = in + (p.num_scenes * p.num_bands + s) * npix;
+
+        switch (p.score) {
+            case CP_MAX_QA:
+                std::copy(qa, qa + npix, sc.begin());
+                break;
+            case CP_MIN_QA:
+                for (std::size_t i = 0; i < npix; ++i)
+                    sc[i] = -qa[i];
+                break;
+            case CP_MAX_NDVI: {
+                const double *r = vals + p.red * npix;
+                const double *n = vals + p.nir * npix;
+                for (std::size_t i = 0; i < npix; ++i) {
+                    const double d = n[i] + r[i];
+                    sc[i] = d != 0 ? (n[i] - r[i]) / d : CP_NAN;
+                }
+                break;
+            }
+            case CP_TARGET_TIME: {
+                const double v = -std::fabs(p.times[s] - p.target_time);
+                std::fill(sc.begin(), sc.end(), v);
+                break;
+            }
+        }
+
+        // masked by QA, or missing in any value band
+        for (std::size_t i = 0; i < npix; ++i) {
+            if (std::isnan(qa[i]) ||
+                    (p.qa_mask != 0 &&
+                     (static_cast<std::int64_t>(qa[i]) & p.qa_mask) != 0)) {
+                sc[i] = CP_NAN;
+            }
+        }
+        for (std::size_t b = 0; b < p.num_bands; ++b) {
+            const double *v = vals + b * npix;
+            for (std::size_t i = 0; i < npix; ++i) {
+                if (std::isnan(v[i]))
+                    sc[i] = CP_NAN;
+            }
+        }
+
+        const double scene = static_cast<double>(s);
+        for (std::size_t i = 0; i < npix; ++i) {
+            if (!std::isnan(sc[i]) &&
+                    (best_scene[i] < 0 || sc[i] > best[i])) {
+                best[i] = sc[i];
+                best_scene[i] = scene;
+            }
+        }
+    }
+
+    for (std::size_t b = 0; b < p.num_bands; ++b) {
+        double *o = out + b * npix;
+        for (std::size_t i = 0; i < npix; ++i) {
+            if (best_scene[i] < 0) {
+                o[i] = CP_NAN;
+            } else {
+                const std::size_t s = static_cast<std::size_t>(best_scene[i]);
+                o[i] = in[(s * p.num_bands + b) * npix + i];
+            }
+        }
+    }
+    if (p.index_band) {
+        double *o = out + p.num_bands * npix;
+        for (std::size_t i = 0; i < npix; ++i)
+            o[i] = best_scene[i] < 0 ? CP_NAN : best_scene[i] + 1;
+    }
+}
+
+}  // namespace
+
+//' Best-pixel composite of num_scenes scenes: dsn/bands give the value
+//' bands of each scene (scene by scene) followed by the QA band of each
+//' scene, the value bands of the best observation are written to dst_ds,
+//' plus the 1-based scene index if index_band
+//' @noRd
+// [[Rcpp::export(name = ".composite_best_pixel")]]
+bool composite_best_pixel(const Rcpp::CharacterVector &dsn,
+                          const Rcpp::IntegerVector &bands, int num_scenes,
+                          GDALRaster* const &dst_ds, const std::string &score,
+                          double qa_mask,
+                          const Rcpp::IntegerVector &ndvi_bands,
+                          const Rcpp::NumericVector &times,
+                          double target_time, bool index_band, int tile_size,
+                          int num_threads, bool quiet) {
+
+    if (num_scenes < 1 || dsn.size() == 0 || dsn.size() % num_scenes != 0 ||
+            dsn.size() / num_scenes < 2) {
+        Rcpp::stop("'dsn' must give the value bands and QA band of each "
+                   "scene");
+    }
+    if (bands.size() != dsn.size())
+        Rcpp::stop("'bands' must have the length of 'dsn'");
+    if (tile_size < 1)
+        Rcpp::stop("'tile_size' must be a positive integer");
+
+    CpParams p;
+    p.num_scenes = static_cast<std::size_t>(num_scenes);
+    p.num_bands = static_cast<std::size_t>(dsn.size() / num_scenes) - 1;
+    p.qa_mask = static_cast<std::int64_t>(qa_mask);
+    p.index_band = index_band;
+    if (score == "max_qa") {
+        p.score = CP_MAX_QA;
+    } else if (score == "min_qa") {
+        p.score = CP_MIN_QA;
+    } else if (score == "max_ndvi") {
+        p.score = CP_MAX_NDVI;
+        if (ndvi_bands.size() != 2)
+            Rcpp::stop("'ndvi_bands' must give the red and near infrared "
+                       "bands");
+        for (int b : ndvi_bands) {
+            if (b == NA_INTEGER || b < 1 ||
+                    static_cast<std::size_t>(b) > p.num_bands) {
+                Rcpp::stop("'ndvi_bands' must be in 1:number of value bands");
+            }
+        }
+        p.red = static_cast<std::size_t>(ndvi_bands[0]) - 1;
+        p.nir = static_cast<std::size_t>(ndvi_bands[1]) - 1;
+    } else if (score == "target_time") {
+        p.score = CP_TARGET_TIME;
+        if (times.size() != num_scenes)
+            Rcpp::stop("'times' must have one value per scene");
+        if (std::isnan(target_time))
+            Rcpp::stop("'target_time' is missing");
+        p.times.assign(times.begin(), times.end());
+        p.target_time = target_time;
+    } else {
+        Rcpp::stop("unknown score: " + score);
+    }
+
+    RasterStack stk(dsn, bands);
+    const int xsize = static_cast<int>(stk.getRasterXSize());
+    const int ysize = static_cast<int>(stk.getRasterYSize());
+
+    const std::size_t nout = p.num_bands + (index_band ? 1 : 0);
+    dst_ds->checkAccess_(GA_Update);
+    if (dst_ds->getRasterXSize() != xsize ||
+            dst_ds->getRasterYSize() != ysize) {
+        Rcpp::stop("the output must have the raster dimensions of the input");
+    }
+    if (static_cast<std::size_t>(dst_ds->getRasterCount()) < nout)
+        Rcpp::stop("the output has fewer bands than required");
+    std::vector<GDALRasterBandH> dst_bands;
+    std::vector<double> dst_nodata;
+    std::vector<int> has_dst_nodata;
+    for (std::size_t b = 0; b < nout; ++b) {
+        GDALRasterBandH hBand = dst_ds->getBand_(static_cast<int>(b) + 1);
+        int has_nodata = FALSE;
+        dst_nodata.push_back(GDALGetRasterNoDataValue(hBand, &has_nodata));
+        has_dst_nodata.push_back(has_nodata);
+        dst_bands.push_back(hBand);
+    }
+
+    int block_xsize = 0;
+    int block_ysize = 0;
+    GDALGetBlockSize(dst_bands[0], &block_xsize, &block_ysize);
+    const std::vector<RasterTile> tiles = makeTiles_(
+        xsize, ysize, tileDim_(tile_size, block_xsize, xsize),
+        tileDim_(tile_size, block_ysize, ysize));
+
+    // batches of one tile per thread, with two sets of input buffers: the
+    // next batch is read in the background while the current one is
+    // composited on the workers and written on the main thread
+    const std::size_t nlayers = stk.numLayers_();
+    const int nthreads = resolve_num_threads_(num_threads, tiles.size());
+    const std::size_t batch_size = static_cast<std::size_t>(nthreads);
+    std::vector<std::vector<double>> in[2] = {
+        std::vector<std::vector<double>>(batch_size),
+        std::vector<std::vector<double>>(batch_size)};
+    std::vector<std::vector<double>> out(batch_size);
+
+    bool read_ok = false;
+    std::string read_err;
+    std::thread reader;
+    CpJoin reader_join {reader};
+    auto startRead = [&](std::size_t first, int set) {
+        read_ok = false;
+        read_err.clear();
+        reader = std::thread([&, first, set]() {
+            const std::size_t n = std::min(batch_size, tiles.size() - first);
+            for (std::size_t j = 0; j < n; ++j) {
+                const RasterTile &t = tiles[first + j];
+                in[set][j].resize(static_cast<std::size_t>(t.xsize) *
+                                  t.ysize * nlayers);
+                if (!stk.readWindow_(t.xoff, t.yoff, t.xsize, t.ysize,
+                                     in[set][j].data(), &read_err)) {
+                    return;
+                }
+            }
+            read_ok = true;
+        });
+    };
+
+    GDALProgressFunc pfnProgress = GDALTermProgressR;
+    if (!quiet)
+        pfnProgress(0, nullptr, nullptr);
+
+    int cur = 0;
+    startRead(0, cur);
+    for (std::size_t first = 0; first < tiles.size(); first += batch_size) {
+        const std::size_t n = std::min(batch_size, tiles.size() - first);
+        reader.join();
+        if (!read_ok)
+            Rcpp::stop(read_err);
+        if (first + batch_size < tiles.size())
+            startRead(first + batch_size, 1 - cur);
+
+        for (std::size_t j = 0; j < n; ++j) {
+            const RasterTile &t = tiles[first + j];
+            out[j].resize(static_cast<std::size_t>(t.xsize) * t.ysize * nout);
+        }
+
+        parallel_for_(n, num_threads, [&](std::size_t j) {
+            const RasterTile &t = tiles[first + j];
+            compositeTile_(p, static_cast<std::size_t>(t.xsize) * t.ysize,
+                           in[cur][j].data(), out[j].data());
+        });
+
+        for (std::size_t j = 0; j < n; ++j) {
+            const RasterTile &t = tiles[first + j];
+            const std::size_t npix = static_cast<std::size_t>(t.xsize) *
+                                     t.ysize;
+            for (std::size_t b = 0; b < nout; ++b) {
+                double *o = out[j].data() + b * npix;
+                if (has_dst_nodata[b]) {
+                    for (std::size_t i = 0; i < npix; ++i) {
+                        if (std::isnan(o[i]))
+                            o[i] = dst_nodata[b];
+                    }
+                }
+                if (GDALRasterIO(dst_bands[b], GF_Write, t.xoff, t.yoff,
+                                 t.xsize, t.ysize, o, t.xsize, t.ysize,
+                                 GDT_Float64, 0, 0) != CE_None) {
+                    Rcpp::stop("failed to write raster tile");
+                }
+            }
+        }
+
+        if (!quiet) {
+            pfnProgress(static_cast<double>(first + n) / tiles.size(),
+                        nullptr, nullptr);
+        }
+        Rcpp::checkUserInterrupt();
+        cur = 1 - cur;
+    }
+
+    return true;
+}
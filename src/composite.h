@@ -0,0 +1,24 @@
+/* Best-pixel compositing of aligned scenes by a per-pixel quality score
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef COMPOSITE_H_
+#define COMPOSITE_H_
+
+#include <Rcpp.h>
+
+#include <string>
+
+class GDALRaster;
+bool composite_best_pixel(const Rcpp::CharacterVector &dsn,
+                          const Rcpp::IntegerVector &bands, int num_scenes,
+                          GDALRaster* const &dst_ds, const std::string &score,
+                          double qa_mask,
+                          const Rcpp::IntegerVector &ndvi_bands,
+                          const Rcpp::NumericVector &times,
+                          double target_time, bool index_band, int tile_size,
+                          int num_threads, bool quiet);
+
+#endif  // COMPOSITE_H_
@@ -0,0 +1,462 @@
+/* DEM derivatives computed in memory
+
+   The source rows are read as Float64 with a one-pixel halo on each side,
+   filled with NaN outside the raster and for nodata, so that the 3x3 kernels
+   need no bounds checks and missing values propagate through the arithmetic
+   (no derivative is computed next to a missing value unless compute_edges is
+   set, as in gdaldem). The kernels follow GDALDEMProcessing: Horn (1981) or
+   Zevenbergen & Thorne (1987) for slope, aspect and hillshade, and Riley or
+   Wilson for the terrain ruggedness index (TRI). Rows are computed on worker
+   threads, with the kernel inner loop instantiated per mode and algorithm.
+
+   For a source in geographic coordinates, the pixel size in meters is
+   computed for each row from the latitude of the row and the semi-major axis
+   of the ellipsoid, unless a scale is given.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_port.h>
+#include <gdal.h>
+#include <ogr_srs_api.h>
+
+#include <Rcpp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "dem_calc.h"
+#include "gdalraster.h"
+#include "parallel_util.h"
+
+constexpr double DEM_PI = 3.14159265358979323846;
+constexpr double DEM_RAD_TO_DEG = 180.0 / DEM_PI;
+
+// upper limit on the number of pixels in a strip when writing to a raster
+constexpr std::size_t DEM_STRIP_MAX_PIXELS = 4 * 1024 * 1024;
+
+// rows per task on worker threads
+constexpr std::size_t DEM_ROW_GRAIN = 16;
+
+// read rows [y0 - 1, y0 + ny + 1) and columns [x0 - 1, x0 + nx + 1) as
+// Float64, with NaN outside the raster and for nodata (see dem_calc.h)
+bool readHalo_(GDALRasterBandH hBand, int x0, int y0, int nx, int ny,
+               std::vector<double> *buf) {
+
+    const int rxsize = GDALGetRasterBandXSize(hBand);
+    const int rysize = GDALGetRasterBandYSize(hBand);
+    const std::size_t stride = static_cast<std::size_t>(nx) + 2;
+    buf->assign(stride * (ny + 2), std::numeric_limits<double>::quiet_NaN());
+
+    const int cx0 = std::max(0, x0 - 1);
+    const int cy0 = std::max(0, y0 - 1);
+    const int cx1 = std::min(rxsize, x0 + nx + 1);
+    const int cy1 = std::min(rysize, y0 + ny + 1);
+    double *dst = buf->data() + (cy0 - (y0 - 1)) * stride +
+                  (cx0 - (x0 - 1));
+
+    if (GDALRasterIO(hBand, GF_Read, cx0, cy0, cx1 - cx0, cy1 - cy0, dst,
+                     cx1 - cx0, cy1 - cy0, GDT_Float64, 0,
+                     static_cast<int>(stride * sizeof(double))) != CE_None) {
+        return false;
+    }
+
+    int has_nodata = FALSE;
+    const double nodata = GDALGetRasterNoDataValue(hBand, &has_nodata);
+    if (has_nodata && !std::isnan(nodata)) {
+        for (double &v : *buf) {
+            if (v == nodata)
+                v = std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+    return true;
+}
+
+namespace {
+
+enum DemMode { DEM_SLOPE, DEM_ASPECT, DEM_HILLSHADE, DEM_TRI };
+
+struct DemParams {
+    DemMode mode {DEM_SLOPE};
+    bool zt {false};  // Zevenbergen-Thorne, otherwise Horn
+    bool tri_wilson {false};  // otherwise Riley
+    bool slope_percent {false};
+    bool zero_for_flat {false};
+    bool compute_edges {false};
+    double z_factor {1.0};
+    double sin_alt {0.0};
+    double cos_alt {0.0};
+    double sin_az {0.0};
+    double cos_az {0.0};
+    double scale {1.0};  // ratio of horizontal units to elevation units
+    bool geographic {false};  // pixel size computed per row
+    double m_per_deg {0.0};
+    double gt[6] {0, 1, 0, 0, 0, 1};
+};
+
+// pixel size in elevation units for a row, ns is negative for north-up
+struct RowRes {
+    double ew;
+    double ns;
+};
+
+RowRes rowRes_(const DemParams &p, int row) {
+    if (!p.geographic)
+        return {p.gt[1] * p.scale, p.gt[5] * p.scale};
+
+    const double lat = p.gt[3] + (row + 0.5) * p.gt[5];
+    return {p.gt[1] * p.m_per_deg * std::cos(lat / DEM_RAD_TO_DEG),
+            p.gt[5] * p.m_per_deg};
+}
+
+// replace missing neighbors by linear extrapolation from the opposite
+// neighbor, or by the center value
+inline void fillMissing_(double *w) {
+    if (std::isnan(w[4]))
+        return;
+    for (int k = 0; k < 9; ++k) {
+        if (std::isnan(w[k])) {
+            const double opp = w[8 - k];
+            w[k] = std::isnan(opp) ? w[4] : 2.0 * w[4] - opp;
+        }
+    }
+}
+
+// the derivative for a 3x3 window w in row-major order (w[4] is the center)
+// dx and dy are the GDAL gradient terms: dx is the decrease in elevation
+// toward the east, and dy the increase toward the north for north-up
+template <DemMode MODE, bool ZT>
+inline double demValue_(const DemParams &p, const RowRes &res,
+                        const double *w) {
+
+    if (MODE == DEM_TRI) {
+        if (p.tri_wilson) {
+            double sum = 0.0;
+            for (int k = 0; k < 9; ++k)
+                sum += std::fabs(w[k] - w[4]);
+            return sum / 8.0;
+        }
+        double sum = 0.0;
+        for (int k = 0; k < 9; ++k)
+            sum += (w[k] - w[4]) * (w[k] - w[4]);
+        return std::sqrt(sum);
+    }
+
+    double dx = 0.0;
+    double dy = 0.0;
+    if (ZT) {
+        dx = (w[3] - w[5]) / (2.0 * res.ew);
+        dy = (w[7] - w[1]) / (2.0 * res.ns);
+    } else {
+        dx = ((w[0] + 2.0 * w[3] + w[6]) - (w[2] + 2.0 * w[5] + w[8])) /
+             (8.0 * res.ew);
+        dy = ((w[6] + 2.0 * w[7] + w[8]) - (w[0] + 2.0 * w[1] + w[2])) /
+             (8.0 * res.ns);
+    }
+
+    if (MODE == DEM_SLOPE) {
+        const double g = p.z_factor * std::sqrt(dx * dx + dy * dy);
+        if (p.slope_percent)
+            return 100.0 * g;
+        return std::atan(g) * DEM_RAD_TO_DEG;
+    }
+
+    if (MODE == DEM_ASPECT) {
+        // in raster row/column orientation, independent of the sign of the
+        // pixel size
+        const double ax = res.ew < 0 ? -dx : dx;
+        const double ay = res.ns < 0 ? -dy : dy;
+        if (ax == 0.0 && ay == 0.0) {
+            return p.zero_for_flat ? 0.0
+                                   : std::numeric_limits<double>::quiet_NaN();
+        }
+        double aspect = std::atan2(ay, ax) * DEM_RAD_TO_DEG;
+        // azimuth, clockwise from north
+        if (aspect > 90.0)
+            aspect = 450.0 - aspect;
+        else
+            aspect = 90.0 - aspect;
+        if (aspect == 360.0)
+            aspect = 0.0;
+        return aspect;
+    }
+
+    // hillshade on 1-255 as GDAL (0 is nodata in the GDAL Byte output)
+    const double gx = p.z_factor * dx;
+    const double gy = p.z_factor * dy;
+    const double cang = 254.0 * (p.sin_alt - p.cos_alt *
+                                 (gy * p.cos_az - gx * p.sin_az)) /
+                        std::sqrt(1.0 + gx * gx + gy * gy);
+    return cang <= 0.0 ? 1.0 : 1.0 + cang;
+}
+
+template <DemMode MODE, bool ZT>
+void demRowT_(const DemParams &p, const RowRes &res, const double *up,
+              const double *mid, const double *dn, int nx, double *out) {
+
+    double w[9];
+    if (p.compute_edges) {
+        for (int j = 0; j < nx; ++j) {
+            w[0] = up[j];
+            w[1] = up[j + 1];
+            w[2] = up[j + 2];
+            w[3] = mid[j];
+            w[4] = mid[j + 1];
+            w[5] = mid[j + 2];
+            w[6] = dn[j];
+            w[7] = dn[j + 1];
+            w[8] = dn[j + 2];
+            fillMissing_(w);
+            out[j] = demValue_<MODE, ZT>(p, res, w);
+        }
+    } else {
+        for (int j = 0; j < nx; ++j) {
+            w[0] = up[j];
+            w[1] = up[j + 1];
+            w[2] = up[j + 2];
+            w[3] = mid[j];
+            w[4] = mid[j + 1];
+            w[5] = mid[j + 2];
+            w[6] = dn[j];
+            w[7] = dn[j + 1];
+            w[8] = dn[j + 2];
+            out[j] = demValue_<MODE, ZT>(p, res, w);
+        }
+    }
+}
+
+// one output row from the rows above, at and below it in the halo buffer
+// (nx + 2 values each), runs on worker threads
+void demRow_(const DemParams &p, int row, const double *up,
+             const double *mid, const double *dn, int nx, double *out) {
+
+    const RowRes res = rowRes_(p, row);
+    switch (p.mode) {
+        case DEM_SLOPE:
+            if (p.zt)
+                demRowT_<DEM_SLOPE, true>(p, res, up, mid, dn, nx, out);
+            else
+                demRowT_<DEM_SLOPE, false>(p, res, up, mid, dn, nx, out);
+            break;
+        case DEM_ASPECT:
+            if (p.zt)
+                demRowT_<DEM_ASPECT, true>(p, res, up, mid, dn, nx, out);
+            else
+                demRowT_<DEM_ASPECT, false>(p, res, up, mid, dn, nx, out);
+            break;
+        case DEM_HILLSHADE:
+            if (p.zt)
+                demRowT_<DEM_HILLSHADE, true>(p, res, up, mid, dn, nx, out);
+            else
+                demRowT_<DEM_HILLSHADE, false>(p, res, up, mid, dn, nx, out);
+            break;
+        case DEM_TRI:
+            demRowT_<DEM_TRI, false>(p, res, up, mid, dn, nx, out);
+            break;
+    }
+}
+
+// compute ny output rows starting at raster row y0 from the halo buffer
+void computeRows_(const DemParams &p, const std::vector<double> &buf,
+                  int nx, int ny, int y0, double *out, int num_threads) {
+
+    const std::size_t stride = static_cast<std::size_t>(nx) + 2;
+    parallel_for_(static_cast<std::size_t>(ny), num_threads,
+                  [&](std::size_t i) {
+        const double *up = buf.data() + i * stride;
+        demRow_(p, y0 + static_cast<int>(i), up, up + stride,
+                up + 2 * stride, nx, out + i * nx);
+    }, DEM_ROW_GRAIN);
+}
+
+DemParams demParams_(const GDALRaster* const &src_ds,
+                     const std::string &mode, const std::string &alg,
+                     bool slope_percent, double z_factor, double scale,
+                     double azimuth, double altitude, bool zero_for_flat,
+                     bool compute_edges) {
+
+    DemParams p;
+    if (EQUAL(mode.c_str(), "slope"))
+        p.mode = DEM_SLOPE;
+    else if (EQUAL(mode.c_str(), "aspect"))
+        p.mode = DEM_ASPECT;
+    else if (EQUAL(mode.c_str(), "hillshade"))
+        p.mode = DEM_HILLSHADE;
+    else if (EQUAL(mode.c_str(), "TRI"))
+        p.mode = DEM_TRI;
+    else
+        Rcpp::stop("'mode' must be one of slope, aspect, hillshade, TRI");
+
+    if (p.mode == DEM_TRI) {
+        if (alg == "" || EQUAL(alg.c_str(), "Riley"))
+            p.tri_wilson = false;
+        else if (EQUAL(alg.c_str(), "Wilson"))
+            p.tri_wilson = true;
+        else
+            Rcpp::stop("'alg' for TRI must be Riley or Wilson");
+    } else {
+        if (alg == "" || EQUAL(alg.c_str(), "Horn"))
+            p.zt = false;
+        else if (EQUAL(alg.c_str(), "ZevenbergenThorne"))
+            p.zt = true;
+        else
+            Rcpp::stop("'alg' must be Horn or ZevenbergenThorne");
+    }
+
+    p.slope_percent = slope_percent;
+    p.zero_for_flat = zero_for_flat;
+    p.compute_edges = compute_edges;
+    p.z_factor = z_factor;
+    p.sin_alt = std::sin(altitude / DEM_RAD_TO_DEG);
+    p.cos_alt = std::cos(altitude / DEM_RAD_TO_DEG);
+    p.sin_az = std::sin(azimuth / DEM_RAD_TO_DEG);
+    p.cos_az = std::cos(azimuth / DEM_RAD_TO_DEG);
+
+    const Rcpp::NumericVector gt = src_ds->getGeoTransform();
+    for (int i = 0; i < 6; ++i)
+        p.gt[i] = gt[i];
+
+    if (scale > 0) {
+        p.scale = scale;
+    } else {
+        p.scale = 1.0;
+        const std::string srs = src_ds->getProjection();
+        if (srs != "") {
+            OGRSpatialReferenceH hSRS = OSRNewSpatialReference(nullptr);
+            if (OSRSetFromUserInput(hSRS, srs.c_str()) == OGRERR_NONE &&
+                    OSRIsGeographic(hSRS)) {
+                p.geographic = true;
+                p.m_per_deg = OSRGetSemiMajor(hSRS, nullptr) /
+                              DEM_RAD_TO_DEG;
+            }
+            OSRDestroySpatialReference(hSRS);
+        }
+    }
+
+    return p;
+}
+
+}  // namespace
+
+//' Compute a DEM derivative for a window of a raster band, returned as a
+//' numeric vector in left to right, top to bottom order
+//' @noRd
+// [[Rcpp::export(name = ".dem_calc_window")]]
+Rcpp::NumericVector dem_calc_window(const GDALRaster* const &src_ds,
+                                    int band, int xoff, int yoff, int xsize,
+                                    int ysize, const std::string &mode,
+                                    const std::string &alg,
+                                    bool slope_percent, double z_factor,
+                                    double scale, double azimuth,
+                                    double altitude, bool zero_for_flat,
+                                    bool compute_edges, int num_threads) {
+
+    GDALRasterBandH hBand = src_ds->getBand_(band);
+    const int rxsize = GDALGetRasterBandXSize(hBand);
+    const int rysize = GDALGetRasterBandYSize(hBand);
+    if (xsize < 1 || ysize < 1 || xoff < 0 || yoff < 0 ||
+            xoff + xsize > rxsize || yoff + ysize > rysize) {
+        Rcpp::stop("the window is outside the raster extent");
+    }
+
+    const DemParams p = demParams_(src_ds, mode, alg, slope_percent,
+                                   z_factor, scale, azimuth, altitude,
+                                   zero_for_flat, compute_edges);
+
+    std::vector<double> buf;
+    if (!readHalo_(hBand, xoff, yoff, xsize, ysize, &buf))
+        Rcpp::stop("failed to read the raster window");
+
+    Rcpp::NumericVector out = Rcpp::no_init(
+        static_cast<R_xlen_t>(xsize) * ysize);
+    computeRows_(p, buf, xsize, ysize, yoff, out.begin(), num_threads);
+
+    for (double &v : out) {
+        if (std::isnan(v))
+            v = NA_REAL;
+    }
+    return out;
+}
+
+//' Compute a DEM derivative for a raster band and write it to a band of
+//' another raster of the same dimensions, in strips of rows
+//' @noRd
+// [[Rcpp::export(name = ".dem_calc_ds")]]
+bool dem_calc_ds(const GDALRaster* const &src_ds, int band,
+                 const GDALRaster* const &dst_ds, int dst_band,
+                 const std::string &mode, const std::string &alg,
+                 bool slope_percent, double z_factor, double scale,
+                 double azimuth, double altitude, bool zero_for_flat,
+                 bool compute_edges, int num_threads, bool quiet) {
+
+    dst_ds->checkAccess_(GA_Update);
+    if (src_ds->getGDALDatasetH_() == dst_ds->getGDALDatasetH_())
+        Rcpp::stop("'dst' must be a different dataset than the source");
+
+    GDALRasterBandH hSrcBand = src_ds->getBand_(band);
+    GDALRasterBandH hDstBand = dst_ds->getBand_(dst_band);
+    const int xsize = GDALGetRasterBandXSize(hSrcBand);
+    const int ysize = GDALGetRasterBandYSize(hSrcBand);
+    if (GDALGetRasterBandXSize(hDstBand) != xsize ||
+            GDALGetRasterBandYSize(hDstBand) != ysize) {
+        Rcpp::stop("'dst' must have the same raster dimensions as the source");
+    }
+
+    const DemParams p = demParams_(src_ds, mode, alg, slope_percent,
+                                   z_factor, scale, azimuth, altitude,
+                                   zero_for_flat, compute_edges);
+
+    int has_dst_nodata = FALSE;
+    const double dst_nodata = GDALGetRasterNoDataValue(hDstBand,
+                                                       &has_dst_nodata);
+
+    // strips of whole blocks of the output
+    int block_xsize = 0;
+    int block_ysize = 0;
+    GDALGetBlockSize(hDstBand, &block_xsize, &block_ysize);
+    int strip_rows = static_cast<int>(std::max<std::size_t>(
+        1, DEM_STRIP_MAX_PIXELS / static_cast<std::size_t>(xsize)));
+    if (block_ysize > 0 && strip_rows >= block_ysize)
+        strip_rows = (strip_rows / block_ysize) * block_ysize;
+    strip_rows = std::min(strip_rows, ysize);
+
+    GDALProgressFunc pfnProgress = GDALTermProgressR;
+    if (!quiet)
+        pfnProgress(0, nullptr, nullptr);
+
+    std::vector<double> buf;
+    std::vector<double> out;
+    for (int y0 = 0; y0 < ysize; y0 += strip_rows) {
+        const int ny = std::min(strip_rows, ysize - y0);
+        if (!readHalo_(hSrcBand, 0, y0, xsize, ny, &buf))
+            Rcpp::stop("failed to read the source raster");
+
+        out.resize(static_cast<std::size_t>(xsize) * ny);
+        computeRows_(p, buf, xsize, ny, y0, out.data(), num_threads);
+
+        if (has_dst_nodata) {
+            for (double &v : out) {
+                if (std::isnan(v))
+                    v = dst_nodata;
+            }
+        }
+
+        if (GDALRasterIO(hDstBand, GF_Write, 0, y0, xsize, ny, out.data(),
+                         xsize, ny, GDT_Float64, 0, 0) != CE_None) {
+            Rcpp::stop("failed to write the output raster");
+        }
+
+        if (!quiet) {
+            pfnProgress(static_cast<double>(y0 + ny) / ysize, nullptr,
+                        nullptr);
+        }
+        Rcpp::checkUserInterrupt();
+    }
+
+    return true;
+}
@@ -0,0 +1,42 @@
+/* DEM derivatives computed in memory (slope, aspect, hillshade, TRI) with
+   3x3 Horn or Zevenbergen-Thorne kernels, on a window of a GDALRaster or
+   streamed into another GDALRaster, on multiple threads.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef DEM_CALC_H_
+#define DEM_CALC_H_
+
+#include <Rcpp.h>
+
+#include <gdal.h>
+
+#include <string>
+#include <vector>
+
+// read rows [y0 - 1, y0 + ny + 1) and columns [x0 - 1, x0 + nx + 1) of a
+// band as Float64 with a one-pixel halo, with NaN outside the raster and for
+// nodata (also used by flow_routing.cpp)
+bool readHalo_(GDALRasterBandH hBand, int x0, int y0, int nx, int ny,
+               std::vector<double> *buf);
+
+class GDALRaster;
+Rcpp::NumericVector dem_calc_window(const GDALRaster* const &src_ds,
+                                    int band, int xoff, int yoff, int xsize,
+                                    int ysize, const std::string &mode,
+                                    const std::string &alg,
+                                    bool slope_percent, double z_factor,
+                                    double scale, double azimuth,
+                                    double altitude, bool zero_for_flat,
+                                    bool compute_edges, int num_threads);
+
+bool dem_calc_ds(const GDALRaster* const &src_ds, int band,
+                 const GDALRaster* const &dst_ds, int dst_band,
+                 const std::string &mode, const std::string &alg,
+                 bool slope_percent, double z_factor, double scale,
+                 double azimuth, double altitude, bool zero_for_flat,
+                 bool compute_edges, int num_threads, bool quiet);
+
+#endif  // DEM_CALC_H_
@@ -0,0 +1,1029 @@
+/* Hydrologic flow routing on DEMs, processed tile by tile
+
+   The raster is divided into tiles aligned with the blocks of the source
+   band. Tiles are read on the main thread in batches, processed on worker
+   threads and written on the main thread, so that only a batch of tiles and
+   a small amount of state for the cells on the tile perimeters is held in
+   memory.
+
+   Depression filling is the tiled priority-flood of Barnes (2016), "Parallel
+   priority-flood depression filling for trillion cell digital elevation
+   models on desktops or clusters", Computers & Geosciences 96:56-68. In a
+   first pass over the tiles, each cell on a tile perimeter floods the tile
+   with its own label, cells that are nodata or on the raster edge drain to
+   the outside, and a graph of spill elevations between the perimeter labels
+   is collected. A minimax search over that graph from the outside gives the
+   elevation at which each perimeter cell spills, and a second pass floods
+   each tile again from its perimeter raised to those elevations. The result
+   is the same as a priority-flood of the whole raster.
+
+   Flow directions are computed on a filled DEM. Flat areas drain toward
+   their outlets (cells with a lower neighbor, or next to nodata or the
+   raster edge) along the shortest path in cells. The distances from the
+   outlets are computed per tile, exchanging the distances of the perimeter
+   cells between neighbor tiles until none change. D8 directions are coded as
+   in ESRI/ArcGIS (1 = E, 2 = SE, 4 = S, ..., 128 = NE, 0 = undefined).
+   D-infinity directions (Tarboton 1997) are angles in radians counter-
+   clockwise from east, on the triangular facet with the steepest downslope,
+   constrained to flow only to lower cells.
+
+   Flow accumulation is the number of cells draining through each cell,
+   including itself, proportionally split between two cells for D-infinity.
+   Each tile is accumulated in topological order and the flow leaving it is
+   queued for the neighbor tiles, which are updated in later passes (adding
+   the incoming flow to the accumulation already written) until no flow is
+   pending.
+
+   Directions are in raster row/column orientation (north is up for a
+   north-up raster).
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_port.h>
+#include <gdal.h>
+
+#include <Rcpp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dem_calc.h"
+#include "flow_routing.h"
+#include "gdalraster.h"
+#include "tile_util.h"
+
+constexpr double FLOW_PI = 3.14159265358979323846;
+
+// node of the spill graph for nodata and outside the raster
+constexpr int64_t FLOW_OUTSIDE = 0;
+constexpr int64_t FLOW_UNLABELED = -1;
+
+constexpr int32_t FLAT_INF = std::numeric_limits<int32_t>::max();
+
+// D-infinity angles within this tolerance of a neighbor direction send all
+// flow to that neighbor (angles are stored as Float32)
+constexpr double DINF_ANGLE_EPS = 1e-5;
+
+// D8 neighbors clockwise from east, and the ESRI direction codes
+constexpr int D8_DC[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+constexpr int D8_DR[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+constexpr int D8_CODE[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+
+// D8 neighbors counter-clockwise from east (E, NE, N, NW, W, SW, S, SE), the
+// D-infinity facets lie between consecutive entries
+constexpr int DINF_SEQ[8] = {0, 7, 6, 5, 4, 3, 2, 1};
+
+namespace {
+
+// number of cells on the perimeter of a w x h tile
+int64_t perimSize_(int w, int h) {
+    if (w == 1 || h == 1)
+        return static_cast<int64_t>(w) * h;
+    return 2 * static_cast<int64_t>(w) + 2 * static_cast<int64_t>(h - 2);
+}
+
+// index of tile cell (lc, lr) among the perimeter cells, or -1
+int64_t perimSlot_(int w, int h, int lc, int lr) {
+    if (h == 1)
+        return lc;
+    if (w == 1)
+        return lr;
+    if (lr == 0)
+        return lc;
+    if (lr == h - 1)
+        return static_cast<int64_t>(w) + lc;
+    if (lc == 0)
+        return 2 * static_cast<int64_t>(w) + (lr - 1);
+    if (lc == w - 1)
+        return 2 * static_cast<int64_t>(w) + (h - 2) + (lr - 1);
+    return -1;
+}
+
+// call fn(lc, lr) once for each perimeter cell of a w x h tile
+template <typename F>
+void forPerimeter_(int w, int h, F fn) {
+    for (int lc = 0; lc < w; ++lc) {
+        fn(lc, 0);
+        if (h > 1)
+            fn(lc, h - 1);
+    }
+    for (int lr = 1; lr < h - 1; ++lr) {
+        fn(0, lr);
+        if (w > 1)
+            fn(w - 1, lr);
+    }
+}
+
+struct FlowGrid {
+    int xsize {0};
+    int ysize {0};
+    int tile_xsize {0};
+    int tile_ysize {0};
+    int ntx {0};
+    int nty {0};
+    std::vector<RasterTile> tiles;
+    // id of the first perimeter node of each tile (node 0 is FLOW_OUTSIDE)
+    std::vector<int64_t> node_offset;
+    int64_t num_nodes {1};
+
+    bool inRaster(int col, int row) const {
+        return col >= 0 && row >= 0 && col < xsize && row < ysize;
+    }
+
+    std::size_t tileOf(int col, int row) const {
+        return static_cast<std::size_t>(row / tile_ysize) * ntx +
+               col / tile_xsize;
+    }
+
+    // node of raster cell (col, row), which must be on a tile perimeter
+    int64_t node(int col, int row) const {
+        const std::size_t i = tileOf(col, row);
+        const RasterTile &t = tiles[i];
+        return node_offset[i] + perimSlot_(t.xsize, t.ysize, col - t.xoff,
+                                           row - t.yoff);
+    }
+};
+
+FlowGrid makeGrid_(GDALRasterBandH hBand, int tile_size) {
+    FlowGrid g;
+    g.xsize = GDALGetRasterBandXSize(hBand);
+    g.ysize = GDALGetRasterBandYSize(hBand);
+    int block_xsize = 0;
+    int block_ysize = 0;
+    GDALGetBlockSize(hBand, &block_xsize, &block_ysize);
+    g.tile_xsize = tileDim_(tile_size, block_xsize, g.xsize);
+    g.tile_ysize = tileDim_(tile_size, block_ysize, g.ysize);
+    g.ntx = (g.xsize + g.tile_xsize - 1) / g.tile_xsize;
+    g.nty = (g.ysize + g.tile_ysize - 1) / g.tile_ysize;
+    g.tiles = makeTiles_(g.xsize, g.ysize, g.tile_xsize, g.tile_ysize);
+    for (const RasterTile &t : g.tiles) {
+        g.node_offset.push_back(g.num_nodes);
+        g.num_nodes += perimSize_(t.xsize, t.ysize);
+    }
+    return g;
+}
+
+void readTile_(GDALRasterBandH hBand, const RasterTile &t,
+               std::vector<double> *buf) {
+    if (!readHalo_(hBand, t.xoff, t.yoff, t.xsize, t.ysize, buf))
+        Rcpp::stop("failed to read raster tile");
+}
+
+// write tile values with NaN replaced by the nodata value of the band
+void writeTile_(GDALRasterBandH hBand, const RasterTile &t,
+                std::vector<double> *val) {
+
+    int has_nodata = FALSE;
+    const double nodata = GDALGetRasterNoDataValue(hBand, &has_nodata);
+    if (has_nodata) {
+        for (double &v : *val) {
+            if (std::isnan(v))
+                v = nodata;
+        }
+    }
+    if (GDALRasterIO(hBand, GF_Write, t.xoff, t.yoff, t.xsize, t.ysize,
+                     val->data(), t.xsize, t.ysize, GDT_Float64, 0,
+                     0) != CE_None) {
+        Rcpp::stop("failed to write raster tile");
+    }
+}
+
+void checkDst_(GDALRasterBandH hSrcBand, const GDALRaster* const &src_ds,
+               const GDALRaster* const &dst_ds) {
+
+    dst_ds->checkAccess_(GA_Update);
+    if (src_ds->getGDALDatasetH_() == dst_ds->getGDALDatasetH_())
+        Rcpp::stop("the output must be a different dataset than the source");
+    GDALRasterBandH hDstBand = dst_ds->getBand_(1);
+    if (GDALGetRasterBandXSize(hDstBand) !=
+            GDALGetRasterBandXSize(hSrcBand) ||
+            GDALGetRasterBandYSize(hDstBand) !=
+            GDALGetRasterBandYSize(hSrcBand)) {
+        Rcpp::stop("the output must have the same raster dimensions as the "
+                   "source");
+    }
+}
+
+void progress_(bool quiet, double complete) {
+    if (!quiet)
+        GDALTermProgressR(complete, nullptr, nullptr);
+}
+
+// ---- depression filling ----------------------------------------------------
+
+struct FillEdge {
+    int64_t a;
+    int64_t b;
+    double w;
+};
+
+using FloodItem = std::pair<double, std::size_t>;
+using FloodQueue = std::priority_queue<FloodItem, std::vector<FloodItem>,
+                                       std::greater<FloodItem>>;
+
+// Priority-flood of tile ti from its perimeter and nodata cells. buf is the
+// tile with a one-pixel halo (NaN for nodata and outside the raster). In the
+// first pass (spill == nullptr), each perimeter cell floods with its own
+// label, and the edges of the spill graph are collected where the floods
+// meet and to the cells just outside the tile. In the second pass, the
+// perimeter cells start from their spill elevation and val receives the
+// filled elevations.
+void floodTile_(const FlowGrid &g, std::size_t ti,
+                const std::vector<double> &buf,
+                const std::vector<double> *spill, std::vector<double> *val,
+                std::vector<FillEdge> *edges) {
+
+    const RasterTile &t = g.tiles[ti];
+    const int w = t.xsize;
+    const int h = t.ysize;
+    const std::size_t stride = static_cast<std::size_t>(w) + 2;
+    auto zAt = [&](int lc, int lr) {
+        return buf[(lr + 1) * stride + lc + 1];
+    };
+
+    const std::size_t n = static_cast<std::size_t>(w) * h;
+    std::vector<int64_t> lab(n, FLOW_UNLABELED);
+    val->assign(n, std::numeric_limits<double>::quiet_NaN());
+    FloodQueue q;
+
+    std::map<std::pair<int64_t, int64_t>, double> emap;
+    auto addEdge = [&](int64_t a, int64_t b, double wt) {
+        if (a == b)
+            return;
+        if (a > b)
+            std::swap(a, b);
+        auto it = emap.find({a, b});
+        if (it == emap.end())
+            emap.emplace(std::make_pair(a, b), wt);
+        else if (wt < it->second)
+            it->second = wt;
+    };
+
+    for (int lr = 0; lr < h; ++lr) {
+        for (int lc = 0; lc < w; ++lc) {
+            const std::size_t c = static_cast<std::size_t>(lr) * w + lc;
+            const double z = zAt(lc, lr);
+            if (std::isnan(z)) {
+                lab[c] = FLOW_OUTSIDE;
+                (*val)[c] = -std::numeric_limits<double>::infinity();
+                q.emplace((*val)[c], c);
+                continue;
+            }
+            const int64_t slot = perimSlot_(w, h, lc, lr);
+            if (slot < 0)
+                continue;
+
+            const int64_t node = g.node_offset[ti] + slot;
+            lab[c] = node;
+            (*val)[c] = spill ? std::max(z, (*spill)[node]) : z;
+            q.emplace((*val)[c], c);
+
+            if (edges == nullptr)
+                continue;
+            for (int k = 0; k < 8; ++k) {
+                const int nc = lc + D8_DC[k];
+                const int nr = lr + D8_DR[k];
+                if (nc >= 0 && nr >= 0 && nc < w && nr < h)
+                    continue;
+                const double zn = zAt(nc, nr);
+                if (std::isnan(zn)) {
+                    addEdge(node, FLOW_OUTSIDE, z);
+                } else {
+                    addEdge(node, g.node(t.xoff + nc, t.yoff + nr),
+                            std::max(z, zn));
+                }
+            }
+        }
+    }
+
+    while (!q.empty()) {
+        const double v = q.top().first;
+        const std::size_t c = q.top().second;
+        q.pop();
+        const int lc = static_cast<int>(c % w);
+        const int lr = static_cast<int>(c / w);
+        for (int k = 0; k < 8; ++k) {
+            const int nc = lc + D8_DC[k];
+            const int nr = lr + D8_DR[k];
+            if (nc < 0 || nr < 0 || nc >= w || nr >= h)
+                continue;
+            const std::size_t nn = static_cast<std::size_t>(nr) * w + nc;
+            if (lab[nn] == FLOW_UNLABELED) {
+                lab[nn] = lab[c];
+                (*val)[nn] = std::max(zAt(nc, nr), v);
+                q.emplace((*val)[nn], nn);
+            } else if (edges != nullptr && lab[nn] != lab[c]) {
+                addEdge(lab[c], lab[nn], std::max(v, (*val)[nn]));
+            }
+        }
+    }
+
+    if (edges != nullptr) {
+        edges->clear();
+        for (const auto &e : emap)
+            edges->push_back({e.first.first, e.first.second, e.second});
+    }
+}
+
+// the lowest elevation at which each node of the spill graph drains to the
+// outside (the minimum over paths of the maximum edge weight)
+std::vector<double> spillElevations_(int64_t num_nodes,
+                                     const std::vector<FillEdge> &edges) {
+
+    std::vector<std::size_t> start(num_nodes + 1, 0);
+    for (const FillEdge &e : edges) {
+        start[e.a + 1] += 1;
+        start[e.b + 1] += 1;
+    }
+    for (int64_t i = 0; i < num_nodes; ++i)
+        start[i + 1] += start[i];
+
+    std::vector<int64_t> adj(start[num_nodes]);
+    std::vector<double> wt(start[num_nodes]);
+    std::vector<std::size_t> pos(start.begin(), start.end() - 1);
+    for (const FillEdge &e : edges) {
+        adj[pos[e.a]] = e.b;
+        wt[pos[e.a]++] = e.w;
+        adj[pos[e.b]] = e.a;
+        wt[pos[e.b]++] = e.w;
+    }
+
+    std::vector<double> spill(num_nodes,
+                              std::numeric_limits<double>::infinity());
+    spill[FLOW_OUTSIDE] = -std::numeric_limits<double>::infinity();
+    using Item = std::pair<double, int64_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> q;
+    q.emplace(spill[FLOW_OUTSIDE], FLOW_OUTSIDE);
+    while (!q.empty()) {
+        const double s = q.top().first;
+        const int64_t u = q.top().second;
+        q.pop();
+        if (s > spill[u])
+            continue;
+        for (std::size_t i = start[u]; i < start[u + 1]; ++i) {
+            const double cand = std::max(s, wt[i]);
+            if (cand < spill[adj[i]]) {
+                spill[adj[i]] = cand;
+                q.emplace(cand, adj[i]);
+            }
+        }
+    }
+    return spill;
+}
+
+// ---- flow direction --------------------------------------------------------
+
+// distance to each D8 neighbor and its direction in radians counter-
+// clockwise from east, for the pixel size of the raster
+struct FlowGeom {
+    double dx {1.0};
+    double dy {1.0};
+    double dist[8] {};
+    double ang[8] {};
+    // direction of DINF_SEQ[i], with seq_ang[8] = 2 * pi for east
+    double seq_ang[9] {};
+};
+
+FlowGeom flowGeom_(const GDALRaster* const &ds) {
+    FlowGeom p;
+    const Rcpp::NumericVector gt = ds->getGeoTransform();
+    p.dx = std::fabs(gt[1]) > 0 ? std::fabs(gt[1]) : 1.0;
+    p.dy = std::fabs(gt[5]) > 0 ? std::fabs(gt[5]) : 1.0;
+    const double diag = std::sqrt(p.dx * p.dx + p.dy * p.dy);
+    const double delta = std::atan2(p.dy, p.dx);
+    const double dist[8] = {p.dx, diag, p.dy, diag, p.dx, diag, p.dy, diag};
+    const double ang[8] = {0.0, 2 * FLOW_PI - delta, 1.5 * FLOW_PI,
+                           FLOW_PI + delta, FLOW_PI, FLOW_PI - delta,
+                           0.5 * FLOW_PI, delta};
+    for (int k = 0; k < 8; ++k) {
+        p.dist[k] = dist[k];
+        p.ang[k] = ang[k];
+    }
+    for (int i = 0; i < 8; ++i)
+        p.seq_ang[i] = ang[DINF_SEQ[i]];
+    p.seq_ang[8] = 2 * FLOW_PI;
+    return p;
+}
+
+// Distance in cells from each cell of a flat to the nearest outlet of the
+// flat, through cells of the same elevation, starting from the distances of
+// the perimeter cells of neighbor tiles in perim_d. Outlets (distance 0) are
+// cells with a lower neighbor, or next to nodata or the raster edge. Cells
+// that cannot reach an outlet keep FLAT_INF. Returns true if the tile has
+// any cells that are not outlets.
+bool flatDist_(const FlowGrid &g, std::size_t ti,
+               const std::vector<double> &buf,
+               const std::vector<int32_t> &perim_d,
+               std::vector<int32_t> *d) {
+
+    const RasterTile &t = g.tiles[ti];
+    const int w = t.xsize;
+    const int h = t.ysize;
+    const std::size_t stride = static_cast<std::size_t>(w) + 2;
+    auto zAt = [&](int lc, int lr) {
+        return buf[(lr + 1) * stride + lc + 1];
+    };
+
+    d->assign(static_cast<std::size_t>(w) * h, FLAT_INF);
+    using Item = std::pair<int32_t, std::size_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> q;
+    bool has_flat = false;
+
+    for (int lr = 0; lr < h; ++lr) {
+        for (int lc = 0; lc < w; ++lc) {
+            const std::size_t c = static_cast<std::size_t>(lr) * w + lc;
+            const double z = zAt(lc, lr);
+            if (std::isnan(z))
+                continue;
+
+            bool outlet = false;
+            for (int k = 0; k < 8 && !outlet; ++k) {
+                const double zn = zAt(lc + D8_DC[k], lr + D8_DR[k]);
+                outlet = std::isnan(zn) || zn < z;
+            }
+            if (outlet) {
+                (*d)[c] = 0;
+                q.emplace(0, c);
+                continue;
+            }
+
+            has_flat = true;
+            if (lc > 0 && lr > 0 && lc < w - 1 && lr < h - 1)
+                continue;
+            int32_t best = FLAT_INF;
+            for (int k = 0; k < 8; ++k) {
+                const int nc = lc + D8_DC[k];
+                const int nr = lr + D8_DR[k];
+                if (nc >= 0 && nr >= 0 && nc < w && nr < h)
+                    continue;
+                if (zAt(nc, nr) != z)
+                    continue;
+                const int32_t dn = perim_d[g.node(t.xoff + nc, t.yoff + nr)];
+                if (dn < FLAT_INF && dn + 1 < best)
+                    best = dn + 1;
+            }
+            if (best < FLAT_INF) {
+                (*d)[c] = best;
+                q.emplace(best, c);
+            }
+        }
+    }
+
+    while (!q.empty()) {
+        const int32_t dc = q.top().first;
+        const std::size_t c = q.top().second;
+        q.pop();
+        if (dc != (*d)[c])
+            continue;
+        const int lc = static_cast<int>(c % w);
+        const int lr = static_cast<int>(c / w);
+        const double z = zAt(lc, lr);
+        for (int k = 0; k < 8; ++k) {
+            const int nc = lc + D8_DC[k];
+            const int nr = lr + D8_DR[k];
+            if (nc < 0 || nr < 0 || nc >= w || nr >= h)
+                continue;
+            const std::size_t nn = static_cast<std::size_t>(nr) * w + nc;
+            if ((*d)[nn] <= dc + 1 || zAt(nc, nr) != z)
+                continue;
+            (*d)[nn] = dc + 1;
+            q.emplace(dc + 1, nn);
+        }
+    }
+
+    return has_flat;
+}
+
+// D-infinity angle for a cell with elevation z and neighbor elevations zn
+// (NaN if missing), or NaN if no facet slopes down
+double dinfAngle_(const FlowGeom &p, double z, const double *zn) {
+    double best_s = 0.0;
+    double best_a = std::numeric_limits<double>::quiet_NaN();
+    for (int i = 0; i < 8; ++i) {
+        const int k0 = DINF_SEQ[i];
+        const int k1 = DINF_SEQ[(i + 1) % 8];
+        const double a0 = p.seq_ang[i];
+        const double a1 = p.seq_ang[i + 1];
+        // the cardinal neighbor is first on even facets
+        const bool card_first = (i % 2 == 0);
+        const int kc = card_first ? k0 : k1;
+        const int kd = card_first ? k1 : k0;
+        const double ac = card_first ? a0 : a1;
+        const double ad = card_first ? a1 : a0;
+        // a missing neighbor gives NaN slopes, which fail the comparisons
+        const double e1 = zn[kc];
+        const double e2 = zn[kd];
+        const double d1 = p.dist[kc];
+        const double d2 = (kc == 0 || kc == 4) ? p.dy : p.dx;
+        const double rmax = std::atan2(d2, d1);
+        const double s1 = (z - e1) / d1;
+        const double s2 = (e1 - e2) / d2;
+        const double sd = (z - e2) / p.dist[kd];
+        double s = 0.0;
+        double r = 0.0;
+        if (s1 > 0.0 && s2 > 0.0) {
+            r = std::atan2(s2, s1);
+            if (r < rmax) {
+                s = std::sqrt(s1 * s1 + s2 * s2);
+            } else {
+                r = rmax;
+                s = sd;
+            }
+        } else {
+            if (s1 > 0.0)
+                s = s1;
+            if (sd > s) {
+                s = sd;
+                r = rmax;
+            }
+        }
+        if (s > best_s) {
+            best_s = s;
+            best_a = ac + (ad - ac) * r / rmax;
+        }
+    }
+    if (best_a >= 2 * FLOW_PI)
+        best_a -= 2 * FLOW_PI;
+    return best_a;
+}
+
+// flow directions of tile ti from the filled elevations in buf
+void flowDirTile_(const FlowGrid &g, std::size_t ti,
+                  const std::vector<double> &buf,
+                  const std::vector<int32_t> &perim_d, const FlowGeom &p,
+                  bool dinf, std::vector<int32_t> *d,
+                  std::vector<double> *out) {
+
+    flatDist_(g, ti, buf, perim_d, d);
+
+    const RasterTile &t = g.tiles[ti];
+    const int w = t.xsize;
+    const int h = t.ysize;
+    const std::size_t stride = static_cast<std::size_t>(w) + 2;
+    auto zAt = [&](int lc, int lr) {
+        return buf[(lr + 1) * stride + lc + 1];
+    };
+    auto distAt = [&](int lc, int lr) {
+        if (lc >= 0 && lr >= 0 && lc < w && lr < h)
+            return (*d)[static_cast<std::size_t>(lr) * w + lc];
+        return perim_d[g.node(t.xoff + lc, t.yoff + lr)];
+    };
+
+    out->assign(static_cast<std::size_t>(w) * h,
+                std::numeric_limits<double>::quiet_NaN());
+    double zn[8];
+    for (int lr = 0; lr < h; ++lr) {
+        for (int lc = 0; lc < w; ++lc) {
+            const std::size_t c = static_cast<std::size_t>(lr) * w + lc;
+            const double z = zAt(lc, lr);
+            if (std::isnan(z))
+                continue;
+
+            int best_k = -1;
+            int edge_k = -1;
+            double best_s = 0.0;
+            for (int k = 0; k < 8; ++k) {
+                zn[k] = zAt(lc + D8_DC[k], lr + D8_DR[k]);
+                if (std::isnan(zn[k])) {
+                    if (edge_k < 0)
+                        edge_k = k;
+                    continue;
+                }
+                const double s = (z - zn[k]) / p.dist[k];
+                if (s > best_s) {
+                    best_s = s;
+                    best_k = k;
+                }
+            }
+
+            if (best_k >= 0) {
+                if (dinf) {
+                    const double a = dinfAngle_(p, z, zn);
+                    (*out)[c] = std::isnan(a) ? p.ang[best_k] : a;
+                } else {
+                    (*out)[c] = D8_CODE[best_k];
+                }
+                continue;
+            }
+
+            // no lower neighbor: out of the raster or into nodata, or along
+            // a flat toward its outlet
+            if (edge_k >= 0) {
+                best_k = edge_k;
+            } else if ((*d)[c] < FLAT_INF) {
+                for (int k = 0; k < 8; ++k) {
+                    if (zn[k] == z &&
+                            distAt(lc + D8_DC[k], lr + D8_DR[k]) ==
+                            (*d)[c] - 1) {
+                        best_k = k;
+                        break;
+                    }
+                }
+            }
+            if (best_k >= 0)
+                (*out)[c] = dinf ? p.ang[best_k] : D8_CODE[best_k];
+            else if (!dinf)
+                (*out)[c] = 0;
+        }
+    }
+}
+
+// ---- flow accumulation -----------------------------------------------------
+
+// the neighbors (k) receiving flow from a cell with direction v, and the
+// fraction of the flow to each, returns the number of receivers
+int receivers_(const FlowGeom &p, bool dinf, double v, int *k, double *f) {
+    if (std::isnan(v))
+        return 0;
+
+    if (!dinf) {
+        for (int i = 0; i < 8; ++i) {
+            if (v == D8_CODE[i]) {
+                k[0] = i;
+                f[0] = 1.0;
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    if (v < -DINF_ANGLE_EPS || v > 2 * FLOW_PI + DINF_ANGLE_EPS)
+        return 0;
+    double a = std::min(std::max(v, 0.0), 2 * FLOW_PI);
+    if (a >= 2 * FLOW_PI)
+        a -= 2 * FLOW_PI;
+    int i = 0;
+    while (i < 7 && a >= p.seq_ang[i + 1])
+        ++i;
+    const double a0 = p.seq_ang[i];
+    const double a1 = p.seq_ang[i + 1];
+    if (a - a0 < DINF_ANGLE_EPS) {
+        k[0] = DINF_SEQ[i];
+        f[0] = 1.0;
+        return 1;
+    }
+    if (a1 - a < DINF_ANGLE_EPS) {
+        k[0] = DINF_SEQ[(i + 1) % 8];
+        f[0] = 1.0;
+        return 1;
+    }
+    const double f1 = (a - a0) / (a1 - a0);
+    k[0] = DINF_SEQ[i];
+    f[0] = 1.0 - f1;
+    k[1] = DINF_SEQ[(i + 1) % 8];
+    f[1] = f1;
+    return 2;
+}
+
+struct AccWork {
+    std::vector<double> dir;  // with a one-pixel halo
+    std::vector<double> acc;
+    std::vector<std::pair<std::size_t, double>> inflow;
+    std::vector<std::pair<int64_t, double>> outflow;
+};
+
+// Accumulate flow over tile ti in topological order. On the first pass each
+// valid cell contributes one unit and acc is set, on later passes only the
+// flow entering from neighbor tiles is routed and added to acc. Flow leaving
+// the tile for another tile is returned in outflow by raster cell index.
+void accTile_(const FlowGrid &g, std::size_t ti, const FlowGeom &p,
+              bool dinf, bool first, AccWork *wk) {
+
+    const RasterTile &t = g.tiles[ti];
+    const int w = t.xsize;
+    const int h = t.ysize;
+    const std::size_t n = static_cast<std::size_t>(w) * h;
+    const std::size_t stride = static_cast<std::size_t>(w) + 2;
+    auto dirAt = [&](std::size_t c) {
+        return wk->dir[(c / w + 1) * stride + c % w + 1];
+    };
+
+    std::vector<int8_t> rk(2 * n, -1);
+    std::vector<double> rf(2 * n, 0.0);
+    std::vector<int> indeg(n, 0);
+    int k[2];
+    double f[2];
+    for (std::size_t c = 0; c < n; ++c) {
+        const int nrecv = receivers_(p, dinf, dirAt(c), k, f);
+        for (int m = 0; m < nrecv; ++m) {
+            rk[2 * c + m] = static_cast<int8_t>(k[m]);
+            rf[2 * c + m] = f[m];
+            const int nc = static_cast<int>(c % w) + D8_DC[k[m]];
+            const int nr = static_cast<int>(c / w) + D8_DR[k[m]];
+            if (nc >= 0 && nr >= 0 && nc < w && nr < h)
+                indeg[static_cast<std::size_t>(nr) * w + nc] += 1;
+        }
+    }
+
+    std::vector<double> flow(n, 0.0);
+    if (first) {
+        for (std::size_t c = 0; c < n; ++c)
+            flow[c] = std::isnan(dirAt(c)) ? 0.0 : 1.0;
+    }
+    for (const auto &in : wk->inflow)
+        flow[in.first] += in.second;
+
+    std::vector<std::size_t> ready;
+    for (std::size_t c = 0; c < n; ++c) {
+        if (indeg[c] == 0)
+            ready.push_back(c);
+    }
+    wk->outflow.clear();
+    while (!ready.empty()) {
+        const std::size_t c = ready.back();
+        ready.pop_back();
+        for (int m = 0; m < 2 && rk[2 * c + m] >= 0; ++m) {
+            const double amt = flow[c] * rf[2 * c + m];
+            const int nc = static_cast<int>(c % w) + D8_DC[rk[2 * c + m]];
+            const int nr = static_cast<int>(c / w) + D8_DR[rk[2 * c + m]];
+            if (nc >= 0 && nr >= 0 && nc < w && nr < h) {
+                const std::size_t nn = static_cast<std::size_t>(nr) * w + nc;
+                flow[nn] += amt;
+                if (--indeg[nn] == 0)
+                    ready.push_back(nn);
+            } else if (amt != 0.0 && g.inRaster(t.xoff + nc, t.yoff + nr)) {
+                wk->outflow.emplace_back(
+                    static_cast<int64_t>(t.yoff + nr) * g.xsize + t.xoff + nc,
+                    amt);
+            }
+        }
+    }
+
+    if (first) {
+        wk->acc.assign(n, std::numeric_limits<double>::quiet_NaN());
+        for (std::size_t c = 0; c < n; ++c) {
+            if (!std::isnan(dirAt(c)))
+                wk->acc[c] = flow[c];
+        }
+    } else {
+        for (std::size_t c = 0; c < n; ++c) {
+            if (!std::isnan(dirAt(c)))
+                wk->acc[c] += flow[c];
+        }
+    }
+}
+
+}  // namespace
+
+//' Fill the depressions of a DEM by priority-flood, processed by tiles,
+//' writing the filled elevations to band 1 of another raster of the same
+//' dimensions
+//' @noRd
+// [[Rcpp::export(name = ".dem_fill")]]
+bool dem_fill(const GDALRaster* const &src_ds, int band,
+              const GDALRaster* const &dst_ds, int tile_size,
+              int num_threads, bool quiet) {
+
+    GDALRasterBandH hSrcBand = src_ds->getBand_(band);
+    checkDst_(hSrcBand, src_ds, dst_ds);
+    GDALRasterBandH hDstBand = dst_ds->getBand_(1);
+    if (tile_size < 1)
+        Rcpp::stop("'tile_size' must be a positive integer");
+
+    const FlowGrid g = makeGrid_(hSrcBand, tile_size);
+    std::vector<std::size_t> all(g.tiles.size());
+    for (std::size_t i = 0; i < all.size(); ++i)
+        all[i] = i;
+
+    const std::size_t batch_size = batchSize_(num_threads, all.size());
+    std::vector<std::vector<double>> bufs(batch_size);
+    std::vector<std::vector<double>> vals(batch_size);
+    std::vector<std::vector<FillEdge>> tile_edges(batch_size);
+    std::vector<FillEdge> edges;
+    std::size_t done = 0;
+
+    progress_(quiet, 0);
+
+    // pass 1: the spill graph between tile perimeter cells
+    forTileBatches_(all, num_threads,
+        [&](std::size_t j, std::size_t i) {
+            readTile_(hSrcBand, g.tiles[i], &bufs[j]);
+        },
+        [&](std::size_t j, std::size_t i) {
+            floodTile_(g, i, bufs[j], nullptr, &vals[j], &tile_edges[j]);
+        },
+        [&](std::size_t j, std::size_t) {
+            edges.insert(edges.end(), tile_edges[j].begin(),
+                         tile_edges[j].end());
+            tile_edges[j].clear();
+            progress_(quiet, 0.5 * ++done / all.size());
+        });
+
+    const std::vector<double> spill = spillElevations_(g.num_nodes, edges);
+    edges.clear();
+    edges.shrink_to_fit();
+
+    // pass 2: flood each tile from its perimeter at the spill elevations
+    done = 0;
+    forTileBatches_(all, num_threads,
+        [&](std::size_t j, std::size_t i) {
+            readTile_(hSrcBand, g.tiles[i], &bufs[j]);
+        },
+        [&](std::size_t j, std::size_t i) {
+            floodTile_(g, i, bufs[j], &spill, &vals[j], nullptr);
+        },
+        [&](std::size_t j, std::size_t i) {
+            for (double &v : vals[j]) {
+                if (std::isinf(v))
+                    v = std::numeric_limits<double>::quiet_NaN();
+            }
+            writeTile_(hDstBand, g.tiles[i], &vals[j]);
+            progress_(quiet, 0.5 + 0.5 * ++done / all.size());
+        });
+
+    return true;
+}
+
+//' Compute D8 or D-infinity flow directions from a filled DEM, processed by
+//' tiles, writing to band 1 of another raster of the same dimensions
+//' @noRd
+// [[Rcpp::export(name = ".flow_dir")]]
+bool flow_dir(const GDALRaster* const &src_ds, int band,
+              const GDALRaster* const &dst_ds, const std::string &method,
+              int tile_size, int num_threads, bool quiet) {
+
+    GDALRasterBandH hSrcBand = src_ds->getBand_(band);
+    checkDst_(hSrcBand, src_ds, dst_ds);
+    GDALRasterBandH hDstBand = dst_ds->getBand_(1);
+    if (method != "D8" && method != "Dinf")
+        Rcpp::stop("'method' must be \"D8\" or \"Dinf\"");
+    if (tile_size < 1)
+        Rcpp::stop("'tile_size' must be a positive integer");
+    const bool dinf = (method == "Dinf");
+    const FlowGeom p = flowGeom_(src_ds);
+
+    const FlowGrid g = makeGrid_(hSrcBand, tile_size);
+    const std::size_t nt = g.tiles.size();
+    std::vector<std::size_t> all(nt);
+    for (std::size_t i = 0; i < nt; ++i)
+        all[i] = i;
+
+    const std::size_t batch_size = batchSize_(num_threads, nt);
+    std::vector<std::vector<double>> bufs(batch_size);
+    std::vector<std::vector<int32_t>> dists(batch_size);
+    std::vector<std::vector<double>> out(batch_size);
+    std::vector<char> has_flat(batch_size, 0);
+
+    // distances from the flat outlets, exchanged between tiles through the
+    // perimeter cells until none change
+    std::vector<int32_t> perim_d(g.num_nodes, FLAT_INF);
+    std::vector<char> tile_flat(nt, 1);
+    std::vector<char> dirty(nt, 1);
+    std::size_t done = 0;
+    bool first = true;
+
+    progress_(quiet, 0);
+
+    while (true) {
+        std::vector<std::size_t> idx;
+        for (std::size_t i = 0; i < nt; ++i) {
+            if (dirty[i] && tile_flat[i]) {
+                idx.push_back(i);
+                dirty[i] = 0;
+            }
+        }
+        if (idx.empty())
+            break;
+
+        forTileBatches_(idx, num_threads,
+            [&](std::size_t j, std::size_t i) {
+                readTile_(hSrcBand, g.tiles[i], &bufs[j]);
+            },
+            [&](std::size_t j, std::size_t i) {
+                has_flat[j] = flatDist_(g, i, bufs[j], perim_d, &dists[j]);
+            },
+            [&](std::size_t j, std::size_t i) {
+                const RasterTile &t = g.tiles[i];
+                tile_flat[i] = has_flat[j];
+                forPerimeter_(t.xsize, t.ysize, [&](int lc, int lr) {
+                    const int32_t v = dists[j][
+                        static_cast<std::size_t>(lr) * t.xsize + lc];
+                    const int64_t node = g.node(t.xoff + lc, t.yoff + lr);
+                    if (v >= perim_d[node])
+                        return;
+                    perim_d[node] = v;
+                    for (int k = 0; k < 8; ++k) {
+                        const int col = t.xoff + lc + D8_DC[k];
+                        const int row = t.yoff + lr + D8_DR[k];
+                        if (g.inRaster(col, row) && g.tileOf(col, row) != i)
+                            dirty[g.tileOf(col, row)] = 1;
+                    }
+                });
+                if (first)
+                    progress_(quiet, 0.5 * ++done / nt);
+            });
+        first = false;
+    }
+
+    done = 0;
+    forTileBatches_(all, num_threads,
+        [&](std::size_t j, std::size_t i) {
+            readTile_(hSrcBand, g.tiles[i], &bufs[j]);
+        },
+        [&](std::size_t j, std::size_t i) {
+            flowDirTile_(g, i, bufs[j], perim_d, p, dinf, &dists[j],
+                         &out[j]);
+        },
+        [&](std::size_t j, std::size_t i) {
+            writeTile_(hDstBand, g.tiles[i], &out[j]);
+            progress_(quiet, 0.5 + 0.5 * ++done / nt);
+        });
+
+    return true;
+}
+
+//' Compute flow accumulation from D8 or D-infinity flow directions,
+//' processed by tiles, writing to band 1 of another raster of the same
+//' dimensions
+//' @noRd
+// [[Rcpp::export(name = ".flow_acc")]]
+bool flow_acc(const GDALRaster* const &src_ds, int band,
+              const GDALRaster* const &dst_ds, const std::string &method,
+              int tile_size, int num_threads, bool quiet) {
+
+    GDALRasterBandH hSrcBand = src_ds->getBand_(band);
+    checkDst_(hSrcBand, src_ds, dst_ds);
+    GDALRasterBandH hDstBand = dst_ds->getBand_(1);
+    if (method != "D8" && method != "Dinf")
+        Rcpp::stop("'method' must be \"D8\" or \"Dinf\"");
+    if (tile_size < 1)
+        Rcpp::stop("'tile_size' must be a positive integer");
+    const bool dinf = (method == "Dinf");
+    const FlowGeom p = flowGeom_(src_ds);
+
+    const FlowGrid g = makeGrid_(hSrcBand, tile_size);
+    const std::size_t nt = g.tiles.size();
+    const std::size_t batch_size = batchSize_(num_threads, nt);
+    std::vector<AccWork> work(batch_size);
+
+    // flow entering each tile from its neighbors, by tile cell index
+    std::vector<std::vector<std::pair<std::size_t, double>>> pending(nt);
+    std::size_t done = 0;
+    bool first = true;
+    int64_t passes = 0;
+
+    progress_(quiet, 0);
+
+    while (true) {
+        std::vector<std::size_t> idx;
+        for (std::size_t i = 0; i < nt; ++i) {
+            if (first || !pending[i].empty())
+                idx.push_back(i);
+        }
+        if (idx.empty())
+            break;
+        // an acyclic flow path crosses each perimeter cell at most once
+        if (++passes > g.num_nodes)
+            Rcpp::stop("the flow directions contain a cycle");
+
+        forTileBatches_(idx, num_threads,
+            [&](std::size_t j, std::size_t i) {
+                const RasterTile &t = g.tiles[i];
+                readTile_(hSrcBand, t, &work[j].dir);
+                work[j].inflow.swap(pending[i]);
+                pending[i].clear();
+                if (first)
+                    return;
+                work[j].acc.resize(static_cast<std::size_t>(t.xsize) *
+                                   t.ysize);
+                if (GDALRasterIO(hDstBand, GF_Read, t.xoff, t.yoff, t.xsize,
+                                 t.ysize, work[j].acc.data(), t.xsize,
+                                 t.ysize, GDT_Float64, 0, 0) != CE_None) {
+                    Rcpp::stop("failed to read raster tile");
+                }
+            },
+            [&](std::size_t j, std::size_t i) {
+                accTile_(g, i, p, dinf, first, &work[j]);
+            },
+            [&](std::size_t j, std::size_t i) {
+                writeTile_(hDstBand, g.tiles[i], &work[j].acc);
+                for (const auto &out : work[j].outflow) {
+                    const int col = static_cast<int>(out.first % g.xsize);
+                    const int row = static_cast<int>(out.first / g.xsize);
+                    const std::size_t ti = g.tileOf(col, row);
+                    const RasterTile &t = g.tiles[ti];
+                    pending[ti].emplace_back(
+                        static_cast<std::size_t>(row - t.yoff) * t.xsize +
+                            (col - t.xoff),
+                        out.second);
+                }
+                if (first)
+                    progress_(quiet, 0.9 * ++done / nt);
+            });
+        first = false;
+    }
+
+    progress_(quiet, 1.0);
+    return true;
+}
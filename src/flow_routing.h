@@ -0,0 +1,29 @@
+/* Hydrologic flow routing on DEMs: priority-flood depression filling, D8 and
+   D-infinity flow direction, and flow accumulation, processed tile by tile
+   on multiple threads without holding the raster in memory.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef FLOW_ROUTING_H_
+#define FLOW_ROUTING_H_
+
+#include <Rcpp.h>
+
+#include <string>
+
+class GDALRaster;
+bool dem_fill(const GDALRaster* const &src_ds, int band,
+              const GDALRaster* const &dst_ds, int tile_size,
+              int num_threads, bool quiet);
+
+bool flow_dir(const GDALRaster* const &src_ds, int band,
+              const GDALRaster* const &dst_ds, const std::string &method,
+              int tile_size, int num_threads, bool quiet);
+
+bool flow_acc(const GDALRaster* const &src_ds, int band,
+              const GDALRaster* const &dst_ds, const std::string &method,
+              int tile_size, int num_threads, bool quiet);
+
+#endif  // FLOW_ROUTING_H_
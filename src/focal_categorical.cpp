@@ -0,0 +1,402 @@
+/* Moving-window statistics for categorical rasters
+
+   The class values of the raster are mapped to indexes in a sorted table of
+   the distinct values. Each tile is read with a halo of the window radius
+   (NaN outside the raster and for nodata, which are not counted) on the
+   main thread, and processed on a worker thread one row at a time: the
+   class histogram of the window is built at the first pixel of the row and
+   then updated as the window slides one pixel to the right, by removing the
+   cells that leave the window and adding the cells that enter it on each
+   window row (2 * (2r + 1) cells instead of the (2r + 1)^2 cells of the
+   window). The number of classes present and the sum of n log n over the
+   class counts are updated along with the histogram, so that richness and
+   Shannon diversity take constant time per pixel. The majority class is
+   tracked as cells are added and found again by a scan of the histogram only
+   after a cell of the majority class has left the window.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_port.h>
+#include <gdal.h>
+
+#include <Rcpp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "focal_categorical.h"
+#include "gdalraster.h"
+#include "tile_util.h"
+
+// upper limit on the number of pixels per read when scanning the classes
+constexpr std::size_t FOCAL_SCAN_MAX_PIXELS = 4 * 1024 * 1024;
+
+namespace {
+
+enum FocalStat { FOCAL_MAJORITY, FOCAL_RICHNESS, FOCAL_DIVERSITY,
+                 FOCAL_PROPORTION };
+
+struct FocalParams {
+    int radius {1};
+    std::vector<int> half_width;  // of the window for each row offset
+    std::vector<double> classes;  // sorted class values
+    std::vector<FocalStat> band_stat;
+    std::vector<int> band_class;  // class index for proportion bands
+    std::vector<double> nlogn;  // n * log(n) for n up to the window size
+};
+
+// sliding window class histogram
+struct WindowHist {
+    std::vector<int32_t> count;
+    int32_t total {0};
+    int32_t richness {0};
+    double sum_nlogn {0.0};
+    int32_t majority {-1};
+    bool majority_stale {false};
+
+    void reset(std::size_t num_classes) {
+        count.assign(num_classes, 0);
+        total = 0;
+        richness = 0;
+        sum_nlogn = 0.0;
+        majority = -1;
+        majority_stale = false;
+    }
+
+    void add(const FocalParams &p, int32_t c) {
+        if (c < 0)
+            return;
+        const int32_t n = count[c]++;
+        sum_nlogn += p.nlogn[n + 1] - p.nlogn[n];
+        total += 1;
+        if (n == 0)
+            richness += 1;
+        if (!majority_stale && (majority < 0 || count[c] > count[majority] ||
+                                (count[c] == count[majority] &&
+                                 c < majority))) {
+            majority = c;
+        }
+    }
+
+    void remove(const FocalParams &p, int32_t c) {
+        if (c < 0)
+            return;
+        const int32_t n = count[c]--;
+        sum_nlogn += p.nlogn[n - 1] - p.nlogn[n];
+        total -= 1;
+        if (n == 1)
+            richness -= 1;
+        if (c == majority)
+            majority_stale = true;
+    }
+
+    // the most frequent class, the lowest class value for ties
+    int32_t getMajority() {
+        if (majority_stale) {
+            majority = -1;
+            for (std::size_t k = 0; k < count.size(); ++k) {
+                if (count[k] > 0 && (majority < 0 || count[k] > count[majority]))
+                    majority = static_cast<int32_t>(k);
+            }
+            majority_stale = false;
+        }
+        return majority;
+    }
+};
+
+// read tile t with a halo of r pixels as class indexes (-1 for nodata,
+// outside the raster and values not in the class table)
+bool readClasses_(GDALRasterBandH hBand, const FocalParams &p,
+                  const RasterTile &t, std::vector<double> *buf,
+                  std::vector<int32_t> *idx) {
+
+    const int r = p.radius;
+    const int rxsize = GDALGetRasterBandXSize(hBand);
+    const int rysize = GDALGetRasterBandYSize(hBand);
+    const std::size_t stride = static_cast<std::size_t>(t.xsize) + 2 * r;
+    const std::size_t nrows = static_cast<std::size_t>(t.ysize) + 2 * r;
+    buf->assign(stride * nrows, std::numeric_limits<double>::quiet_NaN());
+
+    const int cx0 = std::max(0, t.xoff - r);
+    const int cy0 = std::max(0, t.yoff - r);
+    const int cx1 = std::min(rxsize, t.xoff + t.xsize + r);
+    const int cy1 = std::min(rysize, t.yoff + t.ysize + r);
+    double *dst = buf->data() + (cy0 - (t.yoff - r)) * stride +
+                  (cx0 - (t.xoff - r));
+    if (GDALRasterIO(hBand, GF_Read, cx0, cy0, cx1 - cx0, cy1 - cy0, dst,
+                     cx1 - cx0, cy1 - cy0, GDT_Float64, 0,
+                     static_cast<int>(stride * sizeof(double))) != CE_None) {
+        return false;
+    }
+
+    int has_nodata = FALSE;
+    const double nodata = GDALGetRasterNoDataValue(hBand, &has_nodata);
+    idx->resize(buf->size());
+    for (std::size_t i = 0; i < buf->size(); ++i) {
+        const double v = (*buf)[i];
+        (*idx)[i] = -1;
+        if (std::isnan(v) || (has_nodata && v == nodata))
+            continue;
+        auto it = std::lower_bound(p.classes.begin(), p.classes.end(), v);
+        if (it != p.classes.end() && *it == v)
+            (*idx)[i] = static_cast<int32_t>(it - p.classes.begin());
+    }
+    return true;
+}
+
+// compute the output bands for tile t, band-sequential in out
+void focalTile_(const FocalParams &p, const RasterTile &t,
+                const std::vector<int32_t> &idx, std::vector<double> *out) {
+
+    const int r = p.radius;
+    const int w = t.xsize;
+    const int h = t.ysize;
+    const std::size_t stride = static_cast<std::size_t>(w) + 2 * r;
+    const std::size_t npx = static_cast<std::size_t>(w) * h;
+    const std::size_t nbands = p.band_stat.size();
+    out->assign(npx * nbands, std::numeric_limits<double>::quiet_NaN());
+
+    // class index at tile column lc + dx, row lr + dy
+    auto at = [&](int lc, int lr) {
+        return idx[(lr + r) * stride + lc + r];
+    };
+
+    WindowHist hist;
+    for (int lr = 0; lr < h; ++lr) {
+        hist.reset(p.classes.size());
+        for (int dy = -r; dy <= r; ++dy) {
+            const int hw = p.half_width[dy + r];
+            for (int dx = -hw; dx <= hw; ++dx)
+                hist.add(p, at(dx, lr + dy));
+        }
+
+        for (int lc = 0; lc < w; ++lc) {
+            if (lc > 0) {
+                for (int dy = -r; dy <= r; ++dy) {
+                    const int hw = p.half_width[dy + r];
+                    hist.remove(p, at(lc - 1 - hw, lr + dy));
+                    hist.add(p, at(lc + hw, lr + dy));
+                }
+            }
+
+            if (at(lc, lr) < 0 || hist.total == 0)
+                continue;
+
+            const std::size_t c = static_cast<std::size_t>(lr) * w + lc;
+            const double total = static_cast<double>(hist.total);
+            for (std::size_t b = 0; b < nbands; ++b) {
+                double v = 0;
+                switch (p.band_stat[b]) {
+                    case FOCAL_MAJORITY:
+                        v = p.classes[hist.getMajority()];
+                        break;
+                    case FOCAL_RICHNESS:
+                        v = hist.richness;
+                        break;
+                    case FOCAL_DIVERSITY:
+                        // H = log(N) - sum(n log n) / N
+                        v = std::max(0.0, std::log(total) -
+                                          hist.sum_nlogn / total);
+                        break;
+                    case FOCAL_PROPORTION:
+                        v = p.band_class[b] < 0 ? 0.0 :
+                            hist.count[p.band_class[b]] / total;
+                        break;
+                }
+                (*out)[b * npx + c] = v;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+//' Sorted distinct values of a raster band (excluding nodata), with an error
+//' if there are more than max_classes
+//' @noRd
+// [[Rcpp::export(name = ".raster_classes")]]
+Rcpp::NumericVector raster_classes(const GDALRaster* const &src_ds, int band,
+                                   int max_classes) {
+
+    GDALRasterBandH hBand = src_ds->getBand_(band);
+    const int xsize = GDALGetRasterBandXSize(hBand);
+    const int ysize = GDALGetRasterBandYSize(hBand);
+    int has_nodata = FALSE;
+    const double nodata = GDALGetRasterNoDataValue(hBand, &has_nodata);
+
+    const int strip_rows = static_cast<int>(std::max<std::size_t>(
+        1, FOCAL_SCAN_MAX_PIXELS / static_cast<std::size_t>(xsize)));
+    std::vector<double> buf;
+    std::set<double> values;
+    for (int y0 = 0; y0 < ysize; y0 += strip_rows) {
+        const int ny = std::min(strip_rows, ysize - y0);
+        buf.resize(static_cast<std::size_t>(xsize) * ny);
+        if (GDALRasterIO(hBand, GF_Read, 0, y0, xsize, ny, buf.data(), xsize,
+                         ny, GDT_Float64, 0, 0) != CE_None) {
+            Rcpp::stop("failed to read the raster");
+        }
+        for (double v : buf) {
+            if (std::isnan(v) || (has_nodata && v == nodata))
+                continue;
+            values.insert(v);
+        }
+        if (values.size() > static_cast<std::size_t>(max_classes)) {
+            Rcpp::stop("the raster has more than " +
+                       std::to_string(max_classes) + " distinct values");
+        }
+        Rcpp::checkUserInterrupt();
+    }
+
+    return Rcpp::NumericVector(values.begin(), values.end());
+}
+
+//' Compute categorical moving-window statistics for a raster band, writing
+//' one statistic per band of dst_ds, processed by tiles
+//' @noRd
+// [[Rcpp::export(name = ".focal_categorical")]]
+bool focal_categorical(const GDALRaster* const &src_ds, int band,
+                       const GDALRaster* const &dst_ds,
+                       const Rcpp::CharacterVector &stats,
+                       const Rcpp::NumericVector &classes,
+                       const Rcpp::NumericVector &band_classes, int radius,
+                       bool square, int tile_size, int num_threads,
+                       bool quiet) {
+
+    dst_ds->checkAccess_(GA_Update);
+    if (src_ds->getGDALDatasetH_() == dst_ds->getGDALDatasetH_())
+        Rcpp::stop("the output must be a different dataset than the source");
+    if (radius < 1)
+        Rcpp::stop("'radius' must be a positive integer");
+    if (tile_size < 1)
+        Rcpp::stop("'tile_size' must be a positive integer");
+    if (stats.size() == 0 || stats.size() != band_classes.size())
+        Rcpp::stop("'stats' and 'band_classes' must have the same length");
+    if (classes.size() == 0)
+        Rcpp::stop("'classes' is empty");
+
+    GDALRasterBandH hSrcBand = src_ds->getBand_(band);
+    const int xsize = GDALGetRasterBandXSize(hSrcBand);
+    const int ysize = GDALGetRasterBandYSize(hSrcBand);
+    std::vector<GDALRasterBandH> dst_bands;
+    for (R_xlen_t b = 0; b < stats.size(); ++b) {
+        GDALRasterBandH hDstBand = dst_ds->getBand_(static_cast<int>(b + 1));
+        if (GDALGetRasterBandXSize(hDstBand) != xsize ||
+                GDALGetRasterBandYSize(hDstBand) != ysize) {
+            Rcpp::stop("the output must have the same raster dimensions as "
+                       "the source");
+        }
+        dst_bands.push_back(hDstBand);
+    }
+
+    FocalParams p;
+    p.radius = radius;
+    p.classes.assign(classes.begin(), classes.end());
+    std::sort(p.classes.begin(), p.classes.end());
+    p.classes.erase(std::unique(p.classes.begin(), p.classes.end()),
+                    p.classes.end());
+
+    for (R_xlen_t b = 0; b < stats.size(); ++b) {
+        const std::string s = Rcpp::as<std::string>(stats[b]);
+        int cls = -1;
+        if (s == "majority") {
+            p.band_stat.push_back(FOCAL_MAJORITY);
+        } else if (s == "richness") {
+            p.band_stat.push_back(FOCAL_RICHNESS);
+        } else if (s == "diversity") {
+            p.band_stat.push_back(FOCAL_DIVERSITY);
+        } else if (s == "proportion") {
+            p.band_stat.push_back(FOCAL_PROPORTION);
+            auto it = std::lower_bound(p.classes.begin(), p.classes.end(),
+                                       band_classes[b]);
+            if (it != p.classes.end() && *it == band_classes[b])
+                cls = static_cast<int>(it - p.classes.begin());
+        } else {
+            Rcpp::stop("unknown statistic: " + s);
+        }
+        p.band_class.push_back(cls);
+    }
+
+    // window shape: the half width of each window row
+    std::size_t window_size = 0;
+    for (int dy = -radius; dy <= radius; ++dy) {
+        int hw = radius;
+        if (!square) {
+            hw = static_cast<int>(std::floor(std::sqrt(
+                static_cast<double>(radius) * radius -
+                static_cast<double>(dy) * dy)));
+        }
+        p.half_width.push_back(hw);
+        window_size += 2 * static_cast<std::size_t>(hw) + 1;
+    }
+    p.nlogn.resize(window_size + 1);
+    p.nlogn[0] = 0.0;
+    for (std::size_t n = 1; n <= window_size; ++n)
+        p.nlogn[n] = n * std::log(static_cast<double>(n));
+
+    int block_xsize = 0;
+    int block_ysize = 0;
+    GDALGetBlockSize(dst_bands[0], &block_xsize, &block_ysize);
+    const std::vector<RasterTile> tiles = makeTiles_(
+        xsize, ysize, tileDim_(tile_size, block_xsize, xsize),
+        tileDim_(tile_size, block_ysize, ysize));
+
+    std::vector<double> dst_nodata;
+    std::vector<int> has_dst_nodata;
+    for (GDALRasterBandH hDstBand : dst_bands) {
+        int has_nodata = FALSE;
+        dst_nodata.push_back(GDALGetRasterNoDataValue(hDstBand,
+                                                      &has_nodata));
+        has_dst_nodata.push_back(has_nodata);
+    }
+
+    const std::size_t batch_size = batchSize_(num_threads, tiles.size());
+    std::vector<std::vector<double>> bufs(batch_size);
+    std::vector<std::vector<int32_t>> idx(batch_size);
+
+    GDALProgressFunc pfnProgress = GDALTermProgressR;
+    if (!quiet)
+        pfnProgress(0, nullptr, nullptr);
+
+    forTileBatches_(tiles.size(), num_threads,
+        [&](std::size_t j, std::size_t i) {
+            if (!readClasses_(hSrcBand, p, tiles[i], &bufs[j], &idx[j]))
+                Rcpp::stop("failed to read raster tile");
+        },
+        [&](std::size_t j, std::size_t i) {
+            // the read buffer is reused for the output
+            focalTile_(p, tiles[i], idx[j], &bufs[j]);
+        },
+        [&](std::size_t j, std::size_t i) {
+            const RasterTile &t = tiles[i];
+            const std::size_t npx = static_cast<std::size_t>(t.xsize) *
+                                    t.ysize;
+            for (std::size_t b = 0; b < dst_bands.size(); ++b) {
+                double *out = bufs[j].data() + b * npx;
+                if (has_dst_nodata[b]) {
+                    for (std::size_t k = 0; k < npx; ++k) {
+                        if (std::isnan(out[k]))
+                            out[k] = dst_nodata[b];
+                    }
+                }
+                if (GDALRasterIO(dst_bands[b], GF_Write, t.xoff, t.yoff,
+                                 t.xsize, t.ysize, out, t.xsize, t.ysize,
+                                 GDT_Float64, 0, 0) != CE_None) {
+                    Rcpp::stop("failed to write raster tile");
+                }
+            }
+            if (!quiet) {
+                pfnProgress(static_cast<double>(i + 1) / tiles.size(),
+                            nullptr, nullptr);
+            }
+        });
+
+    return true;
+}
@@ -0,0 +1,26 @@
+/* Moving-window statistics for categorical rasters (majority, richness,
+   Shannon diversity and class proportions) with incrementally updated
+   window histograms, processed by tiles on multiple threads.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef FOCAL_CATEGORICAL_H_
+#define FOCAL_CATEGORICAL_H_
+
+#include <Rcpp.h>
+
+class GDALRaster;
+Rcpp::NumericVector raster_classes(const GDALRaster* const &src_ds, int band,
+                                   int max_classes);
+
+bool focal_categorical(const GDALRaster* const &src_ds, int band,
+                       const GDALRaster* const &dst_ds,
+                       const Rcpp::CharacterVector &stats,
+                       const Rcpp::NumericVector &classes,
+                       const Rcpp::NumericVector &band_classes, int radius,
+                       bool square, int tile_size, int num_threads,
+                       bool quiet);
+
+#endif  // FOCAL_CATEGORICAL_H_
@@ -28,6 +28,7 @@
 
 #include "gdalraster.h"
 #include "gdal_vsi.h"
+#include "raster_altrep.h"
 #include "rcpp_util.h"
 #include "transform.h"
 
@@ -100,6 +101,7 @@ void gdal_init(DllInfo *dll) {
     GDALAllRegister();
     CPLSetErrorHandler((CPLErrorHandler) gdal_error_handler_r);
     CPLSetConfigOption("OGR_CT_FORCE_TRADITIONAL_GIS_ORDER", "YES");
+    raster_altrep_init(dll);
 }
 
 // Map certain GDAL enums to string names for use in R
@@ -1891,6 +1893,13 @@ SEXP GDALRaster::readChunk(int band,
         chunk_def[5 - adj_for_chunk_x_y]);
 }
 
+SEXP GDALRaster::getVirtualMem(int band, bool as_matrix) const {
+    // the vector owns its own read-only handle on the dataset, so that it
+    // does not depend on the lifetime of this object
+    getBand_(band);
+    return vmem_band_vector_(reopenReadOnly_(), m_fname, band, as_matrix);
+}
+
 void GDALRaster::write(int band, int xoff, int yoff, int xsize, int ysize,
                        const Rcpp::RObject &rasterData) {
 
@@ -2510,6 +2519,29 @@ void GDALRaster::checkAccess_(GDALAccess access_needed) const {
         Rcpp::stop("dataset is read-only");
 }
 
+GDALDatasetH GDALRaster::reopenReadOnly_() const {
+    // a new read-only handle on the dataset (e.g., for objects that must
+    // outlive this one), pending writes are flushed first
+    checkAccess_(GA_ReadOnly);
+    if (m_fname == "" || EQUAL(getDriverShortName().c_str(), "MEM"))
+        Rcpp::stop("requires a dataset opened by filename");
+    if (m_eAccess == GA_Update)
+        GDALFlushCache(m_hDataset);
+
+    std::vector<char *> dsoo;
+    for (R_xlen_t i = 0; i < m_open_options.size(); ++i)
+        dsoo.push_back((char *) m_open_options[i]);
+    dsoo.push_back(nullptr);
+
+    GDALDatasetH hDS = GDALOpenEx(m_fname.c_str(),
+                                  GDAL_OF_RASTER | GDAL_OF_READONLY |
+                                  GDAL_OF_VERBOSE_ERROR,
+                                  nullptr, dsoo.data(), nullptr);
+    if (hDS == nullptr)
+        Rcpp::stop("failed to reopen the dataset: " + m_fname);
+    return hDS;
+}
+
 GDALRasterBandH GDALRaster::getBand_(int band) const {
     if (band < 1 || band > getRasterCount())
         Rcpp::stop("illegal band number");
@@ -2750,6 +2782,8 @@ RCPP_MODULE(mod_GDALRaster) {
         "Read a block of raster data")
     .const_method("readChunk", &GDALRaster::readChunk,
         "Read a multi-block user-defined chunk of raster data")
+    .const_method("getVirtualMem", &GDALRaster::getVirtualMem,
+        "Return a band as an ALTREP vector in GDAL virtual memory")
     .method("write", &GDALRaster::write,
         "Write a region of raster data for a band")
     .method("writeBlock", &GDALRaster::writeBlock,
@@ -147,6 +147,7 @@ class GDALRaster {
     SEXP readBlock(int band, int xblockoff, int yblockoff) const;
 
     SEXP readChunk(int band, const Rcpp::IntegerVector &chunk_def) const;
+    SEXP getVirtualMem(int band, bool as_matrix) const;
 
     void write(int band, int xoff, int yoff, int xsize, int ysize,
                const Rcpp::RObject &rasterData);
@@ -183,6 +184,7 @@ class GDALRaster {
     bool hasInt64_() const;
     void warnInt64_() const;
     GDALDatasetH getGDALDatasetH_() const;
+    GDALDatasetH reopenReadOnly_() const;
     void setGDALDatasetH_(GDALDatasetH hDs);
 
  private:
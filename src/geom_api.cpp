@@ -13,14 +13,25 @@
 
 #include <Rcpp.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "geom_api.h"
 #include "gdalraster.h"
+#include "parallel_util.h"
 #include "rcpp_util.h"
 #include "srs_api.h"
+#include "transform_cache.h"
+#include "wkb_reader.h"
+
+// number of geometries converted per chunk in bulk WKB/WKT conversion
+constexpr std::size_t WK_CONVERT_CHUNK_SIZE = 65536;
 
 
 //' get GEOS version
@@ -136,11 +147,396 @@ bool exportGeomToWkb(OGRGeometryH hGeom, unsigned char *wkb, bool as_iso,
         return true;
 }
 
+// internal, raw WKB references for a raw vector or list of raw vectors
+// (list elements that are not raw vectors give a null reference)
+std::vector<WkbRef> wkbRefsFromRObject_(const Rcpp::RObject &geom) {
+    std::vector<WkbRef> refs;
+
+    if (geom.isNULL())
+        return refs;
+
+    if (Rcpp::is<Rcpp::RawVector>(geom)) {
+        const Rcpp::RawVector v(geom);
+        WkbRef ref;
+        if (v.size() > 0) {
+            ref.data = &v[0];
+            ref.size = static_cast<std::size_t>(v.size());
+        }
+        refs.push_back(ref);
+    }
+    else if (Rcpp::is<Rcpp::List>(geom)) {
+        const Rcpp::List list_in(geom);
+        refs.resize(list_in.size());
+        for (R_xlen_t i = 0; i < list_in.size(); ++i) {
+            SEXP x = list_in[i];
+            if (TYPEOF(x) == RAWSXP && XLENGTH(x) > 0) {
+                refs[i].data = RAW(x);
+                refs[i].size = static_cast<std::size_t>(XLENGTH(x));
+            }
+        }
+    }
+    else {
+        Rcpp::stop("'geom' must be a raw vector or list of raw vectors");
+    }
+
+    return refs;
+}
+
+// internal create OGRGeometryH from a WKB reference, does not call the R API
+// so it can be used on worker threads (returns nullptr on failure)
+OGRGeometryH createGeomFromWkbRef_(const WkbRef &wkb) {
+    if (wkb.data == nullptr || wkb.size == 0)
+        return nullptr;
+
+    OGRGeometryH hGeom = nullptr;
+#if GDAL_VERSION_NUM < GDAL_COMPUTE_VERSION(3, 3, 0)
+    OGRErr err = OGR_G_CreateFromWkb(wkb.data, nullptr, &hGeom,
+                                     static_cast<int>(wkb.size));
+#else
+    OGRErr err = OGR_G_CreateFromWkbEx(wkb.data, nullptr, &hGeom, wkb.size);
+#endif
+    if (err != OGRERR_NONE) {
+        if (hGeom != nullptr)
+            OGR_G_DestroyGeometry(hGeom);
+        return nullptr;
+    }
+
+    return hGeom;
+}
+
+// internal, OGRwkbByteOrder from "LSB" / "MSB"
+OGRwkbByteOrder wkbByteOrderFromString_(const std::string &byte_order) {
+    if (EQUAL(byte_order.c_str(), "LSB"))
+        return wkbNDR;
+    else if (EQUAL(byte_order.c_str(), "MSB"))
+        return wkbXDR;
+    else
+        Rcpp::stop("invalid 'byte_order'");
+}
+
+// internal export OGRGeometryH to a WKB output slot, does not call the R API
+// so it can be used on worker threads
+void exportGeomToWkbOut_(OGRGeometryH hGeom, OGRwkbByteOrder eOrder,
+                         bool as_iso, WkbOut *out) {
+
+    const int nWKBSize = OGR_G_WkbSize(hGeom);
+    if (nWKBSize <= 0) {
+        out->err = WkbOutErr::SIZE_FAILED;
+        return;
+    }
+
+    out->wkb.resize(static_cast<std::size_t>(nWKBSize));
+    OGRErr err = OGRERR_NONE;
+    if (as_iso)
+        err = OGR_G_ExportToIsoWkb(hGeom, eOrder, out->wkb.data());
+    else
+        err = OGR_G_ExportToWkb(hGeom, eOrder, out->wkb.data());
+
+    if (err != OGRERR_NONE) {
+        std::vector<unsigned char>().swap(out->wkb);
+        out->err = WkbOutErr::EXPORT_FAILED;
+    }
+    else {
+        out->err = WkbOutErr::NONE;
+    }
+}
+
+// internal, copy WKB output slots to a list of raw vectors on the calling
+// thread, releasing each slot as it is copied
+// warnings are emitted in input order, with the same messages as the scalar
+// geometry functions (op_msg for failure of the operation itself)
+Rcpp::List wkbOutToList_(std::vector<WkbOut> *out, const std::string &op_msg,
+                         bool quiet) {
+
+    Rcpp::List list_out(out->size());
+
+    for (std::size_t i = 0; i < out->size(); ++i) {
+        WkbOut &slot = (*out)[i];
+        switch (slot.err) {
+            case WkbOutErr::NONE:
+            {
+                Rcpp::RawVector wkb = Rcpp::no_init(slot.wkb.size());
+                std::copy(slot.wkb.begin(), slot.wkb.end(), wkb.begin());
+                list_out[i] = wkb;
+                std::vector<unsigned char>().swap(slot.wkb);
+            }
+            break;
+
+            case WkbOutErr::NULL_INPUT:
+                list_out[i] = R_NilValue;
+            break;
+
+            case WkbOutErr::CREATE_FAILED:
+                if (!quiet) {
+                    Rcpp::warning("failed to create geometry object from "
+                                  "WKB, NULL returned");
+                }
+                list_out[i] = R_NilValue;
+            break;
+
+            case WkbOutErr::OP_FAILED:
+                if (!quiet)
+                    Rcpp::warning(op_msg);
+                list_out[i] = R_NilValue;
+            break;
+
+            case WkbOutErr::SIZE_FAILED:
+                if (!quiet) {
+                    Rcpp::warning(
+                        "failed to obtain WKB size of output geometry");
+                }
+                list_out[i] = R_NilValue;
+            break;
+
+            case WkbOutErr::EXPORT_FAILED:
+                if (!quiet) {
+                    Rcpp::warning(
+                        "failed to export WKB raw vector for output geometry");
+                }
+                list_out[i] = R_NilValue;
+            break;
+        }
+    }
+
+    return list_out;
+}
+
+// internal, apply a unary geometry operation to each input WKB on
+// num_threads threads (GDAL creates a GEOS context per operation, so GEOS
+// based operations are safe to call concurrently on separate geometries)
+// op(t, hGeom) receives the index t of the worker thread for selecting
+// per-thread objects, and returns a new geometry owned by the caller or
+// nullptr on failure
+// results go to preallocated slots so that output order is the input order
+// and output is identical regardless of the number of threads
+template <typename Op>
+std::vector<WkbOut> unaryOpWkb_(const std::vector<WkbRef> &refs, Op op,
+                                bool as_iso, OGRwkbByteOrder eOrder,
+                                int num_threads) {
+
+    std::vector<WkbOut> out(refs.size());
+
+    auto task = [&](int t, std::size_t i) {
+        if (refs[i].data == nullptr)
+            return;
+
+        OGRGeometryH hGeom = createGeomFromWkbRef_(refs[i]);
+        if (hGeom == nullptr) {
+            out[i].err = WkbOutErr::CREATE_FAILED;
+            return;
+        }
+
+        OGRGeometryH hGeomOut = op(t, hGeom);
+        OGR_G_DestroyGeometry(hGeom);
+        if (hGeomOut == nullptr) {
+            out[i].err = WkbOutErr::OP_FAILED;
+            return;
+        }
+
+        exportGeomToWkbOut_(hGeomOut, eOrder, as_iso, &out[i]);
+        OGR_G_DestroyGeometry(hGeomOut);
+    };
+
+    parallel_for_indexed_(refs.size(), num_threads, task, 8);
+
+    return out;
+}
+
+// internal visitors for scanning WKB directly with WkbReader (wkb_reader.h)
+// they give the same result as the corresponding OGR function for the
+// geometry types that WkbReader handles, or fail the scan in cases where
+// that could differ so that the caller falls back to OGR
+
+// geometry type, OGR_G_GetGeometryCount() and OGR_G_IsEmpty()
+struct WkbInfoVisitor {
+    WkbHeader hdr;
+    uint32_t count = 0;
+    bool is_empty = true;
+
+    bool geometryStart(const WkbHeader &h, uint32_t size, int depth) {
+        if (depth == 0) {
+            hdr = h;
+            if (h.type != WKB_POINT && h.type != WKB_LINESTRING)
+                count = size;
+        }
+        return true;
+    }
+
+    bool ringStart(const WkbHeader &, uint32_t) {
+        return true;
+    }
+
+    bool coord(const WkbHeader &h, const double *xyzm) {
+        // OGR reads a point with NaN x and y as POINT EMPTY
+        if (h.type != WKB_POINT || !std::isnan(xyzm[0]) ||
+                !std::isnan(xyzm[1])) {
+            is_empty = false;
+        }
+        return true;
+    }
+};
+
+// OGR_G_GetEnvelope3D(), fails on empty geometries and NaN coordinates
+struct WkbEnvelopeVisitor {
+    double env[6] = {std::numeric_limits<double>::infinity(),
+                     -std::numeric_limits<double>::infinity(),
+                     std::numeric_limits<double>::infinity(),
+                     -std::numeric_limits<double>::infinity(),
+                     std::numeric_limits<double>::infinity(),
+                     -std::numeric_limits<double>::infinity()};
+    bool is_empty = true;
+
+    bool geometryStart(const WkbHeader &, uint32_t, int) {
+        return true;
+    }
+
+    bool ringStart(const WkbHeader &, uint32_t) {
+        return true;
+    }
+
+    bool coord(const WkbHeader &h, const double *xyzm) {
+        if (h.type == WKB_POINT && std::isnan(xyzm[0]) &&
+                std::isnan(xyzm[1])) {
+            return true;
+        }
+        // OGR gives Z = 0 for 2D parts
+        const double z = h.has_z ? xyzm[2] : 0.0;
+        if (std::isnan(xyzm[0]) || std::isnan(xyzm[1]) || std::isnan(z))
+            return false;
+
+        env[0] = std::min(env[0], xyzm[0]);
+        env[1] = std::max(env[1], xyzm[0]);
+        env[2] = std::min(env[2], xyzm[1]);
+        env[3] = std::max(env[3], xyzm[1]);
+        env[4] = std::min(env[4], z);
+        env[5] = std::max(env[5], z);
+        is_empty = false;
+        return true;
+    }
+};
+
+// vertices in the layout of wk::wk_coords(): feature_id is the 1-based input
+// index, and part_id / ring_id are running counts of geometries / rings
+// across all of the input (wk counts every geometry including collections)
+struct WkbCoordsVisitor {
+    int feature_id = 0;
+    int part_id = 0;
+    int ring_id = 0;
+    bool any_z = false;
+    bool any_m = false;
+    std::vector<int> fid {};
+    std::vector<int> pid {};
+    std::vector<int> rid {};
+    std::vector<double> x {};
+    std::vector<double> y {};
+    std::vector<double> z {};
+    std::vector<double> m {};
+
+    bool geometryStart(const WkbHeader &, uint32_t, int) {
+        part_id += 1;
+        return true;
+    }
+
+    bool ringStart(const WkbHeader &, uint32_t) {
+        ring_id += 1;
+        return true;
+    }
+
+    bool coord(const WkbHeader &h, const double *xyzm) {
+        // wk reads a point with all NaN coordinates as POINT EMPTY
+        if (h.type == WKB_POINT && std::isnan(xyzm[0]) &&
+                std::isnan(xyzm[1]) && (!h.has_z || std::isnan(xyzm[2])) &&
+                (!h.has_m || std::isnan(xyzm[3]))) {
+            return true;
+        }
+
+        fid.push_back(feature_id);
+        pid.push_back(part_id);
+        rid.push_back(ring_id);
+        x.push_back(xyzm[0]);
+        y.push_back(xyzm[1]);
+        z.push_back(h.has_z ? xyzm[2] : NA_REAL);
+        m.push_back(h.has_m ? xyzm[3] : NA_REAL);
+        any_z = any_z || h.has_z;
+        any_m = any_m || h.has_m;
+        return true;
+    }
+};
+
+template <class Visitor>
+bool scanWkb_(const WkbRef &ref, Visitor *visitor) {
+    if (ref.data == nullptr)
+        return false;
+    WkbReader reader(ref.data, ref.size);
+    return reader.walk(visitor);
+}
+
+// internal, WkbRef for an R object that is known to be a raw vector
+WkbRef wkbRefFromRaw_(const Rcpp::RawVector &v) {
+    WkbRef ref;
+    if (v.size() > 0) {
+        ref.data = &v[0];
+        ref.size = static_cast<std::size_t>(v.size());
+    }
+    return ref;
+}
+
+// internal, element i of the input to wkbRefsFromRObject_() (a raw vector or
+// list of raw vectors)
+Rcpp::RObject wkbElement_(const Rcpp::RObject &geom, R_xlen_t i) {
+    if (Rcpp::is<Rcpp::RawVector>(geom))
+        return geom;
+    else
+        return VECTOR_ELT(geom, i);
+}
+
+// internal, WKT string for a geometry, with coordinates optionally written
+// with a fixed number of decimal places (precision < 0 for the OGR default)
+// does not call the R API so it can be used on worker threads
+// returns false on failure
+bool exportGeomToWkt_(OGRGeometryH hGeom, bool as_iso, int precision,
+                      std::string *wkt) {
+
+    if (precision < 0) {
+        char *pszWKT_out = nullptr;
+        OGRErr err = OGRERR_NONE;
+        if (as_iso)
+            err = OGR_G_ExportToIsoWkt(hGeom, &pszWKT_out);
+        else
+            err = OGR_G_ExportToWkt(hGeom, &pszWKT_out);
+
+        if (pszWKT_out != nullptr) {
+            *wkt = pszWKT_out;
+            CPLFree(pszWKT_out);
+        }
+        else {
+            wkt->clear();
+        }
+        return err == OGRERR_NONE;
+    }
+
+    OGRWktOptions opt;
+    opt.variant = as_iso ? wkbVariantIso : wkbVariantOldOgc;
+    opt.format = OGRWktFormat::F;
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 9, 0)
+    opt.xyPrecision = precision;
+    opt.zPrecision = precision;
+    opt.mPrecision = precision;
+#else
+    opt.precision = precision;
+#endif
+
+    OGRErr err = OGRERR_NONE;
+    *wkt = OGRGeometry::FromHandle(hGeom)->exportToWkt(opt, &err);
+    return err == OGRERR_NONE;
+}
+
 // WKB raw vector to WKT string
 //
 //' @noRd
 // [[Rcpp::export(name = ".g_wkb2wkt")]]
-Rcpp::String g_wkb2wkt(const Rcpp::RObject &geom, bool as_iso = false) {
+Rcpp::String g_wkb2wkt(const Rcpp::RObject &geom, bool as_iso = false,
+                       int precision = -1) {
 
     if (geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(geom))
         return NA_STRING;
@@ -149,53 +545,108 @@ Rcpp::String g_wkb2wkt(const Rcpp::RObject &geom, bool as_iso = false) {
     if (geom_in.size() == 0)
         return NA_STRING;
 
-    OGRGeometryH hGeom = createGeomFromWkb(geom_in);
-    if (hGeom == nullptr)
+    OGRGeomPtr_ geom_ptr(createGeomFromWkb(geom_in));
+    if (geom_ptr == nullptr)
         Rcpp::stop("failed to create geometry object from WKB");
 
-    char *pszWKT_out = nullptr;
-    if (as_iso)
-        OGR_G_ExportToIsoWkt(hGeom, &pszWKT_out);
-    else
-        OGR_G_ExportToWkt(hGeom, &pszWKT_out);
-
     std::string wkt_out = "";
-    if (pszWKT_out != nullptr) {
-        wkt_out = pszWKT_out;
-        CPLFree(pszWKT_out);
+    if (!exportGeomToWkt_(geom_ptr.get(), as_iso, precision, &wkt_out)) {
+        Rcpp::warning("failed to export WKT string, NA returned");
+        return NA_STRING;
     }
 
-    OGR_G_DestroyGeometry(hGeom);
-
     return wkt_out;
 }
 
 // list of WKB raw vectors to character vector of WKT strings
+// Geometries are converted in chunks on num_threads threads. Output strings
+// are created on the calling thread after each chunk, so memory use for
+// intermediate WKT is bounded by the chunk size.
 //
 //' @noRd
 // [[Rcpp::export(name = ".g_wkb_list2wkt")]]
 Rcpp::CharacterVector g_wkb_list2wkt(const Rcpp::List &geom,
-                                     bool as_iso = false) {
+                                     bool as_iso = false,
+                                     int precision = -1,
+                                     int num_threads = 1) {
 
     if (geom.size() == 0)
         Rcpp::stop("'geom' is empty");
 
-    Rcpp::CharacterVector wkt = Rcpp::no_init(geom.size());
-    for (R_xlen_t i = 0; i < geom.size(); ++i) {
-        if (!Rcpp::is<Rcpp::RawVector>(geom[i])) {
-            Rcpp::warning("an input list element is not a raw vector");
-            wkt[i] = NA_STRING;
+    const std::size_t n = static_cast<std::size_t>(geom.size());
+
+    // input classified on the calling thread:
+    // 0 = raw vector, 1 = not a raw vector, 2 = length-0 raw vector
+    std::vector<WkbRef> refs(n);
+    std::vector<int> input_err(n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        SEXP x = VECTOR_ELT(geom, i);
+        if (TYPEOF(x) != RAWSXP) {
+            input_err[i] = 1;
+        }
+        else if (XLENGTH(x) == 0) {
+            input_err[i] = 2;
         }
         else {
-            const Rcpp::RawVector v = Rcpp::as<Rcpp::RawVector>(geom[i]);
-            if (v.size() > 0) {
-                wkt[i] = g_wkb2wkt(v, as_iso);
+            refs[i].data = RAW(x);
+            refs[i].size = static_cast<std::size_t>(XLENGTH(x));
+        }
+    }
+
+    Rcpp::CharacterVector wkt = Rcpp::no_init(geom.size());
+
+    std::vector<std::string> wkt_chunk;
+    std::vector<char> created;
+    std::vector<char> exported;
+    for (std::size_t begin = 0; begin < n; begin += WK_CONVERT_CHUNK_SIZE) {
+        const std::size_t end = std::min(n, begin + WK_CONVERT_CHUNK_SIZE);
+        wkt_chunk.assign(end - begin, std::string());
+        created.assign(end - begin, 1);
+        exported.assign(end - begin, 1);
+
+        auto task = [&](std::size_t k) {
+            const std::size_t i = begin + k;
+            if (refs[i].data == nullptr)
+                return;
+
+            OGRGeomPtr_ geom_ptr(createGeomFromWkbRef_(refs[i]));
+            if (geom_ptr == nullptr) {
+                created[k] = 0;
+                return;
             }
-            else {
+            exported[k] = exportGeomToWkt_(geom_ptr.get(), as_iso, precision,
+                                           &wkt_chunk[k]);
+        };
+
+        parallel_for_(end - begin, num_threads, task, 64);
+
+        for (std::size_t k = 0; k < end - begin; ++k) {
+            const std::size_t i = begin + k;
+            if (input_err[i] == 1) {
+                Rcpp::warning("an input list element is not a raw vector");
+                wkt[i] = NA_STRING;
+            }
+            else if (input_err[i] == 2) {
                 Rcpp::warning("an input list element is a length-0 raw vector");
                 wkt[i] = NA_STRING;
             }
+            else if (!created[k]) {
+                Rcpp::stop("failed to create geometry object from WKB");
+            }
+            else if (!exported[k]) {
+                Rcpp::warning("failed to export WKT string, NA returned");
+                wkt[i] = NA_STRING;
+            }
+            else {
+                SET_STRING_ELT(wkt, i,
+                               Rf_mkCharLenCE(
+                                   wkt_chunk[k].c_str(),
+                                   static_cast<int>(wkt_chunk[k].size()),
+                                   CE_UTF8));
+            }
+            std::string().swap(wkt_chunk[k]);
         }
+        Rcpp::checkUserInterrupt();
     }
 
     return wkt;
@@ -249,26 +700,118 @@ SEXP g_wkt2wkb(const std::string &geom, bool as_iso = false,
 }
 
 // vector of WKT strings to list of WKB raw vectors
+// Geometries are converted in chunks. Within a chunk, the WKT is parsed and
+// the WKB sizes are computed on num_threads threads, output raw vectors are
+// then allocated on the calling thread, and the WKB is written directly into
+// them on the worker threads.
 //
 //' @noRd
 // [[Rcpp::export(name = ".g_wkt_vector2wkb")]]
 Rcpp::List g_wkt_vector2wkb(const Rcpp::CharacterVector &geom,
                             bool as_iso = false,
-                            const std::string &byte_order = "LSB") {
+                            const std::string &byte_order = "LSB",
+                            int num_threads = 1) {
 
     if (geom.size() == 0)
         Rcpp::stop("'geom' is empty");
 
-    Rcpp::List wkb = Rcpp::no_init(geom.size());
-    for (R_xlen_t i = 0; i < geom.size(); ++i) {
-        if (Rcpp::CharacterVector::is_na(geom[i]) || EQUAL(geom[i], "")) {
-            Rcpp::warning("an input vector element is NA or empty string");
-            wkb[i] = R_NilValue;
+    const OGRwkbByteOrder eOrder = wkbByteOrderFromString_(byte_order);
+    const std::size_t n = static_cast<std::size_t>(geom.size());
+
+    // input strings, nullptr for NA or empty string
+    std::vector<const char *> wkt_in(n, nullptr);
+    for (std::size_t i = 0; i < n; ++i) {
+        SEXP x = STRING_ELT(geom, i);
+        if (x != NA_STRING && LENGTH(x) > 0)
+            wkt_in[i] = CHAR(x);
+    }
+
+    Rcpp::List wkb(geom.size());
+
+    std::vector<OGRGeomPtr_> geoms;
+    std::vector<int> sizes;
+    std::vector<unsigned char *> dst;
+    std::vector<char> exported;
+    for (std::size_t begin = 0; begin < n; begin += WK_CONVERT_CHUNK_SIZE) {
+        const std::size_t end = std::min(n, begin + WK_CONVERT_CHUNK_SIZE);
+        geoms.clear();
+        geoms.resize(end - begin);
+        sizes.assign(end - begin, 0);
+        dst.assign(end - begin, nullptr);
+        exported.assign(end - begin, 0);
+
+        // parse and size
+        auto parse_task = [&](std::size_t k) {
+            const std::size_t i = begin + k;
+            if (wkt_in[i] == nullptr)
+                return;
+
+            char *pszWKT = const_cast<char *>(wkt_in[i]);
+            OGRGeometryH hGeom = nullptr;
+            if (OGR_G_CreateFromWkt(&pszWKT, nullptr, &hGeom) !=
+                    OGRERR_NONE) {
+                if (hGeom != nullptr)
+                    OGR_G_DestroyGeometry(hGeom);
+                return;
+            }
+            geoms[k].reset(hGeom);
+            if (hGeom != nullptr)
+                sizes[k] = OGR_G_WkbSize(hGeom);
+        };
+
+        parallel_for_(end - begin, num_threads, parse_task, 64);
+
+        // allocate output on the calling thread, with warnings and errors in
+        // input order
+        for (std::size_t k = 0; k < end - begin; ++k) {
+            const std::size_t i = begin + k;
+            std::string err_msg = "";
+            if (wkt_in[i] == nullptr) {
+                Rcpp::warning("an input vector element is NA or empty string");
+                continue;
+            }
+            else if (geoms[k] == nullptr) {
+                err_msg = "failed to create geometry object from WKT string";
+            }
+            else if (sizes[k] == 0) {
+                err_msg = "failed to obtain WKB size of geometry object";
+            }
+
+            if (err_msg != "")
+                Rcpp::stop(err_msg);
+
+            if (OGR_G_GetGeometryType(geoms[k].get()) == wkbPoint &&
+                    OGR_G_IsEmpty(geoms[k].get())) {
+                Rcpp::warning(
+                    "POINT EMPTY is exported to WKB as if it were POINT(0 0)");
+            }
+
+            Rcpp::RawVector v = Rcpp::no_init(sizes[k]);
+            wkb[i] = v;
+            dst[k] = RAW(v);
         }
-        else {
-            wkb[i] = g_wkt2wkb(Rcpp::as<std::string>(geom[i]), as_iso,
-                               byte_order);
+
+        // export directly into the output raw vectors
+        auto export_task = [&](std::size_t k) {
+            if (geoms[k] == nullptr)
+                return;
+
+            OGRErr err = OGRERR_NONE;
+            if (as_iso)
+                err = OGR_G_ExportToIsoWkb(geoms[k].get(), eOrder, dst[k]);
+            else
+                err = OGR_G_ExportToWkb(geoms[k].get(), eOrder, dst[k]);
+            exported[k] = (err == OGRERR_NONE);
+            geoms[k].reset();
+        };
+
+        parallel_for_(end - begin, num_threads, export_task, 64);
+
+        for (std::size_t k = 0; k < end - begin; ++k) {
+            if (wkt_in[begin + k] != nullptr && !exported[k])
+                Rcpp::stop("failed to export WKB raw vector");
         }
+        Rcpp::checkUserInterrupt();
     }
 
     return wkb;
@@ -560,6 +1103,10 @@ int g_geom_count(const Rcpp::RObject &geom, bool quiet = false) {
     if (geom_in.size() == 0)
         return ret;
 
+    WkbInfoVisitor info;
+    if (scanWkb_(wkbRefFromRaw_(geom_in), &info))
+        return static_cast<int>(info.count);
+
     OGRGeometryH hGeom = createGeomFromWkb(geom_in);
 
     if (hGeom == nullptr) {
@@ -575,6 +1122,27 @@ int g_geom_count(const Rcpp::RObject &geom, bool quiet = false) {
     return ret;
 }
 
+//' @noRd
+// [[Rcpp::export(name = ".g_geom_count_vec")]]
+Rcpp::IntegerVector g_geom_count_vec(const Rcpp::RObject &geom,
+                                     bool quiet = false) {
+// g_geom_count() for a list of WKB geometries
+
+    const std::vector<WkbRef> refs = wkbRefsFromRObject_(geom);
+    Rcpp::IntegerVector ret(refs.size());
+    for (std::size_t i = 0; i < refs.size(); ++i) {
+        WkbInfoVisitor info;
+        if (refs[i].data == nullptr)
+            ret[i] = 0;
+        else if (scanWkb_(refs[i], &info))
+            ret[i] = static_cast<int>(info.count);
+        else
+            ret[i] = g_geom_count(wkbElement_(geom, i), quiet);
+    }
+
+    return ret;
+}
+
 //' @noRd
 // [[Rcpp::export(name = ".g_get_geom")]]
 SEXP g_get_geom(const Rcpp::RawVector &container, int sub_geom_idx,
@@ -676,28 +1244,11 @@ Rcpp::LogicalVector g_is_valid(const Rcpp::RObject &geom,
     return ret;
 }
 
-//' @noRd
-// [[Rcpp::export(name = ".g_make_valid")]]
-SEXP g_make_valid(const Rcpp::RObject &geom,
-                  const std::string &method = "LINEWORK",
-                  bool keep_collapsed = false,
-                  bool as_iso = false,
-                  const std::string &byte_order = "LSB",
-                  bool quiet = false) {
-
-// Attempts to make an invalid geometry valid without losing vertices.
-// Already-valid geometries are cloned without further intervention.
-// Running OGRGeometryFactory::removeLowerDimensionSubGeoms() as a
-// post-processing step is often desired.
-// This function is built on the GEOS >= 3.8 library, check it for the
-// definition of the geometry operation.
-
-    if (geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(geom))
-        return R_NilValue;
-
-    const Rcpp::RawVector geom_in(geom);
-    if (geom_in.size() == 0)
-        return geom_in;
+// internal, options for OGR_G_MakeValidEx() with warnings for unsupported
+// methods, use_make_valid_ex is set to FALSE if GEOS < 3.10
+std::vector<const char *> makeValidOptions_(const std::string &method,
+                                            bool keep_collapsed, bool quiet,
+                                            bool *use_make_valid_ex) {
 
     int geos_maj_ver = getGEOSVersion()[0];
     int geos_min_ver = getGEOSVersion()[1];
@@ -757,6 +1308,37 @@ SEXP g_make_valid(const Rcpp::RObject &geom,
     opt.push_back(nullptr);
     // end options
 
+    *use_make_valid_ex = geos_3_10_min;
+    return opt;
+}
+
+//' @noRd
+// [[Rcpp::export(name = ".g_make_valid")]]
+SEXP g_make_valid(const Rcpp::RObject &geom,
+                  const std::string &method = "LINEWORK",
+                  bool keep_collapsed = false,
+                  bool as_iso = false,
+                  const std::string &byte_order = "LSB",
+                  bool quiet = false) {
+
+// Attempts to make an invalid geometry valid without losing vertices.
+// Already-valid geometries are cloned without further intervention.
+// Running OGRGeometryFactory::removeLowerDimensionSubGeoms() as a
+// post-processing step is often desired.
+// This function is built on the GEOS >= 3.8 library, check it for the
+// definition of the geometry operation.
+
+    if (geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(geom))
+        return R_NilValue;
+
+    const Rcpp::RawVector geom_in(geom);
+    if (geom_in.size() == 0)
+        return geom_in;
+
+    bool geos_3_10_min = false;
+    std::vector<const char *> opt = makeValidOptions_(method, keep_collapsed,
+                                                      quiet, &geos_3_10_min);
+
     OGRGeometryH hGeom = createGeomFromWkb(geom_in);
     if (hGeom == nullptr) {
         if (!quiet) {
@@ -810,6 +1392,51 @@ SEXP g_make_valid(const Rcpp::RObject &geom,
     return wkb;
 }
 
+// make valid over a list of WKB geometries, optionally multithreaded
+//' @noRd
+// [[Rcpp::export(name = ".g_make_valid_vec")]]
+Rcpp::List g_make_valid_vec(const Rcpp::RObject &geom,
+                            const std::string &method = "LINEWORK",
+                            bool keep_collapsed = false,
+                            bool as_iso = false,
+                            const std::string &byte_order = "LSB",
+                            bool quiet = false, int num_threads = 1) {
+
+    const std::vector<WkbRef> refs = wkbRefsFromRObject_(geom);
+    const OGRwkbByteOrder eOrder = wkbByteOrderFromString_(byte_order);
+
+    bool geos_3_10_min = false;
+    std::vector<const char *> opt = makeValidOptions_(method, keep_collapsed,
+                                                      quiet, &geos_3_10_min);
+
+    auto op = [&](int, OGRGeometryH hGeom) -> OGRGeometryH {
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 4, 0)
+        if (geos_3_10_min)
+            return OGR_G_MakeValidEx(hGeom, opt.data());
+#endif
+        return OGR_G_MakeValid(hGeom);
+    };
+
+    std::vector<WkbOut> out = unaryOpWkb_(refs, op, as_iso, eOrder,
+                                          num_threads);
+
+    Rcpp::List list_out = wkbOutToList_(&out,
+                                        "OGR MakeValid() gave NULL geometry",
+                                        quiet);
+
+    // an empty raw vector is returned unchanged, as in g_make_valid()
+    if (Rcpp::is<Rcpp::List>(geom)) {
+        const Rcpp::List list_in(geom);
+        for (R_xlen_t i = 0; i < list_in.size(); ++i) {
+            SEXP x = list_in[i];
+            if (TYPEOF(x) == RAWSXP && XLENGTH(x) == 0)
+                list_out[i] = x;
+        }
+    }
+
+    return list_out;
+}
+
 //' @noRd
 // [[Rcpp::export(name = ".g_normalize")]]
 SEXP g_normalize(const Rcpp::RObject &geom, bool as_iso,
@@ -1074,6 +1701,10 @@ Rcpp::LogicalVector g_is_empty(const Rcpp::RObject &geom,
     if (geom_in.size() == 0)
         return Rcpp::LogicalVector::create(NA_LOGICAL);
 
+    WkbInfoVisitor info;
+    if (scanWkb_(wkbRefFromRaw_(geom_in), &info))
+        return Rcpp::LogicalVector::create(info.is_empty);
+
     OGRGeometryH hGeom = createGeomFromWkb(geom_in);
 
     if (hGeom == nullptr) {
@@ -1090,6 +1721,27 @@ Rcpp::LogicalVector g_is_empty(const Rcpp::RObject &geom,
     return ret;
 }
 
+//' @noRd
+// [[Rcpp::export(name = ".g_is_empty_vec")]]
+Rcpp::LogicalVector g_is_empty_vec(const Rcpp::RObject &geom,
+                                   bool quiet = false) {
+// g_is_empty() for a list of WKB geometries
+
+    const std::vector<WkbRef> refs = wkbRefsFromRObject_(geom);
+    Rcpp::LogicalVector ret(refs.size());
+    for (std::size_t i = 0; i < refs.size(); ++i) {
+        WkbInfoVisitor info;
+        if (refs[i].data == nullptr)
+            ret[i] = NA_LOGICAL;
+        else if (scanWkb_(refs[i], &info))
+            ret[i] = info.is_empty;
+        else
+            ret[i] = g_is_empty(wkbElement_(geom, i), quiet)[0];
+    }
+
+    return ret;
+}
+
 //' @noRd
 // [[Rcpp::export(name = ".g_is_3D")]]
 Rcpp::LogicalVector g_is_3D(const Rcpp::RObject &geom,
@@ -1191,6 +1843,10 @@ Rcpp::String g_name(const Rcpp::RObject &geom, bool quiet = false) {
     if (geom_in.size() == 0)
         return NA_STRING;
 
+    WkbInfoVisitor info;
+    if (scanWkb_(wkbRefFromRaw_(geom_in), &info))
+        return wkbTypeName_(info.hdr.type);
+
     OGRGeometryH hGeom = createGeomFromWkb(geom_in);
 
     if (hGeom == nullptr) {
@@ -1207,6 +1863,27 @@ Rcpp::String g_name(const Rcpp::RObject &geom, bool quiet = false) {
     return ret;
 }
 
+//' @noRd
+// [[Rcpp::export(name = ".g_name_vec")]]
+Rcpp::CharacterVector g_name_vec(const Rcpp::RObject &geom,
+                                 bool quiet = false) {
+// g_name() for a list of WKB geometries
+
+    const std::vector<WkbRef> refs = wkbRefsFromRObject_(geom);
+    Rcpp::CharacterVector ret(refs.size());
+    for (std::size_t i = 0; i < refs.size(); ++i) {
+        WkbInfoVisitor info;
+        if (refs[i].data == nullptr)
+            ret[i] = NA_STRING;
+        else if (scanWkb_(refs[i], &info))
+            ret[i] = wkbTypeName_(info.hdr.type);
+        else
+            ret[i] = g_name(wkbElement_(geom, i), quiet);
+    }
+
+    return ret;
+}
+
 //' @noRd
 // [[Rcpp::export(name = ".g_summary")]]
 Rcpp::String g_summary(const Rcpp::RObject &geom, bool quiet = false) {
@@ -1232,507 +1909,368 @@ Rcpp::String g_summary(const Rcpp::RObject &geom, bool quiet = false) {
         return NA_STRING;
     }
 
-    const auto poGeom = std::unique_ptr<OGRGeometry>(
-        OGRGeometry::FromHandle(hGeom));
-
-    std::vector<const char *> options = {"DISPLAY_GEOMETRY=SUMMARY", nullptr};
-    CPLString s = poGeom->dumpReadable(nullptr, options.data());
-    s.replaceAll('\n', ' ');
-    std::string ret = s.Trim();
-    return ret;
-#endif
-}
-
-//' @noRd
-// [[Rcpp::export(name = ".g_envelope")]]
-Rcpp::NumericVector g_envelope(const Rcpp::RObject &geom, bool as_3d = false,
-                               bool quiet = false) {
-// Computes and returns the bounding envelope for this geometry.
-
-    if (geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(geom))
-        return Rcpp::NumericVector::create(NA_REAL, NA_REAL, NA_REAL, NA_REAL);
-
-    const Rcpp::RawVector geom_in(geom);
-    if (geom_in.size() == 0)
-        return Rcpp::NumericVector::create(NA_REAL, NA_REAL, NA_REAL, NA_REAL);
-
-    OGRGeometryH hGeom = createGeomFromWkb(geom_in);
-
-    if (hGeom == nullptr) {
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
-        }
-        return Rcpp::NumericVector::create(NA_REAL, NA_REAL, NA_REAL, NA_REAL);
-    }
-
-    Rcpp::NumericVector ret;
-    if (as_3d) {
-        OGREnvelope3D sEnv3D;
-        OGR_G_GetEnvelope3D(hGeom, &sEnv3D);
-        double minZ = NA_REAL;
-        double maxZ = NA_REAL;
-        if (!std::isinf(sEnv3D.MinZ))
-            minZ = sEnv3D.MinZ;
-        if (!std::isinf(sEnv3D.MaxZ))
-            maxZ = sEnv3D.MaxZ;
-
-        ret = {sEnv3D.MinX, sEnv3D.MaxX,
-               sEnv3D.MinY, sEnv3D.MaxY,
-               minZ, maxZ};
-    }
-    else {
-        OGREnvelope sEnv;
-        OGR_G_GetEnvelope(hGeom, &sEnv);
-        ret = {sEnv.MinX, sEnv.MaxX, sEnv.MinY, sEnv.MaxY};
-    }
-
-    OGR_G_DestroyGeometry(hGeom);
-    return ret;
-}
-
-
-// *** binary predicates ***
-
-
-//' @noRd
-// [[Rcpp::export(name = ".g_intersects")]]
-Rcpp::LogicalVector g_intersects(const Rcpp::RObject &this_geom,
-                                 const Rcpp::RObject &other_geom,
-                                 bool quiet = false) {
-// Determines whether two geometries intersect. If GEOS is enabled, then this
-// is done in rigorous fashion otherwise TRUE is returned if the envelopes
-// (bounding boxes) of the two geometries overlap.
-
-    if (this_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(this_geom))
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-
-    const Rcpp::RawVector this_geom_in(this_geom);
-    if (this_geom_in.size() == 0)
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-
-    OGRGeometryH hGeom_this = createGeomFromWkb(this_geom_in);
-    if (hGeom_this == nullptr) {
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
-        }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    if (other_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(other_geom)) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    const Rcpp::RawVector other_geom_in(other_geom);
-    if (other_geom_in.size() == 0) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    OGRGeometryH hGeom_other = createGeomFromWkb(other_geom_in);
-    if (hGeom_other == nullptr) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
-        }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    bool ret = OGR_G_Intersects(hGeom_this, hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_this);
-    return ret;
-}
-
-//' @noRd
-// [[Rcpp::export(name = ".g_equals")]]
-Rcpp::LogicalVector g_equals(const Rcpp::RObject &this_geom,
-                             const Rcpp::RObject &other_geom,
-                             bool quiet = false) {
-// Returns TRUE if two geometries are equivalent.
-// This operation implements the SQL/MM ST_OrderingEquals() operation.
-// The comparison is done in a structural way, that is to say that the
-// geometry types must be identical, as well as the number and ordering of
-// sub-geometries and vertices. Or equivalently, two geometries are
-// considered equal by this method if their WKT/WKB representation is equal.
-// Note: this must be distinguished from equality in a spatial way.
-
-    if (this_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(this_geom))
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-
-    const Rcpp::RawVector this_geom_in(this_geom);
-    if (this_geom_in.size() == 0)
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-
-    OGRGeometryH hGeom_this = createGeomFromWkb(this_geom_in);
-    if (hGeom_this == nullptr) {
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
-        }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    if (other_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(other_geom)) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    const Rcpp::RawVector other_geom_in(other_geom);
-    if (other_geom_in.size() == 0) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    OGRGeometryH hGeom_other = createGeomFromWkb(other_geom_in);
-    if (hGeom_other == nullptr) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
-        }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    bool ret = OGR_G_Equals(hGeom_this, hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_this);
-    return ret;
-}
-
-//' @noRd
-// [[Rcpp::export(name = ".g_disjoint")]]
-Rcpp::LogicalVector g_disjoint(const Rcpp::RObject &this_geom,
-                               const Rcpp::RObject &other_geom,
-                               bool quiet = false) {
-// Tests if this geometry and the other geometry are disjoint.
-// Geometry validity is not checked. In case you are unsure of the validity
-// of the input geometries, call g_is_valid() before, otherwise the result
-// might be wrong.
-// This function is built on the GEOS library, check it for the definition of
-// the geometry operation.
-
-    if (this_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(this_geom))
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-
-    const Rcpp::RawVector this_geom_in(this_geom);
-    if (this_geom_in.size() == 0)
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-
-    OGRGeometryH hGeom_this = createGeomFromWkb(this_geom_in);
-    if (hGeom_this == nullptr) {
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
-        }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    if (other_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(other_geom)) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    const Rcpp::RawVector other_geom_in(other_geom);
-    if (other_geom_in.size() == 0) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    OGRGeometryH hGeom_other = createGeomFromWkb(other_geom_in);
-    if (hGeom_other == nullptr) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
-        }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    bool ret = OGR_G_Disjoint(hGeom_this, hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_this);
-    return ret;
-}
-
-//' @noRd
-// [[Rcpp::export(name = ".g_touches")]]
-Rcpp::LogicalVector g_touches(const Rcpp::RObject &this_geom,
-                              const Rcpp::RObject &other_geom,
-                              bool quiet = false) {
-// Tests if this geometry and the other geometry are touching.
-// Geometry validity is not checked. In case you are unsure of the validity
-// of the input geometries, call g_is_valid() before, otherwise the result
-// might be wrong.
-// This function is built on the GEOS library, check it for the definition of
-// the geometry operation.
-
-    if (this_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(this_geom))
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-
-    const Rcpp::RawVector this_geom_in(this_geom);
-    if (this_geom_in.size() == 0)
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-
-    OGRGeometryH hGeom_this = createGeomFromWkb(this_geom_in);
-    if (hGeom_this == nullptr) {
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
-        }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    if (other_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(other_geom)) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    const Rcpp::RawVector other_geom_in(other_geom);
-    if (other_geom_in.size() == 0) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    OGRGeometryH hGeom_other = createGeomFromWkb(other_geom_in);
-    if (hGeom_other == nullptr) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
-        }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    bool ret = OGR_G_Touches(hGeom_this, hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_this);
-    return ret;
-}
-
-//' @noRd
-// [[Rcpp::export(name = ".g_contains")]]
-Rcpp::LogicalVector g_contains(const Rcpp::RObject &this_geom,
-                               const Rcpp::RObject &other_geom,
-                               bool quiet = false) {
-// Tests if this geometry contains the other geometry.
-// Geometry validity is not checked. In case you are unsure of the validity
-// of the input geometries, call g_is_valid() before, otherwise the result
-// might be wrong.
-// This function is built on the GEOS library, check it for the definition of
-// the geometry operation.
-
-    if (this_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(this_geom))
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-
-    const Rcpp::RawVector this_geom_in(this_geom);
-    if (this_geom_in.size() == 0)
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-
-    OGRGeometryH hGeom_this = createGeomFromWkb(this_geom_in);
-    if (hGeom_this == nullptr) {
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
-        }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    if (other_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(other_geom)) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    const Rcpp::RawVector other_geom_in(other_geom);
-    if (other_geom_in.size() == 0) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    OGRGeometryH hGeom_other = createGeomFromWkb(other_geom_in);
-    if (hGeom_other == nullptr) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
-        }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    bool ret = OGR_G_Contains(hGeom_this, hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_this);
+    const auto poGeom = std::unique_ptr<OGRGeometry>(
+        OGRGeometry::FromHandle(hGeom));
+
+    std::vector<const char *> options = {"DISPLAY_GEOMETRY=SUMMARY", nullptr};
+    CPLString s = poGeom->dumpReadable(nullptr, options.data());
+    s.replaceAll('\n', ' ');
+    std::string ret = s.Trim();
     return ret;
+#endif
 }
 
 //' @noRd
-// [[Rcpp::export(name = ".g_within")]]
-Rcpp::LogicalVector g_within(const Rcpp::RObject &this_geom,
-                             const Rcpp::RObject &other_geom,
-                             bool quiet = false) {
-// Tests if this geometry is within the other geometry.
-// Geometry validity is not checked. In case you are unsure of the validity
-// of the input geometries, call g_is_valid() before, otherwise the result
-// might be wrong.
-// This function is built on the GEOS library, check it for the definition of
-// the geometry operation.
+// [[Rcpp::export(name = ".g_envelope")]]
+Rcpp::NumericVector g_envelope(const Rcpp::RObject &geom, bool as_3d = false,
+                               bool quiet = false) {
+// Computes and returns the bounding envelope for this geometry.
 
-    if (this_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(this_geom))
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
+    if (geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(geom))
+        return Rcpp::NumericVector::create(NA_REAL, NA_REAL, NA_REAL, NA_REAL);
 
-    const Rcpp::RawVector this_geom_in(this_geom);
-    if (this_geom_in.size() == 0)
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
+    const Rcpp::RawVector geom_in(geom);
+    if (geom_in.size() == 0)
+        return Rcpp::NumericVector::create(NA_REAL, NA_REAL, NA_REAL, NA_REAL);
 
-    OGRGeometryH hGeom_this = createGeomFromWkb(this_geom_in);
-    if (hGeom_this == nullptr) {
+    WkbEnvelopeVisitor env;
+    if (scanWkb_(wkbRefFromRaw_(geom_in), &env) && !env.is_empty) {
+        if (as_3d)
+            return Rcpp::NumericVector(env.env, env.env + 6);
+        else
+            return Rcpp::NumericVector(env.env, env.env + 4);
+    }
+
+    OGRGeometryH hGeom = createGeomFromWkb(geom_in);
+
+    if (hGeom == nullptr) {
         if (!quiet) {
             Rcpp::warning(
                 "failed to create geometry object from WKB, NA returned");
         }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
+        return Rcpp::NumericVector::create(NA_REAL, NA_REAL, NA_REAL, NA_REAL);
     }
 
-    if (other_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(other_geom)) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
+    Rcpp::NumericVector ret;
+    if (as_3d) {
+        OGREnvelope3D sEnv3D;
+        OGR_G_GetEnvelope3D(hGeom, &sEnv3D);
+        double minZ = NA_REAL;
+        double maxZ = NA_REAL;
+        if (!std::isinf(sEnv3D.MinZ))
+            minZ = sEnv3D.MinZ;
+        if (!std::isinf(sEnv3D.MaxZ))
+            maxZ = sEnv3D.MaxZ;
 
-    const Rcpp::RawVector other_geom_in(other_geom);
-    if (other_geom_in.size() == 0) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
+        ret = {sEnv3D.MinX, sEnv3D.MaxX,
+               sEnv3D.MinY, sEnv3D.MaxY,
+               minZ, maxZ};
     }
-
-    OGRGeometryH hGeom_other = createGeomFromWkb(other_geom_in);
-    if (hGeom_other == nullptr) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
-        }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
+    else {
+        OGREnvelope sEnv;
+        OGR_G_GetEnvelope(hGeom, &sEnv);
+        ret = {sEnv.MinX, sEnv.MaxX, sEnv.MinY, sEnv.MaxY};
     }
 
-    bool ret = OGR_G_Within(hGeom_this, hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_this);
+    OGR_G_DestroyGeometry(hGeom);
     return ret;
 }
 
 //' @noRd
-// [[Rcpp::export(name = ".g_crosses")]]
-Rcpp::LogicalVector g_crosses(const Rcpp::RObject &this_geom,
-                              const Rcpp::RObject &other_geom,
-                              bool quiet = false) {
-// Tests if this geometry and the other geometry are crossing.
-// Geometry validity is not checked. In case you are unsure of the validity
-// of the input geometries, call g_is_valid() before, otherwise the result
-// might be wrong.
-// This function is built on the GEOS library, check it for the definition of
-// the geometry operation.
-
-    if (this_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(this_geom))
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-
-    const Rcpp::RawVector this_geom_in(this_geom);
-    if (this_geom_in.size() == 0)
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
+// [[Rcpp::export(name = ".g_envelope_vec")]]
+Rcpp::NumericMatrix g_envelope_vec(const Rcpp::RObject &geom,
+                                   bool as_3d = false, bool quiet = false) {
+// g_envelope() for a list of WKB geometries, one row per geometry
+
+    const std::vector<WkbRef> refs = wkbRefsFromRObject_(geom);
+    const int ncol = as_3d ? 6 : 4;
+    Rcpp::NumericMatrix ret(static_cast<int>(refs.size()), ncol);
+    std::fill(ret.begin(), ret.end(), NA_REAL);
+
+    for (std::size_t i = 0; i < refs.size(); ++i) {
+        if (refs[i].data == nullptr)
+            continue;
 
-    OGRGeometryH hGeom_this = createGeomFromWkb(this_geom_in);
-    if (hGeom_this == nullptr) {
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
+        WkbEnvelopeVisitor env;
+        if (scanWkb_(refs[i], &env) && !env.is_empty) {
+            for (int j = 0; j < ncol; ++j)
+                ret(i, j) = env.env[j];
+        }
+        else {
+            const Rcpp::NumericVector v =
+                    g_envelope(wkbElement_(geom, i), as_3d, quiet);
+            for (R_xlen_t j = 0; j < v.size() && j < ncol; ++j)
+                ret(i, j) = v[j];
         }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
-
-    if (other_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(other_geom)) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
     }
 
-    const Rcpp::RawVector other_geom_in(other_geom);
-    if (other_geom_in.size() == 0) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
+    return ret;
+}
 
-    OGRGeometryH hGeom_other = createGeomFromWkb(other_geom_in);
-    if (hGeom_other == nullptr) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
-        }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
+//' @noRd
+// [[Rcpp::export(name = ".g_coords_wkb")]]
+SEXP g_coords_wkb(const Rcpp::RObject &geom) {
+// vertices of WKB geometries as a data frame in the format of
+// wk::wk_coords(), or NULL if any of the input could not be scanned directly
+// (e.g., curve geometries) in which case the caller falls back to wk
+
+    const std::vector<WkbRef> refs = wkbRefsFromRObject_(geom);
+    WkbCoordsVisitor coords;
+    for (std::size_t i = 0; i < refs.size(); ++i) {
+        coords.feature_id = static_cast<int>(i) + 1;
+        if (refs[i].data == nullptr)
+            continue;
+        if (!scanWkb_(refs[i], &coords))
+            return R_NilValue;
     }
 
-    bool ret = OGR_G_Crosses(hGeom_this, hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_this);
-    return ret;
+    Rcpp::List df = Rcpp::List::create(
+        Rcpp::Named("feature_id") = Rcpp::wrap(coords.fid),
+        Rcpp::Named("part_id") = Rcpp::wrap(coords.pid),
+        Rcpp::Named("ring_id") = Rcpp::wrap(coords.rid),
+        Rcpp::Named("x") = Rcpp::wrap(coords.x),
+        Rcpp::Named("y") = Rcpp::wrap(coords.y));
+    if (coords.any_z)
+        df.push_back(Rcpp::wrap(coords.z), "z");
+    if (coords.any_m)
+        df.push_back(Rcpp::wrap(coords.m), "m");
+
+    df.attr("class") = Rcpp::CharacterVector{"data.frame"};
+    df.attr("row.names") = Rcpp::seq_len(coords.x.size());
+    return df;
 }
 
+
+// *** binary predicates ***
+
+
 //' @noRd
-// [[Rcpp::export(name = ".g_overlaps")]]
-Rcpp::LogicalVector g_overlaps(const Rcpp::RObject &this_geom,
-                               const Rcpp::RObject &other_geom,
-                               bool quiet = false) {
-// Tests if this geometry and the other geometry overlap, that is their
-// intersection has a non-zero area (they have some but not all points in
-// common).
-// Geometry validity is not checked. In case you are unsure of the validity
-// of the input geometries, call g_is_valid() before, otherwise the result
-// might be wrong.
-// This function is built on the GEOS library, check it for the definition of
-// the geometry operation.
+// [[Rcpp::export(name = ".g_binary_pred_vec")]]
+Rcpp::LogicalVector g_binary_pred_vec(const Rcpp::RObject &this_geom,
+                                      const Rcpp::RObject &other_geom,
+                                      const std::string &predicate,
+                                      bool cross = false,
+                                      int num_threads = 1,
+                                      bool quiet = false) {
+// Vectorized binary predicate on WKB input (raw vector or list of raw
+// vectors). Evaluated pairwise if the inputs have equal length, or with
+// broadcasting if either input contains a single geometry, or for all
+// combinations if cross = TRUE (returns a logical matrix of dimension
+// length(this_geom) x length(other_geom)).
+// A geometry that is reused across evaluations is created from WKB once and
+// prepared for intersects, disjoint, contains and within (GEOS prepared
+// geometry). Prepared geometries are not safe to share between threads, so
+// each thread prepares its own copy.
+
+    enum class Pred {INTERSECTS, DISJOINT, TOUCHES, CONTAINS, WITHIN,
+                     CROSSES, OVERLAPS, EQUALS};
+
+    Pred pred = Pred::INTERSECTS;
+    if (EQUAL(predicate.c_str(), "intersects"))
+        pred = Pred::INTERSECTS;
+    else if (EQUAL(predicate.c_str(), "disjoint"))
+        pred = Pred::DISJOINT;
+    else if (EQUAL(predicate.c_str(), "touches"))
+        pred = Pred::TOUCHES;
+    else if (EQUAL(predicate.c_str(), "contains"))
+        pred = Pred::CONTAINS;
+    else if (EQUAL(predicate.c_str(), "within"))
+        pred = Pred::WITHIN;
+    else if (EQUAL(predicate.c_str(), "crosses"))
+        pred = Pred::CROSSES;
+    else if (EQUAL(predicate.c_str(), "overlaps"))
+        pred = Pred::OVERLAPS;
+    else if (EQUAL(predicate.c_str(), "equals"))
+        pred = Pred::EQUALS;
+    else
+        Rcpp::stop("invalid 'predicate'");
+
+    const std::vector<WkbRef> this_refs = wkbRefsFromRObject_(this_geom);
+    const std::vector<WkbRef> other_refs = wkbRefsFromRObject_(other_geom);
+    const std::size_t n_this = this_refs.size();
+    const std::size_t n_other = other_refs.size();
+
+    if (!cross && n_this != n_other && n_this != 1 && n_other != 1) {
+        Rcpp::stop(
+            "inputs must contain equal number of geometries, or one-to-many");
+    }
+
+    std::size_t n_out = 0;
+    if (cross)
+        n_out = n_this * n_other;
+    else if (n_this > 0 && n_other > 0)
+        n_out = std::max(n_this, n_other);
+
+    const int na_value = NA_LOGICAL;
+    std::vector<int> res(n_out, na_value);
+    std::atomic<std::size_t> num_failed(0);
+
+    auto evalGeoms = [pred](OGRGeometryH hThis, OGRGeometryH hOther) -> int {
+        switch (pred) {
+            case Pred::INTERSECTS: return OGR_G_Intersects(hThis, hOther);
+            case Pred::DISJOINT: return OGR_G_Disjoint(hThis, hOther);
+            case Pred::TOUCHES: return OGR_G_Touches(hThis, hOther);
+            case Pred::CONTAINS: return OGR_G_Contains(hThis, hOther);
+            case Pred::WITHIN: return OGR_G_Within(hThis, hOther);
+            case Pred::CROSSES: return OGR_G_Crosses(hThis, hOther);
+            case Pred::OVERLAPS: return OGR_G_Overlaps(hThis, hOther);
+            case Pred::EQUALS: return OGR_G_Equals(hThis, hOther);
+        }
+        return 0;
+    };
 
-    if (this_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(this_geom))
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
+    // whether a prepared geometry can be used when the reused geometry is
+    // on the this_geom side (within(a, b) is evaluated as contains(b, a))
+    auto canPrepare = [pred](bool reused_is_this) -> bool {
+        if (pred == Pred::INTERSECTS || pred == Pred::DISJOINT)
+            return true;
+        if (pred == Pred::CONTAINS)
+            return reused_is_this;
+        if (pred == Pred::WITHIN)
+            return !reused_is_this;
+        return false;
+    };
 
-    const Rcpp::RawVector this_geom_in(this_geom);
-    if (this_geom_in.size() == 0)
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
+    auto evalPrepared = [pred](OGRPreparedGeometryH hPrep,
+                               OGRGeometryH hGeom) -> int {
+        if (pred == Pred::INTERSECTS)
+            return OGRPreparedGeometryIntersects(hPrep, hGeom);
+        else if (pred == Pred::DISJOINT)
+            return !OGRPreparedGeometryIntersects(hPrep, hGeom);
+        else
+            return OGRPreparedGeometryContains(hPrep, hGeom);
+    };
 
-    OGRGeometryH hGeom_this = createGeomFromWkb(this_geom_in);
-    if (hGeom_this == nullptr) {
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
+    auto createGeom = [&num_failed](const WkbRef &ref) -> OGRGeometryH {
+        if (ref.data == nullptr)
+            return nullptr;
+        OGRGeometryH hGeom = createGeomFromWkbRef_(ref);
+        if (hGeom == nullptr)
+            num_failed += 1;
+        return hGeom;
+    };
+
+    // evaluate the reused geometry hReused against refs[start, end), writing
+    // results to res[out_start + (k - start) * out_stride]
+    auto evalReused = [&](OGRGeometryH hReused, bool reused_is_this,
+                          const std::vector<WkbRef> &refs, std::size_t start,
+                          std::size_t end, std::size_t out_start,
+                          std::size_t out_stride,
+                          const std::vector<OGRGeometryH> *geoms) {
+
+        OGRPreparedGeometryH hPrep = nullptr;
+        if (canPrepare(reused_is_this))
+            hPrep = OGRCreatePreparedGeometry(hReused);
+
+        for (std::size_t k = start; k < end; ++k) {
+            OGRGeometryH hGeom = nullptr;
+            if (geoms != nullptr)
+                hGeom = (*geoms)[k];
+            else
+                hGeom = createGeom(refs[k]);
+            if (hGeom == nullptr)
+                continue;
+
+            int value = 0;
+            if (hPrep != nullptr)
+                value = evalPrepared(hPrep, hGeom);
+            else if (reused_is_this)
+                value = evalGeoms(hReused, hGeom);
+            else
+                value = evalGeoms(hGeom, hReused);
+            res[out_start + (k - start) * out_stride] = value ? 1 : 0;
+
+            if (geoms == nullptr)
+                OGR_G_DestroyGeometry(hGeom);
         }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
 
-    if (other_geom.isNULL() || !Rcpp::is<Rcpp::RawVector>(other_geom)) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
+        if (hPrep != nullptr)
+            OGRDestroyPreparedGeometry(hPrep);
+    };
 
-    const Rcpp::RawVector other_geom_in(other_geom);
-    if (other_geom_in.size() == 0) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
-    }
+    if (cross && n_out > 0) {
+        // the geometries of one input are created once and shared read-only,
+        // and each geometry of the other input is reused along its row of
+        // the matrix, or along its column for within(a, b) so that b can be
+        // prepared
+        const bool by_row = (pred != Pred::WITHIN);
+        const std::vector<WkbRef> &shared_refs = by_row ? other_refs
+                                                        : this_refs;
+        const std::vector<WkbRef> &reused_refs = by_row ? this_refs
+                                                        : other_refs;
+        std::vector<OGRGeometryH> shared_geoms(shared_refs.size(), nullptr);
+        parallel_for_(shared_refs.size(), num_threads, [&](std::size_t j) {
+            shared_geoms[j] = createGeom(shared_refs[j]);
+        }, 64);
+
+        parallel_for_(reused_refs.size(), num_threads, [&](std::size_t i) {
+            OGRGeometryH hReused = createGeom(reused_refs[i]);
+            if (hReused == nullptr)
+                return;
+            if (by_row) {
+                evalReused(hReused, true, shared_refs, 0, n_other, i, n_this,
+                           &shared_geoms);
+            }
+            else {
+                evalReused(hReused, false, shared_refs, 0, n_this,
+                           i * n_this, 1, &shared_geoms);
+            }
+            OGR_G_DestroyGeometry(hReused);
+        });
 
-    OGRGeometryH hGeom_other = createGeomFromWkb(other_geom_in);
-    if (hGeom_other == nullptr) {
-        OGR_G_DestroyGeometry(hGeom_this);
-        if (!quiet) {
-            Rcpp::warning(
-                "failed to create geometry object from WKB, NA returned");
+        for (OGRGeometryH hGeom : shared_geoms) {
+            if (hGeom != nullptr)
+                OGR_G_DestroyGeometry(hGeom);
         }
-        return Rcpp::LogicalVector::create(NA_LOGICAL);
+    }
+    else if (n_out > 1 && (n_this == 1 || n_other == 1)) {
+        // broadcast, one contiguous block per thread
+        const bool reused_is_this = (n_this == 1);
+        const std::vector<WkbRef> &refs = reused_is_this ? other_refs
+                                                         : this_refs;
+        OGRGeometryH hReused = createGeom(reused_is_this ? this_refs[0]
+                                                         : other_refs[0]);
+        if (hReused != nullptr) {
+            const int nthreads = resolve_num_threads_(num_threads, n_out);
+            const std::size_t block = (n_out + nthreads - 1) / nthreads;
+            parallel_for_(static_cast<std::size_t>(nthreads), nthreads,
+                          [&](std::size_t t) {
+                const std::size_t start = t * block;
+                const std::size_t end = std::min(start + block, n_out);
+                if (start < end) {
+                    evalReused(hReused, reused_is_this, refs, start, end,
+                               start, 1, nullptr);
+                }
+            });
+            OGR_G_DestroyGeometry(hReused);
+        }
+    }
+    else if (n_out > 0) {
+        // pairwise
+        parallel_for_(n_out, num_threads, [&](std::size_t i) {
+            OGRGeometryH hThis = createGeom(this_refs[i]);
+            if (hThis == nullptr)
+                return;
+            OGRGeometryH hOther = createGeom(other_refs[i]);
+            if (hOther != nullptr) {
+                res[i] = evalGeoms(hThis, hOther) ? 1 : 0;
+                OGR_G_DestroyGeometry(hOther);
+            }
+            OGR_G_DestroyGeometry(hThis);
+        }, 16);
     }
 
-    bool ret = OGR_G_Overlaps(hGeom_this, hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_other);
-    OGR_G_DestroyGeometry(hGeom_this);
-    return ret;
+    if (num_failed > 0 && !quiet) {
+        Rcpp::warning(
+            "failed to create geometry object from WKB, NA returned");
+    }
+
+    Rcpp::LogicalVector out(res.begin(), res.end());
+    if (cross) {
+        out.attr("dim") = Rcpp::Dimension(static_cast<int>(n_this),
+                                          static_cast<int>(n_other));
+    }
+    return out;
 }
 
 
@@ -1877,6 +2415,27 @@ SEXP g_buffer(const Rcpp::RObject &geom, double dist, int quad_segs = 30,
     return wkb;
 }
 
+// buffer over a list of WKB geometries, optionally multithreaded
+//' @noRd
+// [[Rcpp::export(name = ".g_buffer_vec")]]
+Rcpp::List g_buffer_vec(const Rcpp::RObject &geom, double dist,
+                        int quad_segs = 30, bool as_iso = false,
+                        const std::string &byte_order = "LSB",
+                        bool quiet = false, int num_threads = 1) {
+
+    const std::vector<WkbRef> refs = wkbRefsFromRObject_(geom);
+    const OGRwkbByteOrder eOrder = wkbByteOrderFromString_(byte_order);
+
+    auto op = [dist, quad_segs](int, OGRGeometryH hGeom) {
+        return OGR_G_Buffer(hGeom, dist, quad_segs);
+    };
+
+    std::vector<WkbOut> out = unaryOpWkb_(refs, op, as_iso, eOrder,
+                                          num_threads);
+
+    return wkbOutToList_(&out, "OGR_G_Buffer() gave NULL geometry", quiet);
+}
+
 //' @noRd
 // [[Rcpp::export(name = ".g_convex_hull")]]
 SEXP g_convex_hull(const Rcpp::RObject &geom, bool as_iso,
@@ -2212,6 +2771,30 @@ SEXP g_simplify(const Rcpp::RObject &geom, double tolerance,
     return wkb;
 }
 
+// simplify over a list of WKB geometries, optionally multithreaded
+//' @noRd
+// [[Rcpp::export(name = ".g_simplify_vec")]]
+Rcpp::List g_simplify_vec(const Rcpp::RObject &geom, double tolerance,
+                          bool preserve_topology = true, bool as_iso = false,
+                          const std::string &byte_order = "LSB",
+                          bool quiet = false, int num_threads = 1) {
+
+    const std::vector<WkbRef> refs = wkbRefsFromRObject_(geom);
+    const OGRwkbByteOrder eOrder = wkbByteOrderFromString_(byte_order);
+
+    auto op = [tolerance, preserve_topology](int, OGRGeometryH hGeom) {
+        if (preserve_topology)
+            return OGR_G_SimplifyPreserveTopology(hGeom, tolerance);
+        else
+            return OGR_G_Simplify(hGeom, tolerance);
+    };
+
+    std::vector<WkbOut> out = unaryOpWkb_(refs, op, as_iso, eOrder,
+                                          num_threads);
+
+    return wkbOutToList_(&out, "OGR API call gave NULL geometry", quiet);
+}
+
 //' @noRd
 // [[Rcpp::export(name = ".g_unary_union")]]
 SEXP g_unary_union(const Rcpp::RObject &geom, bool as_iso,
@@ -2958,7 +3541,7 @@ SEXP g_transform(const Rcpp::RObject &geom, const std::string &srs_from,
                  const std::string &srs_to, bool wrap_date_line = false,
                  int date_line_offset = 10, bool traditional_gis_order = true,
                  bool as_iso = false, const std::string &byte_order = "LSB",
-                 bool quiet = false) {
+                 bool quiet = false, int num_threads = 1) {
 // Returns a transformed geometry as WKB
 // Apply arbitrary coordinate transformation to geometry.
 // This function will transform the coordinates of a geometry from their
@@ -2984,53 +3567,11 @@ SEXP g_transform(const Rcpp::RObject &geom, const std::string &srs_from,
         return R_NilValue;
     }
 
-    const std::string srs_from_in = srs_to_wkt(srs_from, false);
-    const std::string srs_to_in = srs_to_wkt(srs_to, false);
-
-    OGRSpatialReferenceH hSRS_from = OSRNewSpatialReference(nullptr);
-    OGRSpatialReferenceH hSRS_to = OSRNewSpatialReference(nullptr);
-
-    char *pszWKT1 = const_cast<char*>(srs_from_in.c_str());
-    if (OSRImportFromWkt(hSRS_from, &pszWKT1) != OGRERR_NONE) {
-        if (hSRS_from != nullptr)
-            OSRDestroySpatialReference(hSRS_from);
-        if (hSRS_to != nullptr)
-            OSRDestroySpatialReference(hSRS_to);
-        Rcpp::stop("error importing 'srs_from' from user input");
-    }
-
-    char *pszWKT2 = const_cast<char*>(srs_to_in.c_str());
-    if (OSRImportFromWkt(hSRS_to, &pszWKT2) != OGRERR_NONE) {
-        if (hSRS_from != nullptr)
-            OSRDestroySpatialReference(hSRS_from);
-        if (hSRS_to != nullptr)
-            OSRDestroySpatialReference(hSRS_to);
-        Rcpp::stop("error importing 'srs_to' from user input");
-    }
-
-    const std::string save_opt =
-            get_config_option("OGR_CT_FORCE_TRADITIONAL_GIS_ORDER");
-
-    if (traditional_gis_order) {
-        OSRSetAxisMappingStrategy(hSRS_from, OAMS_TRADITIONAL_GIS_ORDER);
-        OSRSetAxisMappingStrategy(hSRS_to, OAMS_TRADITIONAL_GIS_ORDER);
-    }
-    else {
-        set_config_option("OGR_CT_FORCE_TRADITIONAL_GIS_ORDER", "NO");
-        OSRSetAxisMappingStrategy(hSRS_from, OAMS_AUTHORITY_COMPLIANT);
-        OSRSetAxisMappingStrategy(hSRS_to, OAMS_AUTHORITY_COMPLIANT);
-    }
+    const std::vector<WkbRef> refs = wkbRefsFromRObject_(geom);
+    const OGRwkbByteOrder eOrder = wkbByteOrderFromString_(byte_order);
 
-    OGRCoordinateTransformationH hCT = nullptr;
-    hCT = OCTNewCoordinateTransformation(hSRS_from, hSRS_to);
-    if (hCT == nullptr) {
-        set_config_option("OGR_CT_FORCE_TRADITIONAL_GIS_ORDER", save_opt);
-        if (hSRS_from != nullptr)
-            OSRDestroySpatialReference(hSRS_from);
-        if (hSRS_to != nullptr)
-            OSRDestroySpatialReference(hSRS_to);
-        Rcpp::stop("failed to create coordinate transformer");
-    }
+    // coordinate transformation object from the process-wide cache
+    const CTLease ct = acquireCT_(srs_from, srs_to, traditional_gis_order);
 
     std::vector<char *> options;
     std::string dl_offset = "DATELINEOFFSET=";
@@ -3041,107 +3582,51 @@ SEXP g_transform(const Rcpp::RObject &geom, const std::string &srs_from,
     }
     options.push_back(nullptr);
 
-    OGRGeomTransformerH hGeomTransformer = nullptr;
-    hGeomTransformer = OGR_GeomTransformer_Create(hCT, options.data());
-    if (hGeomTransformer == nullptr) {
-        OCTDestroyCoordinateTransformation(hCT);
-        set_config_option("OGR_CT_FORCE_TRADITIONAL_GIS_ORDER", save_opt);
-        if (hSRS_from != nullptr)
-            OSRDestroySpatialReference(hSRS_from);
-        if (hSRS_to != nullptr)
-            OSRDestroySpatialReference(hSRS_to);
-        Rcpp::stop("failed to create geometry transformer");
-    }
-
-    bool input_is_list = false;
-    Rcpp::List list_in;
-    if (Rcpp::is<Rcpp::List>(geom)) {
-        list_in = Rcpp::as<Rcpp::List>(geom);
-        input_is_list = true;
-    }
-    else {
-        list_in = Rcpp::List::create(Rcpp::as<Rcpp::RawVector>(geom));
-    }
-
-    const R_xlen_t num_geom = list_in.size();
-
-    Rcpp::List list_out(num_geom);
-
-    for (R_xlen_t i = 0; i < num_geom; ++i) {
-        if (list_in[i] == R_NilValue ||
-            !Rcpp::is<Rcpp::RawVector>(list_in[i])) {
-
-            list_out[i] = R_NilValue;
-            continue;
-        }
-
-        const Rcpp::RawVector geom_in = list_in[i];
-        if (geom_in.size() == 0) {
-            list_out[i] = R_NilValue;
-            continue;
-        }
-
-        OGRGeometryH hGeom = createGeomFromWkb(geom_in);
-        if (hGeom == nullptr) {
-            if (!quiet) {
-                Rcpp::warning(
-                    "failed to create geometry object from WKB, NULL returned");
-            }
-            list_out[i] = R_NilValue;
-            continue;
-        }
+    // geometry transformers are not thread-safe, so create one per worker
+    // thread (each holds its own clone of the coordinate transformation)
+    const int nthreads = resolve_num_threads_(num_threads, refs.size());
+    std::vector<OGRGeomTransformerH> transformers;
 
-        OGRGeometryH hGeom2 = nullptr;
-        hGeom2 = OGR_GeomTransformer_Transform(hGeomTransformer, hGeom);
+    auto cleanup = [&transformers]() {
+        for (OGRGeomTransformerH hGT : transformers)
+            OGR_GeomTransformer_Destroy(hGT);
+    };
 
-        if (hGeom2 == nullptr) {
-            if (!quiet) {
-                Rcpp::warning("transformation failed, NULL returned");
-            }
-            list_out[i] = R_NilValue;
-            OGR_G_DestroyGeometry(hGeom);
-            continue;
+    for (int t = 0; t < nthreads; ++t) {
+        OGRGeomTransformerH hGeomTransformer = nullptr;
+        hGeomTransformer = OGR_GeomTransformer_Create(ct.handle(),
+                                                      options.data());
+        if (hGeomTransformer == nullptr) {
+            cleanup();
+            Rcpp::stop("failed to create geometry transformer");
         }
+        transformers.push_back(hGeomTransformer);
+    }
 
-        int nWKBSize = OGR_G_WkbSize(hGeom2);
-        if (!nWKBSize) {
-            OGR_G_DestroyGeometry(hGeom2);
-            OGR_G_DestroyGeometry(hGeom);
-            if (!quiet) {
-                Rcpp::warning("failed to obtain WKB size of output geometry");
-            }
-            list_out[i] = R_NilValue;
-            continue;
-        }
+    auto op = [&transformers](int t, OGRGeometryH hGeom) {
+        return OGR_GeomTransformer_Transform(transformers[t], hGeom);
+    };
 
-        Rcpp::RawVector wkb = Rcpp::no_init(nWKBSize);
-        bool result = exportGeomToWkb(hGeom2, &wkb[0], as_iso, byte_order);
-        OGR_G_DestroyGeometry(hGeom2);
-        OGR_G_DestroyGeometry(hGeom);
-        if (!result) {
-            if (!quiet) {
-                Rcpp::warning(
-                    "failed to export WKB raw vector for output geometry");
-            }
-            list_out[i] = R_NilValue;
-        }
-        else {
-            list_out[i] = wkb;
-        }
+    std::vector<WkbOut> out;
+    try {
+        out = unaryOpWkb_(refs, op, as_iso, eOrder, num_threads);
+    }
+    catch (const std::exception &e) {
+        cleanup();
+        Rcpp::stop(e.what());
     }
 
-    OGR_GeomTransformer_Destroy(hGeomTransformer);
-    OCTDestroyCoordinateTransformation(hCT);
-    OSRDestroySpatialReference(hSRS_from);
-    OSRDestroySpatialReference(hSRS_to);
-    if (!traditional_gis_order)
-        set_config_option("OGR_CT_FORCE_TRADITIONAL_GIS_ORDER", save_opt);
+    cleanup();
 
-    if (input_is_list) {
+    Rcpp::List list_out = wkbOutToList_(&out,
+                                        "transformation failed, NULL returned",
+                                        quiet);
+
+    if (Rcpp::is<Rcpp::List>(geom)) {
         return list_out;
     }
     else {
-        if (Rcpp::is<Rcpp::RawVector>(list_out[0]))
+        if (list_out.size() > 0 && Rcpp::is<Rcpp::RawVector>(list_out[0]))
             return Rcpp::as<Rcpp::RawVector>(list_out[0]);
         else
             return R_NilValue;
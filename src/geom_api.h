@@ -11,27 +11,74 @@
 
 #include <Rcpp.h>
 
+#include <ogr_api.h>
 #include <ogr_geometry.h>
 
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 std::vector<int> getGEOSVersion();
 bool has_geos();  // GDAL built against GEOS is required at gdalraster 1.10
 
+// owning pointer to an OGR geometry handle, so that geometries are destroyed
+// if an error or a user interrupt leaves the scope
+struct OGRGeomDestroyer_ {
+    void operator()(OGRGeometryH hGeom) const {
+        if (hGeom != nullptr)
+            OGR_G_DestroyGeometry(hGeom);
+    }
+};
+using OGRGeomPtr_ = std::unique_ptr<std::remove_pointer<OGRGeometryH>::type,
+                                    OGRGeomDestroyer_>;
+
 OGRGeometryH createGeomFromWkb(const Rcpp::RawVector &wkb);
 bool exportGeomToWkb(OGRGeometryH hGeom, unsigned char *wkb, bool as_iso,
                      const std::string &byte_order);
 
-Rcpp::String g_wkb2wkt(const Rcpp::RObject &geom, bool as_iso);
+// reference to the WKB bytes of an R raw vector, for use on worker threads
+// where the R API cannot be called (data is nullptr for NULL/empty input)
+struct WkbRef {
+    const unsigned char *data = nullptr;
+    std::size_t size = 0;
+};
+
+std::vector<WkbRef> wkbRefsFromRObject_(const Rcpp::RObject &geom);
+OGRGeometryH createGeomFromWkbRef_(const WkbRef &wkb);
+
+// output slot for a geometry operation run on a worker thread, holding the
+// WKB of the result or an error code that is reported on the calling thread
+enum class WkbOutErr {
+    NONE, NULL_INPUT, CREATE_FAILED, OP_FAILED, SIZE_FAILED, EXPORT_FAILED
+};
+
+struct WkbOut {
+    std::vector<unsigned char> wkb {};
+    WkbOutErr err = WkbOutErr::NULL_INPUT;
+};
+
+OGRwkbByteOrder wkbByteOrderFromString_(const std::string &byte_order);
+void exportGeomToWkbOut_(OGRGeometryH hGeom, OGRwkbByteOrder eOrder,
+                         bool as_iso, WkbOut *out);
+Rcpp::List wkbOutToList_(std::vector<WkbOut> *out, const std::string &op_msg,
+                         bool quiet);
 
-Rcpp::CharacterVector g_wkb_list2wkt(const Rcpp::List &geom, bool as_iso);
+bool exportGeomToWkt_(OGRGeometryH hGeom, bool as_iso, int precision,
+                      std::string *wkt);
+
+Rcpp::String g_wkb2wkt(const Rcpp::RObject &geom, bool as_iso,
+                       int precision);
+
+Rcpp::CharacterVector g_wkb_list2wkt(const Rcpp::List &geom, bool as_iso,
+                                     int precision, int num_threads);
 
 SEXP g_wkt2wkb(const std::string &geom, bool as_iso,
                const std::string &byte_order);
 
 Rcpp::List g_wkt_vector2wkb(const Rcpp::CharacterVector &geom, bool as_iso,
-                            const std::string &byte_order);
+                            const std::string &byte_order, int num_threads);
 
 Rcpp::RawVector g_create(const std::string &geom_type,
                          const Rcpp::RObject &pts, bool as_iso,
@@ -42,6 +89,7 @@ Rcpp::RawVector g_add_geom(const Rcpp::RawVector &sub_geom,
                            bool as_iso, const std::string &byte_order);
 
 int g_geom_count(const Rcpp::RObject &geom, bool quiet);
+Rcpp::IntegerVector g_geom_count_vec(const Rcpp::RObject &geom, bool quiet);
 SEXP g_get_geom(const Rcpp::RawVector &container, int sub_geom_idx,
                 bool as_iso, const std::string &byte_order);
 
@@ -49,6 +97,10 @@ Rcpp::LogicalVector g_is_valid(const Rcpp::RObject &geom, bool quiet);
 SEXP g_make_valid(const Rcpp::RObject &geom, const std::string &method,
                   bool keep_collapsed, bool as_iso,
                   const std::string &byte_order, bool quiet);
+Rcpp::List g_make_valid_vec(const Rcpp::RObject &geom,
+                            const std::string &method, bool keep_collapsed,
+                            bool as_iso, const std::string &byte_order,
+                            bool quiet, int num_threads);
 
 SEXP g_normalize(const Rcpp::RObject &geom, bool as_iso,
                  const std::string &byte_order, bool quiet);
@@ -63,51 +115,27 @@ SEXP g_swap_xy(const Rcpp::RObject &geom, bool as_iso,
                const std::string &byte_order, bool quiet);
 
 Rcpp::LogicalVector g_is_empty(const Rcpp::RObject &geom, bool quiet);
+Rcpp::LogicalVector g_is_empty_vec(const Rcpp::RObject &geom, bool quiet);
 Rcpp::LogicalVector g_is_3D(const Rcpp::RObject &geom, bool quiet);
 Rcpp::LogicalVector g_is_measured(const Rcpp::RObject &geom, bool quiet);
 Rcpp::LogicalVector g_is_ring(const Rcpp::RObject &geom, bool quiet);
 Rcpp::String g_name(const Rcpp::RObject &geom, bool quiet);
+Rcpp::CharacterVector g_name_vec(const Rcpp::RObject &geom, bool quiet);
 Rcpp::String g_summary(const Rcpp::RObject &geom, bool quiet);
 Rcpp::NumericVector g_envelope(const Rcpp::RObject &geom, bool as_3d,
                                bool quiet);
-
-Rcpp::LogicalVector g_intersects(const Rcpp::RObject &this_geom,
-                                 const Rcpp::RObject &other_geom,
-                                 bool quiet);
-
-Rcpp::LogicalVector g_equals(const Rcpp::RObject &this_geom,
-                             const Rcpp::RObject &other_geom,
-                             bool quiet);
-
-Rcpp::LogicalVector g_disjoint(const Rcpp::RObject &this_geom,
-                               const Rcpp::RObject &other_geom,
-                               bool quiet);
-
-Rcpp::LogicalVector g_touches(const Rcpp::RObject &this_geom,
-                              const Rcpp::RObject &other_geom,
-                              bool quiet);
-
-Rcpp::LogicalVector g_contains(const Rcpp::RObject &this_geom,
-                               const Rcpp::RObject &other_geom,
-                               bool quiet);
-
-Rcpp::LogicalVector g_within(const Rcpp::RObject &this_geom,
-                             const Rcpp::RObject &other_geom,
-                             bool quiet);
-
-Rcpp::LogicalVector g_crosses(const Rcpp::RObject &this_geom,
-                              const Rcpp::RObject &other_geom,
-                              bool quiet);
-
-Rcpp::LogicalVector g_overlaps(const Rcpp::RObject &this_geom,
-                               const Rcpp::RObject &other_geom,
-                               bool quiet);
+Rcpp::NumericMatrix g_envelope_vec(const Rcpp::RObject &geom, bool as_3d,
+                                   bool quiet);
+SEXP g_coords_wkb(const Rcpp::RObject &geom);
 
 SEXP g_boundary(const Rcpp::RObject &geom, bool as_iso,
                 const std::string &byte_order, bool quiet);
 
 SEXP g_buffer(const Rcpp::RObject &geom, double dist, int quad_segs,
               bool as_iso, const std::string &byte_order, bool quiet);
+Rcpp::List g_buffer_vec(const Rcpp::RObject &geom, double dist, int quad_segs,
+                        bool as_iso, const std::string &byte_order,
+                        bool quiet, int num_threads);
 
 SEXP g_convex_hull(const Rcpp::RObject &geom, bool as_iso,
                    const std::string &byte_order, bool quiet);
@@ -122,6 +150,10 @@ SEXP g_delaunay_triangulation(const Rcpp::RObject &geom, bool constrained,
 SEXP g_simplify(const Rcpp::RObject &geom, double tolerance,
                 bool preserve_topology, bool as_iso,
                 const std::string &byte_order, bool quiet);
+Rcpp::List g_simplify_vec(const Rcpp::RObject &geom, double tolerance,
+                          bool preserve_topology, bool as_iso,
+                          const std::string &byte_order, bool quiet,
+                          int num_threads);
 
 SEXP g_unary_union(const Rcpp::RObject &geom, bool as_iso,
                    const std::string &byte_order, bool quiet);
@@ -161,7 +193,7 @@ Rcpp::NumericVector g_centroid(const Rcpp::RObject &geom, bool quiet);
 SEXP g_transform(const Rcpp::RObject &geom, const std::string &srs_from,
                  const std::string &srs_to, bool wrap_date_line,
                  int date_line_offset, bool traditional_gis_order, bool as_iso,
-                 const std::string &byte_order, bool quiet);
+                 const std::string &byte_order, bool quiet, int num_threads);
 
 Rcpp::NumericVector bbox_from_wkt(const std::string &wkt,
                                   double extend_x, double extend_y);
@@ -0,0 +1,587 @@
+/* Union aggregation of large sets of geometries, optionally grouped by key
+
+   Cascaded union: the input geometries are packed into an STR tree (see
+   strtree.h), and the geometries under each node are unioned bottom-up one
+   level of the tree at a time, with the nodes of a level processed on worker
+   threads. Unioning geometries that are spatially close first keeps the
+   intermediate results small, which is much faster than unioning the whole
+   set at once or accumulating pairwise (cf. CascadedPolygonUnion in GEOS).
+
+   Coverage union: for polygons that form a coverage (no overlaps, and
+   adjacent polygons share vertices along common edges, e.g., the output of
+   polygonize()), the edges shared by two polygons cancel out and only the
+   outer boundary edges need to be polygonized (as done by GEOS
+   CoverageUnion, which is not exposed in the GDAL API). The result is checked
+   against the total input area and for validity (edges left over from input
+   that is not fully noded), and the cascaded union is used instead if the
+   input is not a valid coverage.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_error.h>
+#include <cpl_port.h>
+#include <gdal.h>
+#include <ogr_api.h>
+
+#include <Rcpp.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "geom_union.h"
+#include "gdalvector.h"
+#include "geom_api.h"
+#include "parallel_util.h"
+#include "spatial_index.h"
+#include "strtree.h"
+
+// node capacity of the tree used to order the cascade (as in GEOS)
+constexpr int UNION_NODE_CAPACITY = 4;
+
+// relative tolerance on the total area for accepting a coverage union
+constexpr double COVERAGE_AREA_TOL = 1e-9;
+
+namespace {
+
+// union of a set of geometries, consuming them, nullptr on failure
+OGRGeometryH unionParts_(std::vector<OGRGeometryH> *parts) {
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 7, 0)
+    OGRGeometryH hColl = OGR_G_CreateGeometry(wkbGeometryCollection);
+    bool ok = true;
+    for (OGRGeometryH &hPart : *parts) {
+        if (OGR_G_AddGeometryDirectly(hColl, hPart) != OGRERR_NONE) {
+            OGR_G_DestroyGeometry(hPart);
+            ok = false;
+        }
+        hPart = nullptr;
+    }
+    OGRGeometryH hUnion = ok ? OGR_G_UnaryUnion(hColl) : nullptr;
+    OGR_G_DestroyGeometry(hColl);
+    return hUnion;
+
+#else
+    // OGR_G_UnaryUnion() requires GDAL >= 3.7, accumulate pairwise instead
+    OGRGeometryH hUnion = (*parts)[0];
+    (*parts)[0] = nullptr;
+    for (std::size_t i = 1; i < parts->size(); ++i) {
+        if (hUnion != nullptr) {
+            OGRGeometryH hTmp = OGR_G_Union(hUnion, (*parts)[i]);
+            OGR_G_DestroyGeometry(hUnion);
+            hUnion = hTmp;
+        }
+        OGR_G_DestroyGeometry((*parts)[i]);
+        (*parts)[i] = nullptr;
+    }
+    return hUnion;
+#endif
+}
+
+}  // namespace
+
+// cascaded union of geoms, consuming them, nullptr on failure
+// NULL and empty geometries are ignored, an empty GEOMETRYCOLLECTION is
+// returned if there is nothing else
+OGRGeometryH cascadedUnion_(std::vector<OGRGeometryH> *geoms,
+                            int num_threads) {
+
+    STRtree tree(UNION_NODE_CAPACITY);
+    for (std::size_t i = 0; i < geoms->size(); ++i) {
+        const STRBox box = geomBox_((*geoms)[i]);
+        if (!box.isNull())
+            tree.insert(box, i);
+    }
+    tree.build();
+
+    std::vector<std::size_t> items;
+    std::vector<std::vector<std::pair<std::size_t, std::size_t>>> levels;
+    tree.levels(&items, &levels);
+
+    std::vector<OGRGeometryH> prev(items.size(), nullptr);
+    for (std::size_t j = 0; j < items.size(); ++j) {
+        prev[j] = (*geoms)[items[j]];
+        (*geoms)[items[j]] = nullptr;
+    }
+    destroyGeoms_(geoms);
+
+    if (levels.empty())
+        return OGR_G_CreateGeometry(wkbGeometryCollection);
+
+    std::atomic<bool> failed(false);
+    for (std::size_t k = 0; k < levels.size(); ++k) {
+        const std::vector<std::pair<std::size_t, std::size_t>> &nodes =
+                levels[k];
+        std::vector<OGRGeometryH> cur(nodes.size(), nullptr);
+
+        parallel_for_(nodes.size(), num_threads, [&](std::size_t j) {
+            std::vector<OGRGeometryH> parts;
+            parts.reserve(nodes[j].second);
+            for (std::size_t i = nodes[j].first;
+                    i < nodes[j].first + nodes[j].second; ++i) {
+                parts.push_back(prev[i]);
+                prev[i] = nullptr;
+            }
+            if (failed.load()) {
+                destroyGeoms_(&parts);
+                return;
+            }
+            // input geometries are always unioned (e.g., a single
+            // multipolygon with overlapping parts), intermediate results
+            // are passed up as is when a node has a single child
+            if (k > 0 && parts.size() == 1) {
+                cur[j] = parts[0];
+                return;
+            }
+            cur[j] = unionParts_(&parts);
+            if (cur[j] == nullptr)
+                failed.store(true);
+        });
+
+        destroyGeoms_(&prev);
+        prev.swap(cur);
+        if (failed.load()) {
+            destroyGeoms_(&prev);
+            return nullptr;
+        }
+    }
+
+    return prev[0];
+}
+
+namespace {
+
+// directed segment of a polygon ring, oriented with the polygon interior on
+// the left (shells counter-clockwise, holes clockwise)
+struct Seg {
+    double x0, y0, x1, y1;
+
+    bool operator==(const Seg &other) const {
+        return x0 == other.x0 && y0 == other.y0 && x1 == other.x1 &&
+               y1 == other.y1;
+    }
+};
+
+struct SegHash {
+    std::size_t operator()(const Seg &s) const {
+        std::size_t h = 0;
+        for (double v : {s.x0, s.y0, s.x1, s.y1}) {
+            // -0.0 == 0.0, so they must hash the same
+            if (v == 0.0)
+                v = 0.0;
+            uint64_t bits = 0;
+            std::memcpy(&bits, &v, sizeof(bits));
+            h ^= std::hash<uint64_t>()(bits) + 0x9e3779b97f4a7c15ULL +
+                 (h << 6) + (h >> 2);
+        }
+        return h;
+    }
+};
+
+typedef std::unordered_map<Seg, int, SegHash> SegCounts;
+
+// twice the signed area of a closed ring, positive if counter-clockwise
+double ringArea2_(const std::vector<double> &x, const std::vector<double> &y) {
+    double a2 = 0.0;
+    for (std::size_t i = 0; i + 1 < x.size(); ++i)
+        a2 += x[i] * y[i + 1] - x[i + 1] * y[i];
+    return a2;
+}
+
+bool ringPoints_(OGRGeometryH hRing, std::vector<double> *x,
+                 std::vector<double> *y) {
+    const int n = OGR_G_GetPointCount(hRing);
+    if (n < 4)
+        return false;
+    x->resize(n);
+    y->resize(n);
+    OGR_G_GetPoints(hRing, x->data(), sizeof(double), y->data(),
+                    sizeof(double), nullptr, 0);
+    return true;
+}
+
+// add the segments of a ring, cancelling any that match a segment of an
+// adjacent polygon in the opposite direction
+bool addRing_(OGRGeometryH hRing, bool is_shell, SegCounts *segs,
+              double *area) {
+
+    std::vector<double> x, y;
+    if (!ringPoints_(hRing, &x, &y))
+        return false;
+
+    const double a2 = ringArea2_(x, y);
+    if (a2 == 0.0 || std::isnan(a2))
+        return false;
+    *area += (is_shell ? 0.5 : -0.5) * std::fabs(a2);
+    const bool reverse = is_shell ? (a2 < 0) : (a2 > 0);
+
+    for (std::size_t i = 0; i + 1 < x.size(); ++i) {
+        Seg s = {x[i], y[i], x[i + 1], y[i + 1]};
+        if (reverse)
+            s = {x[i + 1], y[i + 1], x[i], y[i]};
+        if (s.x0 == s.x1 && s.y0 == s.y1)
+            continue;
+
+        auto it = segs->find({s.x1, s.y1, s.x0, s.y0});
+        if (it != segs->end()) {
+            if (--(it->second) == 0)
+                segs->erase(it);
+        }
+        else {
+            (*segs)[s] += 1;
+        }
+    }
+    return true;
+}
+
+// false if the geometry is not polygonal
+bool addPolygonal_(OGRGeometryH hGeom, SegCounts *segs, double *area) {
+    if (OGR_G_IsEmpty(hGeom))
+        return true;
+
+    switch (wkbFlatten(OGR_G_GetGeometryType(hGeom))) {
+        case wkbPolygon:
+        {
+            const int num_rings = OGR_G_GetGeometryCount(hGeom);
+            for (int r = 0; r < num_rings; ++r) {
+                if (!addRing_(OGR_G_GetGeometryRef(hGeom, r), r == 0, segs,
+                              area)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        case wkbMultiPolygon:
+        case wkbGeometryCollection:
+        {
+            const int num_parts = OGR_G_GetGeometryCount(hGeom);
+            for (int i = 0; i < num_parts; ++i) {
+                if (!addPolygonal_(OGR_G_GetGeometryRef(hGeom, i), segs,
+                                   area)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+// whether a face from polygonizing the boundary edges is part of the union:
+// its shell traversed counter-clockwise must follow the boundary edges in
+// their own direction, whereas the faces that fill holes (or gaps enclosed
+// by the coverage) traverse them in reverse
+bool isInteriorFace_(OGRGeometryH hFace, const SegCounts &segs) {
+    std::vector<double> x, y;
+    if (OGR_G_GetGeometryCount(hFace) < 1 ||
+            !ringPoints_(OGR_G_GetGeometryRef(hFace, 0), &x, &y)) {
+        return false;
+    }
+
+    const bool ccw = ringArea2_(x, y) > 0;
+    for (std::size_t i = 0; i + 1 < x.size(); ++i) {
+        if (x[i] == x[i + 1] && y[i] == y[i + 1])
+            continue;
+        if (ccw)
+            return segs.count({x[i], y[i], x[i + 1], y[i + 1]}) > 0;
+        else
+            return segs.count({x[i + 1], y[i + 1], x[i], y[i]}) > 0;
+    }
+    return false;
+}
+
+// coverage union of polygonal geoms (2D), not consuming them
+// nullptr if the input is not polygonal or not a valid, fully noded coverage
+OGRGeometryH coverageUnion_(const std::vector<OGRGeometryH> &geoms) {
+    SegCounts segs;
+    double area_in = 0.0;
+    for (OGRGeometryH hGeom : geoms) {
+        if (hGeom != nullptr && !addPolygonal_(hGeom, &segs, &area_in))
+            return nullptr;
+    }
+
+    // a segment in the same direction more than once means overlap
+    for (const auto &kv : segs) {
+        if (kv.second != 1)
+            return nullptr;
+    }
+
+    if (segs.empty())
+        return OGR_G_CreateGeometry(wkbGeometryCollection);
+
+    OGRGeometryH hLines = OGR_G_CreateGeometry(wkbMultiLineString);
+    for (const auto &kv : segs) {
+        OGRGeometryH hLine = OGR_G_CreateGeometry(wkbLineString);
+        OGR_G_AddPoint_2D(hLine, kv.first.x0, kv.first.y0);
+        OGR_G_AddPoint_2D(hLine, kv.first.x1, kv.first.y1);
+        OGR_G_AddGeometryDirectly(hLines, hLine);
+    }
+    OGRGeometryH hFaces = OGR_G_Polygonize(hLines);
+    OGR_G_DestroyGeometry(hLines);
+    if (hFaces == nullptr)
+        return nullptr;
+
+    OGRGeometryH hOut = OGR_G_CreateGeometry(wkbMultiPolygon);
+    const int num_faces = OGR_G_GetGeometryCount(hFaces);
+    for (int i = 0; i < num_faces; ++i) {
+        OGRGeometryH hFace = OGR_G_GetGeometryRef(hFaces, i);
+        if (isInteriorFace_(hFace, segs))
+            OGR_G_AddGeometry(hOut, hFace);
+    }
+    OGR_G_DestroyGeometry(hFaces);
+
+    // Segments only cancel when they match exactly, so an input that is not
+    // fully noded (e.g., a T-junction where one edge spans the edges of two
+    // neighbors) leaves internal edges that the area check cannot detect.
+    // The faces on either side of such an edge are both selected and share
+    // it, which makes the output invalid (the parts of a multipolygon, or a
+    // hole and its shell, may only touch at points).
+    const double area_out = OGR_G_Area(hOut);
+    if (OGR_G_GetGeometryCount(hOut) == 0 ||
+            std::fabs(area_out - area_in) > COVERAGE_AREA_TOL * area_in ||
+            !OGR_G_IsValid(hOut)) {
+        OGR_G_DestroyGeometry(hOut);
+        return nullptr;
+    }
+
+    if (OGR_G_GetGeometryCount(hOut) == 1) {
+        OGRGeometryH hPoly = OGR_G_Clone(OGR_G_GetGeometryRef(hOut, 0));
+        OGR_G_DestroyGeometry(hOut);
+        return hPoly;
+    }
+    return hOut;
+}
+
+// Union of each group of geometries (groups[g] lists indices into geoms),
+// consuming the geometries that are grouped. Groups are processed
+// concurrently when there are enough of them to occupy the threads,
+// otherwise one at a time with the levels of each cascade processed
+// concurrently. num_not_coverage receives the number of groups for which
+// coverage union was requested but the cascaded union had to be used.
+std::vector<WkbOut> unionGroups_(
+        std::vector<OGRGeometryH> *geoms,
+        const std::vector<std::vector<std::size_t>> &groups, bool coverage,
+        bool as_iso, OGRwkbByteOrder eOrder, int num_threads,
+        std::size_t *num_not_coverage) {
+
+    std::vector<WkbOut> out(groups.size());
+    std::vector<char> not_coverage(groups.size(), 0);
+
+    auto do_group = [&](std::size_t g, int threads) {
+        std::vector<OGRGeometryH> parts;
+        parts.reserve(groups[g].size());
+        for (std::size_t i : groups[g]) {
+            parts.push_back((*geoms)[i]);
+            (*geoms)[i] = nullptr;
+        }
+
+        OGRGeometryH hUnion = nullptr;
+        if (coverage) {
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            hUnion = coverageUnion_(parts);
+            CPLPopErrorHandler();
+            if (hUnion == nullptr)
+                not_coverage[g] = 1;
+        }
+        if (hUnion == nullptr)
+            hUnion = cascadedUnion_(&parts, threads);
+        destroyGeoms_(&parts);
+
+        if (hUnion == nullptr) {
+            out[g].err = WkbOutErr::OP_FAILED;
+            return;
+        }
+        exportGeomToWkbOut_(hUnion, eOrder, as_iso, &out[g]);
+        OGR_G_DestroyGeometry(hUnion);
+    };
+
+    const int max_threads = resolve_num_threads_(num_threads, geoms->size());
+    if (groups.size() >= 2 * static_cast<std::size_t>(max_threads)) {
+        parallel_for_(groups.size(), max_threads,
+                      [&](std::size_t g) { do_group(g, 1); });
+    }
+    else {
+        for (std::size_t g = 0; g < groups.size(); ++g)
+            do_group(g, max_threads);
+    }
+
+    *num_not_coverage = 0;
+    for (char c : not_coverage)
+        *num_not_coverage += (c != 0) ? 1 : 0;
+
+    return out;
+}
+
+// run unionGroups_() and report on the calling thread, destroys geoms
+Rcpp::List unionAggToList_(
+        std::vector<OGRGeometryH> *geoms,
+        const std::vector<std::vector<std::size_t>> &groups, bool coverage,
+        bool as_iso, OGRwkbByteOrder eOrder, bool quiet, int num_threads) {
+
+    std::size_t num_not_coverage = 0;
+    std::vector<WkbOut> out;
+    try {
+        out = unionGroups_(geoms, groups, coverage, as_iso, eOrder,
+                           num_threads, &num_not_coverage);
+    }
+    catch (...) {
+        destroyGeoms_(geoms);
+        throw;
+    }
+    // geometries that were not in any group
+    destroyGeoms_(geoms);
+
+    if (num_not_coverage > 0 && !quiet) {
+        Rcpp::warning("input is not a valid polygonal coverage for " +
+                      std::to_string(num_not_coverage) +
+                      " group(s), overlay union was used instead");
+    }
+
+    return wkbOutToList_(&out, "failed to compute union, NULL returned",
+                         quiet);
+}
+
+}  // namespace
+
+//' Union of a set of geometries as a list of WKB by group
+//' group is a 1-based group index for each element of geom (NA to skip the
+//' element), or length 0 to union all elements as one group
+//' @noRd
+// [[Rcpp::export(name = ".g_union_agg")]]
+Rcpp::List g_union_agg(const Rcpp::RObject &geom,
+                       const Rcpp::IntegerVector &group, int num_groups,
+                       bool coverage, bool as_iso,
+                       const std::string &byte_order, bool quiet,
+                       int num_threads) {
+
+    if (num_groups == NA_INTEGER || num_groups < 1)
+        Rcpp::stop("'num_groups' must be an integer >= 1");
+
+    const OGRwkbByteOrder eOrder = wkbByteOrderFromString_(byte_order);
+
+    std::vector<OGRGeometryH> geoms = geomsFromRObject_(geom, quiet);
+    if (group.size() > 0 &&
+            static_cast<std::size_t>(group.size()) != geoms.size()) {
+        destroyGeoms_(&geoms);
+        Rcpp::stop("'group' must have the same length as 'geom'");
+    }
+
+    std::vector<std::vector<std::size_t>> groups(num_groups);
+    for (std::size_t i = 0; i < geoms.size(); ++i) {
+        if (group.size() == 0) {
+            groups[0].push_back(i);
+            continue;
+        }
+        const int g = group[i];
+        if (g == NA_INTEGER)
+            continue;
+        if (g < 1 || g > num_groups) {
+            destroyGeoms_(&geoms);
+            Rcpp::stop("invalid group index in 'group'");
+        }
+        groups[g - 1].push_back(i);
+    }
+
+    return unionAggToList_(&geoms, groups, coverage, as_iso, eOrder, quiet,
+                           num_threads);
+}
+
+//' Union of the geometries of a vector layer grouped by the values of an
+//' attribute field (by = "" for no grouping)
+//' returns list(key, geom), key is the field value as string (NA for null),
+//' groups are in order of first occurrence
+//' @noRd
+// [[Rcpp::export(name = ".ogr_union_agg")]]
+Rcpp::List ogr_union_agg(GDALVector* const &lyr, const std::string &by,
+                         bool coverage, bool as_iso,
+                         const std::string &byte_order, bool quiet,
+                         int num_threads) {
+
+    if (!lyr->isOpen())
+        Rcpp::stop("'lyr' is not open");
+
+    const OGRwkbByteOrder eOrder = wkbByteOrderFromString_(byte_order);
+
+    OGRLayerH hLayer = lyr->getOGRLayerH_();
+    int fld_idx = -1;
+    if (by != "") {
+        fld_idx = OGR_FD_GetFieldIndex(OGR_L_GetLayerDefn(hLayer),
+                                       by.c_str());
+        if (fld_idx < 0)
+            Rcpp::stop("field not found: " + by);
+    }
+
+    std::vector<OGRGeometryH> geoms;
+    std::vector<std::vector<std::size_t>> groups;
+    std::vector<std::string> keys;
+    std::map<std::string, std::size_t> key_group;
+    std::size_t null_group = 0;
+    bool has_null_group = false;
+
+    OGR_L_ResetReading(hLayer);
+    OGRFeatureH hFeat = nullptr;
+    while ((hFeat = OGR_L_GetNextFeature(hLayer)) != nullptr) {
+        std::size_t g = 0;
+        if (fld_idx < 0 || !OGR_F_IsFieldSetAndNotNull(hFeat, fld_idx)) {
+            if (!has_null_group) {
+                null_group = groups.size();
+                has_null_group = true;
+                groups.emplace_back();
+                keys.emplace_back();
+            }
+            g = null_group;
+        }
+        else {
+            const std::string key(OGR_F_GetFieldAsString(hFeat, fld_idx));
+            auto it = key_group.find(key);
+            if (it == key_group.end()) {
+                g = groups.size();
+                key_group.emplace(key, g);
+                groups.emplace_back();
+                keys.push_back(key);
+            }
+            else {
+                g = it->second;
+            }
+        }
+        groups[g].push_back(geoms.size());
+        geoms.push_back(OGR_F_StealGeometry(hFeat));
+        OGR_F_Destroy(hFeat);
+    }
+    OGR_L_ResetReading(hLayer);
+
+    // without grouping, an empty layer still gives one (empty) result
+    if (fld_idx < 0 && groups.empty()) {
+        groups.emplace_back();
+        keys.emplace_back();
+        has_null_group = true;
+        null_group = 0;
+    }
+
+    Rcpp::CharacterVector key_out(keys.size());
+    for (std::size_t g = 0; g < keys.size(); ++g) {
+        if (has_null_group && g == null_group)
+            key_out[g] = NA_STRING;
+        else
+            key_out[g] = keys[g];
+    }
+
+    Rcpp::List geom_out = unionAggToList_(&geoms, groups, coverage, as_iso,
+                                          eOrder, quiet, num_threads);
+
+    return Rcpp::List::create(Rcpp::Named("key") = key_out,
+                              Rcpp::Named("geom") = geom_out);
+}
@@ -0,0 +1,36 @@
+/* Union aggregation of large sets of geometries, optionally grouped by key
+   Cascaded union over an STR packed R-tree, and coverage union for polygons
+   that form a non-overlapping coverage.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef GEOM_UNION_H_
+#define GEOM_UNION_H_
+
+#include <Rcpp.h>
+
+#include <ogr_api.h>
+
+#include <string>
+#include <vector>
+
+// cascaded union of geoms on num_threads, consuming them, nullptr on failure
+// (also used by the stitch step of tiled polygonize)
+OGRGeometryH cascadedUnion_(std::vector<OGRGeometryH> *geoms,
+                            int num_threads);
+
+Rcpp::List g_union_agg(const Rcpp::RObject &geom,
+                       const Rcpp::IntegerVector &group, int num_groups,
+                       bool coverage, bool as_iso,
+                       const std::string &byte_order, bool quiet,
+                       int num_threads);
+
+class GDALVector;
+Rcpp::List ogr_union_agg(GDALVector* const &lyr, const std::string &by,
+                         bool coverage, bool as_iso,
+                         const std::string &byte_order, bool quiet,
+                         int num_threads);
+
+#endif  // GEOM_UNION_H_
@@ -0,0 +1,316 @@
+/* Interpolation of point values to a raster grid
+
+   The points are indexed with an STR tree (strtree.h), which is read-only
+   once built and queried concurrently from the worker threads. The output
+   grid is divided into tiles of whole blocks, and the value at the center of
+   each pixel of a tile is computed from the points found by a k nearest
+   neighbor search (inverse distance weighting and nearest neighbor) or by
+   a search within a radius (moving average). For an open GDALRaster, tiles
+   are computed in batches and written on the main thread. For an array
+   output, tiles are written directly into the returned vector. Pixels with
+   fewer than min_points points in the search are set to nodata.
+
+   Inverse distance weighting takes the max_points nearest points within the
+   radius (any distance if radius is 0), z = sum(z_i / d_i^p) / sum(1 / d_i^p),
+   and a pixel center that coincides with a point gets the value of the
+   point, as in gdal_grid "invdist".
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_port.h>
+#include <gdal.h>
+
+#include <Rcpp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gdalraster.h"
+#include "grid_points.h"
+#include "rcpp_util.h"
+#include "strtree.h"
+#include "tile_util.h"
+
+namespace {
+
+enum GridMethod { GRID_IDW, GRID_NEAREST, GRID_AVERAGE };
+
+struct GridPoint {
+    double x;
+    double y;
+    double z;
+};
+
+struct GridParams {
+    GridMethod method {GRID_IDW};
+    double power {2.0};
+    double radius {0.0};  // 0 for no limit (IDW and nearest)
+    std::size_t max_points {12};
+    std::size_t min_points {1};
+    double gt[6] {0, 1, 0, 0, 0, 1};
+};
+
+// the points with their index
+struct GridPoints {
+    std::vector<GridPoint> pts;
+    STRtree tree;
+};
+
+GridParams gridParams_(const double *gt, const std::string &method,
+                       double power, double radius, int max_points,
+                       int min_points) {
+
+    GridParams p;
+    if (method == "idw") {
+        p.method = GRID_IDW;
+    } else if (method == "nearest") {
+        p.method = GRID_NEAREST;
+    } else if (method == "average") {
+        p.method = GRID_AVERAGE;
+    } else {
+        Rcpp::stop("'method' must be one of \"idw\", \"nearest\" or "
+                   "\"average\"");
+    }
+
+    if (!(radius >= 0))
+        Rcpp::stop("'radius' must be a non-negative number");
+    if (p.method == GRID_AVERAGE && radius == 0)
+        Rcpp::stop("'radius' is required for the moving average");
+    if (!(power > 0))
+        Rcpp::stop("'power' must be a positive number");
+    if (max_points < 1)
+        Rcpp::stop("'max_points' must be a positive integer");
+    if (min_points < 1)
+        Rcpp::stop("'min_points' must be a positive integer");
+
+    p.power = power;
+    p.radius = radius;
+    p.max_points = static_cast<std::size_t>(max_points);
+    p.min_points = static_cast<std::size_t>(min_points);
+    for (int i = 0; i < 6; ++i)
+        p.gt[i] = gt[i];
+    return p;
+}
+
+void readPoints_(const Rcpp::RObject &xyz, GridPoints *gp) {
+    const Rcpp::NumericMatrix m = xy_robject_to_matrix_(xyz);
+    if (m.ncol() < 3)
+        Rcpp::stop("'xyz' must have three columns");
+
+    for (R_xlen_t i = 0; i < m.nrow(); ++i) {
+        // points with a missing or infinite coordinate, or a missing value,
+        // are skipped
+        if (!std::isfinite(m(i, 0)) || !std::isfinite(m(i, 1)) ||
+                std::isnan(m(i, 2))) {
+            continue;
+        }
+        gp->pts.push_back({m(i, 0), m(i, 1), m(i, 2)});
+    }
+    if (gp->pts.empty())
+        Rcpp::stop("no points with valid coordinates and values");
+
+    for (std::size_t i = 0; i < gp->pts.size(); ++i) {
+        const GridPoint &pt = gp->pts[i];
+        gp->tree.insert(STRBox(pt.x, pt.y, pt.x, pt.y), i);
+    }
+    gp->tree.build();
+}
+
+// the interpolated value at (x, y), NaN if there are too few points
+double gridValue_(const GridParams &p, const GridPoints &gp, double x,
+                  double y, std::vector<std::size_t> *items,
+                  std::vector<std::pair<std::size_t, double>> *nn) {
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const STRBox q(x, y, x, y);
+    auto dist = [&gp, x, y](std::size_t i) {
+        return std::hypot(gp.pts[i].x - x, gp.pts[i].y - y);
+    };
+
+    if (p.method == GRID_AVERAGE) {
+        items->clear();
+        gp.tree.query(STRBox(x - p.radius, y - p.radius, x + p.radius,
+                             y + p.radius), items);
+        double sum = 0.0;
+        std::size_t n = 0;
+        for (std::size_t i : *items) {
+            if (dist(i) <= p.radius) {
+                sum += gp.pts[i].z;
+                n += 1;
+            }
+        }
+        return n < p.min_points ? nan : sum / n;
+    }
+
+    nn->clear();
+    const std::size_t k = p.method == GRID_NEAREST ? 1 : p.max_points;
+    const double max_dist = p.radius > 0 ? p.radius : -1.0;
+    gp.tree.nearest(q, k, max_dist, dist, nn);
+    if (p.method == GRID_NEAREST)
+        return nn->empty() ? nan : gp.pts[(*nn)[0].first].z;
+    if (nn->empty() || nn->size() < p.min_points)
+        return nan;
+
+    // nearest first, a coincident point gives its value
+    if ((*nn)[0].second == 0)
+        return gp.pts[(*nn)[0].first].z;
+    double num = 0.0;
+    double den = 0.0;
+    for (const auto &it : *nn) {
+        const double w = 1.0 / std::pow(it.second, p.power);
+        num += w * gp.pts[it.first].z;
+        den += w;
+    }
+    return num / den;
+}
+
+// compute tile t into out, where out points to the first pixel of the tile
+// and stride is the length of a row of out
+void gridTile_(const GridParams &p, const GridPoints &gp, const RasterTile &t,
+               double *out, std::size_t stride) {
+
+    std::vector<std::size_t> items;
+    std::vector<std::pair<std::size_t, double>> nn;
+    for (int r = t.yoff; r < t.yoff + t.ysize; ++r) {
+        double *out_row = out + (r - t.yoff) * stride - t.xoff;
+        for (int c = t.xoff; c < t.xoff + t.xsize; ++c) {
+            const double x = p.gt[0] + (c + 0.5) * p.gt[1] +
+                             (r + 0.5) * p.gt[2];
+            const double y = p.gt[3] + (c + 0.5) * p.gt[4] +
+                             (r + 0.5) * p.gt[5];
+            out_row[c] = gridValue_(p, gp, x, y, &items, &nn);
+        }
+    }
+}
+
+}  // namespace
+
+//' Interpolate point values into a band of an open raster, by tiles
+//' xyz is a matrix or data frame of x, y, z
+//' @noRd
+// [[Rcpp::export(name = ".grid_points_ds")]]
+bool grid_points_ds(const Rcpp::RObject &xyz,
+                    const GDALRaster* const &dst_ds, int band,
+                    const std::string &method, double power, double radius,
+                    int max_points, int min_points, int tile_size,
+                    int num_threads, bool quiet) {
+
+    dst_ds->checkAccess_(GA_Update);
+    GDALRasterBandH hBand = dst_ds->getBand_(band);
+    if (tile_size < 1)
+        Rcpp::stop("'tile_size' must be a positive integer");
+
+    const Rcpp::NumericVector gt_r = dst_ds->getGeoTransform();
+    const std::vector<double> gt(gt_r.begin(), gt_r.end());
+    const GridParams p = gridParams_(gt.data(), method, power, radius,
+                                     max_points, min_points);
+    GridPoints gp;
+    readPoints_(xyz, &gp);
+
+    const int xsize = GDALGetRasterBandXSize(hBand);
+    const int ysize = GDALGetRasterBandYSize(hBand);
+    int block_xsize = 0;
+    int block_ysize = 0;
+    GDALGetBlockSize(hBand, &block_xsize, &block_ysize);
+    const std::vector<RasterTile> tiles = makeTiles_(
+        xsize, ysize, tileDim_(tile_size, block_xsize, xsize),
+        tileDim_(tile_size, block_ysize, ysize));
+
+    int has_nodata = FALSE;
+    const double nodata = GDALGetRasterNoDataValue(hBand, &has_nodata);
+
+    const std::size_t batch_size = batchSize_(num_threads, tiles.size());
+    std::vector<std::vector<double>> bufs(batch_size);
+
+    GDALProgressFunc pfnProgress = GDALTermProgressR;
+    if (!quiet)
+        pfnProgress(0, nullptr, nullptr);
+
+    forTileBatches_(tiles.size(), num_threads,
+        [](std::size_t, std::size_t) {},
+        [&](std::size_t j, std::size_t i) {
+            const RasterTile &t = tiles[i];
+            bufs[j].resize(static_cast<std::size_t>(t.xsize) * t.ysize);
+            gridTile_(p, gp, t, bufs[j].data(), t.xsize);
+        },
+        [&](std::size_t j, std::size_t i) {
+            const RasterTile &t = tiles[i];
+            if (has_nodata) {
+                for (double &v : bufs[j]) {
+                    if (std::isnan(v))
+                        v = nodata;
+                }
+            }
+            if (GDALRasterIO(hBand, GF_Write, t.xoff, t.yoff, t.xsize,
+                             t.ysize, bufs[j].data(), t.xsize, t.ysize,
+                             GDT_Float64, 0, 0) != CE_None) {
+                Rcpp::stop("failed to write raster tile");
+            }
+            if (!quiet) {
+                pfnProgress(static_cast<double>(i + 1) / tiles.size(),
+                            nullptr, nullptr);
+            }
+        });
+
+    return true;
+}
+
+//' Interpolate point values on a new grid returned as a numeric vector of
+//' pixel values in left to right, top to bottom order
+//' @noRd
+// [[Rcpp::export(name = ".grid_points_grid")]]
+Rcpp::NumericVector grid_points_grid(const Rcpp::RObject &xyz,
+                                     const Rcpp::NumericVector &gt,
+                                     int xsize, int ysize,
+                                     const std::string &method, double power,
+                                     double radius, int max_points,
+                                     int min_points, int tile_size,
+                                     int num_threads, bool quiet) {
+
+    if (gt.size() != 6)
+        Rcpp::stop("'gt' must be a numeric vector of length 6");
+    if (xsize < 1 || ysize < 1)
+        Rcpp::stop("invalid raster dimensions");
+    if (tile_size < 1)
+        Rcpp::stop("'tile_size' must be a positive integer");
+
+    const std::vector<double> gt_in(gt.begin(), gt.end());
+    const GridParams p = gridParams_(gt_in.data(), method, power, radius,
+                                     max_points, min_points);
+    GridPoints gp;
+    readPoints_(xyz, &gp);
+    const std::vector<RasterTile> tiles = makeTiles_(
+        xsize, ysize, std::min(tile_size, xsize), std::min(tile_size, ysize));
+
+    Rcpp::NumericVector out = Rcpp::no_init(
+        static_cast<R_xlen_t>(xsize) * ysize);
+    double *out_data = out.begin();
+
+    if (!quiet)
+        GDALTermProgressR(0, nullptr, nullptr);
+
+    // tiles are disjoint regions of the output vector
+    parallel_for_(tiles.size(), num_threads, [&](std::size_t k) {
+        const RasterTile &t = tiles[k];
+        double *tile_out = out_data +
+                           static_cast<std::size_t>(t.yoff) * xsize + t.xoff;
+        gridTile_(p, gp, t, tile_out, xsize);
+    });
+
+    for (double &v : out) {
+        if (std::isnan(v))
+            v = NA_REAL;
+    }
+
+    if (!quiet)
+        GDALTermProgressR(1.0, nullptr, nullptr);
+
+    return out;
+}
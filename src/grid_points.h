@@ -0,0 +1,31 @@
+/* Interpolation of point values to a raster grid (inverse distance
+   weighting, nearest neighbor, moving average) from coordinate matrices,
+   with an in-memory spatial index, processed by tiles on multiple threads.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef GRID_POINTS_H_
+#define GRID_POINTS_H_
+
+#include <Rcpp.h>
+
+#include <string>
+
+class GDALRaster;
+bool grid_points_ds(const Rcpp::RObject &xyz,
+                    const GDALRaster* const &dst_ds, int band,
+                    const std::string &method, double power, double radius,
+                    int max_points, int min_points, int tile_size,
+                    int num_threads, bool quiet);
+
+Rcpp::NumericVector grid_points_grid(const Rcpp::RObject &xyz,
+                                     const Rcpp::NumericVector &gt,
+                                     int xsize, int ysize,
+                                     const std::string &method, double power,
+                                     double radius, int max_points,
+                                     int min_points, int tile_size,
+                                     int num_threads, bool quiet);
+
+#endif  // GRID_POINTS_H_
@@ -0,0 +1,652 @@
+/* Categorical landscape pattern metrics
+
+   Patches are the connected components of cells with the same value (4- or
+   8-connected, as in GDALPolygonize/GDALSieveFilter). The raster is divided
+   into tiles aligned with the blocks of the band. Each tile is read with a
+   one-pixel halo and labeled on a worker thread with a two-pass union-find,
+   accumulating for each local patch its number of cells, the number of cell
+   sides on its perimeter and its first cell in raster order, and for the
+   tile the counts of adjacent cell pairs by class (each pair counted once,
+   from its west or north cell). Only the local patch table and the labels
+   of the cells on the tile edges are kept. The local patches are then merged
+   across the tile seams with a global union-find, and patch ids are assigned
+   in the raster order of their first cell, so the result does not depend on
+   the tile size. If an output raster is given, the tiles are labeled again
+   and written with the global patch ids.
+
+   Metrics follow the definitions of FRAGSTATS (McGarigal et al. 2023):
+   total edge counts only the edges between different classes (not the
+   landscape boundary or edges with nodata), and contagion uses the
+   double-count method for like and unlike adjacencies.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_port.h>
+#include <gdal.h>
+
+#include <Rcpp.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dem_calc.h"
+#include "gdalraster.h"
+#include "landscape_metrics.h"
+#include "tile_util.h"
+
+namespace {
+
+struct PatchAcc {
+    double value {0};
+    int64_t n_cells {0};
+    int64_t sides_ew {0};  // perimeter sides facing east or west
+    int64_t sides_ns {0};  // perimeter sides facing north or south
+    int64_t first_cell {0};  // raster index of the first cell
+};
+
+// counts of adjacent cell pairs by class pair (lower value first), along
+// rows [0] and along columns [1]
+using AdjCounts = std::map<std::pair<double, double>,
+                           std::array<int64_t, 2>>;
+
+struct TileLabels {
+    std::vector<double> buf;
+    std::vector<int32_t> lab;
+    std::vector<PatchAcc> patches;
+    std::vector<int32_t> top;
+    std::vector<int32_t> bottom;
+    std::vector<int32_t> left;
+    std::vector<int32_t> right;
+    AdjCounts adj;
+};
+
+int32_t findRoot_(std::vector<int32_t> *parent, int32_t i) {
+    while ((*parent)[i] != i) {
+        (*parent)[i] = (*parent)[(*parent)[i]];
+        i = (*parent)[i];
+    }
+    return i;
+}
+
+int64_t findRoot_(std::vector<int64_t> *parent, int64_t i) {
+    while ((*parent)[i] != i) {
+        (*parent)[i] = (*parent)[(*parent)[i]];
+        i = (*parent)[i];
+    }
+    return i;
+}
+
+// Label the patches of tile t from buf (with a one-pixel halo, NaN for
+// nodata and outside the raster) with a two-pass union-find. lab receives
+// local patch ids numbered in order of first cell (-1 for nodata).
+void labelTile_(const RasterTile &t, bool conn8, int raster_xsize,
+                TileLabels *tl) {
+
+    const int w = t.xsize;
+    const int h = t.ysize;
+    const std::size_t stride = static_cast<std::size_t>(w) + 2;
+    const std::vector<double> &buf = tl->buf;
+    auto zAt = [&](int lc, int lr) {
+        return buf[(lr + 1) * stride + lc + 1];
+    };
+
+    // first pass: provisional labels from the west and north neighbors
+    // (and northwest and northeast for 8-connectedness)
+    const std::size_t n = static_cast<std::size_t>(w) * h;
+    std::vector<int32_t> &lab = tl->lab;
+    lab.assign(n, -1);
+    std::vector<int32_t> parent;
+    const int nbr_dc[4] = {-1, 0, -1, 1};
+    const int nbr_dr[4] = {0, -1, -1, -1};
+    const int num_nbr = conn8 ? 4 : 2;
+    for (int lr = 0; lr < h; ++lr) {
+        for (int lc = 0; lc < w; ++lc) {
+            const double v = zAt(lc, lr);
+            if (std::isnan(v))
+                continue;
+            int32_t l = -1;
+            for (int k = 0; k < num_nbr; ++k) {
+                const int nc = lc + nbr_dc[k];
+                const int nr = lr + nbr_dr[k];
+                if (nc < 0 || nr < 0 || nc >= w || zAt(nc, nr) != v)
+                    continue;
+                const int32_t r = findRoot_(&parent,
+                                            lab[static_cast<std::size_t>(nr) *
+                                                w + nc]);
+                if (l < 0) {
+                    l = r;
+                } else if (r != l) {
+                    const int32_t lo = std::min(l, r);
+                    parent[std::max(l, r)] = lo;
+                    l = lo;
+                }
+            }
+            if (l < 0) {
+                l = static_cast<int32_t>(parent.size());
+                parent.push_back(l);
+            }
+            lab[static_cast<std::size_t>(lr) * w + lc] = l;
+        }
+    }
+
+    // second pass: resolve to roots, numbered in order of first cell, and
+    // accumulate the patch attributes
+    std::vector<int32_t> id(parent.size(), -1);
+    tl->patches.clear();
+    for (int lr = 0; lr < h; ++lr) {
+        for (int lc = 0; lc < w; ++lc) {
+            const std::size_t c = static_cast<std::size_t>(lr) * w + lc;
+            if (lab[c] < 0)
+                continue;
+            const int32_t r = findRoot_(&parent, lab[c]);
+            if (id[r] < 0) {
+                id[r] = static_cast<int32_t>(tl->patches.size());
+                PatchAcc p;
+                p.value = zAt(lc, lr);
+                p.first_cell = static_cast<int64_t>(t.yoff + lr) *
+                               raster_xsize + t.xoff + lc;
+                tl->patches.push_back(p);
+            }
+            lab[c] = id[r];
+            PatchAcc &p = tl->patches[id[r]];
+            const double v = p.value;
+            p.n_cells += 1;
+            p.sides_ew += (zAt(lc - 1, lr) != v) + (zAt(lc + 1, lr) != v);
+            p.sides_ns += (zAt(lc, lr - 1) != v) + (zAt(lc, lr + 1) != v);
+        }
+    }
+}
+
+// class pair adjacencies with the east and south neighbors of each cell,
+// and the labels of the cells on the tile edges
+// The classes of the tile (from its local patches) and of the east and south
+// halo are mapped to dense indices once, and the pairs are counted in a flat
+// array indexed by class pair and direction, so the per-cell loop does no
+// lookups. The counts are then added to the AdjCounts map of the tile.
+void tileEdges_(const RasterTile &t, TileLabels *tl) {
+    const int w = t.xsize;
+    const int h = t.ysize;
+    const std::size_t n = static_cast<std::size_t>(w) * h;
+    const std::size_t stride = static_cast<std::size_t>(w) + 2;
+    auto zAt = [&](int lc, int lr) {
+        return tl->buf[(lr + 1) * stride + lc + 1];
+    };
+
+    std::vector<double> cls;
+    for (const PatchAcc &p : tl->patches)
+        cls.push_back(p.value);
+    for (int lr = 0; lr < h; ++lr) {
+        if (!std::isnan(zAt(w, lr)))
+            cls.push_back(zAt(w, lr));
+    }
+    for (int lc = 0; lc < w; ++lc) {
+        if (!std::isnan(zAt(lc, h)))
+            cls.push_back(zAt(lc, h));
+    }
+    std::sort(cls.begin(), cls.end());
+    cls.erase(std::unique(cls.begin(), cls.end()), cls.end());
+    const std::size_t ncls = cls.size();
+
+    // dense class index, or -1 for nodata
+    auto clsIdx = [&](double v) -> int32_t {
+        if (std::isnan(v))
+            return -1;
+        return static_cast<int32_t>(
+            std::lower_bound(cls.begin(), cls.end(), v) - cls.begin());
+    };
+    std::vector<int32_t> patch_cls(tl->patches.size());
+    for (std::size_t k = 0; k < tl->patches.size(); ++k)
+        patch_cls[k] = clsIdx(tl->patches[k].value);
+    std::vector<int32_t> east_cls(h);
+    for (int lr = 0; lr < h; ++lr)
+        east_cls[lr] = clsIdx(zAt(w, lr));
+    std::vector<int32_t> south_cls(w);
+    for (int lc = 0; lc < w; ++lc)
+        south_cls[lc] = clsIdx(zAt(lc, h));
+
+    // calls add(key) for each adjacent pair, with key = (lower class index
+    // * ncls + higher class index) * 2 + direction
+    auto forEachPair = [&](auto add) {
+        auto pairKey = [ncls](int32_t a, int32_t b, int dir) {
+            if (a > b)
+                std::swap(a, b);
+            return (static_cast<std::size_t>(a) * ncls + b) * 2 + dir;
+        };
+        for (int lr = 0; lr < h; ++lr) {
+            const int32_t *lab_row = tl->lab.data() +
+                                     static_cast<std::size_t>(lr) * w;
+            for (int lc = 0; lc < w; ++lc) {
+                if (lab_row[lc] < 0)
+                    continue;
+                const int32_t a = patch_cls[lab_row[lc]];
+                int32_t e = east_cls[lr];
+                if (lc + 1 < w)
+                    e = lab_row[lc + 1] < 0 ? -1 : patch_cls[lab_row[lc + 1]];
+                if (e >= 0)
+                    add(pairKey(a, e, 0));
+                int32_t s = south_cls[lc];
+                if (lr + 1 < h)
+                    s = lab_row[lc + w] < 0 ? -1 : patch_cls[lab_row[lc + w]];
+                if (s >= 0)
+                    add(pairKey(a, s, 1));
+            }
+        }
+    };
+
+    tl->adj.clear();
+    auto addCount = [&](std::size_t key, int64_t count) {
+        const std::size_t pair = key / 2;
+        tl->adj[std::make_pair(cls[pair / ncls], cls[pair % ncls])][key % 2] +=
+            count;
+    };
+    const std::size_t nkeys = 2 * ncls * ncls;
+    if (nkeys <= std::max<std::size_t>(2 * n, 4096)) {
+        std::vector<int64_t> cnt(nkeys, 0);
+        forEachPair([&](std::size_t key) { cnt[key] += 1; });
+        for (std::size_t key = 0; key < nkeys; ++key) {
+            if (cnt[key] > 0)
+                addCount(key, cnt[key]);
+        }
+    }
+    else {
+        // too many classes in the tile for the flat array, so the pair keys
+        // are sorted and counted in runs instead
+        std::vector<std::size_t> keys;
+        keys.reserve(2 * n);
+        forEachPair([&](std::size_t key) { keys.push_back(key); });
+        std::sort(keys.begin(), keys.end());
+        for (std::size_t k = 0; k < keys.size(); ) {
+            std::size_t k_end = k + 1;
+            while (k_end < keys.size() && keys[k_end] == keys[k])
+                ++k_end;
+            addCount(keys[k], static_cast<int64_t>(k_end - k));
+            k = k_end;
+        }
+    }
+
+    auto labAt = [&](int lc, int lr) {
+        return tl->lab[static_cast<std::size_t>(lr) * w + lc];
+    };
+    tl->top.resize(w);
+    tl->bottom.resize(w);
+    for (int lc = 0; lc < w; ++lc) {
+        tl->top[lc] = labAt(lc, 0);
+        tl->bottom[lc] = labAt(lc, h - 1);
+    }
+    tl->left.resize(h);
+    tl->right.resize(h);
+    for (int lr = 0; lr < h; ++lr) {
+        tl->left[lr] = labAt(0, lr);
+        tl->right[lr] = labAt(w - 1, lr);
+    }
+}
+
+struct ClassAcc {
+    int64_t n_patches {0};
+    int64_t n_cells {0};
+    int64_t largest {0};
+    double edge {0};
+};
+
+}  // namespace
+
+//' Label the patches of a categorical raster band by connected components,
+//' processed by tiles, and compute patch, class and landscape metrics,
+//' optionally writing the patch ids to band 1 of dst_ds
+//' @noRd
+// [[Rcpp::export(name = ".landscape_metrics")]]
+Rcpp::List landscape_metrics(const GDALRaster* const &src_ds, int band,
+                             int connectedness,
+                             const Rcpp::Nullable<Rcpp::RObject> &dst_ds,
+                             bool return_patches, int tile_size,
+                             int num_threads, bool quiet) {
+
+    if (connectedness != 4 && connectedness != 8)
+        Rcpp::stop("'connectedness' must be 4 or 8");
+    if (tile_size < 1)
+        Rcpp::stop("'tile_size' must be a positive integer");
+    const bool conn8 = (connectedness == 8);
+
+    GDALRasterBandH hBand = src_ds->getBand_(band);
+    const int xsize = GDALGetRasterBandXSize(hBand);
+    const int ysize = GDALGetRasterBandYSize(hBand);
+
+    GDALRasterBandH hDstBand = nullptr;
+    if (dst_ds.isNotNull()) {
+        const Rcpp::RObject obj(dst_ds.get());
+        const GDALRaster &dst = Rcpp::as<GDALRaster &>(obj);
+        dst.checkAccess_(GA_Update);
+        if (dst.getGDALDatasetH_() == src_ds->getGDALDatasetH_())
+            Rcpp::stop("'dst' must be a different dataset than the source");
+        hDstBand = dst.getBand_(1);
+        if (GDALGetRasterBandXSize(hDstBand) != xsize ||
+                GDALGetRasterBandYSize(hDstBand) != ysize) {
+            Rcpp::stop("'dst' must have the same raster dimensions as the "
+                       "source");
+        }
+    }
+
+    const Rcpp::NumericVector gt = src_ds->getGeoTransform();
+    const double dx = std::fabs(gt[1]);
+    const double dy = std::fabs(gt[5]);
+    const double cell_area = dx * dy;
+
+    int block_xsize = 0;
+    int block_ysize = 0;
+    GDALGetBlockSize(hBand, &block_xsize, &block_ysize);
+    const int tile_xsize = tileDim_(tile_size, block_xsize, xsize);
+    const int tile_ysize = tileDim_(tile_size, block_ysize, ysize);
+    const int ntx = (xsize + tile_xsize - 1) / tile_xsize;
+    const std::vector<RasterTile> tiles = makeTiles_(xsize, ysize, tile_xsize,
+                                                     tile_ysize);
+
+    // per tile: the local patches (offset into the global table) and the
+    // labels of the edge cells
+    std::vector<int64_t> patch_offset(tiles.size() + 1, 0);
+    std::vector<PatchAcc> patches;
+    std::vector<std::array<std::vector<int32_t>, 4>> edges(tiles.size());
+    AdjCounts adj;
+
+    const std::size_t batch_size = batchSize_(num_threads, tiles.size());
+    std::vector<TileLabels> work(batch_size);
+
+    GDALProgressFunc pfnProgress = GDALTermProgressR;
+    if (!quiet)
+        pfnProgress(0, nullptr, nullptr);
+    const double pass_frac = hDstBand ? 0.5 : 1.0;
+
+    forTileBatches_(tiles.size(), num_threads,
+        [&](std::size_t j, std::size_t i) {
+            const RasterTile &t = tiles[i];
+            if (!readHalo_(hBand, t.xoff, t.yoff, t.xsize, t.ysize,
+                           &work[j].buf)) {
+                Rcpp::stop("failed to read raster tile");
+            }
+        },
+        [&](std::size_t j, std::size_t i) {
+            labelTile_(tiles[i], conn8, xsize, &work[j]);
+            tileEdges_(tiles[i], &work[j]);
+        },
+        [&](std::size_t j, std::size_t i) {
+            patch_offset[i] = static_cast<int64_t>(patches.size());
+            patches.insert(patches.end(), work[j].patches.begin(),
+                           work[j].patches.end());
+            patch_offset[i + 1] = static_cast<int64_t>(patches.size());
+            edges[i][0].swap(work[j].top);
+            edges[i][1].swap(work[j].bottom);
+            edges[i][2].swap(work[j].left);
+            edges[i][3].swap(work[j].right);
+            for (const auto &a : work[j].adj) {
+                std::array<int64_t, 2> &cnt = adj[a.first];
+                cnt[0] += a.second[0];
+                cnt[1] += a.second[1];
+            }
+            if (!quiet) {
+                pfnProgress(pass_frac * (i + 1) / tiles.size(), nullptr,
+                            nullptr);
+            }
+        });
+
+    // merge the patches across tile seams
+    std::vector<int64_t> parent(patches.size());
+    std::iota(parent.begin(), parent.end(), 0);
+
+    // global label of raster cell (col, row) on the edge of its tile
+    auto labelAt = [&](int col, int row) -> int64_t {
+        const std::size_t i = static_cast<std::size_t>(row / tile_ysize) *
+                              ntx + col / tile_xsize;
+        const RasterTile &t = tiles[i];
+        const int lc = col - t.xoff;
+        const int lr = row - t.yoff;
+        int32_t l = -1;
+        if (lr == 0)
+            l = edges[i][0][lc];
+        else if (lr == t.ysize - 1)
+            l = edges[i][1][lc];
+        else if (lc == 0)
+            l = edges[i][2][lr];
+        else
+            l = edges[i][3][lr];
+        return l < 0 ? -1 : patch_offset[i] + l;
+    };
+
+    auto link = [&](int col_a, int row_a, int col_b, int row_b) {
+        if (col_b < 0 || row_b < 0 || col_b >= xsize || row_b >= ysize)
+            return;
+        const int64_t a = labelAt(col_a, row_a);
+        const int64_t b = labelAt(col_b, row_b);
+        if (a < 0 || b < 0 || patches[a].value != patches[b].value)
+            return;
+        const int64_t ra = findRoot_(&parent, a);
+        const int64_t rb = findRoot_(&parent, b);
+        if (ra != rb)
+            parent[std::max(ra, rb)] = std::min(ra, rb);
+    };
+
+    for (int x = tile_xsize; x < xsize; x += tile_xsize) {
+        for (int row = 0; row < ysize; ++row) {
+            link(x - 1, row, x, row);
+            if (conn8) {
+                link(x - 1, row, x, row - 1);
+                link(x - 1, row, x, row + 1);
+            }
+        }
+    }
+    for (int y = tile_ysize; y < ysize; y += tile_ysize) {
+        for (int col = 0; col < xsize; ++col) {
+            link(col, y - 1, col, y);
+            if (conn8) {
+                link(col, y - 1, col - 1, y);
+                link(col, y - 1, col + 1, y);
+            }
+        }
+    }
+    edges.clear();
+
+    // aggregate to the roots, then number the patches in raster order of
+    // their first cell
+    std::vector<int64_t> roots;
+    for (std::size_t i = 0; i < patches.size(); ++i) {
+        const int64_t r = findRoot_(&parent, static_cast<int64_t>(i));
+        if (r == static_cast<int64_t>(i)) {
+            roots.push_back(r);
+            continue;
+        }
+        PatchAcc &pr = patches[r];
+        pr.n_cells += patches[i].n_cells;
+        pr.sides_ew += patches[i].sides_ew;
+        pr.sides_ns += patches[i].sides_ns;
+        pr.first_cell = std::min(pr.first_cell, patches[i].first_cell);
+    }
+    std::sort(roots.begin(), roots.end(), [&](int64_t a, int64_t b) {
+        return patches[a].first_cell < patches[b].first_cell;
+    });
+    std::vector<double> patch_id(patches.size(), 0);
+    for (std::size_t k = 0; k < roots.size(); ++k)
+        patch_id[roots[k]] = static_cast<double>(k + 1);
+    for (std::size_t i = 0; i < patches.size(); ++i)
+        patch_id[i] = patch_id[findRoot_(&parent, static_cast<int64_t>(i))];
+
+    // write the patch ids by labeling each tile again
+    if (hDstBand != nullptr) {
+        int has_nodata = FALSE;
+        const double nodata = GDALGetRasterNoDataValue(hDstBand,
+                                                       &has_nodata);
+        const double fill = has_nodata ? nodata : 0;
+        forTileBatches_(tiles.size(), num_threads,
+            [&](std::size_t j, std::size_t i) {
+                const RasterTile &t = tiles[i];
+                if (!readHalo_(hBand, t.xoff, t.yoff, t.xsize, t.ysize,
+                               &work[j].buf)) {
+                    Rcpp::stop("failed to read raster tile");
+                }
+            },
+            [&](std::size_t j, std::size_t i) {
+                labelTile_(tiles[i], conn8, xsize, &work[j]);
+                // reuse buf for the output ids
+                std::vector<double> &out = work[j].buf;
+                out.resize(work[j].lab.size());
+                for (std::size_t c = 0; c < out.size(); ++c) {
+                    const int32_t l = work[j].lab[c];
+                    out[c] = l < 0 ? fill : patch_id[patch_offset[i] + l];
+                }
+            },
+            [&](std::size_t j, std::size_t i) {
+                const RasterTile &t = tiles[i];
+                if (GDALRasterIO(hDstBand, GF_Write, t.xoff, t.yoff, t.xsize,
+                                 t.ysize, work[j].buf.data(), t.xsize,
+                                 t.ysize, GDT_Float64, 0, 0) != CE_None) {
+                    Rcpp::stop("failed to write raster tile");
+                }
+                if (!quiet) {
+                    pfnProgress(0.5 + 0.5 * (i + 1) / tiles.size(), nullptr,
+                                nullptr);
+                }
+            });
+    }
+
+    // class metrics
+    std::map<double, ClassAcc> classes;
+    int64_t total_cells = 0;
+    int64_t largest = 0;
+    for (int64_t r : roots) {
+        ClassAcc &ca = classes[patches[r].value];
+        ca.n_patches += 1;
+        ca.n_cells += patches[r].n_cells;
+        ca.largest = std::max(ca.largest, patches[r].n_cells);
+        total_cells += patches[r].n_cells;
+        largest = std::max(largest, patches[r].n_cells);
+    }
+
+    double total_edge = 0;
+    std::map<double, double> adj_sum;  // double-count adjacencies by class
+    for (const auto &a : adj) {
+        const int64_t cnt = a.second[0] + a.second[1];
+        if (a.first.first == a.first.second) {
+            adj_sum[a.first.first] += 2.0 * cnt;
+            continue;
+        }
+        const double len = a.second[0] * dy + a.second[1] * dx;
+        classes[a.first.first].edge += len;
+        classes[a.first.second].edge += len;
+        total_edge += len;
+        adj_sum[a.first.first] += cnt;
+        adj_sum[a.first.second] += cnt;
+    }
+
+    const double total_area = total_cells * cell_area;
+    const std::size_t m = classes.size();
+    Rcpp::NumericVector cls_value(m), cls_np(m), cls_area(m), cls_pland(m),
+                        cls_te(m), cls_ed(m), cls_lpi(m), cls_mpa(m),
+                        cls_pd(m);
+    double shdi = 0;
+    std::size_t k = 0;
+    for (const auto &c : classes) {
+        const ClassAcc &ca = c.second;
+        const double p = static_cast<double>(ca.n_cells) / total_cells;
+        cls_value[k] = c.first;
+        cls_np[k] = static_cast<double>(ca.n_patches);
+        cls_area[k] = ca.n_cells * cell_area;
+        cls_pland[k] = 100.0 * p;
+        cls_te[k] = ca.edge;
+        cls_ed[k] = total_area > 0 ? 10000.0 * ca.edge / total_area : NA_REAL;
+        cls_lpi[k] = 100.0 * ca.largest / total_cells;
+        cls_mpa[k] = cls_area[k] / ca.n_patches;
+        cls_pd[k] = total_area > 0 ? 1e6 * ca.n_patches / total_area
+                                   : NA_REAL;
+        shdi -= p * std::log(p);
+        ++k;
+    }
+
+    // contagion, double-count method with like adjacencies
+    double contag = NA_REAL;
+    if (m > 1) {
+        double sum = 0;
+        for (const auto &a : adj) {
+            const double cnt = static_cast<double>(a.second[0] +
+                                                   a.second[1]);
+            const double vi = a.first.first;
+            const double vk = a.first.second;
+            const double pi = static_cast<double>(classes[vi].n_cells) /
+                              total_cells;
+            const double pk = static_cast<double>(classes[vk].n_cells) /
+                              total_cells;
+            if (vi == vk) {
+                const double q = pi * 2.0 * cnt / adj_sum[vi];
+                sum += q * std::log(q);
+            } else {
+                const double qi = pi * cnt / adj_sum[vi];
+                const double qk = pk * cnt / adj_sum[vk];
+                sum += qi * std::log(qi) + qk * std::log(qk);
+            }
+        }
+        contag = 100.0 * (1.0 + sum / (2.0 * std::log(static_cast<double>(m))));
+    }
+
+    Rcpp::DataFrame df_class = Rcpp::DataFrame::create(
+        Rcpp::Named("class") = cls_value,
+        Rcpp::Named("n_patches") = cls_np,
+        Rcpp::Named("area") = cls_area,
+        Rcpp::Named("pland") = cls_pland,
+        Rcpp::Named("total_edge") = cls_te,
+        Rcpp::Named("edge_density") = cls_ed,
+        Rcpp::Named("largest_patch_index") = cls_lpi,
+        Rcpp::Named("mean_patch_area") = cls_mpa,
+        Rcpp::Named("patch_density") = cls_pd);
+
+    const double np = static_cast<double>(roots.size());
+    Rcpp::DataFrame df_land = Rcpp::DataFrame::create(
+        Rcpp::Named("area") = total_area,
+        Rcpp::Named("n_classes") = static_cast<double>(m),
+        Rcpp::Named("n_patches") = np,
+        Rcpp::Named("patch_density") = total_area > 0 ?
+                                       1e6 * np / total_area : NA_REAL,
+        Rcpp::Named("total_edge") = total_edge,
+        Rcpp::Named("edge_density") = total_area > 0 ?
+                                      10000.0 * total_edge / total_area :
+                                      NA_REAL,
+        Rcpp::Named("largest_patch_index") = total_cells > 0 ?
+                                             100.0 * largest / total_cells :
+                                             NA_REAL,
+        Rcpp::Named("shannon_diversity") = m > 0 ? shdi : NA_REAL,
+        Rcpp::Named("contagion") = contag);
+
+    Rcpp::List out = Rcpp::List::create(Rcpp::Named("class") = df_class,
+                                        Rcpp::Named("landscape") = df_land);
+
+    if (return_patches) {
+        const R_xlen_t npatch = static_cast<R_xlen_t>(roots.size());
+        Rcpp::NumericVector p_id(npatch), p_class(npatch), p_cells(npatch),
+                            p_area(npatch), p_perim(npatch);
+        for (R_xlen_t i = 0; i < npatch; ++i) {
+            const PatchAcc &p = patches[roots[i]];
+            p_id[i] = static_cast<double>(i + 1);
+            p_class[i] = p.value;
+            p_cells[i] = static_cast<double>(p.n_cells);
+            p_area[i] = p.n_cells * cell_area;
+            p_perim[i] = p.sides_ew * dy + p.sides_ns * dx;
+        }
+        out["patches"] = Rcpp::DataFrame::create(
+            Rcpp::Named("patch_id") = p_id,
+            Rcpp::Named("class") = p_class,
+            Rcpp::Named("n_cells") = p_cells,
+            Rcpp::Named("area") = p_area,
+            Rcpp::Named("perimeter") = p_perim);
+    }
+
+    if (!quiet)
+        pfnProgress(1.0, nullptr, nullptr);
+
+    return out;
+}
@@ -0,0 +1,21 @@
+/* Categorical landscape pattern metrics from patches labeled by connected
+   component analysis of a raster band, processed by tiles on multiple
+   threads.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef LANDSCAPE_METRICS_H_
+#define LANDSCAPE_METRICS_H_
+
+#include <Rcpp.h>
+
+class GDALRaster;
+Rcpp::List landscape_metrics(const GDALRaster* const &src_ds, int band,
+                             int connectedness,
+                             const Rcpp::Nullable<Rcpp::RObject> &dst_ds,
+                             bool return_patches, int tile_size,
+                             int num_threads, bool quiet);
+
+#endif  // LANDSCAPE_METRICS_H_
@@ -0,0 +1,677 @@
+/* Execution of lazy raster expression graphs
+
+   The graph is a table of nodes in topological order (children before
+   parents, the root last), built in R by lazy_raster() and the functions
+   and operators on it. Each node has a grid (geotransform and size); the
+   children of arithmetic, reclass, focal and mask nodes are on the grid of
+   the node, and a resample node maps its child from another grid.
+
+   The output grid (the grid of the root) is processed in tiles of whole
+   blocks. For each tile, the window needed from each node is planned from
+   the root down: the tile itself for the root, the same window for the
+   children of element-wise nodes, the window expanded by the kernel for a
+   focal node, and the window of pixels around the mapped pixel centers for
+   a resample node. A node used by several parents is computed once over the
+   union of the windows they need. The windows of the read nodes are read on
+   the main thread, then all the other nodes are evaluated for the tile in
+   one pass on a worker thread, with no intermediate written to disk. Tiles
+   are processed in batches, and the output is written on the main thread.
+
+   Missing values (nodata, and pixels outside a source raster) are NaN and
+   propagate through arithmetic.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_port.h>
+#include <gdal.h>
+
+#include <Rcpp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "gdalraster.h"
+#include "lazy_raster.h"
+#include "tile_util.h"
+
+namespace {
+
+constexpr double LZ_NAN = std::numeric_limits<double>::quiet_NaN();
+
+enum LzOp { LZ_READ, LZ_UNARY, LZ_BINARY, LZ_RECLASS, LZ_FOCAL, LZ_MASK,
+            LZ_RESAMPLE };
+
+enum LzFn {
+    // binary
+    LZ_ADD, LZ_SUB, LZ_MUL, LZ_DIV, LZ_POW, LZ_MOD, LZ_IDIV,
+    LZ_EQ, LZ_NE, LZ_LT, LZ_LE, LZ_GT, LZ_GE, LZ_AND, LZ_OR,
+    // unary
+    LZ_NEG, LZ_NOT, LZ_ABS, LZ_SIGN, LZ_SQRT, LZ_FLOOR, LZ_CEILING,
+    LZ_TRUNC, LZ_ROUND, LZ_EXP, LZ_LOG, LZ_LOG10, LZ_LOG2, LZ_LOG1P,
+    LZ_EXPM1, LZ_SIN, LZ_COS, LZ_TAN,
+    // focal
+    LZ_SUM, LZ_MEAN, LZ_MIN, LZ_MAX,
+    // resample
+    LZ_NEAREST, LZ_BILINEAR,
+    LZ_NONE
+};
+
+struct LzFnName {
+    const char *name;
+    LzFn fn;
+};
+
+const LzFnName LZ_FN_NAMES[] = {
+    {"+", LZ_ADD}, {"-", LZ_SUB}, {"*", LZ_MUL}, {"/", LZ_DIV},
+    {"^", LZ_POW}, {"%%", LZ_MOD}, {"%/%", LZ_IDIV}, {"==", LZ_EQ},
+    {"!=", LZ_NE}, {"<", LZ_LT}, {"<=", LZ_LE}, {">", LZ_GT},
+    {">=", LZ_GE}, {"&", LZ_AND}, {"|", LZ_OR}, {"neg", LZ_NEG},
+    {"!", LZ_NOT}, {"abs", LZ_ABS}, {"sign", LZ_SIGN}, {"sqrt", LZ_SQRT},
+    {"floor", LZ_FLOOR}, {"ceiling", LZ_CEILING}, {"trunc", LZ_TRUNC},
+    {"round", LZ_ROUND}, {"exp", LZ_EXP}, {"log", LZ_LOG},
+    {"log10", LZ_LOG10}, {"log2", LZ_LOG2}, {"log1p", LZ_LOG1P},
+    {"expm1", LZ_EXPM1}, {"sin", LZ_SIN}, {"cos", LZ_COS}, {"tan", LZ_TAN},
+    {"sum", LZ_SUM}, {"mean", LZ_MEAN}, {"min", LZ_MIN}, {"max", LZ_MAX},
+    {"nearest", LZ_NEAREST}, {"bilinear", LZ_BILINEAR}
+};
+
+struct LzNode {
+    LzOp op {LZ_READ};
+    LzFn fn {LZ_NONE};
+    std::vector<int> children;
+    int src {-1};  // index into the sources for read nodes
+    int band {1};
+    double value {LZ_NAN};  // scalar operand, or mask update value
+    bool scalar_left {false};  // the scalar is the left operand
+    std::vector<double> params;  // reclass table, focal weights, mask values
+    int nrow {0};
+    int ncol {0};
+    double others {LZ_NAN};  // reclass value for unmatched pixels
+    bool keep_others {true};
+    bool inverse {false};
+    bool na_rm {false};
+    double gt[6] {0, 1, 0, 0, 0, 1};
+    double inv_gt[6] {0, 1, 0, 0, 0, 1};
+    int xsize {0};
+    int ysize {0};
+};
+
+// a window of pixels in the grid of a node, may extend outside the grid
+struct LzWindow {
+    int x0 {0};
+    int y0 {0};
+    int nx {0};
+    int ny {0};
+
+    bool empty() const { return nx <= 0 || ny <= 0; }
+
+    void unite(const LzWindow &w) {
+        if (w.empty())
+            return;
+        if (empty()) {
+            *this = w;
+            return;
+        }
+        const int x1 = std::max(x0 + nx, w.x0 + w.nx);
+        const int y1 = std::max(y0 + ny, w.y0 + w.ny);
+        x0 = std::min(x0, w.x0);
+        y0 = std::min(y0, w.y0);
+        nx = x1 - x0;
+        ny = y1 - y0;
+    }
+};
+
+// the values of a node over its window
+struct LzBuffer {
+    LzWindow w;
+    std::vector<double> v;
+
+    double at(int x, int y) const {
+        if (x < w.x0 || y < w.y0 || x >= w.x0 + w.nx || y >= w.y0 + w.ny)
+            return LZ_NAN;
+        return v[static_cast<std::size_t>(y - w.y0) * w.nx + (x - w.x0)];
+    }
+};
+
+LzFn parseFn_(const std::string &s) {
+    for (const LzFnName &f : LZ_FN_NAMES) {
+        if (s == f.name)
+            return f.fn;
+    }
+    Rcpp::stop("unsupported operation in the expression graph: " + s);
+}
+
+std::vector<LzNode> parseNodes_(const Rcpp::List &nodes, int num_sources) {
+    std::vector<LzNode> out;
+    for (R_xlen_t i = 0; i < nodes.size(); ++i) {
+        const Rcpp::List n = nodes[i];
+        LzNode node;
+        const std::string op = Rcpp::as<std::string>(n["op"]);
+        if (op == "read")
+            node.op = LZ_READ;
+        else if (op == "unary")
+            node.op = LZ_UNARY;
+        else if (op == "binary")
+            node.op = LZ_BINARY;
+        else if (op == "reclass")
+            node.op = LZ_RECLASS;
+        else if (op == "focal")
+            node.op = LZ_FOCAL;
+        else if (op == "mask")
+            node.op = LZ_MASK;
+        else if (op == "resample")
+            node.op = LZ_RESAMPLE;
+        else
+            Rcpp::stop("unknown node type in the expression graph: " + op);
+
+        const std::string fn = Rcpp::as<std::string>(n["fn"]);
+        if (fn != "")
+            node.fn = parseFn_(fn);
+        const Rcpp::IntegerVector children = n["children"];
+        for (int c : children) {
+            if (c < 0 || c >= static_cast<int>(i))
+                Rcpp::stop("the expression graph is not in topological order");
+            node.children.push_back(c);
+        }
+        node.src = Rcpp::as<int>(n["src"]);
+        if (node.op == LZ_READ && (node.src < 0 || node.src >= num_sources))
+            Rcpp::stop("invalid source index in the expression graph");
+        node.band = Rcpp::as<int>(n["band"]);
+        node.value = Rcpp::as<double>(n["value"]);
+        node.scalar_left = Rcpp::as<bool>(n["scalar_left"]);
+        const Rcpp::NumericVector params = n["params"];
+        node.params.assign(params.begin(), params.end());
+        node.nrow = Rcpp::as<int>(n["nrow"]);
+        node.ncol = Rcpp::as<int>(n["ncol"]);
+        node.others = Rcpp::as<double>(n["others"]);
+        node.keep_others = Rcpp::as<bool>(n["keep_others"]);
+        node.inverse = Rcpp::as<bool>(n["inverse"]);
+        node.na_rm = Rcpp::as<bool>(n["na_rm"]);
+        const Rcpp::NumericVector gt = n["gt"];
+        if (gt.size() != 6)
+            Rcpp::stop("invalid geotransform in the expression graph");
+        for (int k = 0; k < 6; ++k)
+            node.gt[k] = gt[k];
+        if (!GDALInvGeoTransform(node.gt, node.inv_gt))
+            Rcpp::stop("could not get inverse geotransform");
+        node.xsize = Rcpp::as<int>(n["xsize"]);
+        node.ysize = Rcpp::as<int>(n["ysize"]);
+
+        const std::size_t nchild = node.children.size();
+        const bool ok =
+            (node.op == LZ_READ && nchild == 0) ||
+            (node.op == LZ_UNARY && nchild == 1) ||
+            (node.op == LZ_BINARY && (nchild == 2 || nchild == 1)) ||
+            (node.op == LZ_RECLASS && nchild == 1 &&
+             (node.ncol == 2 || node.ncol == 3) &&
+             node.params.size() ==
+                 static_cast<std::size_t>(node.nrow) * node.ncol) ||
+            (node.op == LZ_FOCAL && nchild == 1 && node.nrow % 2 == 1 &&
+             node.ncol % 2 == 1 &&
+             node.params.size() ==
+                 static_cast<std::size_t>(node.nrow) * node.ncol) ||
+            (node.op == LZ_MASK && nchild == 2) ||
+            (node.op == LZ_RESAMPLE && nchild == 1);
+        if (!ok)
+            Rcpp::stop("invalid node in the expression graph: " + op);
+        out.push_back(node);
+    }
+    if (out.empty())
+        Rcpp::stop("the expression graph is empty");
+    return out;
+}
+
+// the window of a resample node's child covering the pixel centers of w,
+// with one pixel of margin for bilinear, clipped to the child grid
+LzWindow resampleWindow_(const LzNode &node, const LzNode &child,
+                         const LzWindow &w) {
+
+    double xmin = std::numeric_limits<double>::infinity();
+    double ymin = xmin;
+    double xmax = -xmin;
+    double ymax = -xmin;
+    const double cx[2] = {w.x0 + 0.5, w.x0 + w.nx - 0.5};
+    const double cy[2] = {w.y0 + 0.5, w.y0 + w.ny - 0.5};
+    for (double px : cx) {
+        for (double py : cy) {
+            const double gx = node.gt[0] + px * node.gt[1] + py * node.gt[2];
+            const double gy = node.gt[3] + px * node.gt[4] + py * node.gt[5];
+            const double qx = child.inv_gt[0] + gx * child.inv_gt[1] +
+                              gy * child.inv_gt[2];
+            const double qy = child.inv_gt[3] + gx * child.inv_gt[4] +
+                              gy * child.inv_gt[5];
+            xmin = std::min(xmin, qx);
+            xmax = std::max(xmax, qx);
+            ymin = std::min(ymin, qy);
+            ymax = std::max(ymax, qy);
+        }
+    }
+
+    const double x0 = std::max(std::floor(xmin) - 1, -1.0);
+    const double y0 = std::max(std::floor(ymin) - 1, -1.0);
+    const double x1 = std::min(std::floor(xmax) + 2, child.xsize + 1.0);
+    const double y1 = std::min(std::floor(ymax) + 2, child.ysize + 1.0);
+    LzWindow cw;
+    if (x1 > x0 && y1 > y0) {
+        cw.x0 = static_cast<int>(x0);
+        cw.y0 = static_cast<int>(y0);
+        cw.nx = static_cast<int>(x1 - x0);
+        cw.ny = static_cast<int>(y1 - y0);
+    }
+    return cw;
+}
+
+// windows needed from each node to compute tile t of the root
+void planWindows_(const std::vector<LzNode> &nodes, const RasterTile &t,
+                  std::vector<LzWindow> *windows) {
+
+    windows->assign(nodes.size(), LzWindow());
+    LzWindow &w = windows->back();
+    w.x0 = t.xoff;
+    w.y0 = t.yoff;
+    w.nx = t.xsize;
+    w.ny = t.ysize;
+    for (std::size_t i = nodes.size(); i-- > 0; ) {
+        const LzNode &node = nodes[i];
+        const LzWindow &nw = (*windows)[i];
+        if (nw.empty())
+            continue;
+        for (int c : node.children) {
+            LzWindow cw = nw;
+            if (node.op == LZ_FOCAL) {
+                cw.x0 -= node.ncol / 2;
+                cw.y0 -= node.nrow / 2;
+                cw.nx += 2 * (node.ncol / 2);
+                cw.ny += 2 * (node.nrow / 2);
+            } else if (node.op == LZ_RESAMPLE) {
+                cw = resampleWindow_(node, nodes[c], nw);
+            }
+            (*windows)[c].unite(cw);
+        }
+    }
+}
+
+// read window w of a band, NaN outside the raster and for nodata
+bool readWindow_(GDALRasterBandH hBand, const LzWindow &w, LzBuffer *buf) {
+    buf->w = w;
+    buf->v.assign(static_cast<std::size_t>(w.nx) * w.ny, LZ_NAN);
+
+    const int rxsize = GDALGetRasterBandXSize(hBand);
+    const int rysize = GDALGetRasterBandYSize(hBand);
+    const int cx0 = std::max(0, w.x0);
+    const int cy0 = std::max(0, w.y0);
+    const int cx1 = std::min(rxsize, w.x0 + w.nx);
+    const int cy1 = std::min(rysize, w.y0 + w.ny);
+    if (cx1 <= cx0 || cy1 <= cy0)
+        return true;
+
+    double *dst = buf->v.data() +
+                  static_cast<std::size_t>(cy0 - w.y0) * w.nx + (cx0 - w.x0);
+    if (GDALRasterIO(hBand, GF_Read, cx0, cy0, cx1 - cx0, cy1 - cy0, dst,
+                     cx1 - cx0, cy1 - cy0, GDT_Float64, 0,
+                     static_cast<int>(w.nx * sizeof(double))) != CE_None) {
+        return false;
+    }
+
+    int has_nodata = FALSE;
+    const double nodata = GDALGetRasterNoDataValue(hBand, &has_nodata);
+    if (has_nodata && !std::isnan(nodata)) {
+        for (double &v : buf->v) {
+            if (v == nodata)
+                v = LZ_NAN;
+        }
+    }
+    return true;
+}
+
+double binary_(LzFn fn, double a, double b) {
+    switch (fn) {
+        case LZ_ADD: return a + b;
+        case LZ_SUB: return a - b;
+        case LZ_MUL: return a * b;
+        case LZ_DIV: return a / b;
+        case LZ_POW: return std::pow(a, b);
+        case LZ_MOD: return a - std::floor(a / b) * b;
+        case LZ_IDIV: return std::floor(a / b);
+        // three-valued logic as in R, NA & FALSE is FALSE and NA | TRUE is
+        // TRUE (a NaN operand compares unequal to 0 and is tested first)
+        case LZ_AND:
+            if (a == 0 || b == 0)
+                return 0;
+            return (std::isnan(a) || std::isnan(b)) ? LZ_NAN : 1;
+        case LZ_OR:
+            if ((!std::isnan(a) && a != 0) || (!std::isnan(b) && b != 0))
+                return 1;
+            return (std::isnan(a) || std::isnan(b)) ? LZ_NAN : 0;
+        default: break;
+    }
+    if (std::isnan(a) || std::isnan(b))
+        return LZ_NAN;
+    switch (fn) {
+        case LZ_EQ: return a == b;
+        case LZ_NE: return a != b;
+        case LZ_LT: return a < b;
+        case LZ_LE: return a <= b;
+        case LZ_GT: return a > b;
+        case LZ_GE: return a >= b;
+        default: return LZ_NAN;
+    }
+}
+
+double unary_(LzFn fn, double a) {
+    switch (fn) {
+        case LZ_NEG: return -a;
+        case LZ_NOT: return std::isnan(a) ? LZ_NAN : (a == 0);
+        case LZ_ABS: return std::fabs(a);
+        case LZ_SIGN: return std::isnan(a) ? LZ_NAN : (a > 0) - (a < 0);
+        case LZ_SQRT: return std::sqrt(a);
+        case LZ_FLOOR: return std::floor(a);
+        case LZ_CEILING: return std::ceil(a);
+        case LZ_TRUNC: return std::trunc(a);
+        case LZ_ROUND: return std::nearbyint(a);
+        case LZ_EXP: return std::exp(a);
+        case LZ_LOG: return std::log(a);
+        case LZ_LOG10: return std::log10(a);
+        case LZ_LOG2: return std::log2(a);
+        case LZ_LOG1P: return std::log1p(a);
+        case LZ_EXPM1: return std::expm1(a);
+        case LZ_SIN: return std::sin(a);
+        case LZ_COS: return std::cos(a);
+        case LZ_TAN: return std::tan(a);
+        default: return LZ_NAN;
+    }
+}
+
+double reclass_(const LzNode &node, double v) {
+    if (std::isnan(v))
+        return LZ_NAN;
+    const std::vector<double> &t = node.params;  // column-major table
+    const int n = node.nrow;
+    for (int r = 0; r < n; ++r) {
+        if (node.ncol == 2) {
+            if (v == t[r])
+                return t[n + r];
+        } else if (v > t[r] && v <= t[n + r]) {
+            return t[2 * n + r];
+        }
+    }
+    return node.keep_others ? v : node.others;
+}
+
+double focal_(const LzNode &node, const LzBuffer &in, int x, int y) {
+    const int hr = node.nrow / 2;
+    const int hc = node.ncol / 2;
+    double sum = 0.0;
+    double wsum = 0.0;
+    double ext = node.fn == LZ_MIN ? std::numeric_limits<double>::infinity()
+                                   : -std::numeric_limits<double>::infinity();
+    bool any = false;
+    for (int c = 0; c < node.ncol; ++c) {
+        for (int r = 0; r < node.nrow; ++r) {
+            const double wt = node.params[static_cast<std::size_t>(c) *
+                                          node.nrow + r];
+            if (wt == 0)
+                continue;
+            const double v = in.at(x + c - hc, y + r - hr);
+            if (std::isnan(v)) {
+                if (node.na_rm)
+                    continue;
+                return LZ_NAN;
+            }
+            any = true;
+            sum += wt * v;
+            wsum += wt;
+            if (node.fn == LZ_MIN)
+                ext = std::min(ext, v);
+            else if (node.fn == LZ_MAX)
+                ext = std::max(ext, v);
+        }
+    }
+    if (!any)
+        return LZ_NAN;
+    switch (node.fn) {
+        case LZ_SUM: return sum;
+        case LZ_MEAN: return sum / wsum;
+        default: return ext;
+    }
+}
+
+bool masked_(const LzNode &node, double m) {
+    bool hit = false;
+    if (node.params.empty()) {
+        hit = std::isnan(m);
+    } else {
+        for (double mv : node.params) {
+            if ((std::isnan(mv) && std::isnan(m)) || mv == m) {
+                hit = true;
+                break;
+            }
+        }
+    }
+    return node.inverse ? !hit : hit;
+}
+
+double resample_(const LzNode &node, const LzNode &child, const LzBuffer &in,
+                 int x, int y) {
+    const double gx = node.gt[0] + (x + 0.5) * node.gt[1] +
+                      (y + 0.5) * node.gt[2];
+    const double gy = node.gt[3] + (x + 0.5) * node.gt[4] +
+                      (y + 0.5) * node.gt[5];
+    const double qx = child.inv_gt[0] + gx * child.inv_gt[1] +
+                      gy * child.inv_gt[2];
+    const double qy = child.inv_gt[3] + gx * child.inv_gt[4] +
+                      gy * child.inv_gt[5];
+    if (node.fn == LZ_NEAREST) {
+        return in.at(static_cast<int>(std::floor(qx)),
+                     static_cast<int>(std::floor(qy)));
+    }
+
+    // bilinear, with the weights of missing neighbors redistributed
+    const double fx = qx - 0.5;
+    const double fy = qy - 0.5;
+    const int i0 = static_cast<int>(std::floor(fx));
+    const int j0 = static_cast<int>(std::floor(fy));
+    const double ax = fx - i0;
+    const double ay = fy - j0;
+    double sum = 0.0;
+    double wsum = 0.0;
+    for (int dj = 0; dj < 2; ++dj) {
+        for (int di = 0; di < 2; ++di) {
+            const double v = in.at(i0 + di, j0 + dj);
+            if (std::isnan(v))
+                continue;
+            const double wt = (di ? ax : 1.0 - ax) * (dj ? ay : 1.0 - ay);
+            sum += wt * v;
+            wsum += wt;
+        }
+    }
+    return wsum > 0 ? sum / wsum : LZ_NAN;
+}
+
+// evaluate the non-read nodes of a tile, bufs holds the read nodes on
+// input (runs on worker threads and does not call the R API)
+void evalTile_(const std::vector<LzNode> &nodes,
+               const std::vector<LzWindow> &windows,
+               std::vector<LzBuffer> *bufs) {
+
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        const LzNode &node = nodes[i];
+        const LzWindow &w = windows[i];
+        if (node.op == LZ_READ || w.empty())
+            continue;
+
+        LzBuffer &out = (*bufs)[i];
+        out.w = w;
+        out.v.assign(static_cast<std::size_t>(w.nx) * w.ny, LZ_NAN);
+        const LzBuffer &a = (*bufs)[node.children[0]];
+        const LzBuffer *b = node.children.size() > 1 ?
+                            &(*bufs)[node.children[1]] : nullptr;
+
+        std::size_t k = 0;
+        for (int y = w.y0; y < w.y0 + w.ny; ++y) {
+            for (int x = w.x0; x < w.x0 + w.nx; ++x, ++k) {
+                // windows padded for a focal parent extend past the grid,
+                // and no op may produce a value there
+                if (x < 0 || x >= node.xsize || y < 0 || y >= node.ysize)
+                    continue;
+                double v = LZ_NAN;
+                switch (node.op) {
+                    case LZ_UNARY:
+                        v = unary_(node.fn, a.at(x, y));
+                        break;
+                    case LZ_BINARY:
+                        if (b)
+                            v = binary_(node.fn, a.at(x, y), b->at(x, y));
+                        else if (node.scalar_left)
+                            v = binary_(node.fn, node.value, a.at(x, y));
+                        else
+                            v = binary_(node.fn, a.at(x, y), node.value);
+                        break;
+                    case LZ_RECLASS:
+                        v = reclass_(node, a.at(x, y));
+                        break;
+                    case LZ_FOCAL:
+                        v = focal_(node, a, x, y);
+                        break;
+                    case LZ_MASK:
+                        v = masked_(node, b->at(x, y)) ? node.value
+                                                       : a.at(x, y);
+                        break;
+                    case LZ_RESAMPLE:
+                        v = resample_(node, nodes[node.children[0]], a, x, y);
+                        break;
+                    default:
+                        break;
+                }
+                out.v[k] = v;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+//' Execute a lazy raster expression graph block by block, writing into a
+//' band of dst_ds, or returning a numeric vector if dst_ds is NULL
+//' nodes is the node table in topological order (see R/lazy_raster.R),
+//' sources is a list of GDALRaster objects for the read nodes
+//' @noRd
+// [[Rcpp::export(name = ".lazy_compute")]]
+SEXP lazy_compute(const Rcpp::List &nodes, const Rcpp::List &sources,
+                  const Rcpp::Nullable<Rcpp::RObject> &dst_ds, int band,
+                  int tile_size, int num_threads, bool quiet) {
+
+    if (tile_size < 1)
+        Rcpp::stop("'tile_size' must be a positive integer");
+
+    const std::vector<LzNode> graph = parseNodes_(
+        nodes, static_cast<int>(sources.size()));
+    const LzNode &root = graph.back();
+
+    std::vector<GDALRasterBandH> src_bands(graph.size(), nullptr);
+    for (std::size_t i = 0; i < graph.size(); ++i) {
+        if (graph[i].op != LZ_READ)
+            continue;
+        Rcpp::RObject obj = sources[graph[i].src];
+        const GDALRaster &ds = Rcpp::as<GDALRaster &>(obj);
+        src_bands[i] = ds.getBand_(graph[i].band);
+    }
+
+    GDALRasterBandH hDstBand = nullptr;
+    int has_dst_nodata = FALSE;
+    double dst_nodata = 0;
+    int block_xsize = 0;
+    int block_ysize = 0;
+    if (dst_ds.isNotNull()) {
+        Rcpp::RObject obj(dst_ds.get());
+        const GDALRaster &dst = Rcpp::as<GDALRaster &>(obj);
+        dst.checkAccess_(GA_Update);
+        hDstBand = dst.getBand_(band);
+        if (GDALGetRasterBandXSize(hDstBand) != root.xsize ||
+                GDALGetRasterBandYSize(hDstBand) != root.ysize) {
+            Rcpp::stop("the output must have the raster dimensions of the "
+                       "expression");
+        }
+        for (std::size_t i = 0; i < graph.size(); ++i) {
+            if (src_bands[i] == hDstBand)
+                Rcpp::stop("the output cannot be a source of the expression");
+        }
+        dst_nodata = GDALGetRasterNoDataValue(hDstBand, &has_dst_nodata);
+        GDALGetBlockSize(hDstBand, &block_xsize, &block_ysize);
+    }
+
+    const std::vector<RasterTile> tiles = makeTiles_(
+        root.xsize, root.ysize, tileDim_(tile_size, block_xsize, root.xsize),
+        tileDim_(tile_size, block_ysize, root.ysize));
+
+    Rcpp::NumericVector out_vec;
+    if (!hDstBand) {
+        out_vec = Rcpp::no_init(static_cast<R_xlen_t>(root.xsize) *
+                                root.ysize);
+    }
+
+    const std::size_t batch_size = batchSize_(num_threads, tiles.size());
+    std::vector<std::vector<LzWindow>> windows(batch_size);
+    std::vector<std::vector<LzBuffer>> bufs(batch_size);
+
+    GDALProgressFunc pfnProgress = GDALTermProgressR;
+    if (!quiet)
+        pfnProgress(0, nullptr, nullptr);
+
+    forTileBatches_(tiles.size(), num_threads,
+        [&](std::size_t j, std::size_t i) {
+            planWindows_(graph, tiles[i], &windows[j]);
+            bufs[j].assign(graph.size(), LzBuffer());
+            for (std::size_t k = 0; k < graph.size(); ++k) {
+                if (graph[k].op != LZ_READ || windows[j][k].empty())
+                    continue;
+                if (!readWindow_(src_bands[k], windows[j][k], &bufs[j][k]))
+                    Rcpp::stop("failed to read a source raster");
+            }
+        },
+        [&](std::size_t j, std::size_t) {
+            evalTile_(graph, windows[j], &bufs[j]);
+        },
+        [&](std::size_t j, std::size_t i) {
+            const RasterTile &t = tiles[i];
+            std::vector<double> &v = bufs[j].back().v;
+            if (hDstBand) {
+                if (has_dst_nodata) {
+                    for (double &x : v) {
+                        if (std::isnan(x))
+                            x = dst_nodata;
+                    }
+                }
+                if (GDALRasterIO(hDstBand, GF_Write, t.xoff, t.yoff, t.xsize,
+                                 t.ysize, v.data(), t.xsize, t.ysize,
+                                 GDT_Float64, 0, 0) != CE_None) {
+                    Rcpp::stop("failed to write the output raster");
+                }
+            } else {
+                for (int r = 0; r < t.ysize; ++r) {
+                    for (int c = 0; c < t.xsize; ++c) {
+                        const double x = v[static_cast<std::size_t>(r) *
+                                           t.xsize + c];
+                        out_vec[static_cast<R_xlen_t>(t.yoff + r) *
+                                root.xsize + t.xoff + c] =
+                            std::isnan(x) ? NA_REAL : x;
+                    }
+                }
+            }
+            bufs[j].clear();
+            if (!quiet) {
+                pfnProgress(static_cast<double>(i + 1) / tiles.size(),
+                            nullptr, nullptr);
+            }
+        });
+
+    if (hDstBand)
+        return Rcpp::wrap(true);
+    return out_vec;
+}
@@ -0,0 +1,19 @@
+/* Execution of lazy raster expression graphs (read, arithmetic, reclass,
+   focal, mask and resample nodes over GDALRaster sources), fused per block
+   of the output and run on multiple threads.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef LAZY_RASTER_H_
+#define LAZY_RASTER_H_
+
+#include <Rcpp.h>
+
+class GDALRaster;
+SEXP lazy_compute(const Rcpp::List &nodes, const Rcpp::List &sources,
+                  const Rcpp::Nullable<Rcpp::RObject> &dst_ds, int band,
+                  int tile_size, int num_threads, bool quiet);
+
+#endif  // LAZY_RASTER_H_
@@ -0,0 +1,109 @@
+/* Helpers for running loops on worker threads
+   Work functions run on std::thread and must not call the R API (no Rcpp
+   object allocation, no Rcpp::warning/stop, no Rcout). GDAL errors raised on
+   worker threads go to a quiet thread-local handler since the package error
+   handler writes to the R console.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef PARALLEL_UTIL_H_
+#define PARALLEL_UTIL_H_
+
+#include <cpl_conv.h>
+#include <cpl_error.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// num_threads < 1 means use all available CPUs, and never use more threads
+// than there are tasks
+inline int resolve_num_threads_(int num_threads, std::size_t num_tasks) {
+    int n = num_threads;
+    if (n < 1)
+        n = CPLGetNumCPUs();
+    if (n < 1)
+        n = 1;
+    if (num_tasks < static_cast<std::size_t>(n))
+        n = static_cast<int>(std::max<std::size_t>(num_tasks, 1));
+    return n;
+}
+
+// Call fn(t, i) for i in [0, n), where t in [0, nthreads) identifies the
+// thread running task i and nthreads = resolve_num_threads_(num_threads,
+// ceil(n / grain)). The thread index can be used to select per-thread objects
+// that are not thread-safe (e.g., a coordinate transformer). Tasks are handed
+// out in chunks of grain from a shared counter so that uneven per-task costs
+// are balanced across threads. With a single thread, fn runs on the calling
+// thread. An exception thrown by fn is rethrown on the calling thread after
+// all workers have joined.
+template <typename F>
+void parallel_for_indexed_(std::size_t n, int num_threads, F fn,
+                           std::size_t grain = 1) {
+
+    if (n == 0)
+        return;
+
+    if (grain < 1)
+        grain = 1;
+
+    const int nthreads = resolve_num_threads_(num_threads, (n + grain - 1) /
+                                                           grain);
+    if (nthreads == 1) {
+        for (std::size_t i = 0; i < n; ++i)
+            fn(0, i);
+        return;
+    }
+
+    std::atomic<std::size_t> next(0);
+    std::exception_ptr first_error = nullptr;
+    std::mutex err_mutex;
+
+    auto worker = [&](int t) {
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        try {
+            while (true) {
+                const std::size_t start = next.fetch_add(grain);
+                if (start >= n)
+                    break;
+                const std::size_t end = std::min(start + grain, n);
+                for (std::size_t i = start; i < end; ++i)
+                    fn(t, i);
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(err_mutex);
+            if (!first_error)
+                first_error = std::current_exception();
+            next.store(n);
+        }
+        CPLPopErrorHandler();
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(nthreads);
+    for (int t = 0; t < nthreads; ++t)
+        threads.emplace_back(worker, t);
+    for (auto &th : threads)
+        th.join();
+
+    if (first_error)
+        std::rethrow_exception(first_error);
+}
+
+// Call fn(i) for i in [0, n), see parallel_for_indexed_()
+template <typename F>
+void parallel_for_(std::size_t n, int num_threads, F fn,
+                   std::size_t grain = 1) {
+
+    parallel_for_indexed_(n, num_threads,
+                          [&fn](int, std::size_t i) { fn(i); }, grain);
+}
+
+#endif  // PARALLEL_UTIL_H_
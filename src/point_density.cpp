@@ -0,0 +1,377 @@
+/* Point counts and kernel density estimates on a raster grid
+
+   The output grid is divided into tiles of whole blocks. Each point is
+   assigned to the tiles that its kernel support overlaps (the pixel that
+   contains it for counts), with a stable counting sort so that the points of
+   each tile are in input order and the sums do not depend on the number of
+   threads. Tiles are independent and computed on worker threads: for each
+   point of a tile, the kernel is evaluated at the centers of the pixels of
+   the tile within the support. For an open GDALRaster, tiles are computed in
+   batches and written on the main thread. For an array output, tiles are
+   written directly into the returned vector.
+
+   Kernels are normalized to integrate to one over the plane, so the output
+   is a density per squared georeferenced unit (times the weights):
+   quartic (biweight) K(d) = 3 / (pi h^2) * (1 - (d / h)^2)^2 for d < h, and
+   Gaussian K(d) = 1 / (2 pi h^2) * exp(-d^2 / (2 h^2)) truncated at 4h.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_port.h>
+#include <gdal.h>
+
+#include <Rcpp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "gdalraster.h"
+#include "point_density.h"
+#include "rcpp_util.h"
+#include "tile_util.h"
+
+constexpr double PD_PI = 3.14159265358979323846;
+
+// support of the Gaussian kernel in multiples of the bandwidth
+constexpr double PD_GAUSSIAN_CUTOFF = 4.0;
+
+namespace {
+
+enum PdKernel { PD_COUNT, PD_QUARTIC, PD_GAUSSIAN };
+
+struct PdPoint {
+    double x;
+    double y;
+    double w;
+};
+
+struct PdParams {
+    PdKernel kernel {PD_COUNT};
+    double h {0.0};  // bandwidth
+    double radius {0.0};  // support radius
+    double norm {1.0};  // kernel normalizing constant
+    double gt[6] {0, 1, 0, 0, 0, 1};
+    double inv_gt[6] {0, 1, 0, 0, 0, 1};
+};
+
+// tiles with the points that each one needs, in input order
+struct PdTiling {
+    int tile_xsize {0};
+    int tile_ysize {0};
+    int ntx {0};
+    int nty {0};
+    std::vector<RasterTile> tiles;
+    std::vector<std::size_t> start;  // tiles.size() + 1 offsets into items
+    std::vector<std::size_t> items;  // point indexes
+};
+
+PdParams pdParams_(const double *gt, const std::string &kernel,
+                   double bandwidth) {
+
+    PdParams p;
+    if (kernel == "count") {
+        p.kernel = PD_COUNT;
+    } else if (kernel == "quartic") {
+        p.kernel = PD_QUARTIC;
+    } else if (kernel == "gaussian") {
+        p.kernel = PD_GAUSSIAN;
+    } else {
+        Rcpp::stop("'kernel' must be one of \"count\", \"quartic\" or "
+                   "\"gaussian\"");
+    }
+
+    if (p.kernel != PD_COUNT) {
+        if (!(bandwidth > 0))
+            Rcpp::stop("'bandwidth' must be a positive number");
+        p.h = bandwidth;
+        if (p.kernel == PD_QUARTIC) {
+            p.radius = bandwidth;
+            p.norm = 3.0 / (PD_PI * bandwidth * bandwidth);
+        } else {
+            p.radius = PD_GAUSSIAN_CUTOFF * bandwidth;
+            p.norm = 1.0 / (2.0 * PD_PI * bandwidth * bandwidth);
+        }
+    }
+
+    for (int i = 0; i < 6; ++i)
+        p.gt[i] = gt[i];
+    if (!GDALInvGeoTransform(p.gt, p.inv_gt))
+        Rcpp::stop("could not get inverse geotransform");
+
+    return p;
+}
+
+std::vector<PdPoint> readPoints_(const Rcpp::RObject &xy,
+                                 const Rcpp::NumericVector &weights) {
+
+    const Rcpp::NumericMatrix m = xy_robject_to_matrix_(xy);
+    if (m.ncol() < 2)
+        Rcpp::stop("'xy' must have at least two columns");
+    const R_xlen_t n = m.nrow();
+    if (weights.size() != 0 && weights.size() != n)
+        Rcpp::stop("'weights' must have one value per point");
+
+    std::vector<PdPoint> pts;
+    pts.reserve(n);
+    for (R_xlen_t i = 0; i < n; ++i) {
+        const double w = weights.size() == 0 ? 1.0 : weights[i];
+        // points with missing or infinite coordinates, or a missing weight,
+        // are skipped
+        if (!std::isfinite(m(i, 0)) || !std::isfinite(m(i, 1)) ||
+                std::isnan(w)) {
+            continue;
+        }
+        pts.push_back({m(i, 0), m(i, 1), w});
+    }
+    return pts;
+}
+
+// the range of pixels [c0, c1) x [r0, r1) that a point contributes to,
+// false if it is outside the grid
+bool pointPixels_(const PdParams &p, const PdPoint &pt, int xsize, int ysize,
+                  int *c0, int *r0, int *c1, int *r1) {
+
+    const double col = p.inv_gt[0] + p.inv_gt[1] * pt.x + p.inv_gt[2] * pt.y;
+    const double row = p.inv_gt[3] + p.inv_gt[4] * pt.x + p.inv_gt[5] * pt.y;
+    // e.g., 0 * Inf, not representable as a pixel offset
+    if (!std::isfinite(col) || !std::isfinite(row))
+        return false;
+    if (p.kernel != PD_COUNT) {
+        // pixel offsets of the support, conservative for rotated grids
+        const double rc = p.radius * (std::fabs(p.inv_gt[1]) +
+                                      std::fabs(p.inv_gt[2]));
+        const double rr = p.radius * (std::fabs(p.inv_gt[4]) +
+                                      std::fabs(p.inv_gt[5]));
+        // pixels with center c + 0.5 in [col - rc, col + rc]
+        auto clamp = [](double v, int hi) {
+            return static_cast<int>(std::min<double>(std::max(v, 0.0), hi));
+        };
+        *c0 = clamp(std::ceil(col - rc - 0.5), xsize);
+        *c1 = clamp(std::floor(col + rc - 0.5) + 1, xsize);
+        *r0 = clamp(std::ceil(row - rr - 0.5), ysize);
+        *r1 = clamp(std::floor(row + rr - 0.5) + 1, ysize);
+        return *c0 < *c1 && *r0 < *r1;
+    }
+
+    if (!(col >= 0 && col < xsize && row >= 0 && row < ysize))
+        return false;
+    *c0 = static_cast<int>(std::floor(col));
+    *r0 = static_cast<int>(std::floor(row));
+    *c1 = *c0 + 1;
+    *r1 = *r0 + 1;
+    return true;
+}
+
+PdTiling makeTiling_(const PdParams &p, const std::vector<PdPoint> &pts,
+                     int xsize, int ysize, int tile_xsize, int tile_ysize) {
+
+    PdTiling tl;
+    tl.tile_xsize = tile_xsize;
+    tl.tile_ysize = tile_ysize;
+    tl.ntx = (xsize + tile_xsize - 1) / tile_xsize;
+    tl.nty = (ysize + tile_ysize - 1) / tile_ysize;
+    tl.tiles = makeTiles_(xsize, ysize, tile_xsize, tile_ysize);
+
+    // counting sort of the points by tile, in two passes
+    std::vector<std::size_t> count(tl.tiles.size() + 1, 0);
+    for (int pass = 0; pass < 2; ++pass) {
+        for (std::size_t i = 0; i < pts.size(); ++i) {
+            int c0 = 0, r0 = 0, c1 = 0, r1 = 0;
+            if (!pointPixels_(p, pts[i], xsize, ysize, &c0, &r0, &c1, &r1))
+                continue;
+            for (int ty = r0 / tile_ysize; ty <= (r1 - 1) / tile_ysize;
+                    ++ty) {
+                for (int tx = c0 / tile_xsize; tx <= (c1 - 1) / tile_xsize;
+                        ++tx) {
+                    const std::size_t k =
+                        static_cast<std::size_t>(ty) * tl.ntx + tx;
+                    if (pass == 0)
+                        count[k + 1] += 1;
+                    else
+                        tl.items[count[k]++] = i;
+                }
+            }
+        }
+        if (pass == 0) {
+            for (std::size_t k = 0; k < tl.tiles.size(); ++k)
+                count[k + 1] += count[k];
+            tl.start = count;
+            tl.items.resize(count.back());
+        }
+    }
+    return tl;
+}
+
+// accumulate the points of tile k into out, where out points to the first
+// pixel of the tile and stride is the length of a row of out
+void densityTile_(const PdParams &p, const std::vector<PdPoint> &pts,
+                  const PdTiling &tl, std::size_t k, int xsize, int ysize,
+                  double *out, std::size_t stride) {
+
+    const RasterTile &t = tl.tiles[k];
+    const double r2 = p.radius * p.radius;
+    for (std::size_t j = tl.start[k]; j < tl.start[k + 1]; ++j) {
+        const PdPoint &pt = pts[tl.items[j]];
+        int c0 = 0, r0 = 0, c1 = 0, r1 = 0;
+        pointPixels_(p, pt, xsize, ysize, &c0, &r0, &c1, &r1);
+        c0 = std::max(c0, t.xoff);
+        r0 = std::max(r0, t.yoff);
+        c1 = std::min(c1, t.xoff + t.xsize);
+        r1 = std::min(r1, t.yoff + t.ysize);
+
+        for (int r = r0; r < r1; ++r) {
+            double *out_row = out + (r - t.yoff) * stride - t.xoff;
+            if (p.kernel == PD_COUNT) {
+                for (int c = c0; c < c1; ++c)
+                    out_row[c] += pt.w;
+                continue;
+            }
+            for (int c = c0; c < c1; ++c) {
+                const double gx = p.gt[0] + (c + 0.5) * p.gt[1] +
+                                  (r + 0.5) * p.gt[2];
+                const double gy = p.gt[3] + (c + 0.5) * p.gt[4] +
+                                  (r + 0.5) * p.gt[5];
+                const double d2 = (gx - pt.x) * (gx - pt.x) +
+                                  (gy - pt.y) * (gy - pt.y);
+                if (d2 >= r2)
+                    continue;
+                if (p.kernel == PD_QUARTIC) {
+                    const double u = 1.0 - d2 / (p.h * p.h);
+                    out_row[c] += pt.w * p.norm * u * u;
+                } else {
+                    out_row[c] += pt.w * p.norm *
+                                  std::exp(-0.5 * d2 / (p.h * p.h));
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+//' Point counts or kernel density into a band of an open raster, by tiles
+//' @noRd
+// [[Rcpp::export(name = ".point_density_ds")]]
+bool point_density_ds(const Rcpp::RObject &xy,
+                      const Rcpp::NumericVector &weights,
+                      const GDALRaster* const &dst_ds, int band,
+                      const std::string &kernel, double bandwidth, bool add,
+                      int tile_size, int num_threads, bool quiet) {
+
+    dst_ds->checkAccess_(GA_Update);
+    GDALRasterBandH hBand = dst_ds->getBand_(band);
+    if (tile_size < 1)
+        Rcpp::stop("'tile_size' must be a positive integer");
+
+    const Rcpp::NumericVector gt_r = dst_ds->getGeoTransform();
+    const std::vector<double> gt(gt_r.begin(), gt_r.end());
+    const PdParams p = pdParams_(gt.data(), kernel, bandwidth);
+    const std::vector<PdPoint> pts = readPoints_(xy, weights);
+
+    const int xsize = GDALGetRasterBandXSize(hBand);
+    const int ysize = GDALGetRasterBandYSize(hBand);
+    int block_xsize = 0;
+    int block_ysize = 0;
+    GDALGetBlockSize(hBand, &block_xsize, &block_ysize);
+    const PdTiling tl = makeTiling_(p, pts, xsize, ysize,
+                                    tileDim_(tile_size, block_xsize, xsize),
+                                    tileDim_(tile_size, block_ysize, ysize));
+
+    // with add, tiles without points are not touched
+    std::vector<std::size_t> work;
+    for (std::size_t k = 0; k < tl.tiles.size(); ++k) {
+        if (!add || tl.start[k + 1] > tl.start[k])
+            work.push_back(k);
+    }
+
+    const std::size_t batch_size = batchSize_(num_threads, work.size());
+    std::vector<std::vector<double>> bufs(batch_size);
+
+    GDALProgressFunc pfnProgress = GDALTermProgressR;
+    if (!quiet)
+        pfnProgress(0, nullptr, nullptr);
+
+    forTileBatches_(work.size(), num_threads,
+        [&](std::size_t j, std::size_t i) {
+            // with add, the tile is read to accumulate into
+            const RasterTile &t = tl.tiles[work[i]];
+            bufs[j].assign(static_cast<std::size_t>(t.xsize) * t.ysize, 0.0);
+            if (add && GDALRasterIO(hBand, GF_Read, t.xoff, t.yoff, t.xsize,
+                                    t.ysize, bufs[j].data(), t.xsize,
+                                    t.ysize, GDT_Float64, 0, 0) != CE_None) {
+                Rcpp::stop("failed to read raster tile");
+            }
+        },
+        [&](std::size_t j, std::size_t i) {
+            const std::size_t k = work[i];
+            densityTile_(p, pts, tl, k, xsize, ysize, bufs[j].data(),
+                         tl.tiles[k].xsize);
+        },
+        [&](std::size_t j, std::size_t i) {
+            const RasterTile &t = tl.tiles[work[i]];
+            if (GDALRasterIO(hBand, GF_Write, t.xoff, t.yoff, t.xsize,
+                             t.ysize, bufs[j].data(), t.xsize, t.ysize,
+                             GDT_Float64, 0, 0) != CE_None) {
+                Rcpp::stop("failed to write raster tile");
+            }
+            if (!quiet) {
+                pfnProgress(static_cast<double>(i + 1) / work.size(),
+                            nullptr, nullptr);
+            }
+        });
+    if (!quiet && work.empty())
+        pfnProgress(1.0, nullptr, nullptr);
+
+    return true;
+}
+
+//' Point counts or kernel density on a new grid returned as a numeric vector
+//' of pixel values in left to right, top to bottom order
+//' @noRd
+// [[Rcpp::export(name = ".point_density_grid")]]
+Rcpp::NumericVector point_density_grid(const Rcpp::RObject &xy,
+                                       const Rcpp::NumericVector &weights,
+                                       const Rcpp::NumericVector &gt,
+                                       int xsize, int ysize,
+                                       const std::string &kernel,
+                                       double bandwidth, int tile_size,
+                                       int num_threads, bool quiet) {
+
+    if (gt.size() != 6)
+        Rcpp::stop("'gt' must be a numeric vector of length 6");
+    if (xsize < 1 || ysize < 1)
+        Rcpp::stop("invalid raster dimensions");
+    if (tile_size < 1)
+        Rcpp::stop("'tile_size' must be a positive integer");
+
+    const std::vector<double> gt_in(gt.begin(), gt.end());
+    const PdParams p = pdParams_(gt_in.data(), kernel, bandwidth);
+    const std::vector<PdPoint> pts = readPoints_(xy, weights);
+    const PdTiling tl = makeTiling_(p, pts, xsize, ysize,
+                                    std::min(tile_size, xsize),
+                                    std::min(tile_size, ysize));
+
+    Rcpp::NumericVector out(static_cast<R_xlen_t>(xsize) * ysize);
+    double *out_data = out.begin();
+
+    if (!quiet)
+        GDALTermProgressR(0, nullptr, nullptr);
+
+    // tiles are disjoint regions of the output vector
+    parallel_for_(tl.tiles.size(), num_threads, [&](std::size_t k) {
+        const RasterTile &t = tl.tiles[k];
+        double *tile_out = out_data +
+                           static_cast<std::size_t>(t.yoff) * xsize + t.xoff;
+        densityTile_(p, pts, tl, k, xsize, ysize, tile_out, xsize);
+    });
+
+    if (!quiet)
+        GDALTermProgressR(1.0, nullptr, nullptr);
+
+    return out;
+}
@@ -0,0 +1,30 @@
+/* Point counts and kernel density estimates on a raster grid from
+   coordinate matrices, processed by tiles on multiple threads.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef POINT_DENSITY_H_
+#define POINT_DENSITY_H_
+
+#include <Rcpp.h>
+
+#include <string>
+
+class GDALRaster;
+bool point_density_ds(const Rcpp::RObject &xy,
+                      const Rcpp::NumericVector &weights,
+                      const GDALRaster* const &dst_ds, int band,
+                      const std::string &kernel, double bandwidth, bool add,
+                      int tile_size, int num_threads, bool quiet);
+
+Rcpp::NumericVector point_density_grid(const Rcpp::RObject &xy,
+                                       const Rcpp::NumericVector &weights,
+                                       const Rcpp::NumericVector &gt,
+                                       int xsize, int ysize,
+                                       const std::string &kernel,
+                                       double bandwidth, int tile_size,
+                                       int num_threads, bool quiet);
+
+#endif  // POINT_DENSITY_H_
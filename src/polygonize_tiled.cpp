@@ -0,0 +1,626 @@
+/* Tiled polygonize
+
+   The source band is divided into tiles aligned with its blocks. Tiles are
+   read (with the validity mask) on the main thread in batches, and each tile
+   is polygonized with GDALPolygonize() on a worker thread, using a MEM
+   dataset that wraps the tile buffers and an in-memory output layer.
+   Polygons that do not touch an internal tile seam are complete, and are
+   written to the output layer in tile order after each batch.
+
+   The polygons that touch a seam are held for the stitch step. While a tile
+   is processed, the exterior ring edges lying on its seams are recorded by
+   pixel, so that for every pixel edge along a seam the polygon on either
+   side is known. Polygons on the two sides of a seam edge that have the same
+   pixel value are joined with union-find (with 8-connectedness, also across
+   the diagonal neighbors on the other side). The members of each resulting
+   group are unioned (cascaded union, see geom_union.cpp), and the stitched
+   polygons are written last, in order of their first member. With
+   8-connectedness a stitched polygon can be a multipolygon (parts that touch
+   at a corner), so polygons are written as the geometry type of the output
+   layer (see matchLayerGeomType_()).
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_conv.h>
+#include <cpl_port.h>
+#include <cpl_string.h>
+#include <gdal.h>
+#include <gdal_alg.h>
+#include <ogr_api.h>
+
+#include <Rcpp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "polygonize_tiled.h"
+#include "gdalraster.h"
+#include "geom_union.h"
+#include "tile_util.h"
+
+// the in-memory vector driver (merged into MEM in GDAL 3.11)
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3, 11, 0)
+constexpr char POLYGONIZE_VECTOR_DRIVER[] = "MEM";
+#else
+constexpr char POLYGONIZE_VECTOR_DRIVER[] = "Memory";
+#endif
+
+// maximum number of features written per transaction
+constexpr std::size_t POLYGONIZE_WRITE_BATCH = 10000;
+
+namespace {
+
+// a polygon with its pixel value
+struct TilePoly {
+    OGRGeometryH geom;
+    int64_t value;
+};
+
+// the buffers of a tile read on the main thread, and the polygons found for
+// it on a worker
+struct TileWork {
+    std::vector<GByte> data {};
+    std::vector<GByte> mask {};
+    std::vector<TilePoly> polys {};  // not on a seam, complete
+    std::vector<TilePoly> held {};   // on a seam, held for stitching
+    bool ok {false};
+};
+
+// For each internal seam, the index into TileWork::held of the polygon on
+// either side of each pixel edge along the seam, or -1. The elements for a
+// side of a seam segment are written by one tile only.
+struct Seams {
+    int tile_xsize;
+    int tile_ysize;
+    int ntx;
+    int nty;
+    // vertical seam j between tile columns j and j + 1, by raster row
+    std::vector<std::vector<int>> left {};
+    std::vector<std::vector<int>> right {};
+    // horizontal seam i between tile rows i and i + 1, by raster column
+    std::vector<std::vector<int>> top {};
+    std::vector<std::vector<int>> bottom {};
+};
+
+void destroyPolys_(std::vector<TilePoly> *polys) {
+    for (TilePoly &p : *polys) {
+        if (p.geom != nullptr)
+            OGR_G_DestroyGeometry(p.geom);
+    }
+    polys->clear();
+}
+
+// record the exterior ring edges of polygon idx of tile t that lie on
+// internal seams, returns true if there are any
+bool markSeams_(OGRGeometryH hGeom, const RasterTile &t,
+                const double *inv_gt, int idx, Seams *seams) {
+
+    if (hGeom == nullptr || OGR_G_GetGeometryCount(hGeom) < 1)
+        return false;
+
+    const int col = t.xoff / seams->tile_xsize;
+    const int row = t.yoff / seams->tile_ysize;
+    OGRGeometryH hRing = OGR_G_GetGeometryRef(hGeom, 0);
+    const int n = OGR_G_GetPointCount(hRing);
+    bool on_seam = false;
+    int64_t c0 = 0;
+    int64_t r0 = 0;
+    for (int k = 0; k < n; ++k) {
+        // ring vertices are on pixel corners
+        const double x = OGR_G_GetX(hRing, k);
+        const double y = OGR_G_GetY(hRing, k);
+        const int64_t c1 = std::llround(inv_gt[0] + inv_gt[1] * x +
+                                        inv_gt[2] * y);
+        const int64_t r1 = std::llround(inv_gt[3] + inv_gt[4] * x +
+                                        inv_gt[5] * y);
+
+        if (k > 0 && c0 == c1 && r0 != r1) {
+            std::vector<int> *side = nullptr;
+            if (c0 == t.xoff && col > 0)
+                side = &seams->right[col - 1];
+            else if (c0 == t.xoff + t.xsize && col < seams->ntx - 1)
+                side = &seams->left[col];
+
+            if (side != nullptr) {
+                const int64_t lo = std::max<int64_t>(std::min(r0, r1),
+                                                     t.yoff);
+                const int64_t hi = std::min<int64_t>(std::max(r0, r1),
+                                                     t.yoff + t.ysize);
+                for (int64_t r = lo; r < hi; ++r)
+                    (*side)[r] = idx;
+                on_seam = true;
+            }
+        } else if (k > 0 && r0 == r1 && c0 != c1) {
+            std::vector<int> *side = nullptr;
+            if (r0 == t.yoff && row > 0)
+                side = &seams->bottom[row - 1];
+            else if (r0 == t.yoff + t.ysize && row < seams->nty - 1)
+                side = &seams->top[row];
+
+            if (side != nullptr) {
+                const int64_t lo = std::max<int64_t>(std::min(c0, c1),
+                                                     t.xoff);
+                const int64_t hi = std::min<int64_t>(std::max(c0, c1),
+                                                     t.xoff + t.xsize);
+                for (int64_t c = lo; c < hi; ++c)
+                    (*side)[c] = idx;
+                on_seam = true;
+            }
+        }
+        c0 = c1;
+        r0 = r1;
+    }
+    return on_seam;
+}
+
+// polygonize tile t from w->data and w->mask into w->polys and w->held,
+// runs on worker threads and does not call the R API
+bool polygonizeTile_(const RasterTile &t, GDALDataType dt, bool has_mask,
+                     const double *gt, const double *inv_gt,
+                     GDALDriverH hMemDrv, GDALDriverH hVecDrv,
+                     char **papszOptions, Seams *seams, TileWork *w) {
+
+    GDALDatasetH hDS = GDALCreate(hMemDrv, "", t.xsize, t.ysize, 0,
+                                  GDT_Byte, nullptr);
+    if (hDS == nullptr)
+        return false;
+
+    if (!addMemBand_(hDS, dt, w->data.data()) ||
+            (has_mask && !addMemBand_(hDS, GDT_Byte, w->mask.data()))) {
+        GDALClose(hDS);
+        return false;
+    }
+
+    double tile_gt[6] = {gt[0] + t.xoff * gt[1] + t.yoff * gt[2], gt[1],
+                         gt[2], gt[3] + t.xoff * gt[4] + t.yoff * gt[5],
+                         gt[4], gt[5]};
+    GDALSetGeoTransform(hDS, tile_gt);
+
+    GDALDatasetH hVecDS = GDALCreate(hVecDrv, "", 0, 0, 0, GDT_Unknown,
+                                     nullptr);
+    if (hVecDS == nullptr) {
+        GDALClose(hDS);
+        return false;
+    }
+    OGRLayerH hLayer = GDALDatasetCreateLayer(hVecDS, "polygons", nullptr,
+                                              wkbPolygon, nullptr);
+    bool ok = hLayer != nullptr;
+    if (ok) {
+        OGRFieldDefnH hFld = OGR_Fld_Create("DN", OFTInteger64);
+        ok = OGR_L_CreateField(hLayer, hFld, TRUE) == OGRERR_NONE;
+        OGR_Fld_Destroy(hFld);
+    }
+    if (ok) {
+        GDALRasterBandH hMaskBand = nullptr;
+        if (has_mask)
+            hMaskBand = GDALGetRasterBand(hDS, 2);
+        ok = GDALPolygonize(GDALGetRasterBand(hDS, 1), hMaskBand, hLayer, 0,
+                            papszOptions, nullptr, nullptr) == CE_None;
+    }
+    if (ok) {
+        OGR_L_ResetReading(hLayer);
+        OGRFeatureH hFeat = nullptr;
+        while ((hFeat = OGR_L_GetNextFeature(hLayer)) != nullptr) {
+            TilePoly p;
+            p.value = OGR_F_GetFieldAsInteger64(hFeat, 0);
+            p.geom = OGR_F_StealGeometry(hFeat);
+            OGR_F_Destroy(hFeat);
+            const int idx = static_cast<int>(w->held.size());
+            if (markSeams_(p.geom, t, inv_gt, idx, seams))
+                w->held.push_back(p);
+            else
+                w->polys.push_back(p);
+        }
+    }
+
+    GDALClose(hVecDS);
+    GDALClose(hDS);
+    return ok;
+}
+
+// write polys to the output layer, consuming them, in transactions of up to
+// POLYGONIZE_WRITE_BATCH features if the format supports it
+bool writePolys_(GDALDatasetH hDS, OGRLayerH hLayer, int iField,
+                 std::vector<TilePoly> *polys) {
+
+    bool ok = true;
+    for (std::size_t first = 0; first < polys->size() && ok;
+            first += POLYGONIZE_WRITE_BATCH) {
+
+        const std::size_t last = std::min(first + POLYGONIZE_WRITE_BATCH,
+                                          polys->size());
+        const bool in_transaction =
+                GDALDatasetStartTransaction(hDS, FALSE) == OGRERR_NONE;
+
+        for (std::size_t i = first; i < last && ok; ++i) {
+            TilePoly &p = (*polys)[i];
+            OGRFeatureH hFeat = OGR_F_Create(OGR_L_GetLayerDefn(hLayer));
+            if (iField >= 0)
+                OGR_F_SetFieldInteger64(hFeat, iField, p.value);
+            OGR_F_SetGeometryDirectly(hFeat, p.geom);
+            p.geom = nullptr;
+            if (OGR_L_CreateFeature(hLayer, hFeat) != OGRERR_NONE)
+                ok = false;
+            OGR_F_Destroy(hFeat);
+        }
+
+        if (in_transaction) {
+            if (ok)
+                ok = GDALDatasetCommitTransaction(hDS) == OGRERR_NONE;
+            else
+                GDALDatasetRollbackTransaction(hDS);
+        }
+    }
+
+    destroyPolys_(polys);
+    return ok;
+}
+
+// Polygons of the same value that touch only at a corner are connected with
+// connectedness 8, and their union across a seam is a multipolygon. Match
+// the geometry type of the output layer: a layer of type MultiPolygon (as
+// created for tiled mode) gets every polygon as a multipolygon, and a layer
+// of type Polygon gets the parts of a multipolygon as separate features with
+// the same value.
+void matchLayerGeomType_(OGRLayerH hLayer, std::vector<TilePoly> *polys) {
+    const OGRwkbGeometryType eLyrType =
+            wkbFlatten(OGR_L_GetGeomType(hLayer));
+
+    if (eLyrType == wkbMultiPolygon) {
+        for (TilePoly &p : *polys)
+            p.geom = OGR_G_ForceToMultiPolygon(p.geom);
+    }
+    else if (eLyrType == wkbPolygon) {
+        std::vector<TilePoly> parts;
+        for (TilePoly &p : *polys) {
+            if (wkbFlatten(OGR_G_GetGeometryType(p.geom)) != wkbMultiPolygon) {
+                parts.push_back(p);
+                continue;
+            }
+            const int num_parts = OGR_G_GetGeometryCount(p.geom);
+            for (int i = 0; i < num_parts; ++i) {
+                parts.push_back(TilePoly{
+                        OGR_G_Clone(OGR_G_GetGeometryRef(p.geom, i)),
+                        p.value});
+            }
+            OGR_G_DestroyGeometry(p.geom);
+        }
+        polys->swap(parts);
+    }
+}
+
+std::size_t findRoot_(std::vector<std::size_t> *parent, std::size_t i) {
+    while ((*parent)[i] != i) {
+        (*parent)[i] = (*parent)[(*parent)[i]];
+        i = (*parent)[i];
+    }
+    return i;
+}
+
+// the root of a set is its smallest member
+void unite_(std::vector<std::size_t> *parent, std::size_t a, std::size_t b) {
+    const std::size_t ra = findRoot_(parent, a);
+    const std::size_t rb = findRoot_(parent, b);
+    if (ra < rb)
+        (*parent)[rb] = ra;
+    else if (rb < ra)
+        (*parent)[ra] = rb;
+}
+
+}  // namespace
+
+//' Tiled, multithreaded polygonize with stitching of the polygons across
+//' tile seams
+//'
+//' Called from and documented in R/gdalraster_proc.R
+//' @noRd
+// [[Rcpp::export(name = ".polygonize_tiled")]]
+bool polygonize_tiled(const Rcpp::CharacterVector &src_filename,
+                      int src_band, const Rcpp::CharacterVector &out_dsn,
+                      const std::string &out_layer,
+                      const std::string &fld_name,
+                      const Rcpp::CharacterVector &mask_file, bool nomask,
+                      int connectedness, int tile_size, int num_threads,
+                      bool quiet) {
+
+    const std::string src_filename_in =
+        Rcpp::as<std::string>(check_gdal_filename(src_filename));
+
+    const std::string out_dsn_in =
+        Rcpp::as<std::string>(check_gdal_filename(out_dsn));
+
+    const std::string mask_file_in =
+        Rcpp::as<std::string>(check_gdal_filename(mask_file));
+
+    if (connectedness != 4 && connectedness != 8)
+        Rcpp::stop("'connectedness' must be 4 or 8");
+    if (tile_size < 1)
+        Rcpp::stop("'tile_size' must be a positive integer");
+
+    GDALDriverH hMemDrv = GDALGetDriverByName("MEM");
+    GDALDriverH hVecDrv = GDALGetDriverByName(POLYGONIZE_VECTOR_DRIVER);
+    if (hMemDrv == nullptr || hVecDrv == nullptr)
+        Rcpp::stop("in-memory drivers not available");
+
+    GDALDatasetH hSrcDS = GDALOpenShared(src_filename_in.c_str(),
+                                         GA_ReadOnly);
+    if (hSrcDS == nullptr)
+        Rcpp::stop("open source raster failed");
+
+    GDALRasterBandH hSrcBand = GDALGetRasterBand(hSrcDS, src_band);
+    if (hSrcBand == nullptr) {
+        GDALClose(hSrcDS);
+        Rcpp::stop("failed to access the source band");
+    }
+
+    GDALDatasetH hMaskDS = nullptr;
+    GDALRasterBandH hMaskBand = nullptr;
+    if (mask_file_in == "" && nomask == false) {
+        // default validity mask, not needed if all pixels are valid
+        if (GDALGetMaskFlags(hSrcBand) != GMF_ALL_VALID)
+            hMaskBand = GDALGetMaskBand(hSrcBand);
+    } else if (mask_file_in != "") {
+        hMaskDS = GDALOpenShared(mask_file_in.c_str(), GA_ReadOnly);
+        if (hMaskDS == nullptr) {
+            GDALClose(hSrcDS);
+            Rcpp::stop("open mask raster failed");
+        }
+        hMaskBand = GDALGetRasterBand(hMaskDS, 1);
+        if (hMaskBand == nullptr) {
+            GDALClose(hSrcDS);
+            GDALClose(hMaskDS);
+            Rcpp::stop("failed to access the mask band");
+        }
+    }
+
+    GDALDatasetH hOutDS = GDALOpenEx(out_dsn_in.c_str(),
+                                     GDAL_OF_VECTOR | GDAL_OF_UPDATE,
+                                     nullptr, nullptr, nullptr);
+    if (hOutDS == nullptr) {
+        GDALClose(hSrcDS);
+        if (hMaskDS != nullptr)
+            GDALClose(hMaskDS);
+
+        Rcpp::stop("failed to open the output vector data source");
+    }
+
+    OGRLayerH hOutLayer = GDALDatasetGetLayerByName(hOutDS,
+                                                    out_layer.c_str());
+    if (hOutLayer == nullptr) {
+        GDALClose(hSrcDS);
+        if (hMaskDS != nullptr)
+            GDALClose(hMaskDS);
+
+        GDALClose(hOutDS);
+        Rcpp::stop("failed to open the output layer");
+    }
+
+    const int iPixValField = OGR_FD_GetFieldIndex(
+        OGR_L_GetLayerDefn(hOutLayer), fld_name.c_str());
+    if (iPixValField == -1)
+        Rcpp::warning("field not found, pixel values will not be written");
+
+    double gt[6] = {0, 1, 0, 0, 0, 1};
+    GDALGetGeoTransform(hSrcDS, gt);
+    double inv_gt[6] = {0, 1, 0, 0, 0, 1};
+    if (!GDALInvGeoTransform(gt, inv_gt)) {
+        GDALClose(hSrcDS);
+        if (hMaskDS != nullptr)
+            GDALClose(hMaskDS);
+
+        GDALReleaseDataset(hOutDS);
+        Rcpp::stop("failed to invert the geotransform");
+    }
+
+    const int xsize = GDALGetRasterXSize(hSrcDS);
+    const int ysize = GDALGetRasterYSize(hSrcDS);
+    int block_xsize = 0;
+    int block_ysize = 0;
+    GDALGetBlockSize(hSrcBand, &block_xsize, &block_ysize);
+
+    Seams seams;
+    seams.tile_xsize = tileDim_(tile_size, block_xsize, xsize);
+    seams.tile_ysize = tileDim_(tile_size, block_ysize, ysize);
+    seams.ntx = (xsize + seams.tile_xsize - 1) / seams.tile_xsize;
+    seams.nty = (ysize + seams.tile_ysize - 1) / seams.tile_ysize;
+    seams.left.assign(seams.ntx - 1, std::vector<int>(ysize, -1));
+    seams.right.assign(seams.ntx - 1, std::vector<int>(ysize, -1));
+    seams.top.assign(seams.nty - 1, std::vector<int>(xsize, -1));
+    seams.bottom.assign(seams.nty - 1, std::vector<int>(xsize, -1));
+
+    const std::vector<RasterTile> tiles = makeTiles_(
+        xsize, ysize, seams.tile_xsize, seams.tile_ysize);
+
+    const GDALDataType dt = GDALGetRasterDataType(hSrcBand);
+    const std::size_t dt_bytes =
+            static_cast<std::size_t>(GDALGetDataTypeSizeBytes(dt));
+
+    char **papszOptions = nullptr;
+    if (connectedness == 8)
+        papszOptions = CSLSetNameValue(papszOptions, "8CONNECTED", "8");
+
+    // complete polygons are written in tile order, polygons on a seam are
+    // held for stitching
+    std::vector<TileWork> work(batchSize_(num_threads, tiles.size()));
+    std::vector<TilePoly> held;
+    std::vector<std::size_t> held_offset(tiles.size(), 0);
+
+    GDALProgressFunc pfnProgress = GDALTermProgressR;
+    if (!quiet)
+        pfnProgress(0, nullptr, nullptr);
+
+    try {
+        forTileBatches_(tiles.size(), num_threads,
+            [&](std::size_t j, std::size_t i) {
+                const RasterTile &t = tiles[i];
+                const std::size_t npx = static_cast<std::size_t>(t.xsize) *
+                                        t.ysize;
+                work[j].data.resize(npx * dt_bytes);
+                if (GDALRasterIO(hSrcBand, GF_Read, t.xoff, t.yoff, t.xsize,
+                                 t.ysize, work[j].data.data(), t.xsize,
+                                 t.ysize, dt, 0, 0) != CE_None) {
+                    Rcpp::stop("failed to read raster tile");
+                }
+                if (hMaskBand != nullptr) {
+                    work[j].mask.resize(npx);
+                    if (GDALRasterIO(hMaskBand, GF_Read, t.xoff, t.yoff,
+                                     t.xsize, t.ysize, work[j].mask.data(),
+                                     t.xsize, t.ysize, GDT_Byte, 0,
+                                     0) != CE_None) {
+                        Rcpp::stop("failed to read the mask band");
+                    }
+                }
+            },
+            [&](std::size_t j, std::size_t i) {
+                work[j].ok = polygonizeTile_(tiles[i], dt,
+                                             hMaskBand != nullptr, gt,
+                                             inv_gt, hMemDrv, hVecDrv,
+                                             papszOptions, &seams, &work[j]);
+            },
+            [&](std::size_t j, std::size_t i) {
+                held_offset[i] = held.size();
+                held.insert(held.end(), work[j].held.begin(),
+                            work[j].held.end());
+                work[j].held.clear();
+                if (!work[j].ok)
+                    Rcpp::stop("error in GDALPolygonize()");
+                matchLayerGeomType_(hOutLayer, &work[j].polys);
+                if (!writePolys_(hOutDS, hOutLayer, iPixValField,
+                                 &work[j].polys)) {
+                    Rcpp::stop("failed to write polygon features");
+                }
+                destroyPolys_(&work[j].polys);
+                if (!quiet) {
+                    pfnProgress(0.9 * (i + 1) / tiles.size(), nullptr,
+                                nullptr);
+                }
+            });
+    }
+    catch (...) {
+        for (TileWork &w : work) {
+            destroyPolys_(&w.polys);
+            destroyPolys_(&w.held);
+        }
+        destroyPolys_(&held);
+        CSLDestroy(papszOptions);
+        GDALClose(hSrcDS);
+        if (hMaskDS != nullptr)
+            GDALClose(hMaskDS);
+        GDALReleaseDataset(hOutDS);
+        throw;
+    }
+
+    CSLDestroy(papszOptions);
+    GDALClose(hSrcDS);
+    if (hMaskDS != nullptr)
+        GDALClose(hMaskDS);
+
+    // stitch: join the polygons with the same value on either side of each
+    // pixel edge along the seams
+    std::vector<std::size_t> parent(held.size());
+    std::iota(parent.begin(), parent.end(), 0);
+
+    auto link = [&](std::size_t tile_a, int a, std::size_t tile_b, int b) {
+        if (a < 0 || b < 0)
+            return;
+        const std::size_t ia = held_offset[tile_a] + a;
+        const std::size_t ib = held_offset[tile_b] + b;
+        if (held[ia].value == held[ib].value)
+            unite_(&parent, ia, ib);
+    };
+
+    const std::size_t ntx = static_cast<std::size_t>(seams.ntx);
+    for (int j = 0; j < seams.ntx - 1; ++j) {
+        for (int r = 0; r < ysize; ++r) {
+            const std::size_t tile_l = (r / seams.tile_ysize) * ntx + j;
+            link(tile_l, seams.left[j][r], tile_l + 1, seams.right[j][r]);
+            if (connectedness == 4)
+                continue;
+            for (int r2 : {r - 1, r + 1}) {
+                if (r2 < 0 || r2 >= ysize)
+                    continue;
+                const std::size_t tile_r = (r2 / seams.tile_ysize) * ntx +
+                                           j + 1;
+                link(tile_l, seams.left[j][r], tile_r, seams.right[j][r2]);
+            }
+        }
+    }
+    for (int i = 0; i < seams.nty - 1; ++i) {
+        for (int c = 0; c < xsize; ++c) {
+            const std::size_t tile_t = i * ntx + c / seams.tile_xsize;
+            link(tile_t, seams.top[i][c], tile_t + ntx, seams.bottom[i][c]);
+            if (connectedness == 4)
+                continue;
+            for (int c2 : {c - 1, c + 1}) {
+                if (c2 < 0 || c2 >= xsize)
+                    continue;
+                const std::size_t tile_b = (i + 1) * ntx +
+                                           c2 / seams.tile_xsize;
+                link(tile_t, seams.top[i][c], tile_b, seams.bottom[i][c2]);
+            }
+        }
+    }
+
+    // groups in order of their first member (the root)
+    std::vector<std::vector<std::size_t>> groups;
+    std::vector<std::size_t> group_idx(held.size(), 0);
+    for (std::size_t i = 0; i < held.size(); ++i) {
+        const std::size_t root = findRoot_(&parent, i);
+        if (root == i) {
+            group_idx[i] = groups.size();
+            groups.push_back({i});
+        } else {
+            groups[group_idx[root]].push_back(i);
+        }
+    }
+
+    std::vector<TilePoly> stitched(groups.size(), TilePoly{nullptr, 0});
+    parallel_for_(groups.size(), num_threads, [&](std::size_t g) {
+        const std::vector<std::size_t> &members = groups[g];
+        stitched[g].value = held[members[0]].value;
+        if (members.size() == 1) {
+            stitched[g].geom = held[members[0]].geom;
+            held[members[0]].geom = nullptr;
+            return;
+        }
+        std::vector<OGRGeometryH> parts;
+        parts.reserve(members.size());
+        for (std::size_t i : members) {
+            parts.push_back(held[i].geom);
+            held[i].geom = nullptr;
+        }
+        stitched[g].geom = cascadedUnion_(&parts, 1);
+    });
+    held.clear();
+
+    std::string err_msg;
+    for (const TilePoly &p : stitched) {
+        if (p.geom == nullptr) {
+            err_msg = "failed to stitch polygons across tile seams";
+            break;
+        }
+    }
+    if (err_msg.empty()) {
+        matchLayerGeomType_(hOutLayer, &stitched);
+        if (!writePolys_(hOutDS, hOutLayer, iPixValField, &stitched))
+            err_msg = "failed to write polygon features";
+    }
+    destroyPolys_(&stitched);
+    GDALReleaseDataset(hOutDS);
+
+    if (!err_msg.empty())
+        Rcpp::stop(err_msg);
+
+    if (!quiet)
+        pfnProgress(1.0, nullptr, nullptr);
+
+    return true;
+}
@@ -0,0 +1,23 @@
+/* Tiled polygonize: GDALPolygonize on block-aligned tiles on multiple
+   threads, with the polygons that cross tile seams stitched back together.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef POLYGONIZE_TILED_H_
+#define POLYGONIZE_TILED_H_
+
+#include <Rcpp.h>
+
+#include <string>
+
+bool polygonize_tiled(const Rcpp::CharacterVector &src_filename,
+                      int src_band, const Rcpp::CharacterVector &out_dsn,
+                      const std::string &out_layer,
+                      const std::string &fld_name,
+                      const Rcpp::CharacterVector &mask_file, bool nomask,
+                      int connectedness, int tile_size, int num_threads,
+                      bool quiet);
+
+#endif  // POLYGONIZE_TILED_H_
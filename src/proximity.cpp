@@ -0,0 +1,385 @@
+/* Exact Euclidean distance transform
+
+   The squared distance to the nearest target pixel is separable into a
+   column pass and a row pass (Felzenszwalb & Huttenlocher 2012, Meijster et
+   al. 2000). The column pass finds the nearest target above and below each
+   pixel in its column. It is streamed over strips of rows: a first scan from
+   the bottom of the raster records the row of the nearest target at or
+   below each pixel, and a second scan from the top tracks the nearest target
+   at or above, so only one strip and one row of state per column are held
+   in memory. The rows of target indexes from the first scan are stored in
+   the output band when its data type holds them exactly, otherwise in
+   memory. In the second scan, each completed row gets the lower envelope of
+   the parabolas (wx * (x - q))^2 + g(q) over its columns q, where g(q) is
+   the squared vertical distance for column q. The column scans are split
+   over blocks of columns and the row pass over rows, on worker threads.
+
+   With units "geo", wx and wy are the pixel width and height in georeferenced
+   units. For a raster in geographic coordinates, they are in meters on a
+   sphere with the semi-major axis of the ellipsoid, at the latitude of the
+   output row (as in dem_calc()), so distances use the local scale of each
+   output pixel.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_port.h>
+#include <gdal.h>
+#include <ogr_srs_api.h>
+
+#include <Rcpp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "gdalraster.h"
+#include "parallel_util.h"
+#include "proximity.h"
+
+constexpr double PROX_PI = 3.14159265358979323846;
+constexpr double PROX_RAD_TO_DEG = 180.0 / PROX_PI;
+
+// upper limit on the number of pixels in a strip
+constexpr std::size_t PROX_STRIP_MAX_PIXELS = 4 * 1024 * 1024;
+
+// columns per task in the column scans, rows per task in the row pass
+constexpr std::size_t PROX_COL_GRAIN = 1024;
+constexpr std::size_t PROX_ROW_GRAIN = 16;
+
+namespace {
+
+constexpr double PROX_INF = std::numeric_limits<double>::infinity();
+
+struct ProxParams {
+    std::vector<double> targets;  // sorted, empty means any non-zero value
+    bool geo_units {false};
+    bool geographic {false};
+    double m_per_deg {0.0};
+    double gt[6] {0, 1, 0, 0, 0, 1};
+};
+
+// pixel width and height in output units for a row
+void rowScale_(const ProxParams &p, int row, double *wx, double *wy) {
+    if (!p.geo_units) {
+        *wx = 1.0;
+        *wy = 1.0;
+    } else if (!p.geographic) {
+        *wx = std::fabs(p.gt[1]);
+        *wy = std::fabs(p.gt[5]);
+    } else {
+        const double lat = p.gt[3] + (row + 0.5) * p.gt[5];
+        *wx = std::fabs(p.gt[1]) * p.m_per_deg *
+              std::cos(lat / PROX_RAD_TO_DEG);
+        *wy = std::fabs(p.gt[5]) * p.m_per_deg;
+    }
+    // a row centered on a pole
+    *wx = std::max(*wx, 1e-12 * *wy);
+}
+
+// read rows [y0, y0 + ny) as target flags
+bool readTargets_(GDALRasterBandH hBand, const ProxParams &p, int y0, int ny,
+                  std::vector<double> *buf, std::vector<uint8_t> *is_target) {
+
+    const int nx = GDALGetRasterBandXSize(hBand);
+    const std::size_t n = static_cast<std::size_t>(nx) * ny;
+    buf->resize(n);
+    if (GDALRasterIO(hBand, GF_Read, 0, y0, nx, ny, buf->data(), nx, ny,
+                     GDT_Float64, 0, 0) != CE_None) {
+        return false;
+    }
+
+    int has_nodata = FALSE;
+    const double nodata = GDALGetRasterNoDataValue(hBand, &has_nodata);
+    is_target->resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double v = (*buf)[i];
+        bool t = false;
+        if (!std::isnan(v) && !(has_nodata && v == nodata)) {
+            if (p.targets.empty())
+                t = (v != 0);
+            else
+                t = std::binary_search(p.targets.begin(), p.targets.end(), v);
+        }
+        (*is_target)[i] = t ? 1 : 0;
+    }
+    return true;
+}
+
+// lower envelope of the parabolas a * (x - q)^2 + f[q] evaluated at each x,
+// with f[q] = inf for columns that have no target (v and z are scratch)
+void envelope_(const double *f, int n, double a, double *d,
+               std::vector<int> *v, std::vector<double> *z) {
+
+    v->resize(n);
+    z->resize(static_cast<std::size_t>(n) + 1);
+    int k = -1;
+    for (int q = 0; q < n; ++q) {
+        if (f[q] == PROX_INF)
+            continue;
+        double s = -PROX_INF;
+        while (k >= 0) {
+            const int r = (*v)[k];
+            s = ((f[q] + a * q * q) - (f[r] + a * r * r)) /
+                (2.0 * a * (q - r));
+            if (s <= (*z)[k])
+                k -= 1;
+            else
+                break;
+        }
+        if (k < 0)
+            s = -PROX_INF;
+        k += 1;
+        (*v)[k] = q;
+        (*z)[k] = s;
+    }
+
+    if (k < 0) {
+        std::fill(d, d + n, PROX_INF);
+        return;
+    }
+    (*z)[k + 1] = PROX_INF;
+    int j = 0;
+    for (int x = 0; x < n; ++x) {
+        while ((*z)[j + 1] < x)
+            j += 1;
+        const double dx = static_cast<double>(x - (*v)[j]);
+        d[x] = a * dx * dx + f[(*v)[j]];
+    }
+}
+
+}  // namespace
+
+//' Compute the Euclidean distance from each pixel of a raster band to the
+//' nearest target pixel, writing to band 1 of dst_ds
+//' @noRd
+// [[Rcpp::export(name = ".proximity")]]
+bool proximity(const GDALRaster* const &src_ds, int band,
+               const GDALRaster* const &dst_ds,
+               const Rcpp::NumericVector &target_values,
+               const std::string &units, double max_dist, int num_threads,
+               bool quiet) {
+
+    dst_ds->checkAccess_(GA_Update);
+    if (src_ds->getGDALDatasetH_() == dst_ds->getGDALDatasetH_())
+        Rcpp::stop("the output must be a different dataset than the source");
+
+    GDALRasterBandH hSrcBand = src_ds->getBand_(band);
+    GDALRasterBandH hDstBand = dst_ds->getBand_(1);
+    const int xsize = GDALGetRasterBandXSize(hSrcBand);
+    const int ysize = GDALGetRasterBandYSize(hSrcBand);
+    if (GDALGetRasterBandXSize(hDstBand) != xsize ||
+            GDALGetRasterBandYSize(hDstBand) != ysize) {
+        Rcpp::stop("the output must have the same raster dimensions as the "
+                   "source");
+    }
+
+    ProxParams p;
+    for (double v : target_values) {
+        if (!std::isnan(v))
+            p.targets.push_back(v);
+    }
+    std::sort(p.targets.begin(), p.targets.end());
+
+    if (units == "geo") {
+        p.geo_units = true;
+        const Rcpp::NumericVector gt = src_ds->getGeoTransform();
+        for (int i = 0; i < 6; ++i)
+            p.gt[i] = gt[i];
+        const std::string srs = src_ds->getProjection();
+        if (srs != "") {
+            OGRSpatialReferenceH hSRS = OSRNewSpatialReference(nullptr);
+            if (OSRSetFromUserInput(hSRS, srs.c_str()) == OGRERR_NONE &&
+                    OSRIsGeographic(hSRS)) {
+                p.geographic = true;
+                p.m_per_deg = OSRGetSemiMajor(hSRS, nullptr) /
+                              PROX_RAD_TO_DEG;
+            }
+            OSRDestroySpatialReference(hSRS);
+        }
+    } else if (units != "pixel") {
+        Rcpp::stop("'units' must be \"pixel\" or \"geo\"");
+    }
+
+    int has_dst_nodata = FALSE;
+    const double dst_nodata = GDALGetRasterNoDataValue(hDstBand,
+                                                       &has_dst_nodata);
+
+    // the rows of the nearest target below are stored in the output band
+    // between the two scans if its data type holds them exactly
+    const GDALDataType dst_dt = GDALGetRasterDataType(hDstBand);
+    const bool scratch_in_dst =
+        dst_dt == GDT_Int32 || dst_dt == GDT_UInt32 ||
+        dst_dt == GDT_Float64 ||
+        (dst_dt == GDT_Float32 && ysize <= (1 << 24));
+    std::vector<int32_t> below_mem;
+    if (!scratch_in_dst)
+        below_mem.resize(static_cast<std::size_t>(xsize) * ysize);
+
+    // strips of whole blocks of the output
+    int block_xsize = 0;
+    int block_ysize = 0;
+    GDALGetBlockSize(hDstBand, &block_xsize, &block_ysize);
+    int strip_rows = static_cast<int>(std::max<std::size_t>(
+        1, PROX_STRIP_MAX_PIXELS / static_cast<std::size_t>(xsize)));
+    if (block_ysize > 0 && strip_rows >= block_ysize)
+        strip_rows = (strip_rows / block_ysize) * block_ysize;
+    strip_rows = std::min(strip_rows, ysize);
+    const int num_strips = (ysize + strip_rows - 1) / strip_rows;
+
+    const std::size_t num_col_tasks =
+        (static_cast<std::size_t>(xsize) + PROX_COL_GRAIN - 1) /
+        PROX_COL_GRAIN;
+    auto colRange = [&](std::size_t j, int *c0, int *c1) {
+        *c0 = static_cast<int>(j * PROX_COL_GRAIN);
+        *c1 = std::min(xsize, static_cast<int>((j + 1) * PROX_COL_GRAIN));
+    };
+
+    GDALProgressFunc pfnProgress = GDALTermProgressR;
+    if (!quiet)
+        pfnProgress(0, nullptr, nullptr);
+
+    std::vector<double> buf;
+    std::vector<uint8_t> is_target;
+    std::vector<int32_t> below;
+
+    // first scan, bottom to top: row of the nearest target at or below each
+    // pixel, or ysize if none
+    std::vector<int32_t> next_below(xsize, ysize);
+    for (int s = num_strips - 1; s >= 0; --s) {
+        const int y0 = s * strip_rows;
+        const int ny = std::min(strip_rows, ysize - y0);
+        if (!readTargets_(hSrcBand, p, y0, ny, &buf, &is_target))
+            Rcpp::stop("failed to read the source raster");
+
+        int32_t *strip_below = nullptr;
+        if (scratch_in_dst) {
+            below.resize(static_cast<std::size_t>(xsize) * ny);
+            strip_below = below.data();
+        } else {
+            strip_below = below_mem.data() +
+                          static_cast<std::size_t>(y0) * xsize;
+        }
+
+        parallel_for_(num_col_tasks, num_threads, [&](std::size_t j) {
+            int c0 = 0, c1 = 0;
+            colRange(j, &c0, &c1);
+            for (int i = ny - 1; i >= 0; --i) {
+                const std::size_t row = static_cast<std::size_t>(i) * xsize;
+                for (int c = c0; c < c1; ++c) {
+                    if (is_target[row + c])
+                        next_below[c] = y0 + i;
+                    strip_below[row + c] = next_below[c];
+                }
+            }
+        });
+
+        if (scratch_in_dst &&
+                GDALRasterIO(hDstBand, GF_Write, 0, y0, xsize, ny,
+                             below.data(), xsize, ny, GDT_Int32, 0, 0)
+                    != CE_None) {
+            Rcpp::stop("failed to write the output raster");
+        }
+
+        if (!quiet) {
+            pfnProgress(0.5 * (num_strips - s) / num_strips, nullptr,
+                        nullptr);
+        }
+        Rcpp::checkUserInterrupt();
+    }
+
+    // second scan, top to bottom: nearest target at or above, then the row
+    // pass on the completed rows of the strip
+    std::vector<int32_t> prev_above(xsize, -1);
+    std::vector<double> g;
+    std::vector<double> out;
+    const int nthreads = resolve_num_threads_(num_threads, ysize);
+    std::vector<std::vector<int>> env_v(nthreads);
+    std::vector<std::vector<double>> env_z(nthreads);
+    for (int s = 0; s < num_strips; ++s) {
+        const int y0 = s * strip_rows;
+        const int ny = std::min(strip_rows, ysize - y0);
+        const std::size_t npx = static_cast<std::size_t>(xsize) * ny;
+        if (!readTargets_(hSrcBand, p, y0, ny, &buf, &is_target))
+            Rcpp::stop("failed to read the source raster");
+
+        const int32_t *strip_below = nullptr;
+        if (scratch_in_dst) {
+            below.resize(npx);
+            if (GDALRasterIO(hDstBand, GF_Read, 0, y0, xsize, ny,
+                             below.data(), xsize, ny, GDT_Int32, 0, 0)
+                    != CE_None) {
+                Rcpp::stop("failed to read the output raster");
+            }
+            strip_below = below.data();
+        } else {
+            strip_below = below_mem.data() +
+                          static_cast<std::size_t>(y0) * xsize;
+        }
+
+        // vertical distance in rows to the nearest target in the column
+        g.resize(npx);
+        parallel_for_(num_col_tasks, num_threads, [&](std::size_t j) {
+            int c0 = 0, c1 = 0;
+            colRange(j, &c0, &c1);
+            for (int i = 0; i < ny; ++i) {
+                const std::size_t row = static_cast<std::size_t>(i) * xsize;
+                const int y = y0 + i;
+                for (int c = c0; c < c1; ++c) {
+                    if (is_target[row + c])
+                        prev_above[c] = y;
+                    double dy = PROX_INF;
+                    if (prev_above[c] >= 0)
+                        dy = y - prev_above[c];
+                    if (strip_below[row + c] < ysize)
+                        dy = std::min(dy, static_cast<double>(
+                                              strip_below[row + c] - y));
+                    g[row + c] = dy;
+                }
+            }
+        });
+
+        out.resize(npx);
+        parallel_for_indexed_(static_cast<std::size_t>(ny), num_threads,
+                              [&](int t, std::size_t i) {
+            double wx = 1.0, wy = 1.0;
+            rowScale_(p, y0 + static_cast<int>(i), &wx, &wy);
+            double *f = g.data() + i * xsize;
+            for (int c = 0; c < xsize; ++c) {
+                if (f[c] != PROX_INF)
+                    f[c] = (f[c] * wy) * (f[c] * wy);
+            }
+            double *d = out.data() + i * xsize;
+            envelope_(f, xsize, wx * wx, d, &env_v[t], &env_z[t]);
+            for (int c = 0; c < xsize; ++c) {
+                d[c] = std::sqrt(d[c]);
+                if (d[c] == PROX_INF || (max_dist > 0 && d[c] > max_dist))
+                    d[c] = std::numeric_limits<double>::quiet_NaN();
+            }
+        }, PROX_ROW_GRAIN);
+
+        if (has_dst_nodata) {
+            for (double &v : out) {
+                if (std::isnan(v))
+                    v = dst_nodata;
+            }
+        }
+
+        if (GDALRasterIO(hDstBand, GF_Write, 0, y0, xsize, ny, out.data(),
+                         xsize, ny, GDT_Float64, 0, 0) != CE_None) {
+            Rcpp::stop("failed to write the output raster");
+        }
+
+        if (!quiet) {
+            pfnProgress(0.5 + 0.5 * (s + 1) / num_strips, nullptr, nullptr);
+        }
+        Rcpp::checkUserInterrupt();
+    }
+
+    return true;
+}
@@ -0,0 +1,23 @@
+/* Exact Euclidean distance transform of a raster band (proximity to target
+   pixels), computed with separable column and row passes on multiple
+   threads.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef PROXIMITY_H_
+#define PROXIMITY_H_
+
+#include <Rcpp.h>
+
+#include <string>
+
+class GDALRaster;
+bool proximity(const GDALRaster* const &src_ds, int band,
+               const GDALRaster* const &dst_ds,
+               const Rcpp::NumericVector &target_values,
+               const std::string &units, double max_dist, int num_threads,
+               bool quiet);
+
+#endif  // PROXIMITY_H_
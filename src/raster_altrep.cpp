@@ -0,0 +1,715 @@
+/* ALTREP vectors backed by GDAL raster bands
+
+   gdalraster_vmem_real / gdalraster_vmem_integer: a whole raster band
+   mapped into memory with GDALGetVirtualMemAuto(). For raw layouts
+   (uncompressed GeoTIFF, ENVI and other raw formats) this is a mapping of
+   the file itself, otherwise GDAL falls back to virtual memory filled by
+   page faults (64-bit Linux), which reads the blocks that are touched
+   through the band, with a bounded page cache. Elements are converted from
+   the mapped memory on access (Elt, Get_region), so indexing, subsetting
+   and summaries such as sum() only touch the pages they need and the band
+   is never copied. When the data type and layout match the R type exactly
+   (Float64 or Int32, packed pixels, no nodata value to convert), the
+   mapped memory is also returned as the read-only data pointer (no copy at
+   all).
+
+   gdalraster_lazy_real / gdalraster_lazy_integer: a window of one or more
+   bands (interleaved by band as in read_ds()) that is read on access. Each
+   band has a RasterBlockCache, so Elt and Get_region read only the blocks
+   that hold the requested elements (a bounded LRU of blocks per band), and
+   Sum, Min and Max scan the window block by block, reading each block once,
+   without materializing the vector.
+
+   Each vector owns its own read-only dataset handle, so it stays valid
+   after the GDALRaster object is closed. The handle (and the mapping or the
+   block caches) are released by the finalizer of the external pointer in
+   data1. As for all ALTREP vectors here, a writable data pointer (e.g., to
+   modify the vector) materializes an ordinary in-memory copy, kept in
+   data2, and a duplicate shares data1 until it is modified.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_port.h>
+#include <cpl_virtualmem.h>
+#include <gdal.h>
+
+#include <Rcpp.h>
+#include <R_ext/Altrep.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "raster_altrep.h"
+#include "gdalraster.h"
+#include "raster_block_cache.h"
+
+namespace {
+
+R_altrep_class_t VMEM_REAL_CLASS;
+R_altrep_class_t VMEM_INTEGER_CLASS;
+R_altrep_class_t LAZY_REAL_CLASS;
+R_altrep_class_t LAZY_INTEGER_CLASS;
+
+// maximum memory for the cached blocks of each band of a lazy vector
+constexpr std::size_t LAZY_CACHE_BYTES = 64 * 1024 * 1024;
+
+// R integer type as in GDALRaster::read(), see readableAsInt_()
+bool readAsInt_(GDALDataType dt) {
+    const int nbits = GDALGetDataTypeSizeBits(dt);
+    return CPL_TO_BOOL(GDALDataTypeIsInteger(dt)) &&
+           (nbits <= 16 ||
+            (nbits <= 32 && CPL_TO_BOOL(GDALDataTypeIsSigned(dt))));
+}
+
+struct VmemBand {
+    std::string filename {};
+    int band {1};
+    GDALDatasetH hDS {nullptr};
+    CPLVirtualMem *vmem {nullptr};
+    const GByte *base {nullptr};
+    GDALDataType dt {GDT_Unknown};
+    int pixel_space {0};
+    GIntBig line_space {0};
+    R_xlen_t xsize {0};
+    R_xlen_t ysize {0};
+    bool has_nodata {false};
+    double nodata {0};
+    bool file_mapping {false};
+    bool zero_copy {false};
+};
+
+void vmemFinalize_(SEXP xp) {
+    VmemBand *vb = static_cast<VmemBand *>(R_ExternalPtrAddr(xp));
+    if (vb == nullptr)
+        return;
+    // the mapping references the band, so it is freed first
+    if (vb->vmem != nullptr)
+        CPLVirtualMemFree(vb->vmem);
+    if (vb->hDS != nullptr)
+        GDALClose(vb->hDS);
+    delete vb;
+    R_ClearExternalPtr(xp);
+}
+
+VmemBand *vmemBand_(SEXP x) {
+    return static_cast<VmemBand *>(R_ExternalPtrAddr(R_altrep_data1(x)));
+}
+
+R_xlen_t vmemLength_(SEXP x) {
+    const VmemBand *vb = vmemBand_(x);
+    return vb->xsize * vb->ysize;
+}
+
+// copy n elements from element i, converted to eBufType (GDT_Float64 or
+// GDT_Int32) with nodata set to NA, row by row from the mapped memory
+template <typename T>
+R_xlen_t vmemRegion_(const VmemBand *vb, R_xlen_t i, R_xlen_t n, T *buf,
+                     GDALDataType eBufType, T na_value) {
+
+    const R_xlen_t len = vb->xsize * vb->ysize;
+    if (i >= len)
+        return 0;
+    n = std::min(n, len - i);
+
+    R_xlen_t done = 0;
+    while (done < n) {
+        const R_xlen_t k = i + done;
+        const R_xlen_t row = k / vb->xsize;
+        const R_xlen_t col = k % vb->xsize;
+        const R_xlen_t count = std::min(n - done, vb->xsize - col);
+        const GByte *src = vb->base + row * vb->line_space +
+                           col * static_cast<R_xlen_t>(vb->pixel_space);
+        GDALCopyWords64(src, vb->dt, vb->pixel_space, buf + done, eBufType,
+                        static_cast<int>(sizeof(T)), count);
+        if (vb->has_nodata && !std::isnan(vb->nodata)) {
+            // the converted values are exact for the types read as integer
+            for (R_xlen_t j = done; j < done + count; ++j) {
+                if (static_cast<double>(buf[j]) == vb->nodata)
+                    buf[j] = na_value;
+            }
+        }
+        done += count;
+    }
+    return n;
+}
+
+R_xlen_t vmemRealRegion_(SEXP x, R_xlen_t i, R_xlen_t n, double *buf) {
+    SEXP data2 = R_altrep_data2(x);
+    if (data2 != R_NilValue)
+        return REAL_GET_REGION(data2, i, n, buf);
+    return vmemRegion_<double>(vmemBand_(x), i, n, buf, GDT_Float64,
+                               NA_REAL);
+}
+
+R_xlen_t vmemIntegerRegion_(SEXP x, R_xlen_t i, R_xlen_t n, int *buf) {
+    SEXP data2 = R_altrep_data2(x);
+    if (data2 != R_NilValue)
+        return INTEGER_GET_REGION(data2, i, n, buf);
+    return vmemRegion_<int>(vmemBand_(x), i, n, buf, GDT_Int32,
+                            NA_INTEGER);
+}
+
+double vmemRealElt_(SEXP x, R_xlen_t i) {
+    double v = NA_REAL;
+    vmemRealRegion_(x, i, 1, &v);
+    return v;
+}
+
+int vmemIntegerElt_(SEXP x, R_xlen_t i) {
+    int v = NA_INTEGER;
+    vmemIntegerRegion_(x, i, 1, &v);
+    return v;
+}
+
+// an ordinary in-memory copy of the vector
+SEXP vmemMaterialize_(SEXP x) {
+    const R_xlen_t n = vmemLength_(x);
+    SEXP out = PROTECT(Rf_allocVector(TYPEOF(x), n));
+    if (TYPEOF(x) == REALSXP)
+        vmemRealRegion_(x, 0, n, REAL(out));
+    else
+        vmemIntegerRegion_(x, 0, n, INTEGER(out));
+    UNPROTECT(1);
+    return out;
+}
+
+void *vmemDataptr_(SEXP x, Rboolean writeable) {
+    SEXP data2 = R_altrep_data2(x);
+    if (data2 == R_NilValue) {
+        const VmemBand *vb = vmemBand_(x);
+        // the mapping is read-only
+        if (!writeable && vb->zero_copy)
+            return const_cast<GByte *>(vb->base);
+        data2 = vmemMaterialize_(x);
+        R_set_altrep_data2(x, data2);
+    }
+    if (TYPEOF(data2) == REALSXP)
+        return REAL(data2);
+    return INTEGER(data2);
+}
+
+const void *vmemDataptrOrNull_(SEXP x) {
+    SEXP data2 = R_altrep_data2(x);
+    if (data2 != R_NilValue)
+        return vmemDataptr_(x, FALSE);
+    const VmemBand *vb = vmemBand_(x);
+    return vb->zero_copy ? vb->base : nullptr;
+}
+
+SEXP vmemDuplicate_(SEXP x, Rboolean /* deep */) {
+    SEXP data2 = R_altrep_data2(x);
+    if (data2 != R_NilValue)
+        return Rf_duplicate(data2);
+    // read-only, so a copy can share the mapping until it is modified
+    const R_altrep_class_t cls = TYPEOF(x) == REALSXP ? VMEM_REAL_CLASS
+                                                      : VMEM_INTEGER_CLASS;
+    return R_new_altrep(cls, R_altrep_data1(x), R_NilValue);
+}
+
+Rboolean vmemInspect_(SEXP x, int /* pre */, int /* deep */, int /* pvec */,
+                      void (* /* inspect_subtree */)(SEXP, int, int, int)) {
+    const VmemBand *vb = vmemBand_(x);
+    Rprintf(" gdalraster virtual memory (%s) band %d of %s%s\n",
+            vb->file_mapping ? "file mapping" : "page faults", vb->band,
+            vb->filename.c_str(),
+            R_altrep_data2(x) != R_NilValue ? " [materialized]" : "");
+    return TRUE;
+}
+
+void registerVmemClass_(R_altrep_class_t cls) {
+    R_set_altrep_Length_method(cls, vmemLength_);
+    R_set_altrep_Inspect_method(cls, vmemInspect_);
+    R_set_altrep_Duplicate_method(cls, vmemDuplicate_);
+    R_set_altvec_Dataptr_method(cls, vmemDataptr_);
+    R_set_altvec_Dataptr_or_null_method(cls, vmemDataptrOrNull_);
+}
+
+struct LazyWindow {
+    std::string filename {};
+    GDALDatasetH hDS {nullptr};
+    std::vector<int> bands {};
+    std::vector<std::unique_ptr<RasterBlockCache>> caches {};
+    int xoff {0};
+    int yoff {0};
+    int xsize {0};
+    int ysize {0};
+};
+
+void lazyFinalize_(SEXP xp) {
+    LazyWindow *lw = static_cast<LazyWindow *>(R_ExternalPtrAddr(xp));
+    if (lw == nullptr)
+        return;
+    // the caches reference the bands, so they are released first
+    lw->caches.clear();
+    if (lw->hDS != nullptr)
+        GDALClose(lw->hDS);
+    delete lw;
+    R_ClearExternalPtr(xp);
+}
+
+LazyWindow *lazyWindow_(SEXP x) {
+    return static_cast<LazyWindow *>(R_ExternalPtrAddr(R_altrep_data1(x)));
+}
+
+R_xlen_t lazyLength_(SEXP x) {
+    const LazyWindow *lw = lazyWindow_(x);
+    return static_cast<R_xlen_t>(lw->xsize) * lw->ysize * lw->bands.size();
+}
+
+// calls f(cache, col, row, count, offset) for the row spans covering the n
+// elements from element i (the window of each band in turn), stops and
+// returns false if f does
+template <typename F>
+bool lazySpans_(LazyWindow *lw, R_xlen_t i, R_xlen_t n, F f) {
+    const R_xlen_t npix = static_cast<R_xlen_t>(lw->xsize) * lw->ysize;
+    R_xlen_t done = 0;
+    while (done < n) {
+        const R_xlen_t k = i + done;
+        const std::size_t b = static_cast<std::size_t>(k / npix);
+        const R_xlen_t p = k % npix;
+        const int row = lw->yoff + static_cast<int>(p / lw->xsize);
+        const int col_in_win = static_cast<int>(p % lw->xsize);
+        const int count = static_cast<int>(
+                std::min<R_xlen_t>(n - done, lw->xsize - col_in_win));
+        if (!f(lw->caches[b].get(), lw->xoff + col_in_win, row, count, done))
+            return false;
+        done += count;
+    }
+    return true;
+}
+
+bool lazyRealValues_(LazyWindow *lw, R_xlen_t i, R_xlen_t n, double *buf) {
+    return lazySpans_(lw, i, n,
+            [buf](RasterBlockCache *cache, int col, int row, int count,
+                  R_xlen_t offset) {
+                return cache->getRowSpan(col, row, count, buf + offset);
+            });
+}
+
+bool lazyIntegerValues_(LazyWindow *lw, R_xlen_t i, R_xlen_t n, int *buf) {
+    return lazySpans_(lw, i, n,
+            [buf](RasterBlockCache *cache, int col, int row, int count,
+                  R_xlen_t offset) {
+                double tmp[1024];
+                while (count > 0) {
+                    const int m = std::min(count, 1024);
+                    if (!cache->getRowSpan(col, row, m, tmp))
+                        return false;
+                    // nodata is NA_REAL in the cache
+                    for (int j = 0; j < m; ++j) {
+                        buf[offset + j] = std::isnan(tmp[j])
+                                ? NA_INTEGER : static_cast<int>(tmp[j]);
+                    }
+                    col += m;
+                    count -= m;
+                    offset += m;
+                }
+                return true;
+            });
+}
+
+R_xlen_t lazyRealRegion_(SEXP x, R_xlen_t i, R_xlen_t n, double *buf) {
+    SEXP data2 = R_altrep_data2(x);
+    if (data2 != R_NilValue)
+        return REAL_GET_REGION(data2, i, n, buf);
+    const R_xlen_t len = lazyLength_(x);
+    if (i >= len)
+        return 0;
+    n = std::min(n, len - i);
+    if (!lazyRealValues_(lazyWindow_(x), i, n, buf))
+        Rf_error("failed to read raster block");
+    return n;
+}
+
+R_xlen_t lazyIntegerRegion_(SEXP x, R_xlen_t i, R_xlen_t n, int *buf) {
+    SEXP data2 = R_altrep_data2(x);
+    if (data2 != R_NilValue)
+        return INTEGER_GET_REGION(data2, i, n, buf);
+    const R_xlen_t len = lazyLength_(x);
+    if (i >= len)
+        return 0;
+    n = std::min(n, len - i);
+    if (!lazyIntegerValues_(lazyWindow_(x), i, n, buf))
+        Rf_error("failed to read raster block");
+    return n;
+}
+
+double lazyRealElt_(SEXP x, R_xlen_t i) {
+    double v = NA_REAL;
+    lazyRealRegion_(x, i, 1, &v);
+    return v;
+}
+
+int lazyIntegerElt_(SEXP x, R_xlen_t i) {
+    int v = NA_INTEGER;
+    lazyIntegerRegion_(x, i, 1, &v);
+    return v;
+}
+
+// calls f(values, n) for the values of the window of each band, block by
+// block so that each block is read once, returns false if a block could
+// not be read
+template <typename F>
+bool lazyScan_(LazyWindow *lw, F f) {
+    for (std::size_t b = 0; b < lw->bands.size(); ++b) {
+        GDALRasterBandH hBand = GDALGetRasterBand(lw->hDS, lw->bands[b]);
+        int block_xsize = 0, block_ysize = 0;
+        GDALGetBlockSize(hBand, &block_xsize, &block_ysize);
+        std::vector<double> buf(std::min(block_xsize, lw->xsize));
+
+        const int x_end = lw->xoff + lw->xsize;
+        const int y_end = lw->yoff + lw->ysize;
+        for (int y0 = lw->yoff; y0 < y_end;
+                y0 = (y0 / block_ysize + 1) * block_ysize) {
+
+            const int y1 = std::min(y_end, (y0 / block_ysize + 1) *
+                                           block_ysize);
+            for (int x0 = lw->xoff; x0 < x_end;
+                    x0 = (x0 / block_xsize + 1) * block_xsize) {
+
+                const int n = std::min(x_end, (x0 / block_xsize + 1) *
+                                              block_xsize) - x0;
+                for (int row = y0; row < y1; ++row) {
+                    if (!lw->caches[b]->getRowSpan(x0, row, n, buf.data()))
+                        return false;
+                    f(buf.data(), n);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool sumReal_(LazyWindow *lw, bool narm, double *value) {
+    long double s = 0;
+    const bool ok = lazyScan_(lw, [&s, narm](const double *v, int n) {
+        for (int j = 0; j < n; ++j) {
+            if (!narm || !std::isnan(v[j]))
+                s += v[j];
+        }
+    });
+    *value = static_cast<double>(s);
+    return ok;
+}
+
+// sum of the values read as integer, NA if any value is NA and !narm
+bool sumInteger_(LazyWindow *lw, bool narm, double *value) {
+    double s = 0;
+    bool has_na = false;
+    const bool ok = lazyScan_(lw, [&s, &has_na](const double *v, int n) {
+        for (int j = 0; j < n; ++j) {
+            if (std::isnan(v[j]))
+                has_na = true;
+            else
+                s += v[j];
+        }
+    });
+    *value = (has_na && !narm) ? NA_REAL : s;
+    return ok;
+}
+
+// minimum (or maximum) with the semantics of min() and max() in R: NA if
+// any value is NA and !narm (NA takes precedence over NaN), false in
+// *has_value if no values remain
+bool rangeValue_(LazyWindow *lw, bool narm, bool is_max, double *value,
+                bool *has_value) {
+    double m = is_max ? R_NegInf : R_PosInf;
+    bool any = false;
+    bool has_nan = false;
+    bool has_na = false;
+    const bool ok = lazyScan_(lw,
+            [&m, &any, &has_nan, &has_na, is_max](const double *v, int n) {
+        for (int j = 0; j < n; ++j) {
+            if (std::isnan(v[j])) {
+                if (R_IsNA(v[j]))
+                    has_na = true;
+                else
+                    has_nan = true;
+            }
+            else {
+                if (is_max ? v[j] > m : v[j] < m)
+                    m = v[j];
+                any = true;
+            }
+        }
+    });
+    *has_value = true;
+    if (!narm && has_na)
+        *value = NA_REAL;
+    else if (!narm && has_nan)
+        *value = R_NaN;
+    else if (any)
+        *value = m;
+    else
+        *has_value = false;
+    return ok;
+}
+
+SEXP lazyRealSum_(SEXP x, Rboolean narm) {
+    // a modified copy is summarized by R from data2
+    if (R_altrep_data2(x) != R_NilValue)
+        return nullptr;
+    double value = 0;
+    if (!sumReal_(lazyWindow_(x), narm, &value))
+        Rf_error("failed to read raster block");
+    return Rf_ScalarReal(value);
+}
+
+SEXP lazyIntegerSum_(SEXP x, Rboolean narm) {
+    if (R_altrep_data2(x) != R_NilValue)
+        return nullptr;
+    double value = 0;
+    if (!sumInteger_(lazyWindow_(x), narm, &value))
+        Rf_error("failed to read raster block");
+    if (ISNA(value))
+        return Rf_ScalarInteger(NA_INTEGER);
+    // on integer overflow, R gives the NA with its warning
+    if (value > R_INT_MAX || value < R_INT_MIN)
+        return nullptr;
+    return Rf_ScalarInteger(static_cast<int>(value));
+}
+
+SEXP lazyRangeResult_(SEXP x, Rboolean narm, bool is_max) {
+    if (R_altrep_data2(x) != R_NilValue)
+        return nullptr;
+    double value = 0;
+    bool has_value = false;
+    if (!rangeValue_(lazyWindow_(x), narm, is_max, &value, &has_value))
+        Rf_error("failed to read raster block");
+    // no values remain, R gives Inf or -Inf with its warning
+    if (!has_value)
+        return nullptr;
+    if (TYPEOF(x) == INTSXP) {
+        return Rf_ScalarInteger(std::isnan(value) ? NA_INTEGER
+                                                  : static_cast<int>(value));
+    }
+    return Rf_ScalarReal(value);
+}
+
+SEXP lazyMin_(SEXP x, Rboolean narm) {
+    return lazyRangeResult_(x, narm, false);
+}
+
+SEXP lazyMax_(SEXP x, Rboolean narm) {
+    return lazyRangeResult_(x, narm, true);
+}
+
+// an ordinary in-memory copy of the vector
+SEXP lazyMaterialize_(SEXP x) {
+    const R_xlen_t n = lazyLength_(x);
+    SEXP out = PROTECT(Rf_allocVector(TYPEOF(x), n));
+    if (TYPEOF(x) == REALSXP)
+        lazyRealRegion_(x, 0, n, REAL(out));
+    else
+        lazyIntegerRegion_(x, 0, n, INTEGER(out));
+    UNPROTECT(1);
+    return out;
+}
+
+void *lazyDataptr_(SEXP x, Rboolean /* writeable */) {
+    SEXP data2 = R_altrep_data2(x);
+    if (data2 == R_NilValue) {
+        data2 = lazyMaterialize_(x);
+        R_set_altrep_data2(x, data2);
+    }
+    if (TYPEOF(data2) == REALSXP)
+        return REAL(data2);
+    return INTEGER(data2);
+}
+
+const void *lazyDataptrOrNull_(SEXP x) {
+    if (R_altrep_data2(x) != R_NilValue)
+        return lazyDataptr_(x, FALSE);
+    return nullptr;
+}
+
+SEXP lazyDuplicate_(SEXP x, Rboolean /* deep */) {
+    SEXP data2 = R_altrep_data2(x);
+    if (data2 != R_NilValue)
+        return Rf_duplicate(data2);
+    // read-only, so a copy can share the window until it is modified
+    const R_altrep_class_t cls = TYPEOF(x) == REALSXP ? LAZY_REAL_CLASS
+                                                      : LAZY_INTEGER_CLASS;
+    return R_new_altrep(cls, R_altrep_data1(x), R_NilValue);
+}
+
+Rboolean lazyInspect_(SEXP x, int /* pre */, int /* deep */, int /* pvec */,
+                      void (* /* inspect_subtree */)(SEXP, int, int, int)) {
+    const LazyWindow *lw = lazyWindow_(x);
+    Rprintf(" gdalraster lazy window %d x %d at (%d, %d), %d band(s) of "
+            "%s%s\n", lw->xsize, lw->ysize, lw->xoff, lw->yoff,
+            static_cast<int>(lw->bands.size()), lw->filename.c_str(),
+            R_altrep_data2(x) != R_NilValue ? " [materialized]" : "");
+    return TRUE;
+}
+
+void registerLazyClass_(R_altrep_class_t cls) {
+    R_set_altrep_Length_method(cls, lazyLength_);
+    R_set_altrep_Inspect_method(cls, lazyInspect_);
+    R_set_altrep_Duplicate_method(cls, lazyDuplicate_);
+    R_set_altvec_Dataptr_method(cls, lazyDataptr_);
+    R_set_altvec_Dataptr_or_null_method(cls, lazyDataptrOrNull_);
+}
+
+}  // namespace
+
+void raster_altrep_init(DllInfo *dll) {
+    VMEM_REAL_CLASS = R_make_altreal_class("gdalraster_vmem_real",
+                                           "gdalraster", dll);
+    registerVmemClass_(VMEM_REAL_CLASS);
+    R_set_altreal_Elt_method(VMEM_REAL_CLASS, vmemRealElt_);
+    R_set_altreal_Get_region_method(VMEM_REAL_CLASS, vmemRealRegion_);
+
+    VMEM_INTEGER_CLASS = R_make_altinteger_class("gdalraster_vmem_integer",
+                                                 "gdalraster", dll);
+    registerVmemClass_(VMEM_INTEGER_CLASS);
+    R_set_altinteger_Elt_method(VMEM_INTEGER_CLASS, vmemIntegerElt_);
+    R_set_altinteger_Get_region_method(VMEM_INTEGER_CLASS,
+                                       vmemIntegerRegion_);
+
+    LAZY_REAL_CLASS = R_make_altreal_class("gdalraster_lazy_real",
+                                           "gdalraster", dll);
+    registerLazyClass_(LAZY_REAL_CLASS);
+    R_set_altreal_Elt_method(LAZY_REAL_CLASS, lazyRealElt_);
+    R_set_altreal_Get_region_method(LAZY_REAL_CLASS, lazyRealRegion_);
+    R_set_altreal_Sum_method(LAZY_REAL_CLASS, lazyRealSum_);
+    R_set_altreal_Min_method(LAZY_REAL_CLASS, lazyMin_);
+    R_set_altreal_Max_method(LAZY_REAL_CLASS, lazyMax_);
+
+    LAZY_INTEGER_CLASS = R_make_altinteger_class("gdalraster_lazy_integer",
+                                                 "gdalraster", dll);
+    registerLazyClass_(LAZY_INTEGER_CLASS);
+    R_set_altinteger_Elt_method(LAZY_INTEGER_CLASS, lazyIntegerElt_);
+    R_set_altinteger_Get_region_method(LAZY_INTEGER_CLASS,
+                                       lazyIntegerRegion_);
+    R_set_altinteger_Sum_method(LAZY_INTEGER_CLASS, lazyIntegerSum_);
+    R_set_altinteger_Min_method(LAZY_INTEGER_CLASS, lazyMin_);
+    R_set_altinteger_Max_method(LAZY_INTEGER_CLASS, lazyMax_);
+}
+
+SEXP vmem_band_vector_(GDALDatasetH hDS, const std::string &filename,
+                       int band, bool as_matrix) {
+
+    VmemBand *vb = new VmemBand();
+    vb->filename = filename;
+    vb->band = band;
+    vb->hDS = hDS;
+    auto fail = [vb](const std::string &msg) {
+        if (vb->vmem != nullptr)
+            CPLVirtualMemFree(vb->vmem);
+        if (vb->hDS != nullptr)
+            GDALClose(vb->hDS);
+        delete vb;
+        Rcpp::stop(msg);
+    };
+
+    if (band < 1 || band > GDALGetRasterCount(vb->hDS))
+        fail("illegal band number");
+
+    GDALRasterBandH hBand = GDALGetRasterBand(vb->hDS, band);
+    vb->dt = GDALGetRasterDataType(hBand);
+    if (CPL_TO_BOOL(GDALDataTypeIsComplex(vb->dt)))
+        fail("virtual memory is not supported for complex data types");
+    vb->xsize = GDALGetRasterBandXSize(hBand);
+    vb->ysize = GDALGetRasterBandYSize(hBand);
+    int has_nodata = FALSE;
+    vb->nodata = GDALGetRasterNoDataValue(hBand, &has_nodata);
+    vb->has_nodata = has_nodata;
+
+    // a file mapping when the driver supports it, otherwise GDAL's default
+    // implementation with page faults
+    vb->vmem = GDALGetVirtualMemAuto(hBand, GF_Read, &vb->pixel_space,
+                                     &vb->line_space, nullptr);
+    if (vb->vmem == nullptr) {
+        fail("virtual memory mapping is not available for this raster "
+             "(requires a raw layout, or 64-bit Linux for other formats)");
+    }
+    vb->base = static_cast<const GByte *>(CPLVirtualMemGetAddr(vb->vmem));
+    vb->file_mapping = CPL_TO_BOOL(CPLVirtualMemIsFileMapping(vb->vmem));
+
+    const bool as_int = readAsInt_(vb->dt);
+    const GDALDataType eRType = as_int ? GDT_Int32 : GDT_Float64;
+    const int r_size = as_int ? static_cast<int>(sizeof(int))
+                              : static_cast<int>(sizeof(double));
+    const bool no_nodata_na = !vb->has_nodata ||
+                              (as_int ? vb->nodata == NA_INTEGER
+                                      : std::isnan(vb->nodata));
+    vb->zero_copy = vb->dt == eRType && vb->pixel_space == r_size &&
+                    vb->line_space == vb->xsize * r_size && no_nodata_na;
+
+    SEXP xp = PROTECT(R_MakeExternalPtr(vb, R_NilValue, R_NilValue));
+    R_RegisterCFinalizerEx(xp, vmemFinalize_, TRUE);
+    SEXP out = PROTECT(R_new_altrep(as_int ? VMEM_INTEGER_CLASS
+                                           : VMEM_REAL_CLASS,
+                                    xp, R_NilValue));
+    if (as_matrix) {
+        SEXP dim = PROTECT(Rf_allocVector(INTSXP, 2));
+        INTEGER(dim)[0] = static_cast<int>(vb->xsize);
+        INTEGER(dim)[1] = static_cast<int>(vb->ysize);
+        Rf_setAttrib(out, R_DimSymbol, dim);
+        UNPROTECT(1);
+    }
+    UNPROTECT(2);
+    return out;
+}
+
+//' Lazy vector of a raster window, read on access through block caches
+//' @noRd
+// [[Rcpp::export(name = ".read_ds_lazy")]]
+SEXP read_ds_lazy(const GDALRaster* const &ds,
+                  const Rcpp::IntegerVector &bands, int xoff, int yoff,
+                  int xsize, int ysize, bool as_integer) {
+
+    if (bands.size() == 0)
+        Rcpp::stop("'bands' is empty");
+    for (R_xlen_t i = 0; i < bands.size(); ++i) {
+        GDALRasterBandH hBand = ds->getBand_(bands[i]);
+        if (CPL_TO_BOOL(GDALDataTypeIsComplex(
+                GDALGetRasterDataType(hBand)))) {
+            Rcpp::stop("lazy read is not supported for complex data types");
+        }
+    }
+    if (xoff < 0 || yoff < 0 || xsize < 1 || ysize < 1 ||
+            xoff > ds->getRasterXSize() - xsize ||
+            yoff > ds->getRasterYSize() - ysize) {
+        Rcpp::stop("the window is not inside the raster extent");
+    }
+
+    LazyWindow *lw = new LazyWindow();
+    lw->filename = ds->getFilename();
+    lw->bands = Rcpp::as<std::vector<int>>(bands);
+    lw->xoff = xoff;
+    lw->yoff = yoff;
+    lw->xsize = xsize;
+    lw->ysize = ysize;
+    try {
+        // its own handle, so the vector does not depend on the lifetime of
+        // the GDALRaster object
+        lw->hDS = ds->reopenReadOnly_();
+    }
+    catch (...) {
+        delete lw;
+        throw;
+    }
+
+    // nodata is NA_REAL in the caches, the memory for cached blocks is
+    // shared by the bands
+    const std::size_t max_bytes = LAZY_CACHE_BYTES / lw->bands.size();
+    for (int b : lw->bands) {
+        lw->caches.push_back(std::make_unique<RasterBlockCache>(
+                GDALGetRasterBand(lw->hDS, b), max_bytes, NA_REAL));
+    }
+
+    SEXP xp = PROTECT(R_MakeExternalPtr(lw, R_NilValue, R_NilValue));
+    R_RegisterCFinalizerEx(xp, lazyFinalize_, TRUE);
+    SEXP out = R_new_altrep(as_integer ? LAZY_INTEGER_CLASS : LAZY_REAL_CLASS,
+                            xp, R_NilValue);
+    UNPROTECT(1);
+    return out;
+}
@@ -0,0 +1,31 @@
+/* ALTREP vectors backed by GDAL raster bands
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef RASTER_ALTREP_H_
+#define RASTER_ALTREP_H_
+
+#include <gdal.h>
+
+#include <Rcpp.h>
+
+#include <string>
+
+// register the ALTREP classes, called from the package init
+void raster_altrep_init(DllInfo *dll);
+
+// a band of the raster dataset hDS (opened from filename) mapped into
+// memory with GDAL virtual memory, as an ALTREP vector in left to right, top
+// to bottom pixel order (dim c(xsize, ysize) if as_matrix)
+// the vector takes ownership of hDS, which is closed on error
+SEXP vmem_band_vector_(GDALDatasetH hDS, const std::string &filename,
+                       int band, bool as_matrix);
+
+class GDALRaster;
+SEXP read_ds_lazy(const GDALRaster* const &ds,
+                  const Rcpp::IntegerVector &bands, int xoff, int yoff,
+                  int xsize, int ysize, bool as_integer);
+
+#endif  // RASTER_ALTREP_H_
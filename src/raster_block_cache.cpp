@@ -0,0 +1,132 @@
+/* class RasterBlockCache
+   Read-only LRU cache of the blocks of a raster band.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_error.h>
+#include <gdal.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+#include "raster_block_cache.h"
+
+RasterBlockCache::RasterBlockCache(GDALRasterBandH hBand,
+                                   std::size_t max_bytes, double nodata_fill)
+        : m_hBand(hBand), m_nodata_fill(nodata_fill) {
+
+    m_raster_xsize = GDALGetRasterBandXSize(hBand);
+    m_raster_ysize = GDALGetRasterBandYSize(hBand);
+    GDALGetBlockSize(hBand, &m_block_xsize, &m_block_ysize);
+    if (m_block_xsize < 1 || m_block_ysize < 1) {
+        m_block_xsize = m_raster_xsize;
+        m_block_ysize = 1;
+    }
+    m_num_blocks_x = (m_raster_xsize + m_block_xsize - 1) / m_block_xsize;
+
+    int has_nodata = FALSE;
+    m_nodata = GDALGetRasterNoDataValue(hBand, &has_nodata);
+    m_has_nodata = (has_nodata != FALSE);
+
+    const std::size_t block_bytes =
+        static_cast<std::size_t>(m_block_xsize) * m_block_ysize *
+        sizeof(double);
+    m_max_blocks = std::max<std::size_t>(1, max_bytes / block_bytes);
+}
+
+bool RasterBlockCache::getValue(int col, int row, double *value) {
+    if (col < 0 || col >= m_raster_xsize || row < 0 ||
+            row >= m_raster_ysize) {
+        *value = std::numeric_limits<double>::quiet_NaN();
+        return true;
+    }
+
+    const Block *block = fetch_(col / m_block_xsize, row / m_block_ysize);
+    if (block == nullptr)
+        return false;
+
+    const std::size_t i =
+        static_cast<std::size_t>(row % m_block_ysize) * block->xsize +
+        (col % m_block_xsize);
+    *value = block->data[i];
+    return true;
+}
+
+bool RasterBlockCache::getRowSpan(int col, int row, int n, double *buf) {
+    while (n > 0) {
+        const Block *block = fetch_(col / m_block_xsize, row / m_block_ysize);
+        if (block == nullptr)
+            return false;
+
+        const int block_col = col % m_block_xsize;
+        const int count = std::min(n, block->xsize - block_col);
+        const double *src = block->data.data() +
+            static_cast<std::size_t>(row % m_block_ysize) * block->xsize +
+            block_col;
+        std::copy(src, src + count, buf);
+        buf += count;
+        col += count;
+        n -= count;
+    }
+    return true;
+}
+
+std::size_t RasterBlockCache::numReads() const {
+    return m_num_reads;
+}
+
+const RasterBlockCache::Block *RasterBlockCache::fetch_(int xblock,
+                                                        int yblock) {
+
+    const int64_t key = static_cast<int64_t>(yblock) * m_num_blocks_x +
+                        xblock;
+
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        // move to the front of the LRU list
+        if (it->second != m_lru.begin())
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return &m_lru.front();
+    }
+
+    const int xoff = xblock * m_block_xsize;
+    const int yoff = yblock * m_block_ysize;
+    const int xsize = std::min(m_block_xsize, m_raster_xsize - xoff);
+    const int ysize = std::min(m_block_ysize, m_raster_ysize - yoff);
+
+    if (m_lru.size() >= m_max_blocks) {
+        // reuse the buffer of the least recently used block
+        m_index.erase(m_lru.back().key);
+        m_lru.splice(m_lru.begin(), m_lru, std::prev(m_lru.end()));
+    }
+    else {
+        m_lru.emplace_front();
+    }
+    Block &block = m_lru.front();
+    block.key = key;
+    block.xsize = xsize;
+    block.data.resize(static_cast<std::size_t>(xsize) * ysize);
+
+    CPLErr err = GDALRasterIO(m_hBand, GF_Read, xoff, yoff, xsize, ysize,
+                              block.data.data(), xsize, ysize, GDT_Float64,
+                              0, 0);
+    if (err != CE_None) {
+        m_lru.pop_front();
+        return nullptr;
+    }
+    m_num_reads += 1;
+
+    if (m_has_nodata) {
+        for (double &v : block.data) {
+            if (v == m_nodata)
+                v = m_nodata_fill;
+        }
+    }
+
+    m_index[key] = m_lru.begin();
+    return &block;
+}
@@ -0,0 +1,68 @@
+/* class RasterBlockCache
+   Read-only LRU cache of the blocks of a raster band, for random access to
+   individual pixel values (e.g., along profile lines) without a RasterIO
+   call per pixel. Blocks are read as Float64 on first access, with nodata
+   pixels set to NaN (or another fill value, e.g., NA_REAL).
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef RASTER_BLOCK_CACHE_H_
+#define RASTER_BLOCK_CACHE_H_
+
+#include <gdal.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+class RasterBlockCache {
+ public:
+    // max_bytes is the maximum memory used for cached blocks (at least one
+    // block is always kept), nodata pixels are set to nodata_fill
+    RasterBlockCache(GDALRasterBandH hBand, std::size_t max_bytes,
+                     double nodata_fill =
+                         std::numeric_limits<double>::quiet_NaN());
+
+    // value of the pixel at (col, row), nodata_fill for nodata, NaN outside
+    // the raster
+    // returns false if the block could not be read
+    bool getValue(int col, int row, double *value);
+
+    // values of the n pixels from (col, row) along the row, which must be
+    // inside the raster, copied by block
+    // returns false if a block could not be read
+    bool getRowSpan(int col, int row, int n, double *buf);
+
+    // number of block reads so far
+    std::size_t numReads() const;
+
+ private:
+    struct Block {
+        int64_t key;
+        int xsize;
+        std::vector<double> data;
+    };
+
+    GDALRasterBandH m_hBand {nullptr};
+    int m_raster_xsize {0};
+    int m_raster_ysize {0};
+    int m_block_xsize {0};
+    int m_block_ysize {0};
+    int m_num_blocks_x {0};
+    bool m_has_nodata {false};
+    double m_nodata {0};
+    double m_nodata_fill {0};
+    std::size_t m_max_blocks {1};
+    std::size_t m_num_reads {0};
+    std::list<Block> m_lru {};
+    std::unordered_map<int64_t, std::list<Block>::iterator> m_index {};
+
+    const Block *fetch_(int xblock, int yblock);
+};
+
+#endif  // RASTER_BLOCK_CACHE_H_
@@ -0,0 +1,390 @@
+/* Raster profiles along line geometries
+
+   Each line is transformed to grid (pixel/line) coordinates with the inverse
+   geotransform. Since the geotransform is affine, segments remain straight
+   lines in grid space and can be walked cell by cell with a voxel traversal
+   (Amanatides & Woo 1987, "A Fast Voxel Traversal Algorithm for Ray
+   Tracing"), which visits each cell crossed by a segment exactly once, in
+   order. Pixel values are read from an LRU cache of whole blocks, so each
+   block touched by the lines is read once rather than one RasterIO call per
+   sample point.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_port.h>
+#include <gdal.h>
+#include <ogr_api.h>
+#include <ogr_srs_api.h>
+
+#include <Rcpp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "raster_profile.h"
+#include "gdalraster.h"
+#include "gdalvector.h"
+#include "geom_api.h"
+#include "raster_block_cache.h"
+#include "spatial_index.h"
+#include "transform_cache.h"
+
+namespace {
+
+// a run of a line within one raster cell
+struct ProfileCell {
+    int part;
+    int col;
+    int row;
+    double dist_in;   // distance along the feature entering the cell
+    double dist_out;  // distance along the feature leaving the cell
+};
+
+// vertex sequences (parts) of the linear components of a geometry
+void collectPaths_(OGRGeometryH hGeom,
+                   std::vector<std::vector<double>> *paths) {
+
+    const int num_parts = OGR_G_GetGeometryCount(hGeom);
+    if (num_parts > 0) {
+        // rings of a polygon, or parts of a collection
+        for (int i = 0; i < num_parts; ++i)
+            collectPaths_(OGR_G_GetGeometryRef(hGeom, i), paths);
+        return;
+    }
+
+    const int n = OGR_G_GetPointCount(hGeom);
+    if (n < 2)
+        return;
+    std::vector<double> x(n), y(n);
+    OGR_G_GetPoints(hGeom, x.data(), sizeof(double), y.data(),
+                    sizeof(double), nullptr, 0);
+    std::vector<double> xy(2 * static_cast<std::size_t>(n));
+    for (int i = 0; i < n; ++i) {
+        xy[2 * i] = x[i];
+        xy[2 * i + 1] = y[i];
+    }
+    paths->push_back(std::move(xy));
+}
+
+// Walk the cells of an nx by ny grid crossed by the segment (x0, y0) to
+// (x1, y1) in grid coordinates, after clipping to the grid extent.
+// fn(col, row, t_in, t_out) is called for each cell in order, with the
+// segment parameters [0, 1] at which the segment enters and leaves the cell.
+// A segment passing exactly through a cell corner does not visit the two
+// cells that it only touches at the corner.
+template <typename Fn>
+void walkSegment_(double x0, double y0, double x1, double y1, int nx, int ny,
+                  Fn fn) {
+
+    const double dx = x1 - x0;
+    const double dy = y1 - y0;
+
+    // Liang-Barsky clipping to [0, nx] x [0, ny]
+    double t0 = 0.0;
+    double t1 = 1.0;
+    auto clip = [&t0, &t1](double p, double q) {
+        if (p == 0)
+            return q >= 0;
+        const double r = q / p;
+        if (p < 0) {
+            if (r > t1)
+                return false;
+            t0 = std::max(t0, r);
+        }
+        else {
+            if (r < t0)
+                return false;
+            t1 = std::min(t1, r);
+        }
+        return true;
+    };
+    if (!clip(-dx, x0) || !clip(dx, nx - x0) || !clip(-dy, y0) ||
+            !clip(dy, ny - y0) || !(t1 > t0)) {
+        return;
+    }
+
+    // starting cell, on the side of a cell edge that the segment moves into
+    const double xs = x0 + t0 * dx;
+    const double ys = y0 + t0 * dy;
+    int col = static_cast<int>(std::floor(xs));
+    int row = static_cast<int>(std::floor(ys));
+    if (dx < 0 && xs == std::floor(xs))
+        col -= 1;
+    if (dy < 0 && ys == std::floor(ys))
+        row -= 1;
+    col = std::min(std::max(col, 0), nx - 1);
+    row = std::min(std::max(row, 0), ny - 1);
+
+    const double inf = std::numeric_limits<double>::infinity();
+    const int step_x = dx > 0 ? 1 : -1;
+    const int step_y = dy > 0 ? 1 : -1;
+    const double t_delta_x = dx != 0 ? 1.0 / std::fabs(dx) : inf;
+    const double t_delta_y = dy != 0 ? 1.0 / std::fabs(dy) : inf;
+    double t_max_x = inf;
+    if (dx > 0)
+        t_max_x = (col + 1 - x0) / dx;
+    else if (dx < 0)
+        t_max_x = (col - x0) / dx;
+    double t_max_y = inf;
+    if (dy > 0)
+        t_max_y = (row + 1 - y0) / dy;
+    else if (dy < 0)
+        t_max_y = (row - y0) / dy;
+
+    double t_in = t0;
+    while (true) {
+        const double t_out = std::min(std::min(t_max_x, t_max_y), t1);
+        if (t_out > t_in)
+            fn(col, row, t_in, t_out);
+        if (t_out >= t1)
+            break;
+
+        if (t_max_x < t_max_y) {
+            col += step_x;
+            t_max_x += t_delta_x;
+        }
+        else if (t_max_y < t_max_x) {
+            row += step_y;
+            t_max_y += t_delta_y;
+        }
+        else {
+            // through a corner, diagonally to the next cell
+            col += step_x;
+            row += step_y;
+            t_max_x += t_delta_x;
+            t_max_y += t_delta_y;
+        }
+        t_in = t_out;
+        if (col < 0 || col >= nx || row < 0 || row >= ny)
+            break;
+    }
+}
+
+// cells crossed by the parts of a geometry in the raster SRS, runs of
+// consecutive segments within the same cell are merged
+void profileCells_(OGRGeometryH hGeom, const std::vector<double> &inv_gt,
+                   int nx, int ny,
+                   std::vector<ProfileCell> *cells) {
+
+    std::vector<std::vector<double>> paths;
+    if (OGR_G_HasCurveGeometry(hGeom, TRUE)) {
+        OGRGeometryH hLinear = OGR_G_GetLinearGeometry(hGeom, 0, nullptr);
+        if (hLinear == nullptr)
+            return;
+        collectPaths_(hLinear, &paths);
+        OGR_G_DestroyGeometry(hLinear);
+    }
+    else {
+        collectPaths_(hGeom, &paths);
+    }
+
+    // distance is cumulative over the parts of a multi-part geometry
+    double dist = 0;
+    for (std::size_t part = 0; part < paths.size(); ++part) {
+        const std::vector<double> &xy = paths[part];
+        const std::size_t n = xy.size() / 2;
+        for (std::size_t i = 0; i + 1 < n; ++i) {
+            const double geo_x0 = xy[2 * i];
+            const double geo_y0 = xy[2 * i + 1];
+            const double geo_x1 = xy[2 * i + 2];
+            const double geo_y1 = xy[2 * i + 3];
+            const double seg_len = std::hypot(geo_x1 - geo_x0,
+                                              geo_y1 - geo_y0);
+            if (!(seg_len > 0))
+                continue;
+
+            const double x0 = inv_gt[0] + inv_gt[1] * geo_x0 +
+                              inv_gt[2] * geo_y0;
+            const double y0 = inv_gt[3] + inv_gt[4] * geo_x0 +
+                              inv_gt[5] * geo_y0;
+            const double x1 = inv_gt[0] + inv_gt[1] * geo_x1 +
+                              inv_gt[2] * geo_y1;
+            const double y1 = inv_gt[3] + inv_gt[4] * geo_x1 +
+                              inv_gt[5] * geo_y1;
+
+            walkSegment_(x0, y0, x1, y1, nx, ny,
+                [&](int col, int row, double t_in, double t_out) {
+                    const double d_in = dist + t_in * seg_len;
+                    const double d_out = dist + t_out * seg_len;
+                    if (!cells->empty()) {
+                        ProfileCell &last = cells->back();
+                        if (last.part == static_cast<int>(part) &&
+                                last.col == col && last.row == row &&
+                                std::fabs(last.dist_out - d_in) <=
+                                    1e-9 * std::max(1.0, d_in)) {
+                            last.dist_out = d_out;
+                            return;
+                        }
+                    }
+                    cells->push_back({static_cast<int>(part), col, row,
+                                      d_in, d_out});
+                });
+
+            dist += seg_len;
+        }
+    }
+}
+
+}  // namespace
+
+//' Sample raster values along line geometries
+//' geom is WKB/WKT or a GDALVector object, srs is the SRS of the geometries
+//' if they must be transformed to the raster SRS (otherwise "")
+//' @noRd
+// [[Rcpp::export(name = ".raster_profile")]]
+Rcpp::List raster_profile(const GDALRaster* const &src_ds,
+                          const Rcpp::RObject &geom,
+                          const Rcpp::IntegerVector &bands,
+                          const std::string &srs, double max_cache_mb,
+                          bool quiet) {
+
+    src_ds->checkAccess_(GA_ReadOnly);
+
+    if (bands.size() == 0)
+        Rcpp::stop("'bands' is empty");
+    std::vector<GDALRasterBandH> band_h;
+    for (int b : bands) {
+        GDALRasterBandH hBand = src_ds->getBand_(b);
+        if (GDALDataTypeIsComplex(GDALGetRasterDataType(hBand)))
+            Rcpp::stop("complex data types are not supported");
+        band_h.push_back(hBand);
+    }
+
+    if (Rcpp::NumericVector::is_na(max_cache_mb) || max_cache_mb <= 0)
+        Rcpp::stop("'max_cache_mb' must be a positive number");
+
+    const Rcpp::NumericVector gt_r = src_ds->getGeoTransform();
+    const Rcpp::NumericVector inv_gt_r = inv_geotransform(gt_r);
+    if (Rcpp::is_true(Rcpp::any(Rcpp::is_na(inv_gt_r))))
+        Rcpp::stop("failed to get inverse geotransform");
+    const std::vector<double> gt(gt_r.begin(), gt_r.end());
+    const std::vector<double> inv_gt(inv_gt_r.begin(), inv_gt_r.end());
+    const int nx = static_cast<int>(src_ds->getRasterXSize());
+    const int ny = static_cast<int>(src_ds->getRasterYSize());
+
+    bool is_layer = false;
+    if (geom.isObject()) {
+        const Rcpp::String cls = geom.attr("class");
+        if (cls != "Rcpp_GDALVector")
+            Rcpp::stop("'geom' is an object of unsupported class");
+        is_layer = true;
+    }
+
+    std::vector<OGRGeometryH> geoms_in;
+    std::vector<int64_t> fids;
+    if (is_layer) {
+        GDALVector &lyr = Rcpp::as<GDALVector &>(geom);
+        if (!lyr.isOpen())
+            Rcpp::stop("the GDALVector object for 'geom' is not open");
+        readLayerGeoms_(lyr.getOGRLayerH_(), &geoms_in, &fids);
+    }
+    else {
+        geoms_in = geomsFromRObject_(geom, quiet);
+    }
+    // owned from here on, so they are destroyed if the transformation
+    // fails or the user interrupts
+    std::vector<OGRGeomPtr_> geoms(geoms_in.size());
+    for (std::size_t i = 0; i < geoms_in.size(); ++i)
+        geoms[i].reset(geoms_in[i]);
+    geoms_in.clear();
+
+    if (srs != "") {
+        const std::string raster_srs = src_ds->getProjection();
+        if (raster_srs == "")
+            Rcpp::stop("the raster does not have a spatial reference system");
+        const CTLease ct = acquireCT_(srs, raster_srs, true);
+        for (std::size_t i = 0; i < geoms.size(); ++i) {
+            if (geoms[i] == nullptr)
+                continue;
+            if (OGR_G_Transform(geoms[i].get(), ct.handle()) != OGRERR_NONE) {
+                if (!quiet) {
+                    Rcpp::warning("failed to transform geometry " +
+                                  std::to_string(i + 1));
+                }
+                geoms[i].reset();
+            }
+        }
+    }
+
+    // the cache budget is shared by the bands
+    const std::size_t max_bytes = static_cast<std::size_t>(
+        max_cache_mb * 1024 * 1024 / band_h.size());
+    std::vector<std::unique_ptr<RasterBlockCache>> caches;
+    for (GDALRasterBandH hBand : band_h)
+        caches.push_back(std::make_unique<RasterBlockCache>(hBand, max_bytes));
+
+    std::vector<int> feature;
+    std::vector<int64_t> fid;
+    std::vector<int> part;
+    std::vector<double> distance, x, y;
+    std::vector<std::vector<double>> values(band_h.size());
+    std::vector<ProfileCell> cells;
+
+    GDALProgressFunc pfnProgress = GDALTermProgressR;
+    if (!quiet)
+        pfnProgress(0, nullptr, nullptr);
+
+    bool read_error = false;
+    for (std::size_t i = 0; i < geoms.size() && !read_error; ++i) {
+        if (geoms[i] != nullptr) {
+            cells.clear();
+            profileCells_(geoms[i].get(), inv_gt, nx, ny, &cells);
+            for (const ProfileCell &c : cells) {
+                feature.push_back(static_cast<int>(i) + 1);
+                if (is_layer)
+                    fid.push_back(fids[i]);
+                part.push_back(c.part + 1);
+                distance.push_back((c.dist_in + c.dist_out) / 2.0);
+                // center of the pixel
+                const double px = c.col + 0.5;
+                const double py = c.row + 0.5;
+                x.push_back(gt[0] + gt[1] * px + gt[2] * py);
+                y.push_back(gt[3] + gt[4] * px + gt[5] * py);
+                for (std::size_t b = 0; b < caches.size(); ++b) {
+                    double v = 0;
+                    if (!caches[b]->getValue(c.col, c.row, &v)) {
+                        read_error = true;
+                        break;
+                    }
+                    values[b].push_back(std::isnan(v) ? NA_REAL : v);
+                }
+                if (read_error)
+                    break;
+            }
+        }
+
+        if (!quiet)
+            pfnProgress((i + 1.0) / geoms.size(), nullptr, nullptr);
+        if (i % 1000 == 0)
+            Rcpp::checkUserInterrupt();
+    }
+    geoms.clear();
+
+    if (read_error)
+        Rcpp::stop("failed to read raster block");
+
+    const std::size_t num_out = feature.size();
+    Rcpp::List df = Rcpp::List::create(
+        Rcpp::Named("feature") = Rcpp::wrap(feature));
+    if (is_layer)
+        df.push_back(Rcpp::wrap(fid), "fid");
+    df.push_back(Rcpp::wrap(part), "part");
+    df.push_back(Rcpp::wrap(distance), "distance");
+    df.push_back(Rcpp::wrap(x), "x");
+    df.push_back(Rcpp::wrap(y), "y");
+    for (R_xlen_t b = 0; b < bands.size(); ++b) {
+        df.push_back(Rcpp::wrap(values[b]),
+                     "b" + std::to_string(bands[b]));
+    }
+    df.attr("class") = Rcpp::CharacterVector{"data.frame"};
+    df.attr("row.names") = Rcpp::seq_len(num_out);
+    return df;
+}
@@ -0,0 +1,23 @@
+/* Raster profiles along line geometries
+   The segments of each line are traversed across the raster grid cell by
+   cell (Amanatides & Woo), reading pixel values from cached blocks.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef RASTER_PROFILE_H_
+#define RASTER_PROFILE_H_
+
+#include <Rcpp.h>
+
+#include <string>
+
+class GDALRaster;
+Rcpp::List raster_profile(const GDALRaster* const &src_ds,
+                          const Rcpp::RObject &geom,
+                          const Rcpp::IntegerVector &bands,
+                          const std::string &srs, double max_cache_mb,
+                          bool quiet);
+
+#endif  // RASTER_PROFILE_H_
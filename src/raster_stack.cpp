@@ -0,0 +1,489 @@
+/* Implementation of class RasterStack
+   Aligned raster layers read concurrently, one I/O thread per dataset.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_error.h>
+#include <cpl_port.h>
+#include <gdal.h>
+
+#include <Rcpp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "raster_stack.h"
+#include "gdalraster.h"
+#include "parallel_util.h"
+#include "srs_api.h"
+
+namespace {
+
+constexpr double STACK_NAN = std::numeric_limits<double>::quiet_NaN();
+
+// tolerance for comparing geotransforms, as a fraction of the pixel size
+constexpr double STACK_GT_TOL = 0.01;
+
+}  // namespace
+
+RasterStack::RasterStack() {}
+
+RasterStack::RasterStack(const Rcpp::CharacterVector &dsn) {
+    init_(dsn, Rcpp::IntegerVector());
+}
+
+RasterStack::RasterStack(const Rcpp::CharacterVector &dsn,
+                         const Rcpp::IntegerVector &bands) {
+    if (bands.size() == 0)
+        Rcpp::stop("'bands' is empty");
+    init_(dsn, bands);
+}
+
+RasterStack::~RasterStack() {
+    close();
+}
+
+void RasterStack::init_(const Rcpp::CharacterVector &dsn,
+                        const Rcpp::IntegerVector &bands) {
+
+    if (dsn.size() == 0)
+        Rcpp::stop("'dsn' is empty");
+    if (bands.size() > 1 && bands.size() != dsn.size())
+        Rcpp::stop("'bands' must have length 1 or the length of 'dsn'");
+
+    // datasets opened so far are closed before any error
+    auto fail = [this](const std::string &msg) {
+        close();
+        Rcpp::stop(msg);
+    };
+
+    for (R_xlen_t i = 0; i < dsn.size(); ++i) {
+        Member m;
+        m.filename = std::string(dsn[i]);
+        m.hDS = GDALOpenEx(m.filename.c_str(),
+                           GDAL_OF_RASTER | GDAL_OF_READONLY |
+                           GDAL_OF_VERBOSE_ERROR,
+                           nullptr, nullptr, nullptr);
+        if (m.hDS == nullptr)
+            fail("open raster failed: " + m.filename);
+        m_members.push_back(m);
+        Member &mem = m_members.back();
+
+        const int nbands = GDALGetRasterCount(mem.hDS);
+        if (bands.size() == 0) {
+            for (int b = 1; b <= nbands; ++b)
+                mem.bands.push_back(b);
+        } else {
+            const int b = bands.size() == 1 ? bands[0] : bands[i];
+            if (b == NA_INTEGER || b < 1 || b > nbands)
+                fail("band number out of range: " + mem.filename);
+            mem.bands.push_back(b);
+        }
+        if (mem.bands.empty())
+            fail("raster has no bands: " + mem.filename);
+        mem.first_layer = m_num_layers;
+        m_num_layers += mem.bands.size();
+
+        const int xsize = GDALGetRasterXSize(mem.hDS);
+        const int ysize = GDALGetRasterYSize(mem.hDS);
+        double gt[6] = {0, 1, 0, 0, 0, 1};
+        GDALGetGeoTransform(mem.hDS, gt);
+        const char *pszSRS = GDALGetProjectionRef(mem.hDS);
+        const std::string srs = pszSRS ? pszSRS : "";
+
+        if (i == 0) {
+            m_xsize = xsize;
+            m_ysize = ysize;
+            std::copy(gt, gt + 6, m_gt);
+            m_srs = srs;
+            continue;
+        }
+
+        // validate alignment with the first dataset
+        if (xsize != m_xsize || ysize != m_ysize)
+            fail("raster dimensions differ from the first raster: " +
+                 mem.filename);
+        // the origin to within the tolerance, and the pixel size and
+        // rotation terms such that the far corner of the raster moves by no
+        // more than the tolerance (a small difference in pixel size adds up
+        // over the columns or rows)
+        const double tol = STACK_GT_TOL *
+                           std::max(std::fabs(m_gt[1]), std::fabs(m_gt[5]));
+        const double dx = std::fabs(gt[1] - m_gt[1]) * xsize +
+                          std::fabs(gt[2] - m_gt[2]) * ysize;
+        const double dy = std::fabs(gt[4] - m_gt[4]) * xsize +
+                          std::fabs(gt[5] - m_gt[5]) * ysize;
+        if (std::fabs(gt[0] - m_gt[0]) > tol ||
+                std::fabs(gt[3] - m_gt[3]) > tol || dx > tol || dy > tol) {
+            fail("geotransform differs from the first raster: " +
+                 mem.filename);
+        }
+        if (srs != m_srs && (srs == "" || m_srs == "" ||
+                             !srs_is_same(srs, m_srs, "", false, false))) {
+            fail("SRS differs from the first raster: " + mem.filename);
+        }
+    }
+}
+
+bool RasterStack::isOpen() const {
+    return !m_members.empty();
+}
+
+void RasterStack::close() {
+    waitPrefetch_();
+    for (Member &m : m_members) {
+        if (m.hDS != nullptr)
+            GDALClose(m.hDS);
+        m.hDS = nullptr;
+    }
+    m_members.clear();
+    m_num_layers = 0;
+    m_chunks = Rcpp::NumericMatrix();
+    m_next_chunk = 0;
+    m_prefetch_buf.clear();
+    m_prefetch_buf.shrink_to_fit();
+}
+
+void RasterStack::checkOpen_() const {
+    if (!isOpen())
+        Rcpp::stop("the stack is not open");
+}
+
+int RasterStack::getNumLayers() const {
+    return static_cast<int>(m_num_layers);
+}
+
+Rcpp::CharacterVector RasterStack::getFilenames() const {
+    Rcpp::CharacterVector out;
+    for (const Member &m : m_members) {
+        for (std::size_t b = 0; b < m.bands.size(); ++b)
+            out.push_back(m.filename);
+    }
+    return out;
+}
+
+Rcpp::IntegerVector RasterStack::getBands() const {
+    Rcpp::IntegerVector out;
+    for (const Member &m : m_members) {
+        for (int b : m.bands)
+            out.push_back(b);
+    }
+    return out;
+}
+
+double RasterStack::getRasterXSize() const {
+    checkOpen_();
+    return m_xsize;
+}
+
+double RasterStack::getRasterYSize() const {
+    checkOpen_();
+    return m_ysize;
+}
+
+Rcpp::NumericVector RasterStack::getGeoTransform() const {
+    checkOpen_();
+    return Rcpp::NumericVector(m_gt, m_gt + 6);
+}
+
+std::string RasterStack::getProjection() const {
+    checkOpen_();
+    return m_srs;
+}
+
+Rcpp::NumericVector RasterStack::bbox() const {
+    checkOpen_();
+    return bbox_grid_to_geo_(getGeoTransform(), 0.0, m_xsize, 0.0, m_ysize);
+}
+
+Rcpp::NumericVector RasterStack::res() const {
+    checkOpen_();
+    Rcpp::NumericVector ret = {NA_REAL, NA_REAL};
+    if (m_gt[2] == 0.0 && m_gt[4] == 0.0) {
+        ret[0] = m_gt[1];
+        ret[1] = std::fabs(m_gt[5]);
+    }
+    return ret;
+}
+
+Rcpp::NumericVector RasterStack::dim() const {
+    checkOpen_();
+    Rcpp::NumericVector ret = {static_cast<double>(m_xsize),
+                               static_cast<double>(m_ysize),
+                               static_cast<double>(m_num_layers)};
+    return ret;
+}
+
+Rcpp::NumericVector RasterStack::getBlockSize() const {
+    checkOpen_();
+    const Member &m = m_members[0];
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    GDALGetBlockSize(GDALGetRasterBand(m.hDS, m.bands[0]), &nBlockXSize,
+                     &nBlockYSize);
+    Rcpp::NumericVector ret = {static_cast<double>(nBlockXSize),
+                               static_cast<double>(nBlockYSize)};
+    return ret;
+}
+
+Rcpp::NumericMatrix RasterStack::make_chunk_index(
+        const Rcpp::NumericVector &max_pixels) const {
+
+    checkOpen_();
+    const Rcpp::NumericVector blocksize = getBlockSize();
+    return make_chunk_index_(m_xsize, m_ysize,
+                             static_cast<int>(blocksize[0]),
+                             static_cast<int>(blocksize[1]),
+                             getGeoTransform(), max_pixels);
+}
+
+void RasterStack::checkWindow_(int xoff, int yoff, int xsize,
+                               int ysize) const {
+    if (xsize < 1 || ysize < 1)
+        Rcpp::stop("'xsize' and 'ysize' must be > 0");
+    if (xoff < 0 || yoff < 0 || xoff > m_xsize - xsize ||
+            yoff > m_ysize - ysize) {
+        Rcpp::stop("the window is outside the raster extent");
+    }
+}
+
+bool RasterStack::readWindow_(int xoff, int yoff, int xsize, int ysize,
+                              double *buf, std::string *err) const {
+
+    const std::size_t npix = static_cast<std::size_t>(xsize) * ysize;
+    std::vector<std::string> errs(m_members.size());
+
+    // datasets are not thread-safe, so each is read by a single thread
+    const int nthreads = num_threads < 1 ?
+                         static_cast<int>(m_members.size()) : num_threads;
+
+    parallel_for_(m_members.size(), nthreads, [&](std::size_t i) {
+        const Member &m = m_members[i];
+        double *dst = buf + m.first_layer * npix;
+        std::vector<int> band_map(m.bands);
+
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        const CPLErr eErr = GDALDatasetRasterIOEx(
+            m.hDS, GF_Read, xoff, yoff, xsize, ysize, dst, xsize, ysize,
+            GDT_Float64, static_cast<int>(band_map.size()), band_map.data(),
+            sizeof(double), static_cast<GSpacing>(xsize) * sizeof(double),
+            static_cast<GSpacing>(npix) * sizeof(double), nullptr);
+        if (eErr != CE_None) {
+            errs[i] = "read failed: " + m.filename;
+            if (CPLGetLastErrorMsg()[0] != '\0')
+                errs[i] += std::string(" (") + CPLGetLastErrorMsg() + ")";
+        }
+        CPLPopErrorHandler();
+        if (eErr != CE_None)
+            return;
+
+        for (std::size_t b = 0; b < m.bands.size(); ++b) {
+            int has_nodata = FALSE;
+            const double nodata = GDALGetRasterNoDataValue(
+                GDALGetRasterBand(m.hDS, m.bands[b]), &has_nodata);
+            if (!has_nodata || std::isnan(nodata))
+                continue;
+            double *v = dst + b * npix;
+            for (std::size_t k = 0; k < npix; ++k) {
+                if (v[k] == nodata)
+                    v[k] = STACK_NAN;
+            }
+        }
+    });
+
+    for (const std::string &e : errs) {
+        if (!e.empty()) {
+            *err = e;
+            return false;
+        }
+    }
+    return true;
+}
+
+Rcpp::NumericVector RasterStack::readArray_(int xoff, int yoff, int xsize,
+                                            int ysize) {
+    const std::size_t n = static_cast<std::size_t>(xsize) * ysize *
+                          m_num_layers;
+    Rcpp::NumericVector out = Rcpp::no_init(static_cast<R_xlen_t>(n));
+    std::string err;
+    if (!readWindow_(xoff, yoff, xsize, ysize, &out[0], &err))
+        Rcpp::stop(err);
+    for (double &v : out) {
+        if (std::isnan(v))
+            v = NA_REAL;
+    }
+    out.attr("dim") = Rcpp::IntegerVector::create(
+        xsize, ysize, static_cast<int>(m_num_layers));
+    return out;
+}
+
+Rcpp::NumericVector RasterStack::read(int xoff, int yoff, int xsize,
+                                      int ysize) {
+    checkOpen_();
+    waitPrefetch_();
+    checkWindow_(xoff, yoff, xsize, ysize);
+    return readArray_(xoff, yoff, xsize, ysize);
+}
+
+Rcpp::NumericVector RasterStack::readChunk(
+        const Rcpp::IntegerVector &chunk_def) {
+
+    // a row of the matrix returned by make_chunk_index(), or a vector of
+    // xoff, yoff, xsize, ysize (see GDALRaster::readChunk())
+    if (chunk_def.size() == 4)
+        return read(chunk_def[0], chunk_def[1], chunk_def[2], chunk_def[3]);
+    if (chunk_def.size() < 6) {
+        Rcpp::stop("'chunk_def' must have length >= 6 (or 4 "
+                   "with xoff, yoff, xsize, ysize)");
+    }
+    return read(chunk_def[2], chunk_def[3], chunk_def[4], chunk_def[5]);
+}
+
+void RasterStack::startPrefetch_(R_xlen_t chunk) {
+    const int xoff = static_cast<int>(m_chunks(chunk, 2));
+    const int yoff = static_cast<int>(m_chunks(chunk, 3));
+    const int xsize = static_cast<int>(m_chunks(chunk, 4));
+    const int ysize = static_cast<int>(m_chunks(chunk, 5));
+    m_prefetch_buf.resize(static_cast<std::size_t>(xsize) * ysize *
+                          m_num_layers);
+    m_prefetch_ok = false;
+    m_prefetch_err.clear();
+    m_prefetch = std::thread([this, xoff, yoff, xsize, ysize]() {
+        m_prefetch_ok = readWindow_(xoff, yoff, xsize, ysize,
+                                    m_prefetch_buf.data(), &m_prefetch_err);
+    });
+}
+
+void RasterStack::waitPrefetch_() {
+    if (m_prefetch.joinable())
+        m_prefetch.join();
+}
+
+void RasterStack::startIterator(const Rcpp::NumericVector &max_pixels) {
+    checkOpen_();
+    waitPrefetch_();
+    m_chunks = make_chunk_index(max_pixels);
+    m_next_chunk = 0;
+    if (m_chunks.nrow() > 0)
+        startPrefetch_(0);
+}
+
+SEXP RasterStack::nextChunk() {
+    checkOpen_();
+    if (m_next_chunk >= m_chunks.nrow())
+        return R_NilValue;
+
+    waitPrefetch_();
+    if (!m_prefetch_ok) {
+        m_next_chunk = m_chunks.nrow();
+        Rcpp::stop(m_prefetch_err);
+    }
+
+    const R_xlen_t chunk = m_next_chunk;
+    Rcpp::NumericVector data(m_prefetch_buf.begin(), m_prefetch_buf.end());
+    for (double &v : data) {
+        if (std::isnan(v))
+            v = NA_REAL;
+    }
+    data.attr("dim") = Rcpp::IntegerVector::create(
+        static_cast<int>(m_chunks(chunk, 4)),
+        static_cast<int>(m_chunks(chunk, 5)),
+        static_cast<int>(m_num_layers));
+
+    Rcpp::NumericVector chunk_def = m_chunks(chunk, Rcpp::_);
+    chunk_def.names() = Rcpp::colnames(m_chunks);
+
+    // read the next chunk while the caller processes this one
+    ++m_next_chunk;
+    if (m_next_chunk < m_chunks.nrow())
+        startPrefetch_(m_next_chunk);
+
+    return Rcpp::List::create(Rcpp::Named("chunk") = chunk_def,
+                              Rcpp::Named("data") = data);
+}
+
+void RasterStack::show() const {
+    Rcpp::Rcout << "C++ object of class RasterStack\n";
+    if (!isOpen()) {
+        Rcpp::Rcout << " (closed)\n";
+        return;
+    }
+    Rcpp::Rcout << " Number of datasets: " << m_members.size() << "\n";
+    Rcpp::Rcout << " Number of layers: " << m_num_layers << "\n";
+    Rcpp::Rcout << " Dimensions: " << m_xsize << ", " << m_ysize << "\n";
+}
+
+std::size_t RasterStack::numLayers_() const {
+    return m_num_layers;
+}
+
+std::size_t RasterStack::numDatasets_() const {
+    return m_members.size();
+}
+
+GDALDatasetH RasterStack::getDataset_(std::size_t i) const {
+    return m_members[i].hDS;
+}
+
+// ****************************************************************************
+
+RCPP_MODULE(mod_raster_stack) {
+    Rcpp::class_<RasterStack>("RasterStack")
+
+    .constructor
+        ("Default constructor, an empty stack")
+    .constructor<Rcpp::CharacterVector>
+        ("Usage: new(RasterStack, dsn)")
+    .constructor<Rcpp::CharacterVector, Rcpp::IntegerVector>
+        ("Usage: new(RasterStack, dsn, bands)")
+
+    // exposed read/write fields
+    .field("num_threads", &RasterStack::num_threads)
+
+    // exposed member functions
+    .const_method("isOpen", &RasterStack::isOpen,
+        "Return TRUE if the stack is open")
+    .method("close", &RasterStack::close,
+        "Close all the datasets of the stack")
+    .const_method("getNumLayers", &RasterStack::getNumLayers,
+        "Return the number of layers")
+    .const_method("getFilenames", &RasterStack::getFilenames,
+        "Return the file name of each layer")
+    .const_method("getBands", &RasterStack::getBands,
+        "Return the band number of each layer")
+    .const_method("getRasterXSize", &RasterStack::getRasterXSize,
+        "Return the raster width in pixels")
+    .const_method("getRasterYSize", &RasterStack::getRasterYSize,
+        "Return the raster height in pixels")
+    .const_method("getGeoTransform", &RasterStack::getGeoTransform,
+        "Return the affine transformation coefficients")
+    .const_method("getProjection", &RasterStack::getProjection,
+        "Return the coordinate reference system as OGC WKT")
+    .const_method("bbox", &RasterStack::bbox,
+        "Return the bounding box (xmin, ymin, xmax, ymax)")
+    .const_method("res", &RasterStack::res,
+        "Return the resolution (pixel width, pixel height)")
+    .const_method("dim", &RasterStack::dim,
+        "Return raster dimensions (xsize, ysize, number of layers)")
+    .const_method("getBlockSize", &RasterStack::getBlockSize,
+        "Return the block size of the first layer")
+    .const_method("make_chunk_index", &RasterStack::make_chunk_index,
+        "Return a matrix of chunk offsets, sizes and extents")
+    .method("read", &RasterStack::read,
+        "Read a window of all layers into a 3-D array")
+    .method("readChunk", &RasterStack::readChunk,
+        "Read a chunk of all layers into a 3-D array")
+    .method("startIterator", &RasterStack::startIterator,
+        "Start iterating over chunks of at most max_pixels")
+    .method("nextChunk", &RasterStack::nextChunk,
+        "Return the next chunk of the iterator, or NULL when done")
+    .const_method("show", &RasterStack::show,
+        "S4 show()")
+    ;
+}
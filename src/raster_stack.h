@@ -0,0 +1,105 @@
+/* class RasterStack
+   A stack of aligned raster layers (bands of one or more datasets with the
+   same geotransform, raster size and SRS). A window is read from all the
+   layers into one contiguous buffer, concurrently with one I/O thread per
+   dataset, and a chunk iterator prefetches the next chunk in the background.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef RASTER_STACK_H_
+#define RASTER_STACK_H_
+
+#include <Rcpp.h>
+
+#include <gdal.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+class RasterStack {
+ public:
+    RasterStack();
+    explicit RasterStack(const Rcpp::CharacterVector &dsn);
+    RasterStack(const Rcpp::CharacterVector &dsn,
+                const Rcpp::IntegerVector &bands);
+    ~RasterStack();
+
+    // read/write fields exposed to R
+    int num_threads {0};
+
+    // methods exported to R
+    bool isOpen() const;
+    void close();
+
+    int getNumLayers() const;
+    Rcpp::CharacterVector getFilenames() const;
+    Rcpp::IntegerVector getBands() const;
+    double getRasterXSize() const;
+    double getRasterYSize() const;
+    Rcpp::NumericVector getGeoTransform() const;
+    std::string getProjection() const;
+    Rcpp::NumericVector bbox() const;
+    Rcpp::NumericVector res() const;
+    Rcpp::NumericVector dim() const;
+    Rcpp::NumericVector getBlockSize() const;
+    Rcpp::NumericMatrix make_chunk_index(
+        const Rcpp::NumericVector &max_pixels) const;
+
+    Rcpp::NumericVector read(int xoff, int yoff, int xsize, int ysize);
+    Rcpp::NumericVector readChunk(const Rcpp::IntegerVector &chunk_def);
+
+    void startIterator(const Rcpp::NumericVector &max_pixels);
+    SEXP nextChunk();
+
+    void show() const;
+
+    // internal
+    std::size_t numLayers_() const;
+    std::size_t numDatasets_() const;
+    GDALDatasetH getDataset_(std::size_t i) const;
+    // read a window of all the layers into buf, layer by layer with each
+    // layer in row-major order, NaN for nodata, concurrently with one thread
+    // per dataset (up to num_threads), does not call the R API
+    // returns false and sets err on failure
+    bool readWindow_(int xoff, int yoff, int xsize, int ysize, double *buf,
+                     std::string *err) const;
+
+ private:
+    struct Member {
+        std::string filename;
+        GDALDatasetH hDS {nullptr};
+        std::vector<int> bands {};
+        std::size_t first_layer {0};
+    };
+
+    std::vector<Member> m_members {};
+    std::size_t m_num_layers {0};
+    int m_xsize {0};
+    int m_ysize {0};
+    double m_gt[6] {0, 1, 0, 0, 0, 1};
+    std::string m_srs {};
+
+    // chunk iterator with a background read of the next chunk
+    Rcpp::NumericMatrix m_chunks {};
+    R_xlen_t m_next_chunk {0};
+    std::thread m_prefetch {};
+    std::vector<double> m_prefetch_buf {};
+    bool m_prefetch_ok {false};
+    std::string m_prefetch_err {};
+
+    void init_(const Rcpp::CharacterVector &dsn,
+               const Rcpp::IntegerVector &bands);
+    void checkOpen_() const;
+    void checkWindow_(int xoff, int yoff, int xsize, int ysize) const;
+    void startPrefetch_(R_xlen_t chunk);
+    void waitPrefetch_();
+    Rcpp::NumericVector readArray_(int xoff, int yoff, int xsize, int ysize);
+};
+
+// cppcheck-suppress unknownMacro
+RCPP_EXPOSED_CLASS(RasterStack)
+
+#endif  // RASTER_STACK_H_
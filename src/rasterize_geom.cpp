@@ -0,0 +1,371 @@
+/* In-memory rasterization of geometries
+
+   The output grid is processed in strips of full rows. For each strip, the
+   geometries whose envelopes intersect the strip are selected with an STR
+   tree and burned with GDALRasterizeGeometries() into a MEM dataset that
+   wraps the strip buffer (no copy). Strips are independent, so they are
+   burned on worker threads. For an array output the strips are slices of the
+   returned vector. For an open GDALRaster, strips containing geometries are
+   read and written back on the main thread in batches, and strips with no
+   geometries are not touched.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_conv.h>
+#include <cpl_port.h>
+#include <cpl_string.h>
+#include <gdal.h>
+#include <gdal_alg.h>
+#include <ogr_api.h>
+
+#include <Rcpp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rasterize_geom.h"
+#include "gdalraster.h"
+#include "gdalvector.h"
+#include "spatial_index.h"
+#include "strtree.h"
+#include "tile_util.h"
+
+// upper limit on the number of pixels in a strip
+constexpr std::size_t RASTERIZE_STRIP_MAX_PIXELS = 1024 * 1024;
+
+namespace {
+
+// geometries with their burn values, indexed by envelope
+struct BurnSet {
+    std::vector<OGRGeometryH> geoms {};
+    std::vector<double> burn {};
+    STRtree tree;
+
+    ~BurnSet() {
+        destroyGeoms_(&geoms);
+    }
+};
+
+// a strip of rows of the output grid
+struct Strip {
+    int yoff;
+    int ysize;
+    std::vector<std::size_t> items {};  // geometries to burn, in input order
+};
+
+void readLayerBurn_(OGRLayerH hLayer, const std::string &burn_attr,
+                    double burn_value, BurnSet *bs) {
+
+    int iField = -1;
+    if (burn_attr != "") {
+        iField = OGR_FD_GetFieldIndex(OGR_L_GetLayerDefn(hLayer),
+                                      burn_attr.c_str());
+        if (iField < 0)
+            Rcpp::stop("'burn_attr' field not found: " + burn_attr);
+    }
+
+    OGR_L_ResetReading(hLayer);
+    OGRFeatureH hFeat = nullptr;
+    while ((hFeat = OGR_L_GetNextFeature(hLayer)) != nullptr) {
+        if (iField >= 0 && !OGR_F_IsFieldSetAndNotNull(hFeat, iField)) {
+            OGR_F_Destroy(hFeat);
+            continue;
+        }
+        bs->geoms.push_back(OGR_F_StealGeometry(hFeat));
+        if (iField >= 0)
+            bs->burn.push_back(OGR_F_GetFieldAsDouble(hFeat, iField));
+        else
+            bs->burn.push_back(burn_value);
+        OGR_F_Destroy(hFeat);
+    }
+    OGR_L_ResetReading(hLayer);
+}
+
+void loadBurnSet_(const Rcpp::RObject &geom,
+                  const Rcpp::NumericVector &burn_value,
+                  const std::string &burn_attr, bool quiet, BurnSet *bs) {
+
+    if (burn_value.size() == 0)
+        Rcpp::stop("'burn_value' is empty");
+
+    bool is_layer = false;
+    if (geom.isObject()) {
+        const Rcpp::String cls = geom.attr("class");
+        if (cls != "Rcpp_GDALVector")
+            Rcpp::stop("'geom' is an object of unsupported class");
+        is_layer = true;
+    }
+
+    if (is_layer) {
+        GDALVector &lyr = Rcpp::as<GDALVector &>(geom);
+        if (!lyr.isOpen())
+            Rcpp::stop("the GDALVector object for 'geom' is not open");
+        if (burn_attr == "" && burn_value.size() != 1)
+            Rcpp::stop("'burn_value' must be a single value for a layer");
+        readLayerBurn_(lyr.getOGRLayerH_(), burn_attr, burn_value[0], bs);
+    }
+    else {
+        if (burn_attr != "")
+            Rcpp::stop("'burn_attr' requires a GDALVector object for 'geom'");
+        bs->geoms = geomsFromRObject_(geom, quiet);
+        const std::size_t n = bs->geoms.size();
+        if (burn_value.size() != 1 &&
+                static_cast<std::size_t>(burn_value.size()) != n) {
+            Rcpp::stop("'burn_value' must be length 1 or the number of "
+                       "geometries");
+        }
+        bs->burn.resize(n);
+        for (std::size_t i = 0; i < n; ++i)
+            bs->burn[i] = burn_value[burn_value.size() == 1 ? 0 : i];
+    }
+
+    for (std::size_t i = 0; i < bs->geoms.size(); ++i) {
+        const STRBox box = geomBox_(bs->geoms[i]);
+        if (!box.isNull())
+            bs->tree.insert(box, i);
+    }
+    bs->tree.build();
+}
+
+// strips of rows, with the geometries to burn in each (strips with no
+// geometries are left out), rows per strip are a multiple of block_ysize
+std::vector<Strip> makeStrips_(const BurnSet &bs, const double *gt,
+                               int xsize, int ysize, int block_ysize,
+                               int num_threads) {
+
+    const int nthreads = resolve_num_threads_(num_threads,
+                                              static_cast<std::size_t>(ysize));
+    std::size_t rows = std::max<std::size_t>(
+        1, RASTERIZE_STRIP_MAX_PIXELS / static_cast<std::size_t>(xsize));
+    // several strips per thread for load balance
+    const int target = 4 * nthreads;
+    rows = std::min<std::size_t>(rows, (ysize + target - 1) / target);
+    if (block_ysize > 1) {
+        rows = std::max<std::size_t>(block_ysize,
+                                     rows / block_ysize * block_ysize);
+    }
+    rows = std::max<std::size_t>(rows, 1);
+
+    // pad the strip extent by one pixel for ALL_TOUCHED and rounding
+    const double pad = std::max(std::fabs(gt[1]) + std::fabs(gt[2]),
+                                std::fabs(gt[4]) + std::fabs(gt[5]));
+
+    std::vector<Strip> strips;
+    for (int yoff = 0; yoff < ysize; yoff += static_cast<int>(rows)) {
+        Strip s;
+        s.yoff = yoff;
+        s.ysize = std::min(static_cast<int>(rows), ysize - yoff);
+
+        STRBox box;
+        const double px[2] = {0.0, static_cast<double>(xsize)};
+        const double py[2] = {static_cast<double>(yoff),
+                              static_cast<double>(yoff + s.ysize)};
+        for (double x : px) {
+            for (double y : py) {
+                const double gx = gt[0] + gt[1] * x + gt[2] * y;
+                const double gy = gt[3] + gt[4] * x + gt[5] * y;
+                box.expand(STRBox(gx, gy, gx, gy));
+            }
+        }
+        box = STRBox(box.xmin - pad, box.ymin - pad, box.xmax + pad,
+                     box.ymax + pad);
+
+        bs.tree.query(box, &s.items);
+        if (s.items.empty())
+            continue;
+        // burn order is input order (matters for replace)
+        std::sort(s.items.begin(), s.items.end());
+        strips.push_back(std::move(s));
+    }
+    return strips;
+}
+
+// burn the geometries of a strip into buf (Float64, xsize * strip.ysize),
+// runs on worker threads and does not call the R API
+bool burnStrip_(const BurnSet &bs, const Strip &strip, const double *gt,
+                int xsize, double *buf, char **papszOptions) {
+
+    GDALDriverH hDriver = GDALGetDriverByName("MEM");
+    if (hDriver == nullptr)
+        return false;
+    GDALDatasetH hDS = GDALCreate(hDriver, "", xsize, strip.ysize, 0,
+                                  GDT_Float64, nullptr);
+    if (hDS == nullptr)
+        return false;
+
+    if (!addMemBand_(hDS, GDT_Float64, buf)) {
+        GDALClose(hDS);
+        return false;
+    }
+
+    double strip_gt[6] = {gt[0] + strip.yoff * gt[2], gt[1], gt[2],
+                          gt[3] + strip.yoff * gt[5], gt[4], gt[5]};
+    GDALSetGeoTransform(hDS, strip_gt);
+
+    std::vector<OGRGeometryH> geoms;
+    std::vector<double> burn;
+    geoms.reserve(strip.items.size());
+    burn.reserve(strip.items.size());
+    for (std::size_t i : strip.items) {
+        geoms.push_back(bs.geoms[i]);
+        burn.push_back(bs.burn[i]);
+    }
+
+    int band = 1;
+    const CPLErr err = GDALRasterizeGeometries(
+        hDS, 1, &band, static_cast<int>(geoms.size()), geoms.data(),
+        nullptr, nullptr, burn.data(), papszOptions, nullptr, nullptr);
+
+    GDALClose(hDS);
+    return err == CE_None;
+}
+
+char **rasterizeOptions_(bool all_touched, bool add) {
+    char **papszOptions = nullptr;
+    if (all_touched)
+        papszOptions = CSLSetNameValue(papszOptions, "ALL_TOUCHED", "TRUE");
+    if (add)
+        papszOptions = CSLSetNameValue(papszOptions, "MERGE_ALG", "ADD");
+    return papszOptions;
+}
+
+}  // namespace
+
+//' Burn geometries into a band of an open raster, in strips of rows
+//' geom is WKB/WKT or a GDALVector object, burn_attr is a field name of the
+//' layer or ""
+//' @noRd
+// [[Rcpp::export(name = ".rasterize_geom_ds")]]
+bool rasterize_geom_ds(const Rcpp::RObject &geom,
+                       const Rcpp::NumericVector &burn_value,
+                       const std::string &burn_attr,
+                       const GDALRaster* const &dst_ds, int band,
+                       bool all_touched, bool add, int num_threads,
+                       bool quiet) {
+
+    dst_ds->checkAccess_(GA_Update);
+    GDALRasterBandH hBand = dst_ds->getBand_(band);
+
+    const Rcpp::NumericVector gt_r = dst_ds->getGeoTransform();
+    const std::vector<double> gt(gt_r.begin(), gt_r.end());
+    const int xsize = static_cast<int>(dst_ds->getRasterXSize());
+    const int ysize = static_cast<int>(dst_ds->getRasterYSize());
+    int block_xsize = 0;
+    int block_ysize = 0;
+    GDALGetBlockSize(hBand, &block_xsize, &block_ysize);
+
+    BurnSet bs;
+    loadBurnSet_(geom, burn_value, burn_attr, quiet, &bs);
+    const std::vector<Strip> strips = makeStrips_(bs, gt.data(), xsize,
+                                                  ysize, block_ysize,
+                                                  num_threads);
+
+    char **papszOptions = rasterizeOptions_(all_touched, add);
+
+    const std::size_t batch_size = batchSize_(num_threads, strips.size());
+    std::vector<std::vector<double>> bufs(batch_size);
+    std::vector<char> ok(batch_size, 0);
+
+    GDALProgressFunc pfnProgress = GDALTermProgressR;
+    if (!quiet)
+        pfnProgress(0, nullptr, nullptr);
+
+    try {
+        forTileBatches_(strips.size(), num_threads,
+            [&](std::size_t j, std::size_t i) {
+                const Strip &s = strips[i];
+                bufs[j].resize(static_cast<std::size_t>(xsize) * s.ysize);
+                if (GDALRasterIO(hBand, GF_Read, 0, s.yoff, xsize, s.ysize,
+                                 bufs[j].data(), xsize, s.ysize, GDT_Float64,
+                                 0, 0) != CE_None) {
+                    Rcpp::stop("failed to read raster strip");
+                }
+            },
+            [&](std::size_t j, std::size_t i) {
+                ok[j] = burnStrip_(bs, strips[i], gt.data(), xsize,
+                                   bufs[j].data(), papszOptions) ? 1 : 0;
+            },
+            [&](std::size_t j, std::size_t i) {
+                const Strip &s = strips[i];
+                if (!ok[j])
+                    Rcpp::stop("GDALRasterizeGeometries() failed");
+                if (GDALRasterIO(hBand, GF_Write, 0, s.yoff, xsize, s.ysize,
+                                 bufs[j].data(), xsize, s.ysize, GDT_Float64,
+                                 0, 0) != CE_None) {
+                    Rcpp::stop("failed to write raster strip");
+                }
+                if (!quiet) {
+                    pfnProgress(static_cast<double>(i + 1) / strips.size(),
+                                nullptr, nullptr);
+                }
+            });
+    }
+    catch (...) {
+        CSLDestroy(papszOptions);
+        throw;
+    }
+    if (!quiet && strips.empty())
+        pfnProgress(1.0, nullptr, nullptr);
+
+    CSLDestroy(papszOptions);
+    return true;
+}
+
+//' Burn geometries into a new grid returned as a numeric vector of pixel
+//' values in left to right, top to bottom order
+//' @noRd
+// [[Rcpp::export(name = ".rasterize_geom_grid")]]
+Rcpp::NumericVector rasterize_geom_grid(const Rcpp::RObject &geom,
+                                        const Rcpp::NumericVector &burn_value,
+                                        const std::string &burn_attr,
+                                        const Rcpp::NumericVector &gt,
+                                        int xsize, int ysize, double init,
+                                        bool all_touched, bool add,
+                                        int num_threads, bool quiet) {
+
+    if (gt.size() != 6)
+        Rcpp::stop("'gt' must be a numeric vector of length 6");
+    if (xsize < 1 || ysize < 1)
+        Rcpp::stop("invalid raster dimensions");
+
+    const std::vector<double> gt_in(gt.begin(), gt.end());
+
+    BurnSet bs;
+    loadBurnSet_(geom, burn_value, burn_attr, quiet, &bs);
+    const std::vector<Strip> strips = makeStrips_(bs, gt_in.data(), xsize,
+                                                  ysize, 1, num_threads);
+
+    Rcpp::NumericVector out = Rcpp::no_init(
+        static_cast<R_xlen_t>(xsize) * ysize);
+    std::fill(out.begin(), out.end(), init);
+    double *out_data = out.begin();
+
+    char **papszOptions = rasterizeOptions_(all_touched, add);
+
+    if (!quiet)
+        GDALTermProgressR(0, nullptr, nullptr);
+
+    // strips are disjoint slices of the output vector
+    std::vector<char> ok(strips.size(), 0);
+    parallel_for_(strips.size(), num_threads, [&](std::size_t j) {
+        const Strip &s = strips[j];
+        double *buf = out_data + static_cast<std::size_t>(s.yoff) * xsize;
+        ok[j] = burnStrip_(bs, s, gt_in.data(), xsize, buf,
+                           papszOptions) ? 1 : 0;
+    });
+
+    CSLDestroy(papszOptions);
+    if (std::find(ok.begin(), ok.end(), 0) != ok.end())
+        Rcpp::stop("GDALRasterizeGeometries() failed");
+
+    if (!quiet)
+        GDALTermProgressR(1.0, nullptr, nullptr);
+
+    return out;
+}
@@ -0,0 +1,32 @@
+/* In-memory rasterization of geometries given as WKB/WKT or a GDALVector
+   layer, into an open GDALRaster or a returned array, processed in strips
+   of rows on multiple threads.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef RASTERIZE_GEOM_H_
+#define RASTERIZE_GEOM_H_
+
+#include <Rcpp.h>
+
+#include <string>
+
+class GDALRaster;
+bool rasterize_geom_ds(const Rcpp::RObject &geom,
+                       const Rcpp::NumericVector &burn_value,
+                       const std::string &burn_attr,
+                       const GDALRaster* const &dst_ds, int band,
+                       bool all_touched, bool add, int num_threads,
+                       bool quiet);
+
+Rcpp::NumericVector rasterize_geom_grid(const Rcpp::RObject &geom,
+                                        const Rcpp::NumericVector &burn_value,
+                                        const std::string &burn_attr,
+                                        const Rcpp::NumericVector &gt,
+                                        int xsize, int ysize, double init,
+                                        bool all_touched, bool add,
+                                        int num_threads, bool quiet);
+
+#endif  // RASTERIZE_GEOM_H_
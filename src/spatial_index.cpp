@@ -0,0 +1,830 @@
+/* Implementation of class SpatialIndex
+   In-memory spatial index over a set of geometries, backed by STRtree.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_port.h>
+#include <cpl_error.h>
+#include <gdal.h>
+#include <ogr_api.h>
+
+#include <Rcpp.h>
+#include <RcppInt64>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "spatial_index.h"
+#include "gdalraster.h"
+#include "gdalvector.h"
+#include "geom_api.h"
+#include "parallel_util.h"
+#include "rcpp_util.h"
+#include "transform_cache.h"
+
+namespace {
+typedef int (*PredicateFn)(OGRGeometryH, OGRGeometryH);
+
+// predicate(query_geom, tree_geom), nullptr for "bbox"
+PredicateFn getPredicateFn_(const std::string &predicate) {
+    if (EQUAL(predicate.c_str(), "bbox"))
+        return nullptr;
+    else if (EQUAL(predicate.c_str(), "intersects"))
+        return OGR_G_Intersects;
+    else if (EQUAL(predicate.c_str(), "contains"))
+        return OGR_G_Contains;
+    else if (EQUAL(predicate.c_str(), "within"))
+        return OGR_G_Within;
+    else if (EQUAL(predicate.c_str(), "touches"))
+        return OGR_G_Touches;
+    else if (EQUAL(predicate.c_str(), "crosses"))
+        return OGR_G_Crosses;
+    else if (EQUAL(predicate.c_str(), "overlaps"))
+        return OGR_G_Overlaps;
+    else
+        Rcpp::stop("invalid 'predicate'");
+}
+
+// Great-circle distance between geometries in longitude/latitude degrees,
+// with edges taken as great-circle arcs on the sphere. Vertices are held as
+// unit vectors.
+constexpr double PI_ = 3.14159265358979323846;
+constexpr double DEG2RAD_ = PI_ / 180.0;
+
+struct SphereGeom {
+    std::vector<double> xyz {};  // 3 per vertex
+    std::vector<char> joined {};  // vertex i has an edge to vertex i + 1
+};
+
+void addSphereVertices_(OGRGeometryH hGeom, SphereGeom *sg) {
+    const int num_parts = OGR_G_GetGeometryCount(hGeom);
+    if (num_parts > 0) {
+        // rings of a polygon, or parts of a collection
+        for (int i = 0; i < num_parts; ++i)
+            addSphereVertices_(OGR_G_GetGeometryRef(hGeom, i), sg);
+        return;
+    }
+
+    const int n = OGR_G_GetPointCount(hGeom);
+    if (n < 1)
+        return;
+    std::vector<double> x(n), y(n);
+    OGR_G_GetPoints(hGeom, x.data(), sizeof(double), y.data(),
+                    sizeof(double), nullptr, 0);
+    for (int i = 0; i < n; ++i) {
+        const double lon = x[i] * DEG2RAD_;
+        const double lat = y[i] * DEG2RAD_;
+        sg->xyz.push_back(std::cos(lat) * std::cos(lon));
+        sg->xyz.push_back(std::cos(lat) * std::sin(lon));
+        sg->xyz.push_back(std::sin(lat));
+        sg->joined.push_back(i + 1 < n ? 1 : 0);
+    }
+}
+
+void sphereGeom_(OGRGeometryH hGeom, SphereGeom *sg) {
+    if (OGR_G_HasCurveGeometry(hGeom, TRUE)) {
+        OGRGeometryH hLinear = OGR_G_GetLinearGeometry(hGeom, 0, nullptr);
+        if (hLinear != nullptr) {
+            addSphereVertices_(hLinear, sg);
+            OGR_G_DestroyGeometry(hLinear);
+            return;
+        }
+    }
+    addSphereVertices_(hGeom, sg);
+}
+
+inline double dot3_(const double *u, const double *v) {
+    return u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+}
+
+inline void cross3_(const double *u, const double *v, double *out) {
+    out[0] = u[1] * v[2] - u[2] * v[1];
+    out[1] = u[2] * v[0] - u[0] * v[2];
+    out[2] = u[0] * v[1] - u[1] * v[0];
+}
+
+// angle between two unit vectors, accurate for small angles
+double angle3_(const double *u, const double *v) {
+    double c[3];
+    cross3_(u, v, c);
+    return std::atan2(std::sqrt(dot3_(c, c)), dot3_(u, v));
+}
+
+// angle from p to the great-circle arc a-b (shorter arc)
+double pointArcAngle_(const double *p, const double *a, const double *b) {
+    double n[3];
+    cross3_(a, b, n);
+    const double len = std::sqrt(dot3_(n, n));
+    if (len < 1e-15)
+        return std::min(angle3_(p, a), angle3_(p, b));
+    for (double &v : n)
+        v /= len;
+
+    // the projection of p onto the plane of the great circle lies within
+    // the arc if it is between a and b
+    const double pn = dot3_(p, n);
+    const double c[3] = {p[0] - pn * n[0], p[1] - pn * n[1],
+                         p[2] - pn * n[2]};
+    double ac[3], cb[3];
+    cross3_(a, c, ac);
+    cross3_(c, b, cb);
+    if (dot3_(ac, n) >= 0 && dot3_(cb, n) >= 0)
+        return std::asin(std::min(1.0, std::fabs(pn)));
+
+    return std::min(angle3_(p, a), angle3_(p, b));
+}
+
+// minimum angle between two geometries that do not intersect, which is
+// attained at a vertex of one of them
+double sphereAngle_(const SphereGeom &a, const SphereGeom &b) {
+    double best = PI_;
+    auto scan = [&best](const SphereGeom &from, const SphereGeom &to) {
+        for (std::size_t i = 0; i < from.joined.size(); ++i) {
+            const double *p = &from.xyz[3 * i];
+            for (std::size_t j = 0; j < to.joined.size(); ++j) {
+                const double *v = &to.xyz[3 * j];
+                double d = 0;
+                if (to.joined[j])
+                    d = pointArcAngle_(p, v, v + 3);
+                else if (j == 0 || !to.joined[j - 1])
+                    d = angle3_(p, v);  // a lone point
+                else
+                    continue;
+                if (d < best)
+                    best = d;
+            }
+        }
+    };
+    scan(a, b);
+    scan(b, a);
+    return best;
+}
+
+// Lower bound on the angle between any points of two lon/lat boxes, from
+// cos(d) = cos(lat1 - lat2) - (1 - cos(dlon)) cos(lat1) cos(lat2)
+// using the smallest latitude and longitude gaps (the latter possibly across
+// the antimeridian) and the largest absolute latitudes.
+double sphereBoxAngle_(const STRBox &a, const STRBox &b) {
+    const double dlat = std::max(0.0, std::max(a.ymin - b.ymax,
+                                               b.ymin - a.ymax));
+    double dlon = std::max(0.0, std::max(a.xmin - b.xmax, b.xmin - a.xmax));
+    const double span = std::max(a.xmax, b.xmax) - std::min(a.xmin, b.xmin);
+    dlon = std::min(dlon, std::max(0.0, 360.0 - span));
+    dlon = std::min(dlon, 180.0);
+
+    const double lat_a = std::min(90.0, std::max(std::fabs(a.ymin),
+                                                 std::fabs(a.ymax)));
+    const double lat_b = std::min(90.0, std::max(std::fabs(b.ymin),
+                                                 std::fabs(b.ymax)));
+
+    double c = std::cos(dlat * DEG2RAD_) -
+               (1.0 - std::cos(dlon * DEG2RAD_)) *
+               std::cos(lat_a * DEG2RAD_) * std::cos(lat_b * DEG2RAD_);
+    c = std::min(1.0, std::max(-1.0, c));
+    // kept slightly below the exact value for points, against rounding
+    return std::acos(c) * (1.0 - 1e-9);
+}
+}  // namespace
+
+std::vector<OGRGeometryH> geomsFromRObject_(const Rcpp::RObject &geom,
+                                            bool quiet) {
+
+    std::vector<OGRGeometryH> geoms;
+    std::size_t num_failed = 0;
+
+    if (geom.isNULL())
+        return geoms;
+
+    if (Rcpp::is<Rcpp::CharacterVector>(geom)) {
+        const Rcpp::CharacterVector wkt(geom);
+        geoms.resize(wkt.size(), nullptr);
+        for (R_xlen_t i = 0; i < wkt.size(); ++i) {
+            if (Rcpp::CharacterVector::is_na(wkt[i]))
+                continue;
+            const std::string wkt_in(wkt[i]);
+            if (wkt_in.empty())
+                continue;
+            char *pszWKT = const_cast<char *>(wkt_in.c_str());
+            OGRGeometryH hGeom = nullptr;
+            if (OGR_G_CreateFromWkt(&pszWKT, nullptr, &hGeom) !=
+                    OGRERR_NONE) {
+                if (hGeom != nullptr)
+                    OGR_G_DestroyGeometry(hGeom);
+                hGeom = nullptr;
+                num_failed += 1;
+            }
+            geoms[i] = hGeom;
+        }
+    }
+    else {
+        const std::vector<WkbRef> refs = wkbRefsFromRObject_(geom);
+        geoms.resize(refs.size(), nullptr);
+        for (std::size_t i = 0; i < refs.size(); ++i) {
+            if (refs[i].data == nullptr)
+                continue;
+            geoms[i] = createGeomFromWkbRef_(refs[i]);
+            if (geoms[i] == nullptr)
+                num_failed += 1;
+        }
+    }
+
+    if (num_failed > 0 && !quiet) {
+        Rcpp::warning("failed to create geometry object for " +
+                      std::to_string(num_failed) + " input element(s)");
+    }
+
+    return geoms;
+}
+
+void destroyGeoms_(std::vector<OGRGeometryH> *geoms) {
+    for (OGRGeometryH &hGeom : *geoms) {
+        if (hGeom != nullptr)
+            OGR_G_DestroyGeometry(hGeom);
+        hGeom = nullptr;
+    }
+}
+
+void readLayerGeoms_(OGRLayerH hLayer, std::vector<OGRGeometryH> *geoms,
+                     std::vector<int64_t> *fids) {
+
+    OGR_L_ResetReading(hLayer);
+    OGRFeatureH hFeat = nullptr;
+    while ((hFeat = OGR_L_GetNextFeature(hLayer)) != nullptr) {
+        fids->push_back(static_cast<int64_t>(OGR_F_GetFID(hFeat)));
+        geoms->push_back(OGR_F_StealGeometry(hFeat));
+        OGR_F_Destroy(hFeat);
+    }
+    OGR_L_ResetReading(hLayer);
+}
+
+STRBox geomBox_(OGRGeometryH hGeom) {
+    if (hGeom == nullptr || OGR_G_IsEmpty(hGeom))
+        return STRBox();
+
+    OGREnvelope env;
+    OGR_G_GetEnvelope(hGeom, &env);
+    return STRBox(env.MinX, env.MinY, env.MaxX, env.MaxY);
+}
+
+SpatialIndex::SpatialIndex()
+        : m_tree() {}
+
+SpatialIndex::SpatialIndex(const Rcpp::RObject &geom)
+        : m_tree() {
+
+    init_(geom);
+}
+
+SpatialIndex::SpatialIndex(const Rcpp::RObject &geom, int node_capacity)
+        : m_tree(node_capacity < 2 ? 2 : node_capacity) {
+
+    if (node_capacity < 2)
+        Rcpp::stop("'node_capacity' must be >= 2");
+
+    init_(geom);
+}
+
+SpatialIndex::~SpatialIndex() {
+    destroyGeoms_(&m_geoms);
+}
+
+void SpatialIndex::init_(const Rcpp::RObject &geom) {
+    bool is_layer = false;
+    if (geom.isObject()) {
+        const Rcpp::String cls = geom.attr("class");
+        if (cls == "Rcpp_GDALVector")
+            is_layer = true;
+        else
+            Rcpp::stop("'geom' is an object of unsupported class");
+    }
+
+    if (is_layer) {
+        GDALVector &lyr = Rcpp::as<GDALVector &>(geom);
+        if (!lyr.isOpen())
+            Rcpp::stop("the GDALVector object is not open");
+
+        initFromLayer_(lyr.getOGRLayerH_());
+    }
+    else {
+        m_geoms = geomsFromRObject_(geom, quiet);
+        buildTree_();
+    }
+}
+
+void SpatialIndex::initFromLayer_(OGRLayerH hLayer) {
+    if (m_tree.isBuilt())
+        Rcpp::stop("the spatial index has already been built");
+
+    readLayerGeoms_(hLayer, &m_geoms, &m_fids);
+    buildTree_();
+}
+
+void SpatialIndex::buildTree_() {
+    m_boxes.resize(m_geoms.size());
+    for (std::size_t i = 0; i < m_geoms.size(); ++i) {
+        m_boxes[i] = geomBox_(m_geoms[i]);
+        if (!m_boxes[i].isNull()) {
+            m_tree.insert(m_boxes[i], i);
+            m_num_indexed += 1;
+        }
+    }
+    m_tree.build();
+}
+
+double SpatialIndex::size() const {
+    return static_cast<double>(m_geoms.size());
+}
+
+double SpatialIndex::numIndexed() const {
+    return static_cast<double>(m_num_indexed);
+}
+
+Rcpp::NumericVector SpatialIndex::bbox() const {
+    const STRBox box = m_tree.bounds();
+    if (box.isNull()) {
+        return Rcpp::NumericVector::create(NA_REAL, NA_REAL, NA_REAL,
+                                           NA_REAL);
+    }
+    return Rcpp::NumericVector::create(box.xmin, box.ymin, box.xmax,
+                                       box.ymax);
+}
+
+SEXP SpatialIndex::getFID() const {
+    if (m_fids.empty())
+        return R_NilValue;
+    else
+        return Rcpp::wrap(m_fids);
+}
+
+Rcpp::IntegerVector SpatialIndex::queryBBox(
+        const Rcpp::NumericVector &bbox) const {
+
+    if (bbox.size() != 4)
+        Rcpp::stop("'bbox' must be a numeric vector of length 4");
+    if (Rcpp::is_true(Rcpp::any(Rcpp::is_na(bbox))))
+        Rcpp::stop("'bbox' cannot contain missing values");
+
+    std::vector<std::size_t> hits;
+    m_tree.query(STRBox(bbox[0], bbox[1], bbox[2], bbox[3]), &hits);
+    std::sort(hits.begin(), hits.end());
+
+    Rcpp::IntegerVector out(hits.size());
+    for (std::size_t i = 0; i < hits.size(); ++i)
+        out[i] = static_cast<int>(hits[i]) + 1;
+
+    return out;
+}
+
+Rcpp::IntegerMatrix SpatialIndex::query(const Rcpp::RObject &geom,
+                                        const std::string &predicate,
+                                        int num_threads) const {
+
+    std::vector<OGRGeometryH> qgeoms = geomsFromRObject_(geom, quiet);
+    std::vector<std::vector<std::size_t>> results;
+
+    try {
+        queryGeoms_(qgeoms, predicate, num_threads, &results);
+    }
+    catch (const std::exception &e) {
+        destroyGeoms_(&qgeoms);
+        Rcpp::stop(e.what());
+    }
+    destroyGeoms_(&qgeoms);
+
+    std::size_t num_out = 0;
+    for (const auto &r : results)
+        num_out += r.size();
+
+    Rcpp::IntegerMatrix out(num_out, 2);
+    std::size_t row = 0;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        for (std::size_t j : results[i]) {
+            out(row, 0) = static_cast<int>(i) + 1;
+            out(row, 1) = static_cast<int>(j) + 1;
+            row += 1;
+        }
+    }
+    Rcpp::colnames(out) = Rcpp::CharacterVector::create("query_idx",
+                                                        "tree_idx");
+    return out;
+}
+
+void SpatialIndex::queryGeoms_(
+        const std::vector<OGRGeometryH> &qgeoms, const std::string &predicate,
+        int num_threads,
+        std::vector<std::vector<std::size_t>> *results) const {
+
+    const PredicateFn pred = getPredicateFn_(predicate);
+    const bool is_contains = EQUAL(predicate.c_str(), "contains");
+    const bool is_within = EQUAL(predicate.c_str(), "within");
+    // the query geometry is prepared when it has several candidates
+    const bool can_prepare = EQUAL(predicate.c_str(), "intersects") ||
+                             is_contains;
+    constexpr std::size_t MIN_CANDIDATES_TO_PREPARE = 4;
+
+    results->assign(qgeoms.size(), std::vector<std::size_t>());
+
+    parallel_for_(qgeoms.size(), num_threads, [&](std::size_t i) {
+        const STRBox qbox = geomBox_(qgeoms[i]);
+        if (qbox.isNull())
+            return;
+
+        std::vector<std::size_t> hits;
+        m_tree.query(qbox, &hits);
+        std::sort(hits.begin(), hits.end());
+        if (pred == nullptr) {
+            (*results)[i].swap(hits);
+            return;
+        }
+
+        OGRPreparedGeometryH hPrep = nullptr;
+        if (can_prepare && hits.size() >= MIN_CANDIDATES_TO_PREPARE)
+            hPrep = OGRCreatePreparedGeometry(qgeoms[i]);
+
+        for (std::size_t j : hits) {
+            // envelope containment is necessary for these
+            if (is_contains && !qbox.contains(m_boxes[j]))
+                continue;
+            if (is_within && !m_boxes[j].contains(qbox))
+                continue;
+
+            int value = 0;
+            if (hPrep != nullptr && is_contains)
+                value = OGRPreparedGeometryContains(hPrep, m_geoms[j]);
+            else if (hPrep != nullptr)
+                value = OGRPreparedGeometryIntersects(hPrep, m_geoms[j]);
+            else
+                value = pred(qgeoms[i], m_geoms[j]);
+
+            if (value)
+                (*results)[i].push_back(j);
+        }
+
+        if (hPrep != nullptr)
+            OGRDestroyPreparedGeometry(hPrep);
+    });
+}
+
+Rcpp::DataFrame SpatialIndex::nearest(const Rcpp::RObject &geom, int k,
+                                      double max_distance,
+                                      int num_threads) const {
+
+    if (k == NA_INTEGER || k < 1)
+        Rcpp::stop("'k' must be an integer >= 1");
+    if (Rcpp::NumericVector::is_na(max_distance))
+        max_distance = -1.0;
+
+    std::vector<OGRGeometryH> qgeoms = geomsFromRObject_(geom, quiet);
+    std::vector<std::vector<std::pair<std::size_t, double>>> results;
+
+    try {
+        nearestGeoms_(qgeoms, static_cast<std::size_t>(k), max_distance, 0,
+                      num_threads, &results);
+    }
+    catch (const std::exception &e) {
+        destroyGeoms_(&qgeoms);
+        Rcpp::stop(e.what());
+    }
+    destroyGeoms_(&qgeoms);
+
+    std::size_t num_out = 0;
+    for (const auto &r : results)
+        num_out += r.size();
+
+    Rcpp::IntegerVector query_idx(num_out);
+    Rcpp::IntegerVector tree_idx(num_out);
+    Rcpp::NumericVector distance(num_out);
+    std::size_t row = 0;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        for (const auto &hit : results[i]) {
+            query_idx[row] = static_cast<int>(i) + 1;
+            tree_idx[row] = static_cast<int>(hit.first) + 1;
+            distance[row] = hit.second;
+            row += 1;
+        }
+    }
+
+    return Rcpp::DataFrame::create(Rcpp::Named("query_idx") = query_idx,
+                                   Rcpp::Named("tree_idx") = tree_idx,
+                                   Rcpp::Named("distance") = distance);
+}
+
+void SpatialIndex::nearestGeoms_(
+        const std::vector<OGRGeometryH> &qgeoms, std::size_t k,
+        double max_dist, double radius, int num_threads,
+        std::vector<std::vector<std::pair<std::size_t, double>>> *results)
+        const {
+
+    results->assign(qgeoms.size(),
+                    std::vector<std::pair<std::size_t, double>>());
+    if (k == 0)
+        k = std::numeric_limits<std::size_t>::max();
+
+    if (radius <= 0) {
+        parallel_for_(qgeoms.size(), num_threads, [&](std::size_t i) {
+            const STRBox qbox = geomBox_(qgeoms[i]);
+            if (qbox.isNull())
+                return;
+
+            OGRGeometryH hQuery = qgeoms[i];
+            auto dist_fn = [&](std::size_t j) -> double {
+                const double d = OGR_G_Distance(hQuery, m_geoms[j]);
+                return d < 0 ? std::nan("") : d;
+            };
+            m_tree.nearest(qbox, k, max_dist, dist_fn, &(*results)[i]);
+        });
+        return;
+    }
+
+    // great-circle distances, the vertices of the tree geometries are
+    // converted to unit vectors once per call
+    std::vector<SphereGeom> tree_sg(m_geoms.size());
+    parallel_for_(m_geoms.size(), num_threads, [&](std::size_t j) {
+        if (!m_boxes[j].isNull())
+            sphereGeom_(m_geoms[j], &tree_sg[j]);
+    }, 64);
+
+    parallel_for_(qgeoms.size(), num_threads, [&](std::size_t i) {
+        const STRBox qbox = geomBox_(qgeoms[i]);
+        if (qbox.isNull())
+            return;
+
+        OGRGeometryH hQuery = qgeoms[i];
+        SphereGeom qsg;
+        sphereGeom_(hQuery, &qsg);
+
+        auto dist_fn = [&](std::size_t j) -> double {
+            if (qbox.intersects(m_boxes[j]) &&
+                    OGR_G_Intersects(hQuery, m_geoms[j])) {
+                return 0.0;
+            }
+            return radius * sphereAngle_(qsg, tree_sg[j]);
+        };
+        auto box_dist_fn = [&](const STRBox &b) -> double {
+            return radius * sphereBoxAngle_(qbox, b);
+        };
+        m_tree.nearest(k, max_dist, dist_fn, box_dist_fn, &(*results)[i]);
+    });
+}
+
+void SpatialIndex::show() const {
+    Rcpp::Rcout << "C++ object of class SpatialIndex\n";
+    Rcpp::Rcout << " Number of geometries: " << m_geoms.size() << "\n";
+    Rcpp::Rcout << " Number indexed: " << m_num_indexed << "\n";
+    Rcpp::Rcout << " Node capacity: " << m_tree.nodeCapacity() << "\n";
+}
+
+std::size_t SpatialIndex::numGeoms_() const {
+    return m_geoms.size();
+}
+
+OGRGeometryH SpatialIndex::getGeom_(std::size_t i) const {
+    return m_geoms[i];
+}
+
+int64_t SpatialIndex::getFID_(std::size_t i) const {
+    return m_fids[i];
+}
+
+const STRtree &SpatialIndex::getTree_() const {
+    return m_tree;
+}
+
+//' Spatial join of two vector layers returning pairs of FIDs
+//' y_lyr is read into an in-memory SpatialIndex, x_lyr is streamed in
+//' batches and each batch is probed against the index on multiple threads
+//' @noRd
+// [[Rcpp::export(name = ".ogr_sjoin_fid")]]
+Rcpp::List ogr_sjoin_fid(GDALVector* const &x_lyr,
+                         GDALVector* const &y_lyr,
+                         const std::string &predicate, bool left,
+                         int num_threads, int batch_size, bool quiet) {
+
+    if (!x_lyr->isOpen())
+        Rcpp::stop("'x_lyr' is not open");
+    if (!y_lyr->isOpen())
+        Rcpp::stop("'y_lyr' is not open");
+    if (batch_size == NA_INTEGER || batch_size < 1)
+        Rcpp::stop("'batch_size' must be an integer >= 1");
+
+    // validates the predicate before reading any data
+    getPredicateFn_(predicate);
+
+    SpatialIndex idx;
+    idx.initFromLayer_(y_lyr->getOGRLayerH_());
+
+    OGRLayerH hLayer = x_lyr->getOGRLayerH_();
+    const GIntBig num_feat = OGR_L_GetFeatureCount(hLayer, FALSE);
+    GDALProgressFunc pfnProgress = GDALTermProgressR;
+    if (!quiet && num_feat > 0)
+        pfnProgress(0, nullptr, nullptr);
+
+    std::vector<int64_t> x_fid_out;
+    std::vector<int64_t> y_fid_out;
+    std::vector<OGRGeometryH> batch_geoms;
+    std::vector<int64_t> batch_fids;
+    std::vector<std::vector<std::size_t>> results;
+    batch_geoms.reserve(batch_size);
+    batch_fids.reserve(batch_size);
+    GIntBig num_read = 0;
+    bool done = false;
+
+    OGR_L_ResetReading(hLayer);
+    try {
+        while (!done) {
+            OGRFeatureH hFeat = nullptr;
+            while (batch_fids.size() < static_cast<std::size_t>(batch_size)) {
+                hFeat = OGR_L_GetNextFeature(hLayer);
+                if (hFeat == nullptr) {
+                    done = true;
+                    break;
+                }
+                batch_fids.push_back(
+                        static_cast<int64_t>(OGR_F_GetFID(hFeat)));
+                batch_geoms.push_back(OGR_F_StealGeometry(hFeat));
+                OGR_F_Destroy(hFeat);
+            }
+            num_read += static_cast<GIntBig>(batch_fids.size());
+
+            idx.queryGeoms_(batch_geoms, predicate, num_threads, &results);
+
+            for (std::size_t i = 0; i < results.size(); ++i) {
+                if (results[i].empty() && left) {
+                    x_fid_out.push_back(batch_fids[i]);
+                    y_fid_out.push_back(NA_INTEGER64);
+                    continue;
+                }
+                for (std::size_t j : results[i]) {
+                    x_fid_out.push_back(batch_fids[i]);
+                    y_fid_out.push_back(idx.getFID_(j));
+                }
+            }
+
+            destroyGeoms_(&batch_geoms);
+            batch_geoms.clear();
+            batch_fids.clear();
+
+            if (!quiet && num_feat > 0) {
+                pfnProgress(std::min(1.0, num_read /
+                                          static_cast<double>(num_feat)),
+                            nullptr, nullptr);
+            }
+            Rcpp::checkUserInterrupt();
+        }
+    }
+    catch (...) {
+        destroyGeoms_(&batch_geoms);
+        OGR_L_ResetReading(hLayer);
+        throw;
+    }
+    OGR_L_ResetReading(hLayer);
+
+    if (!quiet && num_feat > 0)
+        pfnProgress(1.0, nullptr, nullptr);
+
+    Rcpp::List df = Rcpp::List::create(
+            Rcpp::Named("x_fid") = Rcpp::wrap(x_fid_out),
+            Rcpp::Named("y_fid") = Rcpp::wrap(y_fid_out));
+    df.attr("class") = Rcpp::CharacterVector{"data.frame"};
+    df.attr("row.names") = Rcpp::seq_len(x_fid_out.size());
+    return df;
+}
+
+//' k nearest neighbor (k > 0) or within distance (k = 0) search of the
+//' geometries of y for each geometry of x, given as WKB/WKT or GDALVector
+//' sphere_srs is a geographic SRS for great-circle distances in meters, or
+//' "" for Cartesian distances
+//' @noRd
+// [[Rcpp::export(name = ".g_nearest_idx")]]
+Rcpp::List g_nearest_idx(const Rcpp::RObject &x, const Rcpp::RObject &y,
+                         int k, double max_distance,
+                         const std::string &sphere_srs, int num_threads,
+                         bool quiet) {
+
+    if (k == NA_INTEGER || k < 0)
+        Rcpp::stop("'k' must be an integer >= 0");
+    if (Rcpp::NumericVector::is_na(max_distance))
+        max_distance = -1.0;
+    if (k == 0 && max_distance < 0)
+        Rcpp::stop("a distance limit is required for a search without 'k'");
+
+    double radius = 0;
+    if (sphere_srs != "") {
+        std::shared_ptr<const OGRSpatialReference> poSRS =
+                acquireSRS_(sphere_srs, true);
+        if (!poSRS->IsGeographic())
+            Rcpp::stop("spherical distance requires a geographic SRS");
+        // mean radius of the ellipsoid (IUGG)
+        radius = (2.0 * poSRS->GetSemiMajor() + poSRS->GetSemiMinor()) / 3.0;
+    }
+
+    bool x_is_layer = false;
+    if (x.isObject()) {
+        const Rcpp::String cls = x.attr("class");
+        if (cls != "Rcpp_GDALVector")
+            Rcpp::stop("'x' is an object of unsupported class");
+        x_is_layer = true;
+    }
+
+    // y is indexed, x is queried
+    SpatialIndex idx(y);
+
+    std::vector<OGRGeometryH> xgeoms;
+    std::vector<int64_t> xfids;
+    if (x_is_layer) {
+        GDALVector &lyr = Rcpp::as<GDALVector &>(x);
+        if (!lyr.isOpen())
+            Rcpp::stop("the GDALVector object for 'x' is not open");
+        readLayerGeoms_(lyr.getOGRLayerH_(), &xgeoms, &xfids);
+    }
+    else {
+        xgeoms = geomsFromRObject_(x, quiet);
+    }
+
+    std::vector<std::vector<std::pair<std::size_t, double>>> results;
+    try {
+        idx.nearestGeoms_(xgeoms, static_cast<std::size_t>(k), max_distance,
+                          radius, num_threads, &results);
+    }
+    catch (const std::exception &e) {
+        destroyGeoms_(&xgeoms);
+        Rcpp::stop(e.what());
+    }
+    destroyGeoms_(&xgeoms);
+
+    std::size_t num_out = 0;
+    for (const auto &r : results)
+        num_out += r.size();
+
+    Rcpp::IntegerVector x_idx(num_out);
+    Rcpp::IntegerVector y_idx(num_out);
+    Rcpp::NumericVector distance(num_out);
+    std::vector<int64_t> x_fid, y_fid;
+    const bool y_is_layer = y.isObject();
+    std::size_t row = 0;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        for (const auto &hit : results[i]) {
+            x_idx[row] = static_cast<int>(i) + 1;
+            y_idx[row] = static_cast<int>(hit.first) + 1;
+            distance[row] = hit.second;
+            if (x_is_layer)
+                x_fid.push_back(xfids[i]);
+            if (y_is_layer)
+                y_fid.push_back(idx.getFID_(hit.first));
+            row += 1;
+        }
+    }
+
+    Rcpp::List df = Rcpp::List::create(Rcpp::Named("x_idx") = x_idx,
+                                       Rcpp::Named("y_idx") = y_idx,
+                                       Rcpp::Named("distance") = distance);
+    if (x_is_layer)
+        df.push_back(Rcpp::wrap(x_fid), "x_fid");
+    if (y_is_layer)
+        df.push_back(Rcpp::wrap(y_fid), "y_fid");
+    df.attr("class") = Rcpp::CharacterVector{"data.frame"};
+    df.attr("row.names") = Rcpp::seq_len(num_out);
+    return df;
+}
+
+// ****************************************************************************
+
+RCPP_MODULE(mod_spatial_index) {
+    Rcpp::class_<SpatialIndex>("SpatialIndex")
+
+    .constructor
+        ("Default constructor, an empty index")
+    .constructor<Rcpp::RObject>
+        ("Usage: new(SpatialIndex, geom)")
+    .constructor<Rcpp::RObject, int>
+        ("Usage: new(SpatialIndex, geom, node_capacity)")
+
+    // exposed read/write fields
+    .field("quiet", &SpatialIndex::quiet)
+
+    // exposed member functions
+    .const_method("size", &SpatialIndex::size,
+        "Return the number of input geometries")
+    .const_method("numIndexed", &SpatialIndex::numIndexed,
+        "Return the number of geometries in the tree (non-empty)")
+    .const_method("bbox", &SpatialIndex::bbox,
+        "Return the bounding box of all indexed geometries")
+    .const_method("getFID", &SpatialIndex::getFID,
+        "Return the feature IDs if the index was built from a GDALVector")
+    .const_method("queryBBox", &SpatialIndex::queryBBox,
+        "Return indices of geometries whose envelopes intersect a bbox")
+    .const_method("query", &SpatialIndex::query,
+        "Return pairs of query and tree indices satisfying a predicate")
+    .const_method("nearest", &SpatialIndex::nearest,
+        "Return the k nearest tree geometries for each query geometry")
+    .const_method("show", &SpatialIndex::show,
+        "S4 show()")
+    ;
+}
@@ -0,0 +1,106 @@
+/* class SpatialIndex
+   In-memory spatial index over a set of geometries, backed by a packed
+   R-tree (STRtree). Geometries are read once from WKB, WKT or a GDALVector
+   layer and kept in memory for predicate refinement and distance queries.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef SPATIAL_INDEX_H_
+#define SPATIAL_INDEX_H_
+
+#include <Rcpp.h>
+
+#include <ogr_api.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "strtree.h"
+
+class SpatialIndex {
+ public:
+    SpatialIndex();
+    explicit SpatialIndex(const Rcpp::RObject &geom);
+    SpatialIndex(const Rcpp::RObject &geom, int node_capacity);
+    ~SpatialIndex();
+
+    bool quiet {false};
+
+    double size() const;
+    double numIndexed() const;
+    Rcpp::NumericVector bbox() const;
+    SEXP getFID() const;
+
+    Rcpp::IntegerVector queryBBox(const Rcpp::NumericVector &bbox) const;
+    Rcpp::IntegerMatrix query(const Rcpp::RObject &geom,
+                              const std::string &predicate,
+                              int num_threads) const;
+    Rcpp::DataFrame nearest(const Rcpp::RObject &geom, int k,
+                            double max_distance, int num_threads) const;
+
+    void show() const;
+
+    // internal
+    void initFromLayer_(OGRLayerH hLayer);
+    std::size_t numGeoms_() const;
+    OGRGeometryH getGeom_(std::size_t i) const;
+    int64_t getFID_(std::size_t i) const;
+    const STRtree &getTree_() const;
+    // query with geometries already created, does not call the R API
+    // except for Rcpp::stop on an invalid predicate before any work starts
+    // results[i] receives the 0-based tree indices matching qgeoms[i]
+    void queryGeoms_(const std::vector<OGRGeometryH> &qgeoms,
+                     const std::string &predicate, int num_threads,
+                     std::vector<std::vector<std::size_t>> *results) const;
+    // k nearest tree geometries (k = 0 for no limit) within max_dist (< 0
+    // for no limit) of each query geometry, in order of increasing distance
+    // radius > 0 gives great-circle distances for lon/lat coordinates on a
+    // sphere of that radius, otherwise distances are Cartesian
+    // does not call the R API
+    void nearestGeoms_(
+            const std::vector<OGRGeometryH> &qgeoms, std::size_t k,
+            double max_dist, double radius, int num_threads,
+            std::vector<std::vector<std::pair<std::size_t, double>>> *results)
+            const;
+
+ private:
+    std::vector<OGRGeometryH> m_geoms {};
+    std::vector<STRBox> m_boxes {};
+    std::vector<int64_t> m_fids {};
+    STRtree m_tree;
+    std::size_t m_num_indexed {0};
+
+    void init_(const Rcpp::RObject &geom);
+    void buildTree_();
+};
+
+// internal helpers shared with other geometry set operations
+// create geometries from WKB raw / list of WKB raw / WKT character
+// (elements that are NULL or fail to parse give nullptr)
+std::vector<OGRGeometryH> geomsFromRObject_(const Rcpp::RObject &geom,
+                                            bool quiet);
+void destroyGeoms_(std::vector<OGRGeometryH> *geoms);
+// geometries and FIDs of the features of a layer, honoring any filters
+void readLayerGeoms_(OGRLayerH hLayer, std::vector<OGRGeometryH> *geoms,
+                     std::vector<int64_t> *fids);
+// envelope of a geometry as an STRBox (null box for nullptr or empty)
+STRBox geomBox_(OGRGeometryH hGeom);
+
+class GDALVector;
+Rcpp::List ogr_sjoin_fid(GDALVector* const &x_lyr,
+                         GDALVector* const &y_lyr,
+                         const std::string &predicate, bool left,
+                         int num_threads, int batch_size, bool quiet);
+Rcpp::List g_nearest_idx(const Rcpp::RObject &x, const Rcpp::RObject &y,
+                         int k, double max_distance,
+                         const std::string &sphere_srs, int num_threads,
+                         bool quiet);
+
+// cppcheck-suppress unknownMacro
+RCPP_EXPOSED_CLASS(SpatialIndex)
+
+#endif  // SPATIAL_INDEX_H_
@@ -0,0 +1,198 @@
+/* Implementation of class STRtree
+   Sort-Tile-Recursive bulk loading of a packed R-tree.
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include "strtree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+STRtree::STRtree() {}
+
+STRtree::STRtree(int node_capacity)
+        : m_node_capacity(node_capacity) {
+
+    if (m_node_capacity < 2)
+        throw std::invalid_argument("node capacity must be >= 2");
+}
+
+void STRtree::insert(const STRBox &box, std::size_t item) {
+    if (m_built)
+        throw std::logic_error("cannot insert into an STRtree once built");
+    if (box.isNull())
+        return;
+    m_entries.push_back({box, item});
+}
+
+// Sort a vector of elements into STR order: sort by x of the envelope
+// center, cut into vertical slices of (S * capacity) elements where
+// S = ceil(sqrt(number of parent nodes)), then sort each slice by y.
+template <typename T, typename GetBox>
+void STRtree::sortTileRecursive_(std::vector<T> *v, std::size_t capacity,
+                                 GetBox get_box) {
+
+    const std::size_t n = v->size();
+    if (n <= capacity)
+        return;
+
+    std::sort(v->begin(), v->end(), [&get_box](const T &a, const T &b) {
+        return get_box(a).centerX() < get_box(b).centerX();
+    });
+
+    const std::size_t num_parents = (n + capacity - 1) / capacity;
+    const std::size_t num_slices = static_cast<std::size_t>(
+        std::ceil(std::sqrt(static_cast<double>(num_parents))));
+    const std::size_t slice_len = num_slices * capacity;
+
+    for (std::size_t start = 0; start < n; start += slice_len) {
+        const std::size_t end = std::min(start + slice_len, n);
+        std::sort(v->begin() + start, v->begin() + end,
+                  [&get_box](const T &a, const T &b) {
+            return get_box(a).centerY() < get_box(b).centerY();
+        });
+    }
+}
+
+void STRtree::build() {
+    if (m_built)
+        return;
+
+    m_built = true;
+    m_nodes.clear();
+    if (m_entries.empty())
+        return;
+
+    const std::size_t cap = static_cast<std::size_t>(m_node_capacity);
+
+    sortTileRecursive_(&m_entries, cap,
+                       [](const Entry &e) -> const STRBox & { return e.box; });
+
+    // leaf level
+    std::vector<Node> level;
+    for (std::size_t i = 0; i < m_entries.size(); i += cap) {
+        Node node;
+        node.first = i;
+        node.count = std::min(cap, m_entries.size() - i);
+        node.leaf = true;
+        for (std::size_t j = i; j < i + node.count; ++j)
+            node.box.expand(m_entries[j].box);
+        level.push_back(node);
+    }
+
+    // upper levels, the nodes of each level are stored contiguously and the
+    // children of a node are a contiguous range in the level below
+    while (level.size() > 1) {
+        sortTileRecursive_(&level, cap,
+                           [](const Node &n) -> const STRBox & {
+                               return n.box;
+                           });
+
+        const std::size_t level_start = m_nodes.size();
+        m_nodes.insert(m_nodes.end(), level.begin(), level.end());
+
+        std::vector<Node> parents;
+        for (std::size_t i = 0; i < level.size(); i += cap) {
+            Node node;
+            node.first = level_start + i;
+            node.count = std::min(cap, level.size() - i);
+            node.leaf = false;
+            for (std::size_t j = i; j < i + node.count; ++j)
+                node.box.expand(level[j].box);
+            parents.push_back(node);
+        }
+        level.swap(parents);
+    }
+
+    m_nodes.push_back(level[0]);
+    m_root = m_nodes.size() - 1;
+}
+
+bool STRtree::isBuilt() const {
+    return m_built;
+}
+
+std::size_t STRtree::size() const {
+    return m_entries.size();
+}
+
+int STRtree::nodeCapacity() const {
+    return m_node_capacity;
+}
+
+STRBox STRtree::bounds() const {
+    if (!m_built || m_nodes.empty())
+        return STRBox();
+    return m_nodes[m_root].box;
+}
+
+void STRtree::query(const STRBox &box, std::vector<std::size_t> *out) const {
+    if (!m_built || m_nodes.empty() || box.isNull())
+        return;
+
+    std::vector<std::size_t> stack;
+    stack.push_back(m_root);
+    while (!stack.empty()) {
+        const Node &node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (!node.box.intersects(box))
+            continue;
+
+        if (node.leaf) {
+            for (std::size_t i = node.first; i < node.first + node.count;
+                    ++i) {
+                if (m_entries[i].box.intersects(box))
+                    out->push_back(m_entries[i].item);
+            }
+        }
+        else {
+            for (std::size_t i = node.first; i < node.first + node.count;
+                    ++i) {
+                stack.push_back(i);
+            }
+        }
+    }
+}
+
+void STRtree::levels(
+        std::vector<std::size_t> *items,
+        std::vector<std::vector<std::pair<std::size_t, std::size_t>>> *levels)
+        const {
+
+    items->clear();
+    levels->clear();
+    if (!m_built || m_nodes.empty())
+        return;
+
+    items->reserve(m_entries.size());
+    for (const Entry &e : m_entries)
+        items->push_back(e.item);
+
+    // levels are stored contiguously in m_nodes from the leaves up, and each
+    // level has one node per cap nodes of the level below (see build())
+    const std::size_t cap = static_cast<std::size_t>(m_node_capacity);
+    std::size_t start = 0;
+    std::size_t child_start = 0;
+    std::size_t num = (m_entries.size() + cap - 1) / cap;
+    while (true) {
+        std::vector<std::pair<std::size_t, std::size_t>> ranges;
+        ranges.reserve(num);
+        for (std::size_t j = start; j < start + num; ++j) {
+            const Node &node = m_nodes[j];
+            const std::size_t first =
+                    node.leaf ? node.first : node.first - child_start;
+            ranges.push_back({first, node.count});
+        }
+        levels->push_back(std::move(ranges));
+        if (num == 1)
+            break;
+        child_start = start;
+        start += num;
+        num = (num + cap - 1) / cap;
+    }
+}
@@ -0,0 +1,204 @@
+/* class STRtree
+   A packed R-tree of 2D envelopes, bulk-loaded with the Sort-Tile-Recursive
+   (STR) algorithm (Leutenegger, Lopez and Edgington, 1997). The tree is
+   immutable once built, and queries are safe to run concurrently from
+   multiple threads.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef STRTREE_H_
+#define STRTREE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+struct STRBox {
+    double xmin = std::numeric_limits<double>::infinity();
+    double ymin = std::numeric_limits<double>::infinity();
+    double xmax = -std::numeric_limits<double>::infinity();
+    double ymax = -std::numeric_limits<double>::infinity();
+
+    STRBox() = default;
+    STRBox(double x0, double y0, double x1, double y1)
+        : xmin(x0), ymin(y0), xmax(x1), ymax(y1) {}
+
+    bool isNull() const { return xmin > xmax || ymin > ymax; }
+
+    void expand(const STRBox &other) {
+        xmin = std::min(xmin, other.xmin);
+        ymin = std::min(ymin, other.ymin);
+        xmax = std::max(xmax, other.xmax);
+        ymax = std::max(ymax, other.ymax);
+    }
+
+    bool intersects(const STRBox &other) const {
+        return !(other.xmin > xmax || other.xmax < xmin ||
+                 other.ymin > ymax || other.ymax < ymin);
+    }
+
+    bool contains(const STRBox &other) const {
+        return other.xmin >= xmin && other.xmax <= xmax &&
+               other.ymin >= ymin && other.ymax <= ymax;
+    }
+
+    double centerX() const { return (xmin + xmax) / 2.0; }
+    double centerY() const { return (ymin + ymax) / 2.0; }
+
+    // minimum Euclidean distance between two boxes (0 if they intersect)
+    double distance(const STRBox &other) const {
+        double dx = 0.0;
+        if (other.xmax < xmin)
+            dx = xmin - other.xmax;
+        else if (other.xmin > xmax)
+            dx = other.xmin - xmax;
+        double dy = 0.0;
+        if (other.ymax < ymin)
+            dy = ymin - other.ymax;
+        else if (other.ymin > ymax)
+            dy = other.ymin - ymax;
+        return std::sqrt(dx * dx + dy * dy);
+    }
+};
+
+class STRtree {
+ public:
+    STRtree();
+    explicit STRtree(int node_capacity);
+
+    // add an item before build(), item is an arbitrary caller-defined index
+    void insert(const STRBox &box, std::size_t item);
+    // bulk-load the tree, no inserts are allowed afterwards
+    void build();
+
+    bool isBuilt() const;
+    std::size_t size() const;
+    int nodeCapacity() const;
+    STRBox bounds() const;
+
+    // append to out the items whose envelopes intersect box
+    void query(const STRBox &box, std::vector<std::size_t> *out) const;
+
+    // Best-first traversal returning up to k items nearest to box, in order
+    // of increasing distance. dist_fn(item) returns the exact distance to
+    // the item, which must be >= the envelope distance. Items farther than
+    // max_dist are skipped (max_dist < 0 means no limit). Ties at the k-th
+    // distance are broken arbitrarily.
+    template <typename DistFn>
+    void nearest(const STRBox &box, std::size_t k, double max_dist,
+                 DistFn dist_fn,
+                 std::vector<std::pair<std::size_t, double>> *out) const;
+
+    // As above with a caller-defined lower bound box_dist_fn(node_box) on
+    // the distance from the query to anything within node_box, for
+    // distances other than Cartesian (e.g., on the sphere). dist_fn(item)
+    // must be >= box_dist_fn() of the item's envelope.
+    template <typename DistFn, typename BoxDistFn>
+    void nearest(std::size_t k, double max_dist, DistFn dist_fn,
+                 BoxDistFn box_dist_fn,
+                 std::vector<std::pair<std::size_t, double>> *out) const;
+
+    // Tree structure for bottom-up processing of the nodes (e.g., cascaded
+    // union). items receives the items in leaf order. levels receives the
+    // nodes level by level from the leaves up to the root, each node given
+    // as a range (first, count) of its children: into items for the leaf
+    // level, otherwise into the previous level.
+    void levels(std::vector<std::size_t> *items,
+                std::vector<std::vector<std::pair<std::size_t, std::size_t>>>
+                    *levels) const;
+
+ private:
+    struct Node {
+        STRBox box;
+        std::size_t first;  // index of first child (node or leaf entry)
+        std::size_t count;  // number of children
+        bool leaf;          // children are leaf entries
+    };
+
+    struct Entry {
+        STRBox box;
+        std::size_t item;
+    };
+
+    int m_node_capacity {10};
+    bool m_built {false};
+    std::vector<Entry> m_entries {};
+    std::vector<Node> m_nodes {};
+    std::size_t m_root {0};
+
+    template <typename T, typename GetBox>
+    static void sortTileRecursive_(std::vector<T> *v, std::size_t capacity,
+                                   GetBox get_box);
+};
+
+template <typename DistFn>
+void STRtree::nearest(const STRBox &box, std::size_t k, double max_dist,
+                      DistFn dist_fn,
+                      std::vector<std::pair<std::size_t, double>> *out) const {
+
+    nearest(k, max_dist, dist_fn,
+            [&box](const STRBox &b) { return b.distance(box); }, out);
+}
+
+template <typename DistFn, typename BoxDistFn>
+void STRtree::nearest(std::size_t k, double max_dist, DistFn dist_fn,
+                      BoxDistFn box_dist_fn,
+                      std::vector<std::pair<std::size_t, double>> *out) const {
+
+    if (!m_built || m_nodes.empty() || k == 0)
+        return;
+
+    // queue element: (distance, kind, index)
+    // kind: 0 = node, 1 = entry with envelope distance, 2 = exact distance
+    struct QItem {
+        double dist;
+        int kind;
+        std::size_t idx;
+        bool operator>(const QItem &other) const {
+            if (dist != other.dist)
+                return dist > other.dist;
+            return kind < other.kind;  // prefer exact results on ties
+        }
+    };
+
+    std::priority_queue<QItem, std::vector<QItem>, std::greater<QItem>> pq;
+    pq.push({box_dist_fn(m_nodes[m_root].box), 0, m_root});
+    std::size_t found = 0;
+
+    while (!pq.empty() && found < k) {
+        const QItem top = pq.top();
+        pq.pop();
+        if (max_dist >= 0 && top.dist > max_dist)
+            break;
+
+        if (top.kind == 2) {
+            out->push_back({m_entries[top.idx].item, top.dist});
+            ++found;
+        }
+        else if (top.kind == 1) {
+            const double d = dist_fn(m_entries[top.idx].item);
+            if (std::isnan(d))
+                continue;
+            pq.push({std::max(d, top.dist), 2, top.idx});
+        }
+        else {
+            const Node &node = m_nodes[top.idx];
+            for (std::size_t i = node.first; i < node.first + node.count;
+                    ++i) {
+                if (node.leaf)
+                    pq.push({box_dist_fn(m_entries[i].box), 1, i});
+                else
+                    pq.push({box_dist_fn(m_nodes[i].box), 0, i});
+            }
+        }
+    }
+}
+
+#endif  // STRTREE_H_
@@ -0,0 +1,390 @@
+/* Per-pixel reductions along the time axis of a stack of aligned rasters
+
+   The time steps are the layers of a RasterStack (one band of each input
+   file), read by tiles with one I/O thread per file. Each tile is reduced on
+   a worker thread. The tile buffer holds the layers one after another, so
+   the moments (count, sum, min, max and the sums for the least squares
+   slope) are accumulated layer by layer in simple loops over the pixels of
+   the tile that the compiler can vectorize. Percentiles need the values of
+   one pixel together: they are gathered into a scratch vector without the
+   missing values and selected with std::nth_element (linear time) instead
+   of sorting. Percentiles are interpolated as R quantile() type 7, so the
+   50th percentile is the median.
+
+   For the maximum NDVI, the red and near infrared bands of each file are
+   two more stacks, and the NDVI of each time step is computed as it is
+   scanned.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include <cpl_port.h>
+#include <gdal.h>
+
+#include <Rcpp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "temporal_reduce.h"
+#include "gdalraster.h"
+#include "tile_util.h"
+#include "raster_stack.h"
+
+namespace {
+
+constexpr double TR_NAN = std::numeric_limits<double>::quiet_NaN();
+
+enum TrStat { TR_COUNT, TR_MEAN, TR_MIN, TR_MAX, TR_PERCENTILE, TR_SLOPE,
+              TR_MAX_NDVI, TR_MAX_NDVI_TIME };
+
+struct TrParams {
+    std::vector<TrStat> band_stat;
+    std::vector<double> band_prob;
+    std::vector<double> times;
+    std::size_t min_obs {1};
+    bool need_values {false};
+    bool need_moments {false};
+    bool need_percentiles {false};
+    bool need_ndvi {false};
+};
+
+// type 7 percentile of the n values in x (reordered), n > 0
+double percentile_(double *x, std::size_t n, double prob) {
+    const double h = (n - 1) * prob;
+    const std::size_t lo = static_cast<std::size_t>(std::floor(h));
+    std::nth_element(x, x + lo, x + n);
+    const double v = x[lo];
+    if (lo + 1 >= n || h == lo)
+        return v;
+    // the next order statistic is the minimum of the upper partition
+    const double v_hi = *std::min_element(x + lo + 1, x + n);
+    return v + (h - lo) * (v_hi - v);
+}
+
+// reduce one tile: vals, red and nir hold nlayers layers of npix values
+// (NaN for missing), out receives one layer of npix values per output band
+// does not call the R API
+void reduceTile_(const TrParams &p, std::size_t npix, const double *vals,
+                 const double *red, const double *nir, double *out) {
+
+    const std::size_t nlayers = p.times.size();
+    const std::size_t nbands = p.band_stat.size();
+
+    std::vector<double> cnt, sum, vmin, vmax, st, stt, sty;
+    if (p.need_values) {
+        cnt.assign(npix, 0.0);
+        for (std::size_t k = 0; k < nlayers; ++k) {
+            const double *v = vals + k * npix;
+            for (std::size_t i = 0; i < npix; ++i)
+                cnt[i] += std::isnan(v[i]) ? 0.0 : 1.0;
+        }
+    }
+    if (p.need_moments) {
+        // times are centered on their mean for the slope sums, which does
+        // not change the slope; with large times such as epoch seconds,
+        // cnt * stt - st * st would otherwise lose precision to cancellation
+        double t_mean = 0;
+        for (double t : p.times)
+            t_mean += t;
+        if (nlayers > 0)
+            t_mean /= nlayers;
+
+        sum.assign(npix, 0.0);
+        vmin.assign(npix, std::numeric_limits<double>::infinity());
+        vmax.assign(npix, -std::numeric_limits<double>::infinity());
+        st.assign(npix, 0.0);
+        stt.assign(npix, 0.0);
+        sty.assign(npix, 0.0);
+        for (std::size_t k = 0; k < nlayers; ++k) {
+            const double *v = vals + k * npix;
+            const double t = p.times[k] - t_mean;
+            for (std::size_t i = 0; i < npix; ++i) {
+                const bool ok = !std::isnan(v[i]);
+                const double y = ok ? v[i] : 0.0;
+                const double w = ok ? 1.0 : 0.0;
+                sum[i] += y;
+                st[i] += w * t;
+                stt[i] += w * t * t;
+                sty[i] += y * t;
+                vmin[i] = ok ? std::min(vmin[i], y) : vmin[i];
+                vmax[i] = ok ? std::max(vmax[i], y) : vmax[i];
+            }
+        }
+    }
+
+    std::vector<double> ndvi_max, ndvi_time;
+    if (p.need_ndvi) {
+        ndvi_max.assign(npix, TR_NAN);
+        ndvi_time.assign(npix, TR_NAN);
+        for (std::size_t k = 0; k < nlayers; ++k) {
+            const double *r = red + k * npix;
+            const double *n = nir + k * npix;
+            for (std::size_t i = 0; i < npix; ++i) {
+                const double d = n[i] + r[i];
+                if (std::isnan(d) || d == 0)
+                    continue;
+                const double ndvi = (n[i] - r[i]) / d;
+                if (std::isnan(ndvi_max[i]) || ndvi > ndvi_max[i]) {
+                    ndvi_max[i] = ndvi;
+                    ndvi_time[i] = p.times[k];
+                }
+            }
+        }
+    }
+
+    for (std::size_t b = 0; b < nbands; ++b) {
+        double *o = out + b * npix;
+        switch (p.band_stat[b]) {
+            case TR_COUNT:
+                for (std::size_t i = 0; i < npix; ++i)
+                    o[i] = cnt[i];
+                break;
+            case TR_MEAN:
+                for (std::size_t i = 0; i < npix; ++i)
+                    o[i] = sum[i] / cnt[i];
+                break;
+            case TR_MIN:
+                for (std::size_t i = 0; i < npix; ++i)
+                    o[i] = vmin[i];
+                break;
+            case TR_MAX:
+                for (std::size_t i = 0; i < npix; ++i)
+                    o[i] = vmax[i];
+                break;
+            case TR_SLOPE:
+                for (std::size_t i = 0; i < npix; ++i) {
+                    const double den = cnt[i] * stt[i] - st[i] * st[i];
+                    o[i] = den > 0 ? (cnt[i] * sty[i] - st[i] * sum[i]) / den
+                                   : TR_NAN;
+                }
+                break;
+            case TR_MAX_NDVI:
+                std::copy(ndvi_max.begin(), ndvi_max.end(), o);
+                break;
+            case TR_MAX_NDVI_TIME:
+                std::copy(ndvi_time.begin(), ndvi_time.end(), o);
+                break;
+            case TR_PERCENTILE:
+                break;
+        }
+    }
+
+    if (p.need_percentiles) {
+        std::vector<double> x(nlayers);
+        for (std::size_t i = 0; i < npix; ++i) {
+            std::size_t n = 0;
+            for (std::size_t k = 0; k < nlayers; ++k) {
+                const double v = vals[k * npix + i];
+                if (!std::isnan(v))
+                    x[n++] = v;
+            }
+            for (std::size_t b = 0; b < nbands; ++b) {
+                if (p.band_stat[b] != TR_PERCENTILE)
+                    continue;
+                out[b * npix + i] = n > 0 ?
+                                    percentile_(x.data(), n, p.band_prob[b])
+                                    : TR_NAN;
+            }
+        }
+    }
+
+    // too few observations, the count itself is kept
+    if (p.need_values) {
+        for (std::size_t b = 0; b < nbands; ++b) {
+            if (p.band_stat[b] == TR_COUNT || p.band_stat[b] == TR_MAX_NDVI ||
+                    p.band_stat[b] == TR_MAX_NDVI_TIME) {
+                continue;
+            }
+            double *o = out + b * npix;
+            for (std::size_t i = 0; i < npix; ++i) {
+                if (cnt[i] < p.min_obs || cnt[i] == 0)
+                    o[i] = TR_NAN;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+//' Per-pixel reductions along the time axis of the band of each file in
+//' dsn, one statistic per band of dst_ds (band_probs gives the probability
+//' for "percentile" bands), ndvi_bands is c(red, nir) for max_ndvi
+//' @noRd
+// [[Rcpp::export(name = ".temporal_reduce")]]
+bool temporal_reduce(const Rcpp::CharacterVector &dsn, int band,
+                     const Rcpp::IntegerVector &ndvi_bands,
+                     GDALRaster* const &dst_ds,
+                     const Rcpp::CharacterVector &band_stats,
+                     const Rcpp::NumericVector &band_probs,
+                     const Rcpp::NumericVector &times, int min_obs,
+                     int tile_size, int num_threads, bool quiet) {
+
+    if (dsn.size() == 0)
+        Rcpp::stop("no input rasters");
+    if (times.size() != dsn.size())
+        Rcpp::stop("'times' must have the length of 'dsn'");
+    if (band_stats.size() == 0 || band_probs.size() != band_stats.size())
+        Rcpp::stop("invalid output band statistics");
+    if (tile_size < 1)
+        Rcpp::stop("'tile_size' must be a positive integer");
+
+    TrParams p;
+    p.times.assign(times.begin(), times.end());
+    p.min_obs = static_cast<std::size_t>(std::max(min_obs, 1));
+    for (R_xlen_t b = 0; b < band_stats.size(); ++b) {
+        const std::string s(band_stats[b]);
+        TrStat stat;
+        if (s == "count") {
+            stat = TR_COUNT;
+        } else if (s == "mean") {
+            stat = TR_MEAN;
+        } else if (s == "min") {
+            stat = TR_MIN;
+        } else if (s == "max") {
+            stat = TR_MAX;
+        } else if (s == "percentile") {
+            stat = TR_PERCENTILE;
+            if (!(band_probs[b] >= 0 && band_probs[b] <= 1))
+                Rcpp::stop("percentile probabilities must be in [0, 1]");
+        } else if (s == "slope") {
+            stat = TR_SLOPE;
+        } else if (s == "max_ndvi") {
+            stat = TR_MAX_NDVI;
+        } else if (s == "max_ndvi_time") {
+            stat = TR_MAX_NDVI_TIME;
+        } else {
+            Rcpp::stop("unknown statistic: " + s);
+        }
+        p.band_stat.push_back(stat);
+        p.band_prob.push_back(band_probs[b]);
+        if (stat == TR_MAX_NDVI || stat == TR_MAX_NDVI_TIME) {
+            p.need_ndvi = true;
+        } else {
+            p.need_values = true;
+            if (stat == TR_PERCENTILE)
+                p.need_percentiles = true;
+            else if (stat != TR_COUNT)
+                p.need_moments = true;
+        }
+    }
+    if (p.need_ndvi && ndvi_bands.size() != 2)
+        Rcpp::stop("'ndvi_bands' must give the red and near infrared bands");
+
+    // the stacks are opened in the same order, and each is read with one
+    // thread per file
+    std::unique_ptr<RasterStack> vals_stk, red_stk, nir_stk;
+    if (p.need_values) {
+        vals_stk = std::make_unique<RasterStack>(
+            dsn, Rcpp::IntegerVector::create(band));
+    }
+    if (p.need_ndvi) {
+        red_stk = std::make_unique<RasterStack>(
+            dsn, Rcpp::IntegerVector::create(ndvi_bands[0]));
+        nir_stk = std::make_unique<RasterStack>(
+            dsn, Rcpp::IntegerVector::create(ndvi_bands[1]));
+    }
+    const RasterStack &ref = vals_stk ? *vals_stk : *red_stk;
+    const int xsize = static_cast<int>(ref.getRasterXSize());
+    const int ysize = static_cast<int>(ref.getRasterYSize());
+
+    dst_ds->checkAccess_(GA_Update);
+    if (dst_ds->getRasterXSize() != xsize ||
+            dst_ds->getRasterYSize() != ysize) {
+        Rcpp::stop("the output must have the raster dimensions of the input");
+    }
+    if (dst_ds->getRasterCount() < band_stats.size())
+        Rcpp::stop("the output has fewer bands than statistics");
+    std::vector<GDALRasterBandH> dst_bands;
+    std::vector<double> dst_nodata;
+    std::vector<int> has_dst_nodata;
+    for (R_xlen_t b = 0; b < band_stats.size(); ++b) {
+        GDALRasterBandH hBand = dst_ds->getBand_(static_cast<int>(b) + 1);
+        int has_nodata = FALSE;
+        dst_nodata.push_back(GDALGetRasterNoDataValue(hBand, &has_nodata));
+        has_dst_nodata.push_back(has_nodata);
+        dst_bands.push_back(hBand);
+    }
+
+    int block_xsize = 0;
+    int block_ysize = 0;
+    GDALGetBlockSize(dst_bands[0], &block_xsize, &block_ysize);
+    const std::vector<RasterTile> tiles = makeTiles_(
+        xsize, ysize, tileDim_(tile_size, block_xsize, xsize),
+        tileDim_(tile_size, block_ysize, ysize));
+
+    // batches of tiles: read on the main thread (concurrently across the
+    // files), reduced on workers, written on the main thread
+    const std::size_t nlayers = p.times.size();
+    const std::size_t nbands = p.band_stat.size();
+    const std::size_t batch_size = batchSize_(num_threads, tiles.size());
+    std::vector<std::vector<double>> vals(batch_size), red(batch_size),
+                                     nir(batch_size), out(batch_size);
+
+    GDALProgressFunc pfnProgress = GDALTermProgressR;
+    if (!quiet)
+        pfnProgress(0, nullptr, nullptr);
+
+    forTileBatches_(tiles.size(), num_threads,
+        [&](std::size_t j, std::size_t i) {
+            const RasterTile &t = tiles[i];
+            const std::size_t npix = static_cast<std::size_t>(t.xsize) *
+                                     t.ysize;
+            std::string err;
+            if (vals_stk) {
+                vals[j].resize(npix * nlayers);
+                if (!vals_stk->readWindow_(t.xoff, t.yoff, t.xsize, t.ysize,
+                                           vals[j].data(), &err)) {
+                    Rcpp::stop(err);
+                }
+            }
+            if (red_stk) {
+                red[j].resize(npix * nlayers);
+                nir[j].resize(npix * nlayers);
+                if (!red_stk->readWindow_(t.xoff, t.yoff, t.xsize, t.ysize,
+                                          red[j].data(), &err) ||
+                        !nir_stk->readWindow_(t.xoff, t.yoff, t.xsize,
+                                              t.ysize, nir[j].data(), &err)) {
+                    Rcpp::stop(err);
+                }
+            }
+            out[j].resize(npix * nbands);
+        },
+        [&](std::size_t j, std::size_t i) {
+            const RasterTile &t = tiles[i];
+            reduceTile_(p, static_cast<std::size_t>(t.xsize) * t.ysize,
+                        vals[j].data(), red[j].data(), nir[j].data(),
+                        out[j].data());
+        },
+        [&](std::size_t j, std::size_t i) {
+            const RasterTile &t = tiles[i];
+            const std::size_t npix = static_cast<std::size_t>(t.xsize) *
+                                     t.ysize;
+            for (std::size_t b = 0; b < nbands; ++b) {
+                double *o = out[j].data() + b * npix;
+                if (has_dst_nodata[b]) {
+                    for (std::size_t k = 0; k < npix; ++k) {
+                        if (std::isnan(o[k]))
+                            o[k] = dst_nodata[b];
+                    }
+                }
+                if (GDALRasterIO(dst_bands[b], GF_Write, t.xoff, t.yoff,
+                                 t.xsize, t.ysize, o, t.xsize, t.ysize,
+                                 GDT_Float64, 0, 0) != CE_None) {
+                    Rcpp::stop("failed to write raster tile");
+                }
+            }
+            if (!quiet) {
+                pfnProgress(static_cast<double>(i + 1) / tiles.size(),
+                            nullptr, nullptr);
+            }
+        });
+
+    return true;
+}
@@ -0,0 +1,23 @@
+/* Per-pixel reductions along the time axis of a stack of aligned rasters
+   (count, mean, min, max, percentiles, trend slope and maximum NDVI),
+   processed by tiles on multiple threads.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef TEMPORAL_REDUCE_H_
+#define TEMPORAL_REDUCE_H_
+
+#include <Rcpp.h>
+
+class GDALRaster;
+bool temporal_reduce(const Rcpp::CharacterVector &dsn, int band,
+                     const Rcpp::IntegerVector &ndvi_bands,
+                     GDALRaster* const &dst_ds,
+                     const Rcpp::CharacterVector &band_stats,
+                     const Rcpp::NumericVector &band_probs,
+                     const Rcpp::NumericVector &times, int min_obs,
+                     int tile_size, int num_threads, bool quiet);
+
+#endif  // TEMPORAL_REDUCE_H_
@@ -0,0 +1,118 @@
+/* Helpers for processing a raster in tiles on worker threads
+   Tiles are read and written on the main thread, which is the only thread
+   that may call the R API or do I/O through the package's GDAL handles, and
+   are computed on worker threads with parallel_for_(). They are processed in
+   batches of a few tiles per thread so that only a batch of tile buffers is
+   held in memory.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef TILE_UTIL_H_
+#define TILE_UTIL_H_
+
+#include <cpl_conv.h>
+#include <cpl_string.h>
+#include <gdal.h>
+
+#include <Rcpp.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "parallel_util.h"
+
+// a window of a raster in pixel/line offsets
+struct RasterTile {
+    int xoff {0};
+    int yoff {0};
+    int xsize {0};
+    int ysize {0};
+};
+
+// tile size along one axis, rounded down to whole blocks when the block is
+// not larger than the tile
+inline int tileDim_(int tile_size, int block_size, int raster_size) {
+    int dim = tile_size;
+    if (block_size > 0 && block_size <= tile_size)
+        dim = (tile_size / block_size) * block_size;
+    return std::min(dim, raster_size);
+}
+
+// tiles of tile_xsize by tile_ysize covering an xsize by ysize raster, in row
+// major order (tile (col, row) has index row * ceil(xsize / tile_xsize) + col)
+inline std::vector<RasterTile> makeTiles_(int xsize, int ysize,
+                                          int tile_xsize, int tile_ysize) {
+    std::vector<RasterTile> tiles;
+    for (int yoff = 0; yoff < ysize; yoff += tile_ysize) {
+        for (int xoff = 0; xoff < xsize; xoff += tile_xsize) {
+            RasterTile t;
+            t.xoff = xoff;
+            t.yoff = yoff;
+            t.xsize = std::min(tile_xsize, xsize - xoff);
+            t.ysize = std::min(tile_ysize, ysize - yoff);
+            tiles.push_back(t);
+        }
+    }
+    return tiles;
+}
+
+// number of tiles per batch in forTileBatches_(), two per thread so that the
+// workers stay busy when tile costs are uneven
+inline std::size_t batchSize_(int num_threads, std::size_t num_tiles) {
+    return 2 * static_cast<std::size_t>(resolve_num_threads_(num_threads,
+                                                             num_tiles));
+}
+
+// Process tiles [0, num_tiles) in batches of batchSize_() tiles: read(j, i)
+// on the main thread for batch slot j and tile i, compute(j, i) on worker
+// threads, then write(j, i) on the main thread in tile order. Per-tile
+// buffers are indexed by the batch slot. compute must not call the R API.
+template <typename Read, typename Compute, typename Write>
+void forTileBatches_(std::size_t num_tiles, int num_threads, Read read,
+                     Compute compute, Write write) {
+
+    const std::size_t batch_size = batchSize_(num_threads, num_tiles);
+    for (std::size_t first = 0; first < num_tiles; first += batch_size) {
+        const std::size_t n = std::min(batch_size, num_tiles - first);
+        for (std::size_t j = 0; j < n; ++j)
+            read(j, first + j);
+
+        parallel_for_(n, num_threads, [&](std::size_t j) {
+            compute(j, first + j);
+        });
+
+        for (std::size_t j = 0; j < n; ++j)
+            write(j, first + j);
+
+        Rcpp::checkUserInterrupt();
+    }
+}
+
+// as above for the subset of tiles in idx, with i = idx[k] for the k-th
+template <typename Read, typename Compute, typename Write>
+void forTileBatches_(const std::vector<std::size_t> &idx, int num_threads,
+                     Read read, Compute compute, Write write) {
+
+    forTileBatches_(idx.size(), num_threads,
+        [&](std::size_t j, std::size_t k) { read(j, idx[k]); },
+        [&](std::size_t j, std::size_t k) { compute(j, idx[k]); },
+        [&](std::size_t j, std::size_t k) { write(j, idx[k]); });
+}
+
+// add a band of type dt to a MEM dataset, wrapping buf (no copy)
+inline bool addMemBand_(GDALDatasetH hDS, GDALDataType dt, void *buf) {
+    char szPtr[64] = {'\0'};
+    const int nChars = CPLPrintPointer(szPtr, buf, sizeof(szPtr));
+    szPtr[nChars] = '\0';
+    char **papszBandOptions = nullptr;
+    papszBandOptions = CSLSetNameValue(papszBandOptions, "DATAPOINTER",
+                                       szPtr);
+    const CPLErr err = GDALAddBand(hDS, dt, papszBandOptions);
+    CSLDestroy(papszBandOptions);
+    return err == CE_None;
+}
+
+#endif  // TILE_UTIL_H_
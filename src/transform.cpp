@@ -17,6 +17,7 @@
 
 #include "gdalraster.h"
 #include "srs_api.h"
+#include "transform_cache.h"
 
 //' get PROJ version
 //' @noRd
@@ -60,6 +61,8 @@ void setPROJSearchPaths(Rcpp::CharacterVector paths) {
     }
     path_list[paths.size()] = nullptr;
     OSRSetPROJSearchPaths(path_list.data());
+    // cached transformations may depend on resource files in the old paths
+    transform_cache_clear();
     return;
 }
 
@@ -87,8 +90,10 @@ Rcpp::LogicalVector getPROJEnableNetwork() {
 // [[Rcpp::export(name = ".setPROJEnableNetwork")]]
 void setPROJEnableNetwork(int enabled) {
 #if GDAL_VERSION_NUM >= 3040000
-    if (getPROJVersion()[0] >= 7)
+    if (getPROJVersion()[0] >= 7) {
         OSRSetPROJEnableNetwork(enabled);
+        transform_cache_clear();
+    }
     else
         Rcpp::Rcout << "OSRSetPROJEnableNetwork() requires PROJ 7 or later\n";
 #else
@@ -123,31 +128,12 @@ Rcpp::NumericMatrix inv_project(const Rcpp::RObject &pts,
         has_t = true;
     }
 
-    std::string srs_in = srs_to_wkt(srs, false);
-    OGRSpatialReference oSourceSRS{};
-    std::unique_ptr<OGRSpatialReference> poLongLat;
-    OGRErr err = OGRERR_NONE;
-
-    err = oSourceSRS.importFromWkt(srs_in.c_str());
-    if (err != OGRERR_NONE)
-        Rcpp::stop("failed to import SRS from WKT string");
-    oSourceSRS.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
-
-    if (well_known_gcs == "") {
-        poLongLat = std::unique_ptr<OGRSpatialReference>(
-            oSourceSRS.CloneGeogCS());
-    }
-    else {
-        poLongLat = std::make_unique<OGRSpatialReference>();
-        err = poLongLat->SetWellKnownGeogCS(well_known_gcs.c_str());
-        if (err == OGRERR_FAILURE) {
-            Rcpp::stop("failed to set well known GCS");
-        }
-    }
-    poLongLat->SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
-
-    auto poCT = std::unique_ptr<OGRCoordinateTransformation>(
-        OGRCreateCoordinateTransformation(&oSourceSRS, poLongLat.get()));
+    // transformation object from the process-wide cache
+    const CTLease ct = acquireCT_(srs, well_known_gcs, true,
+                                  well_known_gcs == "" ?
+                                        CTTarget::GEOGCS_OF_SOURCE :
+                                        CTTarget::WELL_KNOWN_GCS);
+    OGRCoordinateTransformation *poCT = ct.get();
 
     Rcpp::NumericVector x = pts_in(Rcpp::_ , 0);
     Rcpp::NumericVector y = pts_in(Rcpp::_ , 1);
@@ -279,26 +265,9 @@ Rcpp::NumericMatrix transform_xy(const Rcpp::RObject &pts,
         has_t = true;
     }
 
-    std::string srs_from_in = srs_to_wkt(srs_from, false);
-    std::string srs_to_in = srs_to_wkt(srs_to, false);
-
-    OGRSpatialReference oSourceSRS{}, oDestSRS{};
-    OGRErr err = OGRERR_NONE;
-
-    err = oSourceSRS.importFromWkt(srs_from_in.c_str());
-    if (err != OGRERR_NONE)
-        Rcpp::stop("failed to import source SRS from WKT string");
-
-    oSourceSRS.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
-
-    err = oDestSRS.importFromWkt(srs_to_in.c_str());
-    if (err != OGRERR_NONE)
-        Rcpp::stop("failed to import destination SRS from WKT string");
-
-    oDestSRS.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
-
-    auto poCT = std::unique_ptr<OGRCoordinateTransformation>(
-        OGRCreateCoordinateTransformation(&oSourceSRS, &oDestSRS));
+    // transformation object from the process-wide cache
+    const CTLease ct = acquireCT_(srs_from, srs_to, true);
+    OGRCoordinateTransformation *poCT = ct.get();
 
     Rcpp::NumericVector x = pts_in(Rcpp::_ , 0);
     Rcpp::NumericVector y = pts_in(Rcpp::_ , 1);
@@ -521,52 +490,9 @@ SEXP transform_bounds(const Rcpp::RObject &bbox,
         Rcpp::stop("'bbox' must be a numeric vector, matrix or data frame");
     }
 
-    const std::string srs_from_in = srs_to_wkt(srs_from, false);
-    const std::string srs_to_in = srs_to_wkt(srs_to, false);
-
-    OGRSpatialReferenceH hSRS_from = OSRNewSpatialReference(nullptr);
-    OGRSpatialReferenceH hSRS_to = OSRNewSpatialReference(nullptr);
-
-    char *pszWKT1 = const_cast<char*>(srs_from_in.c_str());
-    if (OSRImportFromWkt(hSRS_from, &pszWKT1) != OGRERR_NONE) {
-        if (hSRS_from != nullptr)
-            OSRDestroySpatialReference(hSRS_from);
-        if (hSRS_to != nullptr)
-            OSRDestroySpatialReference(hSRS_to);
-        Rcpp::stop("error importing 'srs_from' from user input");
-    }
-
-    char *pszWKT2 = const_cast<char*>(srs_to_in.c_str());
-    if (OSRImportFromWkt(hSRS_to, &pszWKT2) != OGRERR_NONE) {
-        if (hSRS_from != nullptr)
-            OSRDestroySpatialReference(hSRS_from);
-        if (hSRS_to != nullptr)
-            OSRDestroySpatialReference(hSRS_to);
-        Rcpp::stop("error importing 'srs_to' from user input");
-    }
-
-    const std::string save_opt =
-        get_config_option("OGR_CT_FORCE_TRADITIONAL_GIS_ORDER");
-
-    if (traditional_gis_order) {
-        OSRSetAxisMappingStrategy(hSRS_from, OAMS_TRADITIONAL_GIS_ORDER);
-        OSRSetAxisMappingStrategy(hSRS_to, OAMS_TRADITIONAL_GIS_ORDER);
-    }
-    else {
-        set_config_option("OGR_CT_FORCE_TRADITIONAL_GIS_ORDER", "NO");
-        OSRSetAxisMappingStrategy(hSRS_from, OAMS_AUTHORITY_COMPLIANT);
-        OSRSetAxisMappingStrategy(hSRS_to, OAMS_AUTHORITY_COMPLIANT);
-    }
-
-    OGRCoordinateTransformationH hCT = nullptr;
-    hCT = OCTNewCoordinateTransformation(hSRS_from, hSRS_to);
-    if (hCT == nullptr) {
-        if (hSRS_from != nullptr)
-            OSRDestroySpatialReference(hSRS_from);
-        if (hSRS_to != nullptr)
-            OSRDestroySpatialReference(hSRS_to);
-        Rcpp::stop("failed to create coordinate transformer");
-    }
+    // transformation object from the process-wide cache
+    const CTLease ct = acquireCT_(srs_from, srs_to, traditional_gis_order);
+    OGRCoordinateTransformationH hCT = ct.handle();
 
     Rcpp::NumericMatrix out = Rcpp::no_init(num_bbox, 4);
     double out_xmin, out_ymin, out_xmax, out_ymax;
@@ -602,11 +528,6 @@ SEXP transform_bounds(const Rcpp::RObject &bbox,
         }
     }
 
-    OCTDestroyCoordinateTransformation(hCT);
-    OSRDestroySpatialReference(hSRS_from);
-    OSRDestroySpatialReference(hSRS_to);
-    set_config_option("OGR_CT_FORCE_TRADITIONAL_GIS_ORDER", save_opt);
-
     if (num_bbox > 1) {
         return out;
     }
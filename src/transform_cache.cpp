@@ -0,0 +1,299 @@
+/* Process-wide LRU cache of spatial reference systems and coordinate
+   transformation objects.
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#include "transform_cache.h"
+
+#include <cpl_conv.h>
+#include <ogr_core.h>
+#include <ogr_srs_api.h>
+#include <ogr_spatialref.h>
+
+#include <Rcpp.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+constexpr std::size_t SRS_CACHE_CAPACITY = 64;
+constexpr std::size_t CT_CACHE_CAPACITY = 64;
+
+struct CTCacheEntry {
+    std::unique_ptr<OGRCoordinateTransformation> ct {nullptr};
+    std::atomic<bool> in_use {false};
+};
+
+// Least-recently-used map from string keys to shared values. Values that
+// are evicted or cleared stay alive while still referenced by a caller.
+template <typename V>
+class LRUCache {
+ public:
+    explicit LRUCache(std::size_t capacity) : m_capacity(capacity) {}
+
+    std::shared_ptr<V> get(const std::string &key) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_map.find(key);
+        if (it == m_map.end()) {
+            m_misses += 1;
+            return nullptr;
+        }
+        m_hits += 1;
+        m_order.splice(m_order.begin(), m_order, it->second.second);
+        return it->second.first;
+    }
+
+    void put(const std::string &key, std::shared_ptr<V> value) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_map.find(key);
+        if (it != m_map.end()) {
+            it->second.first = value;
+            m_order.splice(m_order.begin(), m_order, it->second.second);
+            return;
+        }
+        m_order.push_front(key);
+        m_map.emplace(key, std::make_pair(value, m_order.begin()));
+        while (m_map.size() > m_capacity) {
+            m_map.erase(m_order.back());
+            m_order.pop_back();
+            m_evictions += 1;
+        }
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_map.clear();
+        m_order.clear();
+        m_hits = m_misses = m_evictions = 0;
+    }
+
+    Rcpp::NumericVector stats() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return Rcpp::NumericVector::create(
+            static_cast<double>(m_map.size()),
+            static_cast<double>(m_capacity),
+            static_cast<double>(m_hits),
+            static_cast<double>(m_misses),
+            static_cast<double>(m_evictions));
+    }
+
+ private:
+    using Order = std::list<std::string>;
+    std::size_t m_capacity;
+    Order m_order {};
+    std::unordered_map<std::string,
+                       std::pair<std::shared_ptr<V>, Order::iterator>> m_map {};
+    uint64_t m_hits {0};
+    uint64_t m_misses {0};
+    uint64_t m_evictions {0};
+    std::mutex m_mutex;
+};
+
+// the caches are intentionally never destroyed, since static destruction at
+// process exit can run after GDAL/PROJ have been cleaned up
+// (they are cleared by the R session finalizer instead)
+static LRUCache<OGRSpatialReference> &srsCache_() {
+    static auto *cache = new LRUCache<OGRSpatialReference>(SRS_CACHE_CAPACITY);
+    return *cache;
+}
+
+static LRUCache<CTCacheEntry> &ctCache_() {
+    static auto *cache = new LRUCache<CTCacheEntry>(CT_CACHE_CAPACITY);
+    return *cache;
+}
+
+// unambiguous key from a list of strings (length-prefixed)
+static std::string makeKey_(std::initializer_list<std::string> parts) {
+    std::string key;
+    for (const std::string &s : parts) {
+        key += std::to_string(s.size());
+        key += ':';
+        key += s;
+    }
+    return key;
+}
+
+// SRS from user input, nullptr on failure
+static std::shared_ptr<OGRSpatialReference> getSRS_(
+        const std::string &srs, bool traditional_gis_order) {
+
+    if (srs == "")
+        return nullptr;
+
+    const std::string key = makeKey_({srs, traditional_gis_order ? "1" : "0"});
+    std::shared_ptr<OGRSpatialReference> poSRS = srsCache_().get(key);
+    if (poSRS)
+        return poSRS;
+
+    poSRS = std::make_shared<OGRSpatialReference>();
+    if (poSRS->SetFromUserInput(srs.c_str()) != OGRERR_NONE)
+        return nullptr;
+
+    if (traditional_gis_order)
+        poSRS->SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+    else
+        poSRS->SetAxisMappingStrategy(OAMS_AUTHORITY_COMPLIANT);
+
+    srsCache_().put(key, poSRS);
+    return poSRS;
+}
+
+CTLease::CTLease(std::shared_ptr<CTCacheEntry> entry,
+                 std::unique_ptr<OGRCoordinateTransformation> own)
+        : m_entry(std::move(entry)), m_own(std::move(own)) {}
+
+CTLease::CTLease(CTLease &&other) noexcept
+        : m_entry(std::move(other.m_entry)), m_own(std::move(other.m_own)) {
+    other.m_entry = nullptr;
+}
+
+CTLease::~CTLease() {
+    if (m_entry)
+        m_entry->in_use.store(false);
+}
+
+OGRCoordinateTransformation *CTLease::get() const {
+    if (m_own)
+        return m_own.get();
+    else if (m_entry)
+        return m_entry->ct.get();
+    else
+        return nullptr;
+}
+
+OGRCoordinateTransformationH CTLease::handle() const {
+    return OGRCoordinateTransformation::ToHandle(get());
+}
+
+OGRCoordinateTransformation *CTLease::clone() const {
+    OGRCoordinateTransformation *poCT = get();
+    if (poCT == nullptr)
+        return nullptr;
+    return poCT->Clone();
+}
+
+CTLease acquireCT_(const std::string &srs_from, const std::string &srs_to,
+                   bool traditional_gis_order, CTTarget target) {
+
+    // the config option affects how the transformation is created, so its
+    // current value is part of the key
+    const char *pszForceTrad =
+            CPLGetConfigOption("OGR_CT_FORCE_TRADITIONAL_GIS_ORDER", "");
+
+    const std::string key = makeKey_({srs_from, srs_to,
+                                      traditional_gis_order ? "1" : "0",
+                                      std::to_string(static_cast<int>(target)),
+                                      pszForceTrad});
+
+    std::shared_ptr<CTCacheEntry> entry = ctCache_().get(key);
+
+    if (!entry) {
+        std::shared_ptr<OGRSpatialReference> poSRS_from =
+                getSRS_(srs_from, traditional_gis_order);
+        if (!poSRS_from)
+            Rcpp::stop("error importing 'srs_from' from user input");
+
+        std::shared_ptr<OGRSpatialReference> poSRS_to = nullptr;
+        if (target == CTTarget::SRS) {
+            poSRS_to = getSRS_(srs_to, traditional_gis_order);
+            if (!poSRS_to)
+                Rcpp::stop("error importing 'srs_to' from user input");
+        }
+        else {
+            if (target == CTTarget::GEOGCS_OF_SOURCE) {
+                poSRS_to = std::shared_ptr<OGRSpatialReference>(
+                        poSRS_from->CloneGeogCS());
+                if (!poSRS_to)
+                    Rcpp::stop("failed to obtain the GCS of 'srs_from'");
+            }
+            else {
+                poSRS_to = std::make_shared<OGRSpatialReference>();
+                if (poSRS_to->SetWellKnownGeogCS(srs_to.c_str()) !=
+                        OGRERR_NONE) {
+                    Rcpp::stop("failed to set well known GCS");
+                }
+            }
+            if (traditional_gis_order)
+                poSRS_to->SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+            else
+                poSRS_to->SetAxisMappingStrategy(OAMS_AUTHORITY_COMPLIANT);
+        }
+
+        const std::string save_opt(pszForceTrad);
+        if (!traditional_gis_order) {
+            CPLSetConfigOption("OGR_CT_FORCE_TRADITIONAL_GIS_ORDER", "NO");
+        }
+
+        entry = std::make_shared<CTCacheEntry>();
+        entry->ct.reset(OGRCreateCoordinateTransformation(poSRS_from.get(),
+                                                          poSRS_to.get()));
+
+        if (!traditional_gis_order) {
+            CPLSetConfigOption("OGR_CT_FORCE_TRADITIONAL_GIS_ORDER",
+                               save_opt == "" ? nullptr : save_opt.c_str());
+        }
+
+        if (!entry->ct)
+            Rcpp::stop("failed to create coordinate transformer");
+
+        ctCache_().put(key, entry);
+    }
+
+    bool expected = false;
+    if (entry->in_use.compare_exchange_strong(expected, true))
+        return CTLease(entry, nullptr);
+
+    // already in use, hand out a private copy
+    std::unique_ptr<OGRCoordinateTransformation> own(entry->ct->Clone());
+    if (!own)
+        Rcpp::stop("failed to clone coordinate transformer");
+
+    return CTLease(nullptr, std::move(own));
+}
+
+std::shared_ptr<const OGRSpatialReference> acquireSRS_(
+        const std::string &srs, bool traditional_gis_order) {
+
+    std::shared_ptr<OGRSpatialReference> poSRS =
+            getSRS_(srs, traditional_gis_order);
+    if (!poSRS)
+        Rcpp::stop("error importing SRS from user input");
+
+    return poSRS;
+}
+
+//' @noRd
+// [[Rcpp::export(name = ".transform_cache_stats")]]
+Rcpp::List transform_cache_stats() {
+    const Rcpp::NumericVector srs = srsCache_().stats();
+    const Rcpp::NumericVector ct = ctCache_().stats();
+
+    Rcpp::List df = Rcpp::List::create(
+        Rcpp::Named("cache") =
+                Rcpp::CharacterVector::create("srs", "transformation"),
+        Rcpp::Named("size") = Rcpp::NumericVector::create(srs[0], ct[0]),
+        Rcpp::Named("capacity") = Rcpp::NumericVector::create(srs[1], ct[1]),
+        Rcpp::Named("hits") = Rcpp::NumericVector::create(srs[2], ct[2]),
+        Rcpp::Named("misses") = Rcpp::NumericVector::create(srs[3], ct[3]),
+        Rcpp::Named("evictions") =
+                Rcpp::NumericVector::create(srs[4], ct[4]));
+
+    df.attr("class") = Rcpp::CharacterVector{"data.frame"};
+    df.attr("row.names") = Rcpp::seq_len(2);
+    return df;
+}
+
+//' @noRd
+// [[Rcpp::export(name = ".transform_cache_clear")]]
+void transform_cache_clear() {
+    ctCache_().clear();
+    srsCache_().clear();
+}
@@ -0,0 +1,69 @@
+/* Process-wide LRU cache of spatial reference systems and coordinate
+   transformation objects, so that repeated calls to the transformation
+   functions with the same SRS definitions avoid the cost of parsing user
+   input and looking up operations in the PROJ database.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef TRANSFORM_CACHE_H_
+#define TRANSFORM_CACHE_H_
+
+#include <Rcpp.h>
+
+#include <ogr_spatialref.h>
+
+#include <memory>
+#include <string>
+
+// target of a cached coordinate transformation
+enum class CTTarget {
+    SRS,               // srs_to
+    GEOGCS_OF_SOURCE,  // the geographic CRS of srs_from (srs_to ignored)
+    WELL_KNOWN_GCS     // srs_to is a well known GCS name, e.g., "WGS84"
+};
+
+struct CTCacheEntry;
+
+// A coordinate transformation borrowed from the cache for the duration of a
+// call. A cached object is handed to one user at a time. If it is already in
+// use (e.g., by another thread), the lease holds a private clone instead.
+// GDAL assigns the thread-local PROJ context of the calling thread when a
+// transformation is used, so a lease may be used on a thread other than the
+// one that created it, but not concurrently.
+class CTLease {
+ public:
+    CTLease() = default;
+    CTLease(std::shared_ptr<CTCacheEntry> entry,
+            std::unique_ptr<OGRCoordinateTransformation> own);
+    CTLease(CTLease &&other) noexcept;
+    ~CTLease();
+
+    OGRCoordinateTransformation *get() const;
+    OGRCoordinateTransformationH handle() const;
+    // an independent copy for use on another thread, owned by the caller
+    OGRCoordinateTransformation *clone() const;
+
+ private:
+    std::shared_ptr<CTCacheEntry> m_entry {nullptr};
+    std::unique_ptr<OGRCoordinateTransformation> m_own {nullptr};
+};
+
+// Coordinate transformation for srs_from -> srs_to from the cache, created on
+// a cache miss. SRS definitions may be in any format accepted by
+// srs_to_wkt(). Must be called on the main R thread (calls Rcpp::stop() on
+// failure).
+CTLease acquireCT_(const std::string &srs_from, const std::string &srs_to,
+                   bool traditional_gis_order,
+                   CTTarget target = CTTarget::SRS);
+
+// SRS object from the cache with the given axis mapping strategy, shared and
+// read-only. Must be called on the main R thread.
+std::shared_ptr<const OGRSpatialReference> acquireSRS_(
+        const std::string &srs, bool traditional_gis_order);
+
+Rcpp::List transform_cache_stats();
+void transform_cache_clear();
+
+#endif  // TRANSFORM_CACHE_H_
@@ -0,0 +1,241 @@
+/* class WkbReader
+   Forward-only reader over the bytes of a WKB geometry, for computing
+   properties such as the geometry type, part counts, envelope and vertices
+   without creating an OGR geometry object. OGC WKB, ISO WKB (Z/M/ZM type
+   codes 1000/2000/3000) and PostGIS EWKB (Z/M flags and embedded SRID) are
+   recognized, with byte order read per (sub-)geometry. Only the simple
+   feature types Point through GeometryCollection are handled. Curve and
+   surface types, and any malformed input, make the scan fail so that the
+   caller can fall back to OGR. Does not allocate and does not call the R
+   API, so it can be used on worker threads.
+
+   Chris Toney <chris.toney at usda.gov>
+   Copyright (c) 2023-2025 gdalraster authors
+*/
+
+#ifndef WKB_READER_H_
+#define WKB_READER_H_
+
+#include <cpl_port.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// same limit on the nesting of collections as OGR
+constexpr int WKB_MAX_DEPTH = 32;
+
+// flat geometry type codes handled by WkbReader
+constexpr uint32_t WKB_POINT = 1;
+constexpr uint32_t WKB_LINESTRING = 2;
+constexpr uint32_t WKB_POLYGON = 3;
+constexpr uint32_t WKB_MULTIPOINT = 4;
+constexpr uint32_t WKB_MULTILINESTRING = 5;
+constexpr uint32_t WKB_MULTIPOLYGON = 6;
+constexpr uint32_t WKB_GEOMETRYCOLLECTION = 7;
+
+struct WkbHeader {
+    uint32_t type = 0;  // flat type code
+    bool has_z = false;
+    bool has_m = false;
+    bool has_srid = false;
+    uint32_t srid = 0;
+
+    std::size_t coordSize() const {
+        return sizeof(double) * (2 + (has_z ? 1 : 0) + (has_m ? 1 : 0));
+    }
+};
+
+// geometry type name as given by OGR_G_GetGeometryName()
+inline const char *wkbTypeName_(uint32_t type) {
+    switch (type) {
+        case WKB_POINT: return "POINT";
+        case WKB_LINESTRING: return "LINESTRING";
+        case WKB_POLYGON: return "POLYGON";
+        case WKB_MULTIPOINT: return "MULTIPOINT";
+        case WKB_MULTILINESTRING: return "MULTILINESTRING";
+        case WKB_MULTIPOLYGON: return "MULTIPOLYGON";
+        case WKB_GEOMETRYCOLLECTION: return "GEOMETRYCOLLECTION";
+        default: return "";
+    }
+}
+
+// WkbReader::walk() calls the following methods of a visitor, any of which
+// may return false to stop the scan:
+//   bool geometryStart(const WkbHeader &hdr, uint32_t size, int depth)
+//       size is 1 for a point, else the number of points, rings or parts
+//   bool ringStart(const WkbHeader &hdr, uint32_t num_points)
+//   bool coord(const WkbHeader &hdr, const double *xyzm)
+//       xyzm[2] and xyzm[3] are only set if hdr.has_z / hdr.has_m
+class WkbReader {
+ public:
+    WkbReader(const unsigned char *data, std::size_t size)
+        : m_p(data), m_end(data == nullptr ? data : data + size) {}
+
+    std::size_t remaining() const {
+        return static_cast<std::size_t>(m_end - m_p);
+    }
+
+    // byte order, geometry type and optional EWKB SRID of the next geometry
+    bool readHeader(WkbHeader *hdr) {
+        unsigned char order = 0;
+        if (remaining() < 1)
+            return false;
+        order = *m_p++;
+        if (order > 1)
+            return false;
+        // 0 = big endian (XDR), 1 = little endian (NDR)
+        m_swap = ((order == 1) != (CPL_IS_LSB == 1));
+
+        uint32_t code = 0;
+        if (!readUInt32(&code))
+            return false;
+
+        hdr->has_z = (code & 0x80000000) != 0;
+        hdr->has_m = (code & 0x40000000) != 0;
+        hdr->has_srid = (code & 0x20000000) != 0;
+        code &= 0x0FFFFFFF;
+        if (code >= 3000 && code < 4000) {
+            hdr->has_z = hdr->has_m = true;
+            code -= 3000;
+        }
+        else if (code >= 2000 && code < 3000) {
+            hdr->has_m = true;
+            code -= 2000;
+        }
+        else if (code >= 1000 && code < 2000) {
+            hdr->has_z = true;
+            code -= 1000;
+        }
+        if (code < WKB_POINT || code > WKB_GEOMETRYCOLLECTION)
+            return false;
+        hdr->type = code;
+
+        hdr->srid = 0;
+        if (hdr->has_srid && !readUInt32(&hdr->srid))
+            return false;
+
+        return true;
+    }
+
+    bool readUInt32(uint32_t *value) {
+        return read_(value, sizeof(uint32_t));
+    }
+
+    bool readDouble(double *value) {
+        return read_(value, sizeof(double));
+    }
+
+    // walk the geometry at the current position, calling methods of visitor
+    template <class Visitor>
+    bool walk(Visitor *visitor, uint32_t parent_type = 0, int depth = 0) {
+        if (depth > WKB_MAX_DEPTH)
+            return false;
+
+        WkbHeader hdr;
+        if (!readHeader(&hdr))
+            return false;
+
+        // the parts of a MultiPoint must be Point, etc.
+        if (parent_type >= WKB_MULTIPOINT && parent_type <= WKB_MULTIPOLYGON &&
+                hdr.type != parent_type - 3) {
+            return false;
+        }
+
+        const std::size_t coord_size = hdr.coordSize();
+        double xyzm[4] = {0, 0, 0, 0};
+        uint32_t size = 0;
+
+        switch (hdr.type) {
+            case WKB_POINT:
+            {
+                if (!visitor->geometryStart(hdr, 1, depth))
+                    return false;
+                return readCoord_(hdr, xyzm) && visitor->coord(hdr, xyzm);
+            }
+
+            case WKB_LINESTRING:
+            {
+                if (!readUInt32(&size) || size > remaining() / coord_size)
+                    return false;
+                if (!visitor->geometryStart(hdr, size, depth))
+                    return false;
+                for (uint32_t i = 0; i < size; ++i) {
+                    if (!readCoord_(hdr, xyzm) || !visitor->coord(hdr, xyzm))
+                        return false;
+                }
+                return true;
+            }
+
+            case WKB_POLYGON:
+            {
+                if (!readUInt32(&size) || size > remaining() / 4)
+                    return false;
+                if (!visitor->geometryStart(hdr, size, depth))
+                    return false;
+                for (uint32_t r = 0; r < size; ++r) {
+                    uint32_t num_pts = 0;
+                    if (!readUInt32(&num_pts) ||
+                            num_pts > remaining() / coord_size) {
+                        return false;
+                    }
+                    if (!visitor->ringStart(hdr, num_pts))
+                        return false;
+                    for (uint32_t i = 0; i < num_pts; ++i) {
+                        if (!readCoord_(hdr, xyzm) ||
+                                !visitor->coord(hdr, xyzm)) {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            }
+
+            default:
+            {
+                // collections, each part has at least a 5-byte header
+                if (!readUInt32(&size) || size > remaining() / 5)
+                    return false;
+                if (!visitor->geometryStart(hdr, size, depth))
+                    return false;
+                for (uint32_t i = 0; i < size; ++i) {
+                    if (!walk(visitor, hdr.type, depth + 1))
+                        return false;
+                }
+                return true;
+            }
+        }
+    }
+
+ private:
+    const unsigned char *m_p;
+    const unsigned char *m_end;
+    bool m_swap {false};
+
+    bool read_(void *value, std::size_t n) {
+        if (remaining() < n)
+            return false;
+        unsigned char *out = static_cast<unsigned char *>(value);
+        if (m_swap) {
+            for (std::size_t i = 0; i < n; ++i)
+                out[i] = m_p[n - 1 - i];
+        }
+        else {
+            std::memcpy(out, m_p, n);
+        }
+        m_p += n;
+        return true;
+    }
+
+    bool readCoord_(const WkbHeader &hdr, double *xyzm) {
+        if (!readDouble(&xyzm[0]) || !readDouble(&xyzm[1]))
+            return false;
+        if (hdr.has_z && !readDouble(&xyzm[2]))
+            return false;
+        if (hdr.has_m && !readDouble(&xyzm[3]))
+            return false;
+        return true;
+    }
+};
+
+#endif  // WKB_READER_H_